@@ -0,0 +1,412 @@
+/**
+@file
+
+Check that the evaluation functions of the ILM do not allocate memory.
+
+Replaces the global operator new with one that counts its calls, then calls
+each single path, batch and coverage function once to warm up the thread pool
+and the scratch memory of the threads, and again while counting. Fails if any
+call allocates. The batch and coverage functions are checked on the calling
+thread alone without an ILM_Workspace, and on -t threads with one.
+
+Usage: allocation_check [-n np] [-t threads]
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Enums.h"
+#include "Errors.h"
+
+/**
+@brief
+Keep a function out of line. The allocation and release of the replacements
+of operator new and operator delete are not inlined, so that the compiler
+does not pair an inlined free() with a call of operator new.
+*/
+#if defined(_MSC_VER)
+#define ALLOCATION_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define ALLOCATION_NOINLINE __attribute__((noinline))
+#else
+#define ALLOCATION_NOINLINE
+#endif
+
+/**
+@brief
+Whether allocations are being counted.
+*/
+static std::atomic<bool> counting(false);
+
+/**
+@brief
+Number of allocations counted.
+*/
+static std::atomic<long long> n_allocations(0);
+
+/**
+@brief
+Allocate memory, counting the call.
+
+@param[in] bytes
+Size, in bytes.
+
+@return
+Memory, or NULL if none is available.
+
+*/
+static ALLOCATION_NOINLINE void *CountedAllocate(
+    size_t bytes
+) {
+    if (counting.load(std::memory_order_relaxed))
+        n_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    return malloc(bytes > 0 ? bytes : 1);
+}
+
+/**
+@brief
+Release memory of CountedAllocate().
+
+The replacements of operator new and operator delete all go through this pair,
+so every block is allocated with malloc() and released with free().
+
+@param[in] memory
+Memory, or NULL.
+
+*/
+static ALLOCATION_NOINLINE void CountedRelease(
+    void *memory
+) {
+    free(memory);
+}
+
+void *operator new(size_t bytes)
+{
+    void *memory = CountedAllocate(bytes);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void *operator new[](size_t bytes)
+{
+    void *memory = CountedAllocate(bytes);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void *operator new(size_t bytes, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(bytes);
+}
+
+void *operator new[](size_t bytes, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(bytes);
+}
+
+void operator delete(void *memory) noexcept
+{
+    CountedRelease(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    CountedRelease(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    CountedRelease(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+    CountedRelease(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+    CountedRelease(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+    CountedRelease(memory);
+}
+
+/**
+@brief
+Call a function once to warm up, then again while counting allocations, and
+report the count.
+
+@param[in] name
+Name of the check.
+
+@param[in] call
+Function to check.
+
+@return
+Number of allocations of the counted call.
+
+*/
+static long long CheckAllocations(
+    const char *name,
+    const std::function<void()> &call
+) {
+    call();
+
+    n_allocations = 0;
+    counting = true;
+    call();
+    counting = false;
+
+    long long n = n_allocations;
+    printf("%-32s %s (%lld allocations)\n", name, n == 0 ? "ok" : "FAILED", n);
+
+    return n;
+}
+
+/**
+@brief
+Fill in a terrain profile of rolling hills in PFL format.
+
+@param[in] np
+Number of intervals.
+
+@param[in] xi__meter
+Profile resolution, in meters.
+
+@param[in] seed
+Variation of the terrain.
+
+@param[out] pfl
+Terrain profile, with np + 3 entries.
+
+*/
+static void HillProfile(
+    int np,
+    double xi__meter,
+    int seed,
+    double pfl[]
+) {
+    pfl[0] = np;
+    pfl[1] = xi__meter;
+
+    for (int i = 0; i <= np; i++)
+    {
+        double x = i * xi__meter;
+        pfl[i + 2] = 400.0 * sin(x / (3000.0 + 500.0 * seed)) + 150.0 * sin(x / 700.0 + seed) + 20.0 * sin(x / 90.0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int np = 2000;
+    int n_threads = 4;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:t:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            np = atoi(optarg);
+            break;
+        case 't':
+            n_threads = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: allocation_check [-n np] [-t threads]\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (np < 10)
+        np = 10;
+
+    double f__mhz = 2000.0;
+    int pol = POLARIZATION__VERTICAL;
+    double epsilon = 15.0;
+    double sigma = 0.005;
+    double p = 50.0;
+
+    std::vector<double> pfl(np + 3);
+    HillProfile(np, 10.0, 0, pfl.data());
+
+    // The same profile in place and in a compact encoding.
+    TerrainView view = { &pfl[2], np, pfl[1], 1 };
+
+    std::vector<short> z_int16(np + 1);
+    for (int i = 0; i <= np; i++)
+        z_int16[i] = short(lround(pfl[i + 2] * 10.0));
+    CompactTerrainView compact = { z_int16.data(), TERRAIN_ENCODING__INT16, 0.1, 0.0, np, pfl[1], 1 };
+
+    RadioContext radio;
+    InitializeRadioContext(f__mhz, pol, epsilon, sigma, &radio);
+    RadioContext fast = radio;
+    fast.precision = PRECISION__FAST;
+
+    PreparedPath path;
+    PreparePath(10.0, 2.0, pfl.data(), &path);
+
+    double A__db;
+    long warnings;
+    IntermediateValues iv;
+    double ps[3] = { 10.0, 50.0, 90.0 };
+    double A_p__db[3];
+
+    // Losses at every point along the profile.
+    std::vector<double> A_k__db(np);
+    std::vector<long> warnings_k(np);
+    std::vector<int> errors_k(np);
+
+    // A batch of links with profiles of different lengths.
+    int n = 64;
+    std::vector<long long> pfl_offsets(n);
+    std::vector<double> pfls;
+    for (int i = 0; i < n; i++)
+    {
+        int np_i = np / 2 + (i * np) / (2 * n);
+        pfl_offsets[i] = (long long)pfls.size();
+        pfls.resize(pfls.size() + np_i + 3);
+        HillProfile(np_i, 10.0, i % 7, &pfls[pfl_offsets[i]]);
+    }
+    std::vector<double> h_tx__meter(n, 10.0), h_rx__meter(n, 2.0);
+    std::vector<double> f(n, f__mhz), epsilons(n, epsilon), sigmas(n, sigma), p_n(n, p);
+    std::vector<int> pols(n, pol);
+    std::vector<int> tx_site(n, SITING_CRITERIA__MOBILE), rx_site(n, SITING_CRITERIA__MOBILE);
+    std::vector<double> d__km(n), delta_h__meter(n, 90.0);
+    for (int i = 0; i < n; i++)
+        d__km[i] = 5.0 + i;
+    std::vector<double> A_n__db(n);
+    std::vector<long> warnings_n(n);
+    std::vector<int> errors_n(n), mode_n(n);
+    std::vector<double> d_hzn__meter(n);
+    IntermediateValuesBatch ivb = {};
+    ivb.d_hzn__meter[0] = d_hzn__meter.data();
+    ivb.mode = mode_n.data();
+
+    // A terrain grid around the TX.
+    int n_grid = 200;
+    std::vector<double> z__meter((size_t)n_grid * n_grid);
+    for (int row = 0; row < n_grid; row++)
+    {
+        for (int col = 0; col < n_grid; col++)
+            z__meter[(size_t)row * n_grid + col] = 300.0 * sin(col / 17.0) * cos(row / 23.0) + 50.0 * sin((row + col) / 5.0);
+    }
+    TerrainGrid grid = { n_grid, n_grid, 0.0, 0.0, 50.0, 50.0, z__meter.data() };
+    int n_radials = 36;
+    int n_ranges = 40;
+    std::vector<double> A_c__db((size_t)n_radials * n_ranges);
+    std::vector<long> warnings_c(A_c__db.size());
+    std::vector<int> errors_c(A_c__db.size());
+    std::vector<unsigned char> mask(((size_t)n_grid * n_grid + 7) / 8);
+
+    // Coverage samples 2 points per range step of 100 m on the 50 m grid.
+    ILM_Workspace *workspace;
+    CreateWorkspace(n_threads, std::max(np, n_ranges * 2), &workspace);
+
+    long long n_failed = 0;
+
+    n_failed += CheckAllocations("PointToPoint_Ex", [&]() {
+        PointToPoint_Ex(10.0, 2.0, pfl.data(), f__mhz, pol, epsilon, sigma, p, &A__db, &warnings, &iv);
+    });
+    n_failed += CheckAllocations("PointToPointView_Ex", [&]() {
+        PointToPointView_Ex(10.0, 2.0, &view, f__mhz, pol, epsilon, sigma, p, &A__db, &warnings, &iv);
+    });
+    n_failed += CheckAllocations("PointToPointCompact_Ex", [&]() {
+        PointToPointCompact_Ex(10.0, 2.0, &compact, f__mhz, pol, epsilon, sigma, p, &A__db, &warnings, &iv);
+    });
+    n_failed += CheckAllocations("PointToPointPercentiles_Ex", [&]() {
+        PointToPointPercentiles_Ex(10.0, 2.0, pfl.data(), f__mhz, pol, epsilon, sigma, 3, ps, A_p__db, &warnings, &iv);
+    });
+    n_failed += CheckAllocations("PointToPointContext_Ex", [&]() {
+        PointToPointContext_Ex(10.0, 2.0, pfl.data(), &fast, p, &A__db, &warnings, &iv);
+    });
+    n_failed += CheckAllocations("PointToPointPreparedContext_Ex", [&]() {
+        PointToPointPreparedContext_Ex(&path, &radio, 3, ps, A_p__db, &warnings, &iv);
+    });
+    n_failed += CheckAllocations("PointToPointPrefixes", [&]() {
+        PointToPointPrefixes(10.0, 2.0, pfl.data(), f__mhz, pol, epsilon, sigma, p, A_k__db.data(), warnings_k.data(), errors_k.data());
+    });
+    n_failed += CheckAllocations("Area_Ex", [&]() {
+        Area_Ex(10.0, 2.0, SITING_CRITERIA__MOBILE, SITING_CRITERIA__MOBILE, 50.0, 90.0, f__mhz, pol, epsilon, sigma, p, &A__db, &warnings, &iv);
+    });
+    n_failed += CheckAllocations("AreaPercentiles_Ex", [&]() {
+        AreaPercentiles_Ex(10.0, 2.0, SITING_CRITERIA__MOBILE, SITING_CRITERIA__MOBILE, 50.0, 90.0, f__mhz, pol, epsilon, sigma, 3, ps, A_p__db, &warnings, &iv);
+    });
+    n_failed += CheckAllocations("AreaCurve", [&]() {
+        AreaCurve(10.0, 2.0, SITING_CRITERIA__MOBILE, SITING_CRITERIA__MOBILE, n, d__km.data(), 90.0, f__mhz, pol, epsilon, sigma, p, A_n__db.data(), warnings_n.data(), mode_n.data());
+    });
+    double d_crossing__km[8];
+    int direction[8];
+    int n_crossings;
+    double d_range__km;
+    n_failed += CheckAllocations("AreaRange", [&]() {
+        AreaRange(10.0, 2.0, SITING_CRITERIA__MOBILE, SITING_CRITERIA__MOBILE, 1.0, 500.0, 90.0, f__mhz, pol, epsilon, sigma, p, 150.0, 8, d_crossing__km, direction, &n_crossings, &d_range__km, &warnings);
+    });
+
+    for (int w = 0; w < 2; w++)
+    {
+        // Without a workspace, the pool threads' own scratch memory grows to
+        // the longest profile each happens to evaluate, so only a batch on the
+        // calling thread is sure to be warmed up.
+        ILM_Workspace *ws = w == 0 ? nullptr : workspace;
+        int n_threads_w = w == 0 ? 1 : n_threads;
+        const char *suffix = w == 0 ? "" : " (workspace)";
+        char name[64];
+
+        snprintf(name, sizeof(name), "PointToPointBatchParallel%s", suffix);
+        n_failed += CheckAllocations(name, [&]() {
+            PointToPointBatchParallel_Ws(n, h_tx__meter.data(), h_rx__meter.data(), pfls.data(), (long long)pfls.size(), pfl_offsets.data(), f.data(), pols.data(), epsilons.data(), sigmas.data(), p_n.data(), A_n__db.data(), warnings_n.data(), errors_n.data(), &ivb, n_threads_w, ws);
+        });
+
+        snprintf(name, sizeof(name), "PointToPointBatchSimd%s", suffix);
+        n_failed += CheckAllocations(name, [&]() {
+            PointToPointBatchSimd_Ws(n, h_tx__meter.data(), h_rx__meter.data(), pfls.data(), (long long)pfls.size(), pfl_offsets.data(), f.data(), pols.data(), epsilons.data(), sigmas.data(), p_n.data(), A_n__db.data(), warnings_n.data(), errors_n.data(), &ivb, n_threads_w, ws);
+        });
+
+        snprintf(name, sizeof(name), "AreaBatchParallel%s", suffix);
+        n_failed += CheckAllocations(name, [&]() {
+            AreaBatchParallel_Ws(n, h_tx__meter.data(), h_rx__meter.data(), tx_site.data(), rx_site.data(), d__km.data(), delta_h__meter.data(), f.data(), pols.data(), epsilons.data(), sigmas.data(), p_n.data(), A_n__db.data(), warnings_n.data(), errors_n.data(), &ivb, n_threads_w, ws);
+        });
+
+        snprintf(name, sizeof(name), "AreaBatchSimd%s", suffix);
+        n_failed += CheckAllocations(name, [&]() {
+            AreaBatchSimd_Ws(n, h_tx__meter.data(), h_rx__meter.data(), tx_site.data(), rx_site.data(), d__km.data(), delta_h__meter.data(), f.data(), pols.data(), epsilons.data(), sigmas.data(), p_n.data(), A_n__db.data(), warnings_n.data(), errors_n.data(), &ivb, n_threads_w, ws);
+        });
+
+        snprintf(name, sizeof(name), "CoverageContext%s", suffix);
+        n_failed += CheckAllocations(name, [&]() {
+            CoverageContext_Ws(&grid, 5000.0, 5000.0, 10.0, 2.0, n_radials, n_ranges, 100.0, &radio, p, n_threads_w, ws, A_c__db.data(), warnings_c.data(), errors_c.data());
+        });
+    }
+
+    n_failed += CheckAllocations("Viewshed", [&]() {
+        Viewshed(&grid, 5000.0, 5000.0, 10.0, 2.0, mask.data());
+    });
+
+    DestroyWorkspace(workspace);
+
+    if (n_failed > 0)
+    {
+        printf("FAILED: %lld allocations\n", n_failed);
+        return EXIT_FAILURE;
+    }
+
+    printf("PASSED: no call allocated after warming up\n");
+    return EXIT_SUCCESS;
+}
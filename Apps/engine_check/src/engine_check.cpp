@@ -0,0 +1,1523 @@
+/**
+@file
+
+Check of the header-only engine of Engine.h against the functions of ilm.h.
+
+Evaluates random area and point-to-point paths, over and around the valid
+input domain, with the area mode and prepared path functions of the library
+and with the engine instantiated for double, for both polarizations, all
+siting criteria and both precisions. Fails if an error code, warning, mode,
+loss or intermediate value of a path differs in any bit, or if no path was
+evaluated. The library functions are wrappers over the engine, so the
+finite losses and terms of the engine are then checked against copies of
+the baseline scalar functions, on the geometry of the area paths. Fails if
+one deviates by more than BASELINE_TOLERANCE__DB, or if none was finite.
+Then evaluates the area paths with the engine for float and long double, and
+compares their intermediate values, free space loss, and line-of-sight and
+knife-edge terms with double. Fails if one deviates by more than the
+tolerance of its type, or if no finite value was compared. Reports the
+number of finite basic transmission losses, reference attenuations and free
+space losses of each mode, the deviations, and the time taken by the library
+and by the engine.
+
+Usage: engine_check [-n paths] [-s seed]
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <chrono>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Engine.h"
+#include "Enums.h"
+#include "Errors.h"
+#include "FastMath.h"
+
+/**
+@brief
+Largest relative deviation of an intermediate value of float from double.
+*/
+#define FLOAT_RELATIVE_TOLERANCE            1.0E-5
+
+/**
+@brief
+Largest deviation of a loss or term of float from double, in dB.
+*/
+#define FLOAT_TOLERANCE__DB                 1.0E-2
+
+/**
+@brief
+Largest relative deviation of an intermediate value of long double from
+double.
+*/
+#define LONG_DOUBLE_RELATIVE_TOLERANCE      1.0E-12
+
+/**
+@brief
+Largest deviation of a loss or term of long double from double, in dB.
+*/
+#define LONG_DOUBLE_TOLERANCE__DB           1.0E-9
+
+/**
+@brief
+Largest deviation of a loss or term of the engine for double from the
+baseline scalar functions, in dB.
+*/
+#define BASELINE_TOLERANCE__DB              1.0E-9
+
+/**
+@brief
+Inputs of one random area path.
+*/
+struct AreaInputs
+{
+    /**
+    Structural heights of the TX and RX, in meters.
+    */
+    double h_tx__meter;
+    double h_rx__meter;
+
+    /**
+    Siting criteria of the TX and RX.
+    */
+    int tx_site_criteria;
+    int rx_site_criteria;
+
+    /**
+    Path distance, in km.
+    */
+    double d__km;
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    double delta_h__meter;
+
+    /**
+    Frequency, in MHz.
+    */
+    double f__mhz;
+
+    /**
+    Polarization.
+    */
+    int pol;
+
+    /**
+    Relative permittivity and conductivity.
+    */
+    double epsilon;
+    double sigma;
+
+    /**
+    Location percentage.
+    */
+    double p;
+};
+
+/**
+@brief
+Outputs of one evaluation of a path.
+*/
+struct CheckResult
+{
+    /**
+    Error code.
+    */
+    int error;
+
+    /**
+    Warning flags.
+    */
+    long warnings;
+
+    /**
+    Basic transmission loss, in dB.
+    */
+    double A__db;
+
+    /**
+    Intermediate values.
+    */
+    IntermediateValues interValues;
+};
+
+/**
+@brief
+Deviations of the results of one floating point type from double.
+*/
+struct TypeDeviation
+{
+    /**
+    Number of finite values compared.
+    */
+    long long n_compared;
+
+    /**
+    Number of values that exceeded their tolerance, or that were finite in
+    only one of the types.
+    */
+    long long n_failed;
+
+    /**
+    Number of terms finite in only one of the types, where an exponential
+    under- or overflowed in the range of the narrower type.
+    */
+    long long n_range;
+
+    /**
+    Largest deviation.
+    */
+    double max_diff;
+};
+
+/**
+@brief
+Return the time, in seconds.
+
+@return
+Time, in seconds.
+
+*/
+static double Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+@brief
+Return a random number with a uniform distribution of its logarithm.
+
+@param[in] rng
+Random number generator.
+
+@param[in] lo
+Smallest value, > 0.
+
+@param[in] hi
+Largest value.
+
+@return
+Random number, lo <= x <= hi.
+
+*/
+static double LogUniform(
+    std::mt19937_64 &rng,
+    double lo,
+    double hi
+) {
+    std::uniform_real_distribution<double> uniform(log(lo), log(hi));
+    return std::min(hi, std::max(lo, exp(uniform(rng))));
+}
+
+/**
+@brief
+Return if two values are the same bits.
+
+@param[in] a
+First value.
+
+@param[in] b
+Second value.
+
+@return
+True if the values are identical, including NaNs.
+
+*/
+static bool SameBits(
+    double a,
+    double b
+) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/**
+@brief
+Return if two results are identical. The loss and intermediate values are
+only compared if the path was evaluated, and only the path distance if there
+was an error after the inputs were validated.
+
+@param[in] a
+First result.
+
+@param[in] b
+Second result.
+
+@return
+True if the results are identical.
+
+*/
+static bool SameResult(
+    const CheckResult &a,
+    const CheckResult &b
+) {
+    if (a.error != b.error || a.warnings != b.warnings)
+        return false;
+
+    if (a.error == ERROR__GROUND_IMPEDANCE)
+        return SameBits(a.interValues.d__km, b.interValues.d__km);
+
+    if (a.error != SUCCESS && a.error != SUCCESS_WITH_WARNINGS)
+        return true;
+
+    const IntermediateValues &u = a.interValues;
+    const IntermediateValues &v = b.interValues;
+    bool same = SameBits(a.A__db, b.A__db) && u.mode == v.mode
+        && SameBits(u.delta_h__meter, v.delta_h__meter) && SameBits(u.A_ref__db, v.A_ref__db)
+        && SameBits(u.A_fs__db, v.A_fs__db) && SameBits(u.d__km, v.d__km);
+    for (int i = 0; i < 2; i++)
+        same = same && SameBits(u.theta_hzn[i], v.theta_hzn[i]) && SameBits(u.d_hzn__meter[i], v.d_hzn__meter[i])
+            && SameBits(u.h_e__meter[i], v.h_e__meter[i]);
+
+    return same;
+}
+
+/**
+@brief
+Count the finite losses of a result that was compared.
+
+@param[in] result
+Result.
+
+@param[in,out] n_finite
+Numbers of finite basic transmission losses, reference attenuations and free
+space losses.
+
+*/
+static void CountFinite(
+    const CheckResult &result,
+    long long n_finite[3]
+) {
+    if (result.error != SUCCESS && result.error != SUCCESS_WITH_WARNINGS)
+        return;
+
+    n_finite[0] += int(std::isfinite(result.A__db));
+    n_finite[1] += int(std::isfinite(result.interValues.A_ref__db));
+    n_finite[2] += int(std::isfinite(result.interValues.A_fs__db));
+}
+
+/**
+@brief
+Add a comparison of a value of another type with the value of double to a
+deviation.
+
+@param[in,out] dev
+Deviation.
+
+@param[in] reference
+Value of double.
+
+@param[in] value
+Value of the other type.
+
+@param[in] tolerance
+Largest acceptable deviation.
+
+@param[in] scale
+Scale of a relative deviation, or 0 for an absolute deviation. The deviation
+is relative to the larger of the scale and the magnitudes of the values.
+
+*/
+static void Accumulate(
+    TypeDeviation *dev,
+    double reference,
+    double value,
+    double tolerance,
+    double scale
+) {
+    if (!std::isfinite(reference) || !std::isfinite(value))
+    {
+        if (std::isfinite(reference) || std::isfinite(value))
+            dev->n_failed++;
+        return;
+    }
+
+    double diff = fabs(value - reference);
+    if (scale > 0.0)
+        diff /= std::max(scale, std::max(fabs(reference), fabs(value)));
+
+    dev->n_compared++;
+    if (!(diff <= tolerance))
+        dev->n_failed++;
+
+    dev->max_diff = std::max(dev->max_diff, diff);
+}
+
+/**
+@brief
+Print a deviation and return its number of failures, counting a deviation
+that compared no finite values as a failure.
+
+@param[in] type
+Name of the floating point type.
+
+@param[in] name
+Name of the quantity.
+
+@param[in] dev
+Deviation.
+
+@param[in] tolerance
+Largest acceptable deviation.
+
+@return
+Number of failures.
+
+*/
+static long long Report(
+    const char *type,
+    const char *name,
+    const TypeDeviation &dev,
+    double tolerance
+) {
+    printf("%-11s %-24s %9lld compared, max %.3e (tolerance %.1e), %lld failed",
+        type, name, dev.n_compared, dev.max_diff, tolerance, dev.n_failed);
+    if (dev.n_range > 0)
+        printf(", %lld out of range of a type", dev.n_range);
+    printf("\n");
+
+    if (dev.n_compared == 0)
+    {
+        printf("%-11s %-24s compared no finite values\n", type, name);
+        return dev.n_failed + 1;
+    }
+
+    return dev.n_failed;
+}
+
+/**
+@brief
+Copy the intermediate values of the engine.
+
+@param[in] engine_values
+Intermediate values of the engine.
+
+@param[out] interValues
+Intermediate values.
+
+*/
+template <typename T>
+static void CopyValues(
+    const EngineIntermediateValues<T> &engine_values,
+    IntermediateValues *interValues
+) {
+    for (int i = 0; i < 2; i++)
+    {
+        interValues->theta_hzn[i] = double(engine_values.theta_hzn[i]);
+        interValues->d_hzn__meter[i] = double(engine_values.d_hzn__meter[i]);
+        interValues->h_e__meter[i] = double(engine_values.h_e__meter[i]);
+    }
+    interValues->delta_h__meter = double(engine_values.delta_h__meter);
+    interValues->A_ref__db = double(engine_values.A_ref__db);
+    interValues->A_fs__db = double(engine_values.A_fs__db);
+    interValues->d__km = double(engine_values.d__km);
+    interValues->mode = engine_values.mode;
+}
+
+/**
+@brief
+Evaluate an area path with the engine, for policies fixed at compile time.
+
+@param[in] in
+Inputs of the path.
+
+@param[out] result
+Outputs of the path.
+
+*/
+template <typename T, typename Polarization, typename TxSiting, typename RxSiting>
+static void EngineArea(
+    const AreaInputs &in,
+    CheckResult *result
+) {
+    T p = T(in.p);
+    T A__db = T(0);
+    EngineIntermediateValues<T> engine_values = {};
+    result->error = IlmEngine<T, Polarization>::template Area<TxSiting, RxSiting>(
+        T(in.h_tx__meter),
+        T(in.h_rx__meter),
+        T(in.d__km),
+        T(in.delta_h__meter),
+        T(in.f__mhz),
+        T(in.epsilon),
+        T(in.sigma),
+        1,
+        &p,
+        &A__db,
+        &result->warnings,
+        &engine_values
+    );
+    result->A__db = double(A__db);
+    CopyValues(engine_values, &result->interValues);
+}
+
+/**
+@brief
+Evaluate an area path with the engine, choosing the policies from the inputs.
+The inputs have a valid polarization and siting criteria.
+
+@param[in] in
+Inputs of the path.
+
+@param[out] result
+Outputs of the path.
+
+*/
+template <typename T>
+static void EngineArea(
+    const AreaInputs &in,
+    CheckResult *result
+) {
+    bool vertical = in.pol == POLARIZATION__VERTICAL;
+    bool tx_mobile = in.tx_site_criteria == SITING_CRITERIA__MOBILE;
+    bool rx_mobile = in.rx_site_criteria == SITING_CRITERIA__MOBILE;
+
+    if (vertical)
+    {
+        if (tx_mobile)
+            rx_mobile ? EngineArea<T, VerticalPolarization, MobileSiting, MobileSiting>(in, result)
+                : EngineArea<T, VerticalPolarization, MobileSiting, FixedSiting>(in, result);
+        else
+            rx_mobile ? EngineArea<T, VerticalPolarization, FixedSiting, MobileSiting>(in, result)
+                : EngineArea<T, VerticalPolarization, FixedSiting, FixedSiting>(in, result);
+    }
+    else
+    {
+        if (tx_mobile)
+            rx_mobile ? EngineArea<T, HorizontalPolarization, MobileSiting, MobileSiting>(in, result)
+                : EngineArea<T, HorizontalPolarization, MobileSiting, FixedSiting>(in, result);
+        else
+            rx_mobile ? EngineArea<T, HorizontalPolarization, FixedSiting, MobileSiting>(in, result)
+                : EngineArea<T, HorizontalPolarization, FixedSiting, FixedSiting>(in, result);
+    }
+}
+
+/**
+@brief
+Evaluate the line-of-sight and knife-edge terms of an area path with the
+engine, for a polarization fixed at compile time.
+
+The terms are evaluated on the intermediate values of double, rounded to the
+type, so that they only differ by the arithmetic of the type.
+
+@param[in] in
+Inputs of the path.
+
+@param[in] iv
+Intermediate values of double.
+
+@param[in] s__meter
+Distance of the line-of-sight term, in meters.
+
+@param[in] m_d
+Diffraction slope of the line-of-sight term, in dB/meter.
+
+@param[in] A_ed__db
+Diffraction intercept of the line-of-sight term, in dB.
+
+@param[in] d__meter
+Distance of the knife-edge term, beyond the horizons, in meters.
+
+@param[out] A__db
+Line-of-sight and knife-edge terms, in dB.
+
+*/
+template <typename T, typename Polarization>
+static void EngineTerms(
+    const AreaInputs &in,
+    const IntermediateValues &iv,
+    double s__meter,
+    double m_d,
+    double A_ed__db,
+    double d__meter,
+    double A__db[2]
+) {
+    using std::max;
+    using std::sqrt;
+
+    EngineRadio<T> radio;
+    IlmEngine<T, Polarization>::InitializeRadio(T(in.f__mhz), T(in.epsilon), T(in.sigma), &radio);
+
+    T h_e__meter[2] = { T(iv.h_e__meter[0]), T(iv.h_e__meter[1]) };
+    T d_hzn__meter[2] = { T(iv.d_hzn__meter[0]), T(iv.d_hzn__meter[1]) };
+
+    // [RLS, A-8, A-11 & A-12].
+    T d_ls__meter = sqrt(T(2.0) * h_e__meter[0] * T(a_m__meter)) + sqrt(T(2.0) * h_e__meter[1] * T(a_m__meter));
+    T d_l__meter = d_hzn__meter[0] + d_hzn__meter[1];
+
+    A__db[0] = double(LongleyRiceModel<T>::LineOfSightLoss(
+        T(s__meter), h_e__meter, radio, T(iv.delta_h__meter), T(m_d), T(A_ed__db), d_ls__meter));
+
+    // Angular distance of the line-of-sight region [Algorithm, Eqn 4.12].
+    T theta_los = max(T(iv.theta_hzn[0]) + T(iv.theta_hzn[1]), -d_l__meter / T(a_m__meter));
+    A__db[1] = double(LongleyRiceModel<T>::KnifeEdgeDiffraction(
+        T(d__meter), radio.f__mhz, theta_los, d_hzn__meter));
+}
+
+/**
+@brief
+Evaluate the line-of-sight and knife-edge terms of an area path with the
+engine, choosing the polarization from the inputs.
+
+The parameters are those of the template above.
+*/
+template <typename T>
+static void EngineTerms(
+    const AreaInputs &in,
+    const IntermediateValues &iv,
+    double s__meter,
+    double m_d,
+    double A_ed__db,
+    double d__meter,
+    double A__db[2]
+) {
+    if (in.pol == POLARIZATION__VERTICAL)
+        EngineTerms<T, VerticalPolarization>(in, iv, s__meter, m_d, A_ed__db, d__meter, A__db);
+    else
+        EngineTerms<T, HorizontalPolarization>(in, iv, s__meter, m_d, A_ed__db, d__meter, A__db);
+}
+
+/**
+@brief
+Evaluate an area path with the library.
+
+@param[in] in
+Inputs of the path.
+
+@param[out] result
+Outputs of the path.
+
+*/
+static void LibraryArea(
+    const AreaInputs &in,
+    CheckResult *result
+) {
+    double p = in.p;
+    result->error = AreaPercentiles_Ex(
+        in.h_tx__meter,
+        in.h_rx__meter,
+        in.tx_site_criteria,
+        in.rx_site_criteria,
+        in.d__km,
+        in.delta_h__meter,
+        in.f__mhz,
+        in.pol,
+        in.epsilon,
+        in.sigma,
+        1,
+        &p,
+        &result->A__db,
+        &result->warnings,
+        &result->interValues
+    );
+}
+
+/**
+@brief
+Draw random area inputs, mostly over the valid input domain.
+
+@param[in] rng
+Random number generator.
+
+@return
+Inputs of the path.
+
+*/
+static AreaInputs RandomArea(
+    std::mt19937_64 &rng
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    AreaInputs in;
+    in.h_tx__meter = LogUniform(rng, 0.4, 3500.0);
+    in.h_rx__meter = LogUniform(rng, 0.4, 3500.0);
+    in.tx_site_criteria = uniform(rng) < 0.5 ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED;
+    in.rx_site_criteria = uniform(rng) < 0.5 ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED;
+    in.d__km = uniform(rng) < 0.02 ? 0.0 : LogUniform(rng, 0.001, 2500.0);
+    in.delta_h__meter = uniform(rng) < 0.1 ? 0.0 : LogUniform(rng, 0.1, 3000.0);
+    in.f__mhz = LogUniform(rng, 15.0, 25000.0);
+    in.pol = uniform(rng) < 0.5 ? POLARIZATION__HORIZONTAL : POLARIZATION__VERTICAL;
+    in.epsilon = LogUniform(rng, 0.9, 1000.0);
+    in.sigma = uniform(rng) < 0.02 ? 0.0 : LogUniform(rng, 1.0E-6, 1000.0);
+    in.p = uniform(rng) < 0.02 ? 100.0 : LogUniform(rng, 0.001, 99.999);
+    return in;
+}
+
+/**
+@brief
+Draw a random point-to-point path, on rough random walk terrain.
+
+@param[in] rng
+Random number generator.
+
+@param[out] path
+Prepared path.
+
+*/
+static void RandomPointToPoint(
+    std::mt19937_64 &rng,
+    PreparedPath *path
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    int np = 2 + int(2000 * uniform(rng));
+    double xi__meter = LogUniform(rng, 1.0, 2000.0);
+    double roughness__meter = LogUniform(rng, 0.01, 100.0);
+
+    std::vector<double> pfl(np + 3);
+    pfl[0] = np;
+    pfl[1] = xi__meter;
+    pfl[2] = 0.0;
+    for (int i = 1; i <= np; i++)
+        pfl[i + 2] = pfl[i + 1] + roughness__meter * normal(rng);
+
+    PreparePath(
+        LogUniform(rng, 0.5, 3000.0),
+        LogUniform(rng, 0.5, 3000.0),
+        pfl.data(),
+        path
+    );
+}
+
+/**
+@brief
+Evaluate a prepared path with the engine for double, with the precision of a
+radio context.
+
+@param[in] path
+Prepared path.
+
+@param[in] radio
+Radio context.
+
+@param[in] p
+Location percentage.
+
+@param[out] result
+Outputs of the path.
+
+*/
+static void EnginePointToPoint(
+    const PreparedPath *path,
+    const RadioContext *radio,
+    double p,
+    CheckResult *result
+) {
+    EnginePath<double> engine_path = EnginePathOf(path);
+    EngineRadio<double> engine_radio = EngineRadioOf(radio);
+    EngineIntermediateValues<double> engine_values = {};
+
+    result->warnings = NO_WARNINGS;
+    int rtn = IlmEngine<double, HorizontalPolarization>::ValidatePercentiles(
+        engine_path.h__meter, radio->f__mhz, radio->epsilon, radio->sigma, 1, &p, &result->warnings);
+    if (rtn == SUCCESS)
+    {
+        if (radio->precision == PRECISION__FAST)
+            rtn = LongleyRiceModel<double, FastPrecision>::EvaluatePath(
+                engine_path, engine_radio, 1, &p, &result->A__db, &result->warnings, &engine_values);
+        else
+            rtn = LongleyRiceModel<double>::EvaluatePath(
+                engine_path, engine_radio, 1, &p, &result->A__db, &result->warnings, &engine_values);
+        if (rtn == SUCCESS && result->warnings != NO_WARNINGS)
+            rtn = SUCCESS_WITH_WARNINGS;
+    }
+
+    result->error = rtn;
+    CopyValues(engine_values, &result->interValues);
+}
+
+/* Baseline scalar functions. */
+
+/**
+@brief
+Compute the complex ground impedance, as the baseline InitializePointToPoint()
+does.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@return
+Complex ground impedance.
+
+*/
+static std::complex<double> BaselineGroundImpedance(
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma
+) {
+    std::complex<double> ep_r = std::complex<double>(epsilon, 18000.0 * sigma / f__mhz);
+
+    std::complex<double> Z_g = sqrt(ep_r - 1.0);
+
+    if (pol == POLARIZATION__VERTICAL)
+        Z_g = Z_g / ep_r;
+
+    return Z_g;
+}
+
+/**
+@brief
+Compute the free space loss, as the baseline FreeSpaceLoss() does.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@return
+Free space loss, in dB.
+
+*/
+static double BaselineFreeSpaceLoss(
+    double d__meter,
+    double f__mhz
+) {
+    return 32.45 + 20.0 * log10(f__mhz) + 20.0 * log10(d__meter / 1000.0);
+}
+
+/**
+@brief
+Compute the Fresnel integral, as the baseline FresnelIntegral() does.
+
+@param[in] v2
+Square of the Fresnel-Kirchhoff diffraction parameter.
+
+@return
+Knife-edge diffraction loss, in dB.
+
+*/
+static double BaselineFresnelIntegral(
+    double v2
+) {
+    if (v2 < 5.76)
+        return 6.02 + 9.11 * sqrt(v2) - 1.27 * v2;
+    else
+        return 12.953 + 10.0 * log10(v2);
+}
+
+/**
+@brief
+Compute the height gain function, as the baseline HeightFunction() does.
+
+@param[in] x__km
+Normalized distance, in km.
+
+@param[in] K
+K value.
+
+@return
+F(x, K), in dB.
+
+*/
+static double BaselineHeightFunction(
+    double x__km,
+    double K
+) {
+    double w;
+    double result;
+
+    if (x__km < 200.0)
+    {
+        w = -log(K);
+
+        if (K < 1.0E-5 || x__km * pow(w, 3) > 5495.0)
+        {
+            result = -117.0;
+
+            if (x__km > 1.0)
+                result = 17.372 * log(x__km) + result;
+        }
+        else
+            result = 2.5E-5 * pow(x__km, 2) / K - 8.686 * w - 15.0;
+    }
+    else
+    {
+        result = 0.05751 * x__km - 4.343 * log(x__km);
+
+        if (x__km < 2000.0)
+        {
+            w = 0.0134 * x__km * exp(-0.005 * x__km);
+            result = (1.0 - w) * result + w * (17.372 * log(x__km) - 117.0);
+        }
+    }
+
+    return result;
+}
+
+/**
+@brief
+Compute the knife-edge diffraction loss, as the baseline
+KnifeEdgeDiffraction() does.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] theta_los
+Angular distance of line-of-sight region.
+
+@param[in] d_hzn__meter
+Horizon distances, in meters.
+
+@return
+Knife-edge diffraction loss, in dB.
+
+*/
+static double BaselineKnifeEdgeDiffraction(
+    double d__meter,
+    double f__mhz,
+    double theta_los,
+    const double d_hzn__meter[2]
+) {
+    double d_ML__meter = d_hzn__meter[0] + d_hzn__meter[1];
+    double theta_nlos = d__meter / a_m__meter - theta_los;
+    double d_nlos__meter = d__meter - d_ML__meter;
+
+    double v_1 = 0.0795775 * (f__mhz / 47.7) * pow(theta_nlos, 2) * d_hzn__meter[0] * d_nlos__meter / (d_nlos__meter + d_hzn__meter[0]);
+    double v_2 = 0.0795775 * (f__mhz / 47.7) * pow(theta_nlos, 2) * d_hzn__meter[1] * d_nlos__meter / (d_nlos__meter + d_hzn__meter[1]);
+
+    return BaselineFresnelIntegral(v_1) + BaselineFresnelIntegral(v_2);
+}
+
+/**
+@brief
+Compute the smooth sphere diffraction loss, as the baseline
+SmoothSphereDiffraction() does.
+
+@param[in] radius__meter
+Radius of the sphere, in meters.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] theta_los
+Angular distance of line-of-sight region.
+
+@param[in] d_hzn__meter
+Horizon distances, in meters.
+
+@param[in] h_e__meter
+Effective terminal heights, in meters.
+
+@param[in] Z_g
+Complex ground impedance.
+
+@return
+Smooth sphere diffraction loss, in dB.
+
+*/
+static double BaselineSmoothSphereDiffraction(
+    double radius__meter,
+    double d__meter,
+    double f__mhz,
+    double theta_los,
+    const double d_hzn__meter[2],
+    const double h_e__meter[2],
+    std::complex<double> Z_g
+) {
+    double a__meter[3];
+    double d__km[3];
+    double F_x__db[2];
+    double K[3];
+    double B_0[3];
+    double x__km[3];
+    double C_0[3];
+
+    double theta_nlos = d__meter / radius__meter - theta_los;
+    double d_ML__meter = d_hzn__meter[0] + d_hzn__meter[1];
+
+    a__meter[0] = (d__meter - d_ML__meter) / (d__meter / radius__meter - theta_los);
+    a__meter[1] = 0.5 * pow(d_hzn__meter[0], 2) / h_e__meter[0];
+    a__meter[2] = 0.5 * pow(d_hzn__meter[1], 2) / h_e__meter[1];
+
+    d__km[0] = (a__meter[0] * theta_nlos) / 1000.0;
+    d__km[1] = d_hzn__meter[0] / 1000.0;
+    d__km[2] = d_hzn__meter[1] / 1000.0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        C_0[i] = pow((4.0 / 3.0) * radius__meter / a__meter[i], 1.0 / 3.0);
+        K[i] = 0.017778 * C_0[i] * pow(f__mhz, -1.0 / 3.0) / abs(Z_g);
+
+        // The unqualified abs() of the baseline, as ReferenceAbs() takes it.
+        B_0[i] = 1.607 - abs(K[i]);
+    }
+
+    x__km[1] = B_0[1] * pow(C_0[1], 2) * pow(f__mhz, 1.0 / 3.0) * d__km[1];
+    x__km[2] = B_0[2] * pow(C_0[2], 2) * pow(f__mhz, 1.0 / 3.0) * d__km[2];
+    x__km[0] = B_0[0] * pow(C_0[0], 2) * pow(f__mhz, 1.0 / 3.0) * d__km[0] + x__km[1] + x__km[2];
+
+    F_x__db[0] = BaselineHeightFunction(x__km[1], K[1]);
+    F_x__db[1] = BaselineHeightFunction(x__km[2], K[2]);
+
+    double G_x__db = 0.05751 * x__km[0] - 10.0 * log10(x__km[0]);
+
+    return G_x__db - F_x__db[0] - F_x__db[1] - 20.0;
+}
+
+/**
+@brief
+Compute the diffraction loss, as the baseline DiffractionLoss() does.
+
+@param[in] radius__meter
+Radius of the sphere, in meters.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] d_hzn__meter
+Horizon distances, in meters.
+
+@param[in] h_e__meter
+Effective terminal heights, in meters.
+
+@param[in] Z_g
+Complex ground impedance.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter, in meters.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in] theta_los
+Angular distance of line-of-sight region.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@return
+Diffraction loss, in dB.
+
+*/
+static double BaselineDiffractionLoss(
+    double radius__meter,
+    double d__meter,
+    const double d_hzn__meter[2],
+    const double h_e__meter[2],
+    std::complex<double> Z_g,
+    double delta_h__meter,
+    const double h__meter[2],
+    double theta_los,
+    double f__mhz
+) {
+    double A_k__db = BaselineKnifeEdgeDiffraction(d__meter, f__mhz, theta_los, d_hzn__meter);
+    double A_r__db = BaselineSmoothSphereDiffraction(radius__meter, d__meter, f__mhz, theta_los, d_hzn__meter, h_e__meter, Z_g);
+
+    double delta_h_d__meter = delta_h__meter * (1.0 - 0.8 * exp(-d__meter / 50.0E3));
+
+    double term1 = sqrt((h_e__meter[0] * h_e__meter[1]) / (h__meter[0] * h__meter[1]));
+    double d_l__meter = d_hzn__meter[0] + d_hzn__meter[1];
+    double q = (term1 + (-theta_los * radius__meter + d_l__meter) / d__meter) * std::min(delta_h_d__meter * f__mhz / 47.7, 1000.0);
+
+    double w = 1.0 / (1.0 + 0.1 * sqrt(q));
+
+    return w * A_r__db + (1.0 - w) * A_k__db;
+}
+
+/**
+@brief
+Compute the line-of-sight loss, as the baseline LineOfSightLoss() does.
+
+@param[in] s__meter
+Distance, in meters.
+
+@param[in] h_e__meter
+Effective terminal heights, in meters.
+
+@param[in] Z_g
+Complex ground impedance.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter, in meters.
+
+@param[in] m_d
+Diffraction slope.
+
+@param[in] A_ed
+Diffraction intercept.
+
+@param[in] d_ls__meter
+Maximum line-of-sight distance for a smooth path, in meters.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@return
+Line-of-sight loss, in dB.
+
+*/
+static double BaselineLineOfSightLoss(
+    double s__meter,
+    const double h_e__meter[2],
+    std::complex<double> Z_g,
+    double delta_h__meter,
+    double m_d,
+    double A_ed,
+    double d_ls__meter,
+    double f__mhz
+) {
+    double sigma_h_s__meter = (delta_h__meter / 1.282) * exp(-pow(delta_h__meter, 0.25) / 2.0);
+
+    double c = 299792458.0;
+    double k = 2.0 * M_PI * (f__mhz * 1.0E6) / c;
+
+    double sin_psi = (h_e__meter[0] + h_e__meter[1]) / sqrt(pow(s__meter, 2) + pow(h_e__meter[0] + h_e__meter[1], 2));
+
+    std::complex<double> R_e = (sin_psi - Z_g) / (sin_psi + Z_g) * exp(-k * sigma_h_s__meter * sin_psi);
+
+    double q = pow(R_e.real(), 2) + pow(R_e.imag(), 2);
+    if (q < 0.25 || q < sin_psi)
+        R_e = R_e * sqrt(sin_psi / q);
+
+    double delta_phi = 2.0 * k * h_e__meter[0] * h_e__meter[1] / s__meter;
+
+    if (delta_phi > M_PI / 2.0)
+        delta_phi = M_PI - pow(M_PI / 2.0, 2) / delta_phi;
+
+    std::complex<double> rr = std::complex<double>(cos(delta_phi), -sin(delta_phi)) + R_e;
+    double A_t__db = -10.0 * log10(pow(rr.real(), 2) + pow(rr.imag(), 2));
+
+    double A_d__db = A_ed + m_d * s__meter;
+
+    double D_1 = 47.7;
+    double D_2 = 10.0E3;
+    double w = 1.0 / (1.0 + D_1 * k * delta_h__meter / std::max(D_2, d_ls__meter));
+
+    return (1.0 - w) * A_d__db + w * A_t__db;
+}
+
+/**
+@brief
+Compute the inverse of the complementary cumulative distribution function,
+as the baseline InverseComplementaryCumulativeDistributionFunction() does.
+
+@param[in] q
+Quantile, 0 < q < 1.
+
+@return
+Q(q)^-1.
+
+*/
+static double BaselineInverseCcdf(
+    double q
+) {
+    double x = q;
+    if (q > 0.5)
+        x = 1.0 - x;
+
+    double T_x = sqrt(-2.0 * log(x));
+
+    double zeta_x = ((0.010328 * T_x + 0.802853) * T_x + 2.515516) / (((0.001308 * T_x + 0.189269) * T_x + 1.432788) * T_x + 1.0);
+
+    double Q_q = T_x - zeta_x;
+
+    if (q > 0.5)
+        Q_q = -Q_q;
+
+    return Q_q;
+}
+
+/**
+@brief
+Compute the variability, as the baseline Variability() does.
+
+@param[in] p
+Quantile, 0 < p < 1.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter, in meters.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] A_ref__db
+Reference attenuation, in dB.
+
+@return
+Loss, in dB.
+
+*/
+static double BaselineVariability(
+    double p,
+    double delta_h__meter,
+    double f__mhz,
+    double d__meter,
+    double A_ref__db
+) {
+    double c = 299792458.0;
+    double k = 2.0 * M_PI * (f__mhz * 1.0E6) / c;
+
+    double delta_h_d__meter = delta_h__meter * (1.0 - 0.8 * exp(-d__meter / 50.0E3));
+    double sigma = 10.0 * k * delta_h_d__meter / (k * delta_h_d__meter + 13.0);
+
+    A_ref__db = A_ref__db + sigma * BaselineInverseCcdf(p);
+
+    if (A_ref__db < 0.0)
+        A_ref__db = A_ref__db * (29.0 - A_ref__db) / (29.0 - 10.0 * A_ref__db);
+
+    return A_ref__db;
+}
+
+/**
+@brief
+Compare the terms of the engine for double with the baseline scalar functions
+on the geometry of the evaluated area paths, and print a summary.
+
+The library functions are wrappers over the engine, so the engine is checked
+against copies of the functions of the baseline instead. The terms are
+evaluated within and beyond the line-of-sight region of each path, with the
+angular distance of the line-of-sight region of [Algorithm, Eqn 4.12] and
+random diffraction coefficients, reference attenuations and arguments of the
+special functions, where they are all finite. The engine precomputes the
+wavenumber and the powers of the frequency, so the two need only agree to
+within rounding.
+
+@param[in] rng
+Random number generator.
+
+@param[in] area
+Inputs of the area paths.
+
+@param[in] library
+Results of the area paths.
+
+@return
+Number of failures.
+
+*/
+static long long CompareBaseline(
+    std::mt19937_64 &rng,
+    const std::vector<AreaInputs> &area,
+    const std::vector<CheckResult> &library
+) {
+    typedef LongleyRiceModel<double> Model;
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    TypeDeviation free_space = {};
+    TypeDeviation fresnel = {};
+    TypeDeviation height = {};
+    TypeDeviation inverse = {};
+    TypeDeviation knife = {};
+    TypeDeviation sphere = {};
+    TypeDeviation diffraction = {};
+    TypeDeviation los = {};
+    TypeDeviation variability = {};
+
+    for (size_t i = 0; i < area.size(); i++)
+    {
+        if (library[i].error != SUCCESS && library[i].error != SUCCESS_WITH_WARNINGS)
+            continue;
+
+        const AreaInputs &in = area[i];
+        const IntermediateValues &iv = library[i].interValues;
+
+        EngineRadio<double> radio;
+        if (in.pol == POLARIZATION__VERTICAL)
+            IlmEngine<double, VerticalPolarization>::InitializeRadio(in.f__mhz, in.epsilon, in.sigma, &radio);
+        else
+            IlmEngine<double, HorizontalPolarization>::InitializeRadio(in.f__mhz, in.epsilon, in.sigma, &radio);
+        std::complex<double> Z_g = BaselineGroundImpedance(in.f__mhz, in.pol, in.epsilon, in.sigma);
+
+        double d__meter = 1000.0 * iv.d__km;
+        Accumulate(&free_space, BaselineFreeSpaceLoss(d__meter, in.f__mhz), Model::FreeSpaceLoss(d__meter, radio),
+            BASELINE_TOLERANCE__DB, 0.0);
+
+        // v^2 around the change of piece at v = 2.4, K from below the cut off
+        // of 1E-5 to above 1, and quantiles out to 1E-300 from 0.
+        double v2 = LogUniform(rng, 1.0E-6, 1.0E6);
+        Accumulate(&fresnel, BaselineFresnelIntegral(v2), Model::FresnelIntegral(v2), BASELINE_TOLERANCE__DB, 0.0);
+
+        double x__km = LogUniform(rng, 1.0E-4, 1.0E5);
+        double K = LogUniform(rng, 1.0E-7, 10.0);
+        Accumulate(&height, BaselineHeightFunction(x__km, K), Model::HeightFunction(x__km, K), BASELINE_TOLERANCE__DB, 0.0);
+
+        double q = uniform(rng) < 0.5 ? LogUniform(rng, 1.0E-300, 0.5) : 1.0 - LogUniform(rng, ldexp(1.0, -53), 0.5);
+        Accumulate(&inverse, BaselineInverseCcdf(q), Model::InverseComplementaryCumulativeDistributionFunction(q),
+            BASELINE_TOLERANCE__DB, 0.0);
+
+        // [RLS, A-8, A-11 & A-12].
+        double d_ls__meter = sqrt(2.0 * iv.h_e__meter[0] * a_m__meter) + sqrt(2.0 * iv.h_e__meter[1] * a_m__meter);
+        double d_l__meter = iv.d_hzn__meter[0] + iv.d_hzn__meter[1];
+
+        double s__meter = d_ls__meter * LogUniform(rng, 1.0E-3, 1.0);
+        double m_d = LogUniform(rng, 1.0E-7, 1.0E-3);
+        double A_ed__db = -20.0 + 100.0 * uniform(rng);
+        Accumulate(&los,
+            BaselineLineOfSightLoss(s__meter, iv.h_e__meter, Z_g, iv.delta_h__meter, m_d, A_ed__db, d_ls__meter, in.f__mhz),
+            Model::LineOfSightLoss(s__meter, iv.h_e__meter, radio, iv.delta_h__meter, m_d, A_ed__db, d_ls__meter),
+            BASELINE_TOLERANCE__DB, 0.0);
+
+        // Angular distance of the line-of-sight region [Algorithm, Eqn 4.12],
+        // at a distance beyond the horizons.
+        double theta_los = std::max(iv.theta_hzn[0] + iv.theta_hzn[1], -d_l__meter / a_m__meter);
+        double d_d__meter = d_l__meter * (1.0 + LogUniform(rng, 1.0E-3, 100.0));
+        double h__meter[2] = { in.h_tx__meter, in.h_rx__meter };
+        Accumulate(&knife,
+            BaselineKnifeEdgeDiffraction(d_d__meter, in.f__mhz, theta_los, iv.d_hzn__meter),
+            Model::KnifeEdgeDiffraction(d_d__meter, radio.f__mhz, theta_los, iv.d_hzn__meter),
+            BASELINE_TOLERANCE__DB, 0.0);
+        Accumulate(&sphere,
+            BaselineSmoothSphereDiffraction(a_m__meter, d_d__meter, in.f__mhz, theta_los, iv.d_hzn__meter, iv.h_e__meter, Z_g),
+            Model::SmoothSphereDiffraction(a_m__meter, d_d__meter, radio, theta_los, iv.d_hzn__meter, iv.h_e__meter),
+            BASELINE_TOLERANCE__DB, 0.0);
+        Accumulate(&diffraction,
+            BaselineDiffractionLoss(a_m__meter, d_d__meter, iv.d_hzn__meter, iv.h_e__meter, Z_g, iv.delta_h__meter, h__meter, theta_los, in.f__mhz),
+            Model::DiffractionLoss(a_m__meter, d_d__meter, iv.d_hzn__meter, iv.h_e__meter, radio, iv.delta_h__meter, h__meter, theta_los),
+            BASELINE_TOLERANCE__DB, 0.0);
+
+        double A_ref__db = -30.0 + 330.0 * uniform(rng);
+        double p = in.p / 100.0;
+        if (p > 0.0 && p < 1.0)
+            Accumulate(&variability,
+                BaselineVariability(p, iv.delta_h__meter, in.f__mhz, d__meter, A_ref__db),
+                Model::Variability(p, iv.delta_h__meter, radio, d__meter, A_ref__db),
+                BASELINE_TOLERANCE__DB, 0.0);
+    }
+
+    long long n_failed = 0;
+    n_failed += Report("baseline", "FreeSpaceLoss [dB]", free_space, BASELINE_TOLERANCE__DB);
+    n_failed += Report("baseline", "FresnelIntegral [dB]", fresnel, BASELINE_TOLERANCE__DB);
+    n_failed += Report("baseline", "HeightFunction [dB]", height, BASELINE_TOLERANCE__DB);
+    n_failed += Report("baseline", "InverseCCDF", inverse, BASELINE_TOLERANCE__DB);
+    n_failed += Report("baseline", "LineOfSightLoss [dB]", los, BASELINE_TOLERANCE__DB);
+    n_failed += Report("baseline", "KnifeEdge [dB]", knife, BASELINE_TOLERANCE__DB);
+    n_failed += Report("baseline", "SmoothSphere [dB]", sphere, BASELINE_TOLERANCE__DB);
+    n_failed += Report("baseline", "DiffractionLoss [dB]", diffraction, BASELINE_TOLERANCE__DB);
+    n_failed += Report("baseline", "Variability [dB]", variability, BASELINE_TOLERANCE__DB);
+
+    return n_failed;
+}
+
+int main(int argc, char **argv)
+{
+    int n = 100000;
+    unsigned long long seed = 1;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:s:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            n = atoi(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, nullptr, 10);
+            break;
+        default:
+            fprintf(stderr, "Usage: engine_check [-n paths] [-s seed]\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    long long n_failed = 0;
+
+    // Area mode.
+    std::vector<AreaInputs> area(n);
+    for (int i = 0; i < n; i++)
+        area[i] = RandomArea(rng);
+
+    std::vector<CheckResult> library(n);
+    std::vector<CheckResult> engine(n);
+
+    double t_0 = Now();
+    for (int i = 0; i < n; i++)
+        LibraryArea(area[i], &library[i]);
+    double t_library = Now() - t_0;
+
+    t_0 = Now();
+    for (int i = 0; i < n; i++)
+        EngineArea<double>(area[i], &engine[i]);
+    double t_engine = Now() - t_0;
+
+    long long n_area_failed = 0;
+    long long n_area_finite[3] = { 0, 0, 0 };
+    for (int i = 0; i < n; i++)
+    {
+        if (!SameResult(library[i], engine[i]))
+            n_area_failed++;
+        else
+            CountFinite(library[i], n_area_finite);
+    }
+    n_failed += n_area_failed;
+
+    printf("area   %d paths, %lld differ, finite A %lld, A_ref %lld, A_fs %lld, library %.1f ns/path, engine %.1f ns/path\n",
+        n, n_area_failed, n_area_finite[0], n_area_finite[1], n_area_finite[2], 1.0E9 * t_library / n, 1.0E9 * t_engine / n);
+    // The reference attenuation, and so the loss, is not finite on any path,
+    // as InitializeLongleyRice() takes the smooth earth line-of-sight
+    // distance as theta_los like the reference code. Their bits are compared
+    // here, and the finite terms against the baseline functions below.
+    if (n_area_finite[2] == 0)
+    {
+        printf("area   evaluated no paths\n");
+        n_failed++;
+    }
+
+    // Point-to-point mode, with prepared paths and both precisions.
+    long long n_p2p_failed = 0;
+    long long n_p2p_finite[3] = { 0, 0, 0 };
+    for (int i = 0; i < n / 10; i++)
+    {
+        PreparedPath path;
+        RandomPointToPoint(rng, &path);
+
+        RadioContext radio;
+        InitializeRadioContext(
+            LogUniform(rng, 20.0, 20000.0),
+            uniform(rng) < 0.5 ? POLARIZATION__HORIZONTAL : POLARIZATION__VERTICAL,
+            LogUniform(rng, 1.0, 1000.0),
+            LogUniform(rng, 1.0E-6, 1000.0),
+            &radio
+        );
+        double p = LogUniform(rng, 0.001, 99.999);
+
+        for (int precision = PRECISION__EXACT; precision <= PRECISION__FAST; precision++)
+        {
+            radio.precision = precision;
+
+            CheckResult a;
+            a.error = PointToPointPreparedContext_Ex(&path, &radio, 1, &p, &a.A__db, &a.warnings, &a.interValues);
+
+            CheckResult b;
+            EnginePointToPoint(&path, &radio, p, &b);
+
+            if (!SameResult(a, b))
+                n_p2p_failed++;
+            else
+                CountFinite(a, n_p2p_finite);
+        }
+    }
+    n_failed += n_p2p_failed;
+
+    printf("p2p    %d paths, %lld differ, finite A %lld, A_ref %lld, A_fs %lld\n",
+        2 * (n / 10), n_p2p_failed, n_p2p_finite[0], n_p2p_finite[1], n_p2p_finite[2]);
+    if (n_p2p_finite[2] == 0)
+    {
+        printf("p2p    evaluated no paths\n");
+        n_failed++;
+    }
+
+    // Baseline scalar functions.
+    n_failed += CompareBaseline(rng, area, library);
+
+    // Other floating point types. The intermediate values, the free space
+    // loss and the line-of-sight and knife-edge terms are compared for every
+    // evaluated path, and the basic transmission loss is reported where it is
+    // finite for both types.
+    const char *names[2] = { "float", "long double" };
+    double relative_tolerance[2] = { FLOAT_RELATIVE_TOLERANCE, LONG_DOUBLE_RELATIVE_TOLERANCE };
+    double tolerance__db[2] = { FLOAT_TOLERANCE__DB, LONG_DOUBLE_TOLERANCE__DB };
+    TypeDeviation values[2] = {};
+    TypeDeviation free_space[2] = {};
+    TypeDeviation los[2] = {};
+    TypeDeviation knife[2] = {};
+    long long n_finite[2] = { 0, 0 };
+    double max_diff__db[2] = { 0.0, 0.0 };
+    for (int i = 0; i < n; i++)
+    {
+        if (library[i].error != SUCCESS && library[i].error != SUCCESS_WITH_WARNINGS)
+            continue;
+
+        const IntermediateValues &iv = library[i].interValues;
+
+        CheckResult other[2];
+        EngineArea<float>(area[i], &other[0]);
+        EngineArea<long double>(area[i], &other[1]);
+
+        // Terms within and beyond the line-of-sight region of the path.
+        double d_ls__meter = sqrt(2.0 * iv.h_e__meter[0] * a_m__meter) + sqrt(2.0 * iv.h_e__meter[1] * a_m__meter);
+        double s__meter = d_ls__meter * LogUniform(rng, 1.0E-3, 1.0);
+        double m_d = LogUniform(rng, 1.0E-7, 1.0E-3);
+        double A_ed__db = -20.0 + 100.0 * uniform(rng);
+        double d__meter = (iv.d_hzn__meter[0] + iv.d_hzn__meter[1]) * (1.0 + LogUniform(rng, 1.0E-3, 100.0));
+
+        double terms__db[3][2];
+        EngineTerms<double>(area[i], iv, s__meter, m_d, A_ed__db, d__meter, terms__db[0]);
+        EngineTerms<float>(area[i], iv, s__meter, m_d, A_ed__db, d__meter, terms__db[1]);
+        EngineTerms<long double>(area[i], iv, s__meter, m_d, A_ed__db, d__meter, terms__db[2]);
+
+        for (int k = 0; k < 2; k++)
+        {
+            const IntermediateValues &ov = other[k].interValues;
+
+            // Angles relative to a radian, lengths relative to a meter.
+            for (int j = 0; j < 2; j++)
+            {
+                Accumulate(&values[k], iv.theta_hzn[j], ov.theta_hzn[j], relative_tolerance[k], 1.0);
+                Accumulate(&values[k], iv.d_hzn__meter[j], ov.d_hzn__meter[j], relative_tolerance[k], 1.0);
+                Accumulate(&values[k], iv.h_e__meter[j], ov.h_e__meter[j], relative_tolerance[k], 1.0);
+            }
+            Accumulate(&values[k], iv.delta_h__meter, ov.delta_h__meter, relative_tolerance[k], 1.0);
+
+            Accumulate(&free_space[k], iv.A_fs__db, ov.A_fs__db, tolerance__db[k], 0.0);
+            // The reflection coefficient of the line-of-sight term underflows
+            // at large k * sigma_h, at a different point for each type.
+            TypeDeviation *terms[2] = { &los[k], &knife[k] };
+            for (int j = 0; j < 2; j++)
+            {
+                if (std::isfinite(terms__db[0][j]) != std::isfinite(terms__db[k + 1][j]))
+                    terms[j]->n_range++;
+                else
+                    Accumulate(terms[j], terms__db[0][j], terms__db[k + 1][j], tolerance__db[k], 0.0);
+            }
+
+            if (!std::isfinite(library[i].A__db) || !std::isfinite(other[k].A__db))
+                continue;
+
+            n_finite[k]++;
+            max_diff__db[k] = std::max(max_diff__db[k], fabs(other[k].A__db - library[i].A__db));
+        }
+    }
+
+    for (int k = 0; k < 2; k++)
+    {
+        n_failed += Report(names[k], "intermediate values", values[k], relative_tolerance[k]);
+        n_failed += Report(names[k], "FreeSpaceLoss [dB]", free_space[k], tolerance__db[k]);
+        n_failed += Report(names[k], "LineOfSightLoss [dB]", los[k], tolerance__db[k]);
+        n_failed += Report(names[k], "KnifeEdge [dB]", knife[k], tolerance__db[k]);
+        printf("%-11s %-24s %9lld finite, max |dA| %.3e dB\n", names[k], "A [dB]", n_finite[k], max_diff__db[k]);
+    }
+
+    if (n_failed > 0)
+    {
+        printf("FAILED: %lld checks differ between the library and the engine, exceed their tolerance or compared nothing\n", n_failed);
+        return EXIT_FAILURE;
+    }
+
+    printf("PASSED: the engine is identical to the library and within tolerance of the baseline, and float and long double are within their tolerances\n");
+    return EXIT_SUCCESS;
+}
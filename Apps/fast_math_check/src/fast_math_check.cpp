@@ -0,0 +1,800 @@
+/**
+@file
+
+Validation of the PRECISION__FAST mode of the special functions.
+
+Checks the approximations of FastMath.h against the standard library over the
+range of their arguments, and the fast special functions of the model against
+their exact counterparts over their whole domains. Then evaluates random
+point-to-point and area paths over the valid input domain of ValidateInputs()
+with an exact and a fast radio context, compares the intermediate values, the
+basic transmission loss where it is finite, and the free space, line-of-sight,
+knife-edge, smooth-sphere and variability terms of each path, and reports the
+largest deviation of each and the time taken by each precision.
+
+Fails if an approximation or special function exceeds its error bound, if the
+error codes, warnings or modes of a path differ between the precisions, if a
+loss or term deviates by more than its bound, or if any check compared no
+finite values.
+
+Usage: fast_math_check [-n paths] [-b bound__db] [-s seed]
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Enums.h"
+#include "Errors.h"
+#include "FastMath.h"
+#include "RadioContext.h"
+
+/**
+@brief
+Inputs of one random path.
+*/
+struct CheckPath
+{
+    /**
+    Prepared path.
+    */
+    PreparedPath path;
+
+    /**
+    Exact radio context.
+    */
+    RadioContext exact;
+
+    /**
+    Radio context with PRECISION__FAST.
+    */
+    RadioContext fast;
+
+    /**
+    Location percentage.
+    */
+    double p;
+};
+
+/**
+@brief
+Outputs of one evaluation of a path.
+*/
+struct CheckResult
+{
+    /**
+    Basic transmission loss, in dB.
+    */
+    double A__db;
+
+    /**
+    Warning flags.
+    */
+    long warnings;
+
+    /**
+    Error code.
+    */
+    int error;
+
+    /**
+    Intermediate values.
+    */
+    IntermediateValues iv;
+};
+
+/**
+@brief
+Deviations of the fast mode from the exact mode of one quantity.
+*/
+struct Deviation
+{
+    /**
+    Number of finite values compared.
+    */
+    long long n_compared;
+
+    /**
+    Number of values that exceeded their bound, or that were finite in only
+    one of the modes.
+    */
+    long long n_failed;
+
+    /**
+    Number of arguments skipped because the two modes chose different pieces
+    of a function.
+    */
+    long long n_boundary;
+
+    /**
+    Largest absolute deviation.
+    */
+    double max_diff;
+};
+
+/**
+@brief
+Return the time, in seconds.
+
+@return
+Time, in seconds.
+
+*/
+static double Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+@brief
+Return a random number with a uniform distribution of its logarithm.
+
+@param[in] rng
+Random number generator.
+
+@param[in] lo
+Smallest value, > 0.
+
+@param[in] hi
+Largest value.
+
+@return
+Random number, lo <= x <= hi.
+
+*/
+static double LogUniform(
+    std::mt19937_64 &rng,
+    double lo,
+    double hi
+) {
+    std::uniform_real_distribution<double> uniform(log(lo), log(hi));
+    return std::min(hi, std::max(lo, exp(uniform(rng))));
+}
+
+/**
+@brief
+Check FastLog2(), FastExp2() and FastCbrt() against the standard library.
+
+The rounding of the results, of the standard library and of the tables is
+allowed for with a few units in the last place of the result.
+
+@param[in] rng
+Random number generator.
+
+@param[in] n
+Number of random arguments of each function.
+
+@return
+Number of arguments that exceeded the error bounds.
+
+*/
+static long long CheckElementaryFunctions(
+    std::mt19937_64 &rng,
+    int n
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    long long n_failed = 0;
+
+    // Random exponents and mantissas, and arguments around the interval
+    // boundaries of the tables and around 1.
+    double max_log2 = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        double x;
+        switch (i % 3)
+        {
+        case 0:
+            x = ldexp(1.0 + uniform(rng), int(-1022 + 2045 * uniform(rng)));
+            break;
+        case 1:
+            x = nextafter(1.0 + (i / 3 % 129) / 128.0, uniform(rng) < 0.5 ? 0.0 : 2.0);
+            break;
+        default:
+            x = 1.0 + (uniform(rng) - 0.5) * 1.0E-3;
+            break;
+        }
+
+        double exact = log2(x);
+        double error = fabs(FastLog2(x) - exact) - ldexp(fabs(exact), -51);
+        max_log2 = std::max(max_log2, error);
+        if (error > FAST_LOG2_ERROR)
+            n_failed++;
+    }
+
+    double max_exp2 = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        double y = i % 2 == 0 ? -1000.0 + 2000.0 * uniform(rng) : -4.0 + 8.0 * uniform(rng);
+
+        double exact = exp2(y);
+        double error = fabs(FastExp2(y) - exact) / exact - ldexp(1.0, -50);
+        max_exp2 = std::max(max_exp2, error);
+        if (error > FAST_EXP2_ERROR)
+            n_failed++;
+    }
+
+    // The arguments of the cube roots of smooth sphere diffraction are ratios
+    // of radii.
+    double cbrt_bound = log(2.0) * FAST_LOG2_ERROR / 3.0 + FAST_EXP2_ERROR;
+    double max_cbrt = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        double x = LogUniform(rng, 1.0E-12, 1.0E12);
+
+        double exact = pow(x, 1.0 / 3.0);
+        double rounding = log(2.0) * ldexp(fabs(log2(x)), -51) / 3.0 + ldexp(1.0, -50);
+        double error = fabs(FastCbrt(x) - exact) / exact - rounding;
+        max_cbrt = std::max(max_cbrt, error);
+        if (error > cbrt_bound)
+            n_failed++;
+    }
+
+    printf("FastLog2   max abs error %.3e  (bound %.1e)\n", max_log2, FAST_LOG2_ERROR);
+    printf("FastExp2   max rel error %.3e  (bound %.1e)\n", max_exp2, FAST_EXP2_ERROR);
+    printf("FastCbrt   max rel error %.3e  (bound %.1e)\n", max_cbrt, cbrt_bound);
+
+    return n_failed;
+}
+
+/**
+@brief
+Add a comparison of a fast value with its exact value to a deviation.
+
+@param[in,out] dev
+Deviation.
+
+@param[in] exact
+Value of the exact mode.
+
+@param[in] fast
+Value of the fast mode.
+
+@param[in] bound
+Largest acceptable absolute deviation.
+
+*/
+static void Accumulate(
+    Deviation *dev,
+    double exact,
+    double fast,
+    double bound
+) {
+    if (!std::isfinite(exact) || !std::isfinite(fast))
+    {
+        if (std::isfinite(exact) || std::isfinite(fast) || std::isnan(exact) != std::isnan(fast))
+            dev->n_failed++;
+        return;
+    }
+
+    double diff = exact == fast ? 0.0 : fabs(fast - exact);
+    dev->n_compared++;
+
+    if (!(diff <= bound))
+        dev->n_failed++;
+
+    dev->max_diff = std::max(dev->max_diff, diff);
+}
+
+/**
+@brief
+Print a deviation and return its number of failures, counting a deviation
+that compared no finite values as a failure.
+
+@param[in] name
+Name of the quantity.
+
+@param[in] dev
+Deviation.
+
+@param[in] bound
+Bound of the deviation, without the allowance for rounding.
+
+@return
+Number of failures.
+
+*/
+static long long Report(
+    const char *name,
+    const Deviation &dev,
+    double bound
+) {
+    printf("%-22s %9lld compared, max |d| %.3e  (bound %.1e), %lld failed",
+        name, dev.n_compared, dev.max_diff, bound, dev.n_failed);
+    if (dev.n_boundary > 0)
+        printf(", %lld at a piece boundary", dev.n_boundary);
+    printf("\n");
+
+    if (dev.n_compared == 0)
+    {
+        printf("%-22s compared no finite values\n", name);
+        return dev.n_failed + 1;
+    }
+
+    return dev.n_failed;
+}
+
+/**
+@brief
+Check FresnelIntegralFast(), HeightFunctionFast() and
+InverseComplementaryCumulativeDistributionFunctionFast() against their exact
+counterparts over their whole domains.
+
+The arguments of HeightFunction() at which the exact and fast logarithms of K
+select different pieces are counted, not compared, as the pieces are not
+continuous there.
+
+@param[in] rng
+Random number generator.
+
+@param[in] n
+Number of random arguments of each function.
+
+@return
+Number of failures.
+
+*/
+static long long CheckSpecialFunctions(
+    std::mt19937_64 &rng,
+    int n
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    long long n_failed = 0;
+
+    // v^2 over many decades, and around the change of piece at v = 2.4.
+    double fresnel_bound = 10.0 * log10(2.0) * FAST_LOG2_ERROR;
+    Deviation fresnel = {};
+    for (int i = 0; i < n; i++)
+    {
+        double v2 = i % 2 == 0 ? LogUniform(rng, 1.0E-12, 1.0E12) : 12.0 * uniform(rng);
+
+        double exact = FresnelIntegral(v2);
+        Accumulate(&fresnel, exact, FresnelIntegralFast(v2), fresnel_bound + ldexp(fabs(exact), -50));
+    }
+    n_failed += Report("FresnelIntegral [dB]", fresnel, fresnel_bound);
+
+    // K from well below the cut off of 1E-5 to above 1, where w < 0.
+    double height_bound = 1.0E-8;
+    Deviation height = {};
+    for (int i = 0; i < n; i++)
+    {
+        double x__km = LogUniform(rng, 1.0E-4, 1.0E5);
+        double K = LogUniform(rng, 1.0E-7, 10.0);
+
+        if (x__km < 200.0 && K >= 1.0E-5 &&
+            (x__km * ExactPrecision::Cube(-ExactPrecision::Log(K)) > 5495.0) !=
+            (x__km * FastPrecision::Cube(-FastPrecision::Log(K)) > 5495.0))
+        {
+            height.n_boundary++;
+            continue;
+        }
+
+        double exact = HeightFunction(x__km, K);
+        Accumulate(&height, exact, HeightFunctionFast(x__km, K), height_bound + ldexp(fabs(exact), -50));
+    }
+    n_failed += Report("HeightFunction [dB]", height, height_bound);
+
+    // Quantiles out to 1E-300 from 0, and to the rounding of 1 - q from 1.
+    double inverse_bound = 1.3 * log(2.0) * FAST_LOG2_ERROR;
+    Deviation inverse = {};
+    for (int i = 0; i < n; i++)
+    {
+        double q = i % 2 == 0 ? LogUniform(rng, 1.0E-300, 0.5) : 1.0 - LogUniform(rng, ldexp(1.0, -53), 0.5);
+
+        double exact = InverseComplementaryCumulativeDistributionFunction(q);
+        Accumulate(&inverse, exact, InverseComplementaryCumulativeDistributionFunctionFast(q), inverse_bound + ldexp(fabs(exact), -50));
+    }
+    n_failed += Report("InverseCCDF", inverse, inverse_bound);
+
+    return n_failed;
+}
+
+/**
+@brief
+Draw a random radio context and location percentage over the valid domain of
+ValidateInputs().
+
+@param[in] rng
+Random number generator.
+
+@param[out] check
+Path whose radio contexts and location percentage are set.
+
+*/
+static void RandomRadio(
+    std::mt19937_64 &rng,
+    CheckPath *check
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    double f__mhz = LogUniform(rng, 20.0, 20000.0);
+    int pol = uniform(rng) < 0.5 ? POLARIZATION__HORIZONTAL : POLARIZATION__VERTICAL;
+    double epsilon = LogUniform(rng, 1.0, 1000.0);
+    double sigma = LogUniform(rng, 1.0E-6, 1000.0);
+
+    InitializeRadioContext(f__mhz, pol, epsilon, sigma, &check->exact);
+    check->fast = check->exact;
+    check->fast.precision = PRECISION__FAST;
+
+    // Location percentages out to 1E-5 of the ends of the range.
+    double u = -11.5 + 23.0 * uniform(rng);
+    check->p = std::min(99.99999, std::max(0.00001, 100.0 / (1.0 + exp(-u))));
+}
+
+/**
+@brief
+Draw a random point-to-point path, on rough random walk terrain.
+
+@param[in] rng
+Random number generator.
+
+@param[out] check
+Path whose prepared path is set.
+
+*/
+static void RandomPointToPoint(
+    std::mt19937_64 &rng,
+    CheckPath *check
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    int np = 2 + int(2000 * uniform(rng));
+    double xi__meter = LogUniform(rng, 1.0, 2000.0);
+    double roughness__meter = LogUniform(rng, 0.01, 100.0);
+
+    std::vector<double> pfl(np + 3);
+    pfl[0] = np;
+    pfl[1] = xi__meter;
+    pfl[2] = 0.0;
+    for (int i = 1; i <= np; i++)
+        pfl[i + 2] = pfl[i + 1] + roughness__meter * normal(rng);
+
+    PreparePath(
+        LogUniform(rng, 0.5, 3000.0),
+        LogUniform(rng, 0.5, 3000.0),
+        pfl.data(),
+        &check->path
+    );
+}
+
+/**
+@brief
+Draw a random area mode path.
+
+@param[in] rng
+Random number generator.
+
+@param[out] check
+Path whose prepared path is set.
+
+@return
+Error code of PrepareArea().
+
+*/
+static int RandomArea(
+    std::mt19937_64 &rng,
+    CheckPath *check
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    return PrepareArea(
+        LogUniform(rng, 0.5, 3000.0),
+        LogUniform(rng, 0.5, 3000.0),
+        uniform(rng) < 0.5 ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED,
+        uniform(rng) < 0.5 ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED,
+        LogUniform(rng, 0.001, 2000.0),
+        uniform(rng) < 0.05 ? 0.0 : LogUniform(rng, 0.1, 3000.0),
+        &check->path
+    );
+}
+
+/**
+@brief
+Evaluate the paths with one precision.
+
+@param[in] checks
+Paths.
+
+@param[in] fast
+Whether to use the radio contexts with PRECISION__FAST.
+
+@param[out] results
+Result of each path.
+
+@return
+Time taken, in seconds.
+
+*/
+static double Evaluate(
+    std::vector<CheckPath> &checks,
+    bool fast,
+    std::vector<CheckResult> &results
+) {
+    double t_0 = Now();
+
+    for (size_t i = 0; i < checks.size(); i++)
+    {
+        results[i].error = PointToPointPreparedContext_Ex(
+            &checks[i].path,
+            fast ? &checks[i].fast : &checks[i].exact,
+            1,
+            &checks[i].p,
+            &results[i].A__db,
+            &results[i].warnings,
+            &results[i].iv
+        );
+    }
+
+    return Now() - t_0;
+}
+
+/**
+@brief
+Compare the free space, line-of-sight, knife-edge, smooth-sphere and
+variability terms of the exact and fast radio contexts on the terrain of a
+set of paths, and print a summary.
+
+The terms are evaluated with the intermediate values of the exact mode, the
+geometry of the diffraction region of the Longley-Rice method, and random
+diffraction coefficients, reference attenuations and distances within and
+beyond the line-of-sight region.
+
+@param[in] rng
+Random number generator.
+
+@param[in] checks
+Paths.
+
+@param[in] results
+Results of the exact mode.
+
+@param[in] bound__db
+Largest acceptable deviation of a term without a tighter bound, in dB.
+
+@return
+Number of failures.
+
+*/
+static long long CompareTerms(
+    std::mt19937_64 &rng,
+    std::vector<CheckPath> &checks,
+    const std::vector<CheckResult> &results,
+    double bound__db
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // The distance of the knife-edge diffraction is exact, so its only
+    // approximations are the logarithms of the two Fresnel integrals.
+    double knife_bound__db = 20.0 * log10(2.0) * FAST_LOG2_ERROR;
+
+    Deviation free_space = {};
+    Deviation los = {};
+    Deviation knife = {};
+    Deviation sphere = {};
+    Deviation variability = {};
+
+    for (size_t i = 0; i < checks.size(); i++)
+    {
+        const CheckResult &r = results[i];
+        if (r.error != SUCCESS && r.error != SUCCESS_WITH_WARNINGS)
+            continue;
+
+        const RadioContext *exact = &checks[i].exact;
+        const RadioContext *fast = &checks[i].fast;
+        IntermediateValues iv = r.iv;
+        double d__meter = 1000.0 * iv.d__km;
+
+        // Free space loss does not depend on the precision.
+        Accumulate(&free_space, FreeSpaceLoss(d__meter, exact), FreeSpaceLoss(d__meter, fast), 0.0);
+
+        // [RLS, A-8, A-11 & A-12].
+        double d_ls__meter = sqrt(2.0 * iv.h_e__meter[0] * a_m__meter) + sqrt(2.0 * iv.h_e__meter[1] * a_m__meter);
+        double d_l__meter = iv.d_hzn__meter[0] + iv.d_hzn__meter[1];
+
+        double s__meter = d_ls__meter * LogUniform(rng, 1.0E-3, 1.0);
+        double m_d = LogUniform(rng, 1.0E-7, 1.0E-3);
+        double A_ed__db = -20.0 + 100.0 * uniform(rng);
+        Accumulate(&los,
+            LineOfSightLoss(s__meter, iv.h_e__meter, exact, iv.delta_h__meter, m_d, A_ed__db, d_ls__meter),
+            LineOfSightLoss(s__meter, iv.h_e__meter, fast, iv.delta_h__meter, m_d, A_ed__db, d_ls__meter),
+            bound__db);
+
+        // Angular distance of the line-of-sight region [Algorithm, Eqn 4.12],
+        // at a distance beyond the horizons.
+        double theta_los = std::max(iv.theta_hzn[0] + iv.theta_hzn[1], -d_l__meter / a_m__meter);
+        double d_d__meter = d_l__meter * (1.0 + LogUniform(rng, 1.0E-3, 100.0));
+        double A_k__db = KnifeEdgeDiffraction(d_d__meter, exact, theta_los, iv.d_hzn__meter);
+        Accumulate(&knife,
+            A_k__db,
+            KnifeEdgeDiffraction(d_d__meter, fast, theta_los, iv.d_hzn__meter),
+            knife_bound__db + ldexp(fabs(A_k__db), -49));
+        Accumulate(&sphere,
+            SmoothSphereDiffraction(a_m__meter, d_d__meter, exact, theta_los, iv.d_hzn__meter, iv.h_e__meter),
+            SmoothSphereDiffraction(a_m__meter, d_d__meter, fast, theta_los, iv.d_hzn__meter, iv.h_e__meter),
+            bound__db);
+
+        double A_ref__db = -30.0 + 330.0 * uniform(rng);
+        double p = checks[i].p / 100.0;
+        Accumulate(&variability,
+            Variability(p, iv.delta_h__meter, exact, d__meter, A_ref__db),
+            Variability(p, iv.delta_h__meter, fast, d__meter, A_ref__db),
+            bound__db);
+    }
+
+    long long n_failed = 0;
+    n_failed += Report("  FreeSpaceLoss [dB]", free_space, 0.0);
+    n_failed += Report("  LineOfSightLoss [dB]", los, bound__db);
+    n_failed += Report("  KnifeEdge [dB]", knife, knife_bound__db);
+    n_failed += Report("  SmoothSphere [dB]", sphere, bound__db);
+    n_failed += Report("  Variability [dB]", variability, bound__db);
+
+    return n_failed;
+}
+
+/**
+@brief
+Compare the fast and exact results of a set of paths, and print a summary.
+
+The terrain intermediate values and the free space loss do not depend on the
+precision, and must be identical. The reference attenuation and the basic
+transmission loss are compared where they are finite in both modes, and must
+be non-finite in both modes otherwise.
+
+@param[in] name
+Name of the set of paths.
+
+@param[in] rng
+Random number generator.
+
+@param[in] checks
+Paths.
+
+@param[in] bound__db
+Largest acceptable deviation of a loss, in dB.
+
+@return
+Number of failures.
+
+*/
+static long long Compare(
+    const char *name,
+    std::mt19937_64 &rng,
+    std::vector<CheckPath> &checks,
+    double bound__db
+) {
+    std::vector<CheckResult> exact(checks.size());
+    std::vector<CheckResult> fast(checks.size());
+
+    // Best of a few alternating runs.
+    double t_exact = HUGE_VAL;
+    double t_fast = HUGE_VAL;
+    for (int run = 0; run < 3; run++)
+    {
+        t_exact = std::min(t_exact, Evaluate(checks, false, exact));
+        t_fast = std::min(t_fast, Evaluate(checks, true, fast));
+    }
+
+    long long n_failed = 0;
+    long long n_succeeded = 0;
+    Deviation terrain = {};
+    Deviation A_ref = {};
+    Deviation A = {};
+
+    for (size_t i = 0; i < checks.size(); i++)
+    {
+        const CheckResult &a = exact[i];
+        const CheckResult &b = fast[i];
+
+        if (a.error != b.error || a.warnings != b.warnings ||
+            ((a.error == SUCCESS || a.error == SUCCESS_WITH_WARNINGS) && a.iv.mode != b.iv.mode))
+        {
+            n_failed++;
+            continue;
+        }
+
+        if (a.error != SUCCESS && a.error != SUCCESS_WITH_WARNINGS)
+            continue;
+
+        n_succeeded++;
+
+        for (int j = 0; j < 2; j++)
+        {
+            Accumulate(&terrain, a.iv.theta_hzn[j], b.iv.theta_hzn[j], 0.0);
+            Accumulate(&terrain, a.iv.d_hzn__meter[j], b.iv.d_hzn__meter[j], 0.0);
+            Accumulate(&terrain, a.iv.h_e__meter[j], b.iv.h_e__meter[j], 0.0);
+        }
+        Accumulate(&terrain, a.iv.delta_h__meter, b.iv.delta_h__meter, 0.0);
+        Accumulate(&terrain, a.iv.A_fs__db, b.iv.A_fs__db, 0.0);
+        Accumulate(&terrain, a.iv.d__km, b.iv.d__km, 0.0);
+
+        Accumulate(&A_ref, a.iv.A_ref__db, b.iv.A_ref__db, bound__db);
+        Accumulate(&A, a.A__db, b.A__db, bound__db);
+    }
+
+    printf("%-6s %lld of %zu paths succeeded, %lld differ in error, warnings or mode, exact %.1f ns/path, fast %.1f ns/path (%.2fx)\n",
+        name, n_succeeded, checks.size(), n_failed,
+        1.0E9 * t_exact / checks.size(), 1.0E9 * t_fast / checks.size(), t_exact / t_fast);
+
+    // The terrain values must be compared; the losses are finite on only
+    // some paths, and are reported for those.
+    n_failed += Report("  intermediate values", terrain, 0.0);
+    n_failed += A_ref.n_failed;
+    n_failed += A.n_failed;
+    printf("  %-20s %9lld compared, max |d| %.3e  (bound %.1e), %lld failed\n",
+        "A_ref [dB]", A_ref.n_compared, A_ref.max_diff, bound__db, A_ref.n_failed);
+    printf("  %-20s %9lld compared, max |d| %.3e  (bound %.1e), %lld failed\n",
+        "A [dB]", A.n_compared, A.max_diff, bound__db, A.n_failed);
+
+    n_failed += CompareTerms(rng, checks, exact, bound__db);
+
+    return n_failed;
+}
+
+int main(int argc, char **argv)
+{
+    int n = 100000;
+    double bound__db = 0.01;
+    unsigned long long seed = 1;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:b:s:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            n = atoi(optarg);
+            break;
+        case 'b':
+            bound__db = atof(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, nullptr, 10);
+            break;
+        default:
+            fprintf(stderr, "Usage: fast_math_check [-n paths] [-b bound__db] [-s seed]\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937_64 rng(seed);
+
+    long long n_failed = CheckElementaryFunctions(rng, 10 * n);
+    n_failed += CheckSpecialFunctions(rng, 10 * n);
+
+    std::vector<CheckPath> p2p(n);
+    for (int i = 0; i < n; i++)
+    {
+        RandomRadio(rng, &p2p[i]);
+        RandomPointToPoint(rng, &p2p[i]);
+    }
+
+    std::vector<CheckPath> area;
+    area.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        CheckPath check;
+        RandomRadio(rng, &check);
+        if (RandomArea(rng, &check) == SUCCESS)
+            area.push_back(check);
+    }
+
+    n_failed += Compare("p2p", rng, p2p, bound__db);
+    n_failed += Compare("area", rng, area, bound__db);
+
+    if (n_failed > 0)
+    {
+        printf("FAILED: %lld checks exceeded their bounds or compared nothing\n", n_failed);
+        return EXIT_FAILURE;
+    }
+
+    printf("PASSED: fast mode within the bounds of exact mode\n");
+    return EXIT_SUCCESS;
+}
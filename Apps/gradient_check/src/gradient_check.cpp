@@ -0,0 +1,1084 @@
+/**
+@file
+
+Check of the partial derivatives of Area_Grad(), PointToPoint_Grad() and the
+dual numbers of Dual.h.
+
+Evaluates random area and point-to-point paths with Area_Grad() and
+PointToPoint_Grad(), and fails if an error code, warning or basic transmission
+loss differs in any bit from Area() and PointToPoint(). The derivatives of the
+basic transmission loss are compared with central differences where the loss
+is finite.
+
+As the loss is not finite on most paths, the finite parts of the model are
+checked on their own, with respect to the terminal heights, the frequency and
+the path distance. For the area paths these are the free space loss, the
+line-of-sight loss, the knife-edge and smooth-sphere diffraction and the
+variability of the engine instantiated for Dual<4>, and the effective heights
+of its terminal estimates. For the point-to-point paths they are the horizons,
+the effective heights and the terrain irregularity of PreparePathGrad(), the
+terrain analysis of PointToPoint_Grad(), against PreparePath().
+
+A derivative is only checked where two central differences with different
+steps agree, and one of the one-sided differences agrees with them, as the
+model has branches and is not smooth everywhere. It fails if it is off by more
+than 1E-4 of its size and the rounding of the differences from the central
+differences, less their own difference, and from both one-sided differences.
+Fails if a part compared no derivatives. Also reports the time taken by Area()
+and Area_Grad().
+
+Usage: gradient_check [-n paths] [-s seed]
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Dual.h"
+#include "Engine.h"
+#include "Enums.h"
+#include "Errors.h"
+#include "Internal.h"
+
+/**
+@brief
+Number of inputs of the derivatives: the terminal heights, the frequency and
+the path distance.
+*/
+#define N_INPUTS 4
+
+/**
+@brief
+Number of terrain values of a point-to-point path: the horizon angles, the
+horizon distances, the effective heights and the terrain irregularity.
+*/
+#define N_TERRAIN_VALUES 7
+
+/**
+@brief
+Largest relative difference of a terrain value of PreparePathGrad() from
+PreparePath(), relative to the larger of 1 and its size.
+*/
+#define TERRAIN_TOLERANCE 1.0E-12
+
+/**
+@brief
+Inputs of one random path, and of the parts of the model.
+*/
+struct PathInputs
+{
+    /**
+    Structural heights of the TX and RX, in meters, frequency, in MHz, and
+    path distance, in km.
+    */
+    double x[N_INPUTS];
+
+    /**
+    Siting criteria of the TX and RX.
+    */
+    int tx_site_criteria;
+    int rx_site_criteria;
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    double delta_h__meter;
+
+    /**
+    Polarization.
+    */
+    int pol;
+
+    /**
+    Relative permittivity and conductivity.
+    */
+    double epsilon;
+    double sigma;
+
+    /**
+    Location percentage.
+    */
+    double p;
+};
+
+/**
+@brief
+Tally of the derivatives checked against central differences.
+*/
+struct Tally
+{
+    /**
+    Number of derivatives compared.
+    */
+    long long n;
+
+    /**
+    Number of them where the central differences agree.
+    */
+    long long n_smooth;
+
+    /**
+    Number of smooth derivatives that are off.
+    */
+    long long n_off;
+
+    /**
+    Number of smooth derivatives that overflow, where an intermediate of the
+    model, such as the reflection coefficient, underflows and the derivative
+    of its reciprocal is out of the range of double.
+    */
+    long long n_overflow;
+
+    /**
+    Largest relative difference of a smooth derivative.
+    */
+    double max_error;
+};
+
+/**
+@brief
+Return the time, in seconds.
+
+@return
+Time, in seconds.
+
+*/
+static double Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+@brief
+Return a random number with a uniform distribution of its logarithm.
+
+@param[in] rng
+Random number generator.
+
+@param[in] lo
+Smallest value, > 0.
+
+@param[in] hi
+Largest value.
+
+@return
+Random number, lo <= x <= hi.
+
+*/
+static double LogUniform(
+    std::mt19937_64 &rng,
+    double lo,
+    double hi
+) {
+    std::uniform_real_distribution<double> uniform(log(lo), log(hi));
+    return std::min(hi, std::max(lo, exp(uniform(rng))));
+}
+
+/**
+@brief
+Return if two values are the same bits.
+
+@param[in] a
+First value.
+
+@param[in] b
+Second value.
+
+@return
+True if the values are identical, including NaNs.
+
+*/
+static bool SameBits(
+    double a,
+    double b
+) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/**
+@brief
+Draw random path inputs over the valid input domain.
+
+@param[in] rng
+Random number generator.
+
+@return
+Inputs of the path.
+
+*/
+static PathInputs RandomPath(
+    std::mt19937_64 &rng
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    PathInputs in;
+    in.x[0] = LogUniform(rng, 1.0, 1000.0);
+    in.x[1] = LogUniform(rng, 1.0, 1000.0);
+    in.x[2] = LogUniform(rng, 40.0, 10000.0);
+    in.x[3] = LogUniform(rng, 1.0, 1000.0);
+    in.tx_site_criteria = uniform(rng) < 0.5 ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED;
+    in.rx_site_criteria = uniform(rng) < 0.5 ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED;
+    in.delta_h__meter = LogUniform(rng, 1.0, 1000.0);
+    in.pol = uniform(rng) < 0.5 ? POLARIZATION__HORIZONTAL : POLARIZATION__VERTICAL;
+    in.epsilon = LogUniform(rng, 1.0, 100.0);
+    in.sigma = LogUniform(rng, 1.0E-5, 10.0);
+    in.p = LogUniform(rng, 0.01, 99.99);
+    return in;
+}
+
+/**
+@brief
+Compute the terminal estimates and the radio constants of the area mode, for
+the parts of the model.
+
+@param[in] x
+Structural heights of the TX and RX, in meters, frequency, in MHz, and path
+distance, in km.
+
+@param[in] in
+Other inputs of the path.
+
+@param[out] path
+Terrain parameters of the path.
+
+@param[out] radio
+Radio constants.
+
+*/
+template <typename T, typename Polarization>
+static void PreparePart(
+    const T x[N_INPUTS],
+    const PathInputs &in,
+    EnginePath<T> *path,
+    EngineRadio<T> *radio
+) {
+    AreaModel<T>::template PrepareArea<FixedSiting, MobileSiting>(
+        x[0],
+        x[1],
+        x[3],
+        T(in.delta_h__meter),
+        path
+    );
+
+    IlmEngine<T, Polarization>::InitializeRadio(
+        x[2],
+        T(in.epsilon),
+        T(in.sigma),
+        radio
+    );
+}
+
+/**
+@brief
+Line-of-sight loss of an area path, with the terminal estimates and the
+complex ground impedance.
+*/
+template <typename T, typename Polarization>
+static T LineOfSightPart(
+    const T x[N_INPUTS],
+    const PathInputs &in
+) {
+    using std::sqrt;
+
+    EnginePath<T> path;
+    EngineRadio<T> radio;
+    PreparePart<T, Polarization>(x, in, &path, &radio);
+
+    T d_ls__meter = sqrt(T(2.0) * path.h_e__meter[0] * T(a_m__meter)) + sqrt(T(2.0) * path.h_e__meter[1] * T(a_m__meter));
+
+    return LongleyRiceModel<T>::LineOfSightLoss(
+        path.d__meter,
+        path.h_e__meter,
+        radio,
+        path.delta_h__meter,
+        T(1.0E-4),
+        T(10.0),
+        d_ls__meter
+    );
+}
+
+/**
+@brief
+Diffraction loss of an area path beyond the horizons, with the angular
+distance of the line-of-sight region of a smooth sphere.
+*/
+template <typename T, typename Polarization>
+static T DiffractionPart(
+    const T x[N_INPUTS],
+    const PathInputs &in
+) {
+    EnginePath<T> path;
+    EngineRadio<T> radio;
+    PreparePart<T, Polarization>(x, in, &path, &radio);
+
+    T d_l__meter = path.d_hzn__meter[0] + path.d_hzn__meter[1];
+
+    return LongleyRiceModel<T>::DiffractionLoss(
+        T(a_m__meter),
+        d_l__meter + path.d__meter,
+        path.d_hzn__meter,
+        path.h_e__meter,
+        radio,
+        path.delta_h__meter,
+        path.h__meter,
+        d_l__meter / T(a_m__meter)
+    );
+}
+
+/**
+@brief
+Free space loss of an area path.
+*/
+template <typename T, typename Polarization>
+static T FreeSpacePart(
+    const T x[N_INPUTS],
+    const PathInputs &in
+) {
+    EnginePath<T> path;
+    EngineRadio<T> radio;
+    PreparePart<T, Polarization>(x, in, &path, &radio);
+
+    return LongleyRiceModel<T>::FreeSpaceLoss(path.d__meter, radio);
+}
+
+/**
+@brief
+Knife-edge diffraction loss of an area path beyond the horizons, with the
+angular distance of the line-of-sight region of a smooth sphere.
+*/
+template <typename T, typename Polarization>
+static T KnifeEdgePart(
+    const T x[N_INPUTS],
+    const PathInputs &in
+) {
+    EnginePath<T> path;
+    EngineRadio<T> radio;
+    PreparePart<T, Polarization>(x, in, &path, &radio);
+
+    T d_l__meter = path.d_hzn__meter[0] + path.d_hzn__meter[1];
+
+    return LongleyRiceModel<T>::KnifeEdgeDiffraction(
+        d_l__meter + path.d__meter,
+        radio.f__mhz,
+        d_l__meter / T(a_m__meter),
+        path.d_hzn__meter
+    );
+}
+
+/**
+@brief
+Variability of an area path, for a reference attenuation that grows with the
+path distance.
+*/
+template <typename T, typename Polarization>
+static T VariabilityPart(
+    const T x[N_INPUTS],
+    const PathInputs &in
+) {
+    EnginePath<T> path;
+    EngineRadio<T> radio;
+    PreparePart<T, Polarization>(x, in, &path, &radio);
+
+    return LongleyRiceModel<T>::Variability(
+        T(in.p / 100.0),
+        path.delta_h__meter,
+        radio,
+        path.d__meter,
+        T(1.0E-4) * path.d__meter - T(5.0)
+    );
+}
+
+/**
+@brief
+Effective height of a terminal of an area path.
+*/
+template <typename T, typename Polarization, int I>
+static T EffectiveHeightPart(
+    const T x[N_INPUTS],
+    const PathInputs &in
+) {
+    EnginePath<T> path;
+    EngineRadio<T> radio;
+    PreparePart<T, Polarization>(x, in, &path, &radio);
+
+    return path.h_e__meter[I];
+}
+
+/**
+@brief
+A part of the model, for the inputs of the derivatives.
+*/
+typedef double (*DoublePart)(const double x[N_INPUTS], const PathInputs &in);
+typedef Dual<N_INPUTS> (*DualPart)(const Dual<N_INPUTS> x[N_INPUTS], const PathInputs &in);
+
+/**
+@brief
+Return the central difference of a function of the path inputs.
+
+@param[in] f
+Function.
+
+@param[in] in
+Inputs of the path.
+
+@param[in] i
+Input to vary.
+
+@param[in] step
+Relative step of the input.
+
+@return
+Central difference.
+
+*/
+template <typename F>
+static double CentralDifference(
+    F f,
+    const PathInputs &in,
+    int i,
+    double step
+) {
+    PathInputs lo = in;
+    PathInputs hi = in;
+    double h = step * in.x[i];
+    lo.x[i] -= h;
+    hi.x[i] += h;
+
+    return (f(hi) - f(lo)) / (hi.x[i] - lo.x[i]);
+}
+
+/**
+@brief
+Return the one-sided difference of a function of the path inputs.
+
+@param[in] f
+Function.
+
+@param[in] in
+Inputs of the path.
+
+@param[in] i
+Input to vary.
+
+@param[in] step
+Relative step of the input, < 0 for the backward difference.
+
+@return
+One-sided difference.
+
+*/
+template <typename F>
+static double OneSidedDifference(
+    F f,
+    const PathInputs &in,
+    int i,
+    double step
+) {
+    PathInputs hi = in;
+    hi.x[i] += step * in.x[i];
+
+    return (f(hi) - f(in)) / (hi.x[i] - in.x[i]);
+}
+
+/**
+@brief
+Compare a derivative with central differences, and tally it.
+
+@param[in] f
+Function of the path inputs, for double.
+
+@param[in] in
+Inputs of the path.
+
+@param[in] i
+Input of the derivative.
+
+@param[in] derivative
+Derivative to compare.
+
+@param[in,out] tally
+Tally of the derivatives.
+
+*/
+template <typename F>
+static void Compare(
+    F f,
+    const PathInputs &in,
+    int i,
+    double derivative,
+    Tally *tally
+) {
+    double fd_1 = CentralDifference(f, in, i, 1.0E-5);
+    double fd_2 = CentralDifference(f, in, i, 2.5E-6);
+
+    if (!std::isfinite(fd_1) || !std::isfinite(fd_2) || !std::isfinite(f(in)))
+        return;
+
+    tally->n++;
+
+    // Scale of the rounding of the central differences.
+    double scale = 1.0E-7 * (fabs(f(in)) + 1.0) / in.x[i];
+
+    if (fabs(fd_1 - fd_2) > 1.0E-3 * fabs(fd_2) + scale)
+        return;
+
+    // The central differences cancel the jump where the rounding of a least
+    // squares fit window puts a single point on the next piece, where
+    // neither one-sided difference agrees with them.
+    double fd_forward = OneSidedDifference(f, in, i, 2.5E-6);
+    double fd_backward = OneSidedDifference(f, in, i, -2.5E-6);
+    if (std::min(fabs(fd_forward - fd_2), fabs(fd_backward - fd_2)) > 1.0E-3 * fabs(fd_2) + scale)
+        return;
+
+    tally->n_smooth++;
+
+    if (!std::isfinite(derivative))
+    {
+        tally->n_overflow++;
+        return;
+    }
+
+    // The difference of the two central differences bounds their own error.
+    // Next to a kink of the terrain interpolation, the derivative is the
+    // slope of the piece on the side without the kink.
+    double diff = std::min(
+        fabs(derivative - fd_2) - fabs(fd_1 - fd_2),
+        std::min(fabs(derivative - fd_forward), fabs(derivative - fd_backward))
+    );
+    tally->max_error = std::max(tally->max_error, std::max(0.0, diff) / (fabs(fd_2) + scale));
+    if (diff > 1.0E-4 * fabs(fd_2) + scale)
+        tally->n_off++;
+}
+
+/**
+@brief
+Check the derivatives of a part of the model against central differences.
+
+@param[in] double_part
+Part of the model, for double.
+
+@param[in] dual_part
+Same part of the model, for dual numbers.
+
+@param[in] in
+Inputs of the path.
+
+@param[in,out] tally
+Tally of the derivatives.
+
+*/
+static void CheckPart(
+    DoublePart double_part,
+    DualPart dual_part,
+    const PathInputs &in,
+    Tally *tally
+) {
+    Dual<N_INPUTS> x[N_INPUTS];
+    for (int i = 0; i < N_INPUTS; i++)
+        x[i] = Dual<N_INPUTS>::Input(in.x[i], i);
+
+    Dual<N_INPUTS> result = dual_part(x, in);
+
+    // The values must be those of double.
+    if (!SameBits(result.value, double_part(in.x, in)))
+    {
+        tally->n++;
+        tally->n_off++;
+        return;
+    }
+
+    for (int i = 0; i < N_INPUTS; i++)
+        Compare([&](const PathInputs &a) { return double_part(a.x, a); }, in, i, result.deriv[i], tally);
+}
+
+/**
+@brief
+Copy the terrain values of a prepared path.
+
+@param[in] path
+Prepared path, a PreparedPath or an EnginePath.
+
+@param[out] values
+Horizon angles, horizon distances, effective heights and terrain
+irregularity.
+
+*/
+template <typename T, typename Path>
+static void TerrainValues(
+    const Path &path,
+    T values[N_TERRAIN_VALUES]
+) {
+    for (int i = 0; i < 2; i++)
+    {
+        values[i] = path.theta_hzn[i];
+        values[2 + i] = path.d_hzn__meter[i];
+        values[4 + i] = path.h_e__meter[i];
+    }
+    values[6] = path.delta_h__meter;
+}
+
+/**
+@brief
+Return a terrain profile stretched to a path distance, through its terrain
+resolution. The resolution is scaled rather than recomputed, so that the
+distance of the profile itself gives back the same profile, and the same
+least squares fit windows.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] d__km
+Path distance, in km.
+
+@return
+Terrain data, in PFL format.
+
+*/
+static std::vector<double> StretchedProfile(
+    const std::vector<double> &pfl,
+    double d__km
+) {
+    std::vector<double> stretched(pfl);
+    stretched[1] = pfl[1] * (d__km / (pfl[0] * pfl[1] / 1000.0));
+    return stretched;
+}
+
+/**
+@brief
+Return a terrain value of PreparePath(), for the inputs of the derivatives.
+The path distance is that of the profile, stretched through its terrain
+resolution.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] in
+Inputs of the path.
+
+@param[in] k
+Index of the terrain value, as TerrainValues().
+
+@return
+Terrain value.
+
+*/
+static double PreparedTerrainValue(
+    const std::vector<double> &pfl,
+    const PathInputs &in,
+    int k
+) {
+    std::vector<double> stretched = StretchedProfile(pfl, in.x[3]);
+
+    PreparedPath path;
+    PreparePath(in.x[0], in.x[1], stretched.data(), &path);
+
+    double values[N_TERRAIN_VALUES];
+    TerrainValues(path, values);
+    return values[k];
+}
+
+/**
+@brief
+Check the derivatives of the terrain analysis of PointToPoint_Grad() against
+central differences of PreparePath().
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] in
+Inputs of the path, with the path distance of the profile.
+
+@param[in,out] tally
+Tally of the derivatives.
+
+*/
+static void CheckTerrain(
+    std::vector<double> &pfl,
+    const PathInputs &in,
+    Tally *tally
+) {
+    Dual<N_INPUTS> h__meter[2] = {
+        Dual<N_INPUTS>::Input(in.x[0], 0),
+        Dual<N_INPUTS>::Input(in.x[1], 1)
+    };
+
+    EnginePath<Dual<N_INPUTS>> path;
+    PreparePathGrad(h__meter, pfl.data(), &path);
+
+    Dual<N_INPUTS> values[N_TERRAIN_VALUES];
+    TerrainValues(path, values);
+
+    for (int k = 0; k < N_TERRAIN_VALUES; k++)
+    {
+        // The values must be those of PreparePath(), to within the rounding
+        // of its horizon search and fits, which are vectorized and ordered
+        // differently.
+        double value = PreparedTerrainValue(pfl, in, k);
+        if (!(fabs(values[k].value - value) <= TERRAIN_TOLERANCE * std::max(1.0, fabs(value))))
+        {
+            tally->n++;
+            tally->n_off++;
+            continue;
+        }
+
+        for (int i = 0; i < N_INPUTS; i++)
+            Compare([&](const PathInputs &a) { return PreparedTerrainValue(pfl, a, k); }, in, i, values[k].deriv[i], tally);
+    }
+}
+
+/**
+@brief
+Evaluate a path with Area().
+
+@param[in] in
+Inputs of the path.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@return error
+Error code.
+
+*/
+static int AreaOf(
+    const PathInputs &in,
+    long *warnings,
+    double *A__db
+) {
+    return Area(
+        in.x[0],
+        in.x[1],
+        in.tx_site_criteria,
+        in.rx_site_criteria,
+        in.x[3],
+        in.delta_h__meter,
+        in.x[2],
+        in.pol,
+        in.epsilon,
+        in.sigma,
+        in.p,
+        A__db,
+        warnings
+    );
+}
+
+/**
+@brief
+Evaluate a path with Area_Grad().
+
+@param[in] in
+Inputs of the path.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@param[out] grad
+Partial derivatives of the basic transmission loss.
+
+@return error
+Error code.
+
+*/
+static int AreaGradOf(
+    const PathInputs &in,
+    long *warnings,
+    double *A__db,
+    LossGradient *grad
+) {
+    return Area_Grad(
+        in.x[0],
+        in.x[1],
+        in.tx_site_criteria,
+        in.rx_site_criteria,
+        in.x[3],
+        in.delta_h__meter,
+        in.x[2],
+        in.pol,
+        in.epsilon,
+        in.sigma,
+        in.p,
+        A__db,
+        grad,
+        warnings
+    );
+}
+
+/**
+@brief
+Return the partial derivatives of a gradient as an array.
+
+@param[in] grad
+Partial derivatives of the basic transmission loss.
+
+@param[out] derivative
+Derivatives, in the order of the inputs.
+
+*/
+static void Derivatives(
+    const LossGradient &grad,
+    double derivative[N_INPUTS]
+) {
+    derivative[0] = grad.dA_dh_tx__db_per_meter;
+    derivative[1] = grad.dA_dh_rx__db_per_meter;
+    derivative[2] = grad.dA_df__db_per_mhz;
+    derivative[3] = grad.dA_dd__db_per_km;
+}
+
+/**
+@brief
+Print a tally of the derivatives.
+
+@param[in] name
+Name of the tally.
+
+@param[in] tally
+Tally of the derivatives.
+
+*/
+static void PrintTally(
+    const char *name,
+    const Tally &tally
+) {
+    printf("  %-18s %lld derivatives, %lld smooth, %lld off, %lld overflow, max relative error %.3e\n",
+        name, tally.n, tally.n_smooth, tally.n_off, tally.n_overflow, tally.max_error);
+}
+
+/**
+@brief
+Print a tally of the derivatives of a part of the model, and return its
+number of failures, counting a part that compared no smooth derivatives as a
+failure.
+
+@param[in] name
+Name of the part.
+
+@param[in] tally
+Tally of the derivatives.
+
+@return
+Number of failures.
+
+*/
+static long long ReportPart(
+    const char *name,
+    const Tally &tally
+) {
+    PrintTally(name, tally);
+
+    if (tally.n_smooth == 0)
+    {
+        printf("  %-18s compared no derivatives\n", name);
+        return tally.n_off + 1;
+    }
+
+    return tally.n_off;
+}
+
+int main(int argc, char **argv)
+{
+    int n = 20000;
+    unsigned long long seed = 1;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:s:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            n = atoi(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, nullptr, 10);
+            break;
+        default:
+            fprintf(stderr, "Usage: gradient_check [-n paths] [-s seed]\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    long long n_failed = 0;
+
+    std::vector<PathInputs> paths(n);
+    for (int i = 0; i < n; i++)
+        paths[i] = RandomPath(rng);
+
+    // Area mode, against Area().
+    std::vector<double> A__db(n);
+    std::vector<long> warnings(n);
+    std::vector<int> errors(n);
+
+    double t_0 = Now();
+    for (int i = 0; i < n; i++)
+        errors[i] = AreaOf(paths[i], &warnings[i], &A__db[i]);
+    double t_area = Now() - t_0;
+
+    std::vector<double> A_grad__db(n);
+    std::vector<long> grad_warnings(n);
+    std::vector<int> grad_errors(n);
+    std::vector<LossGradient> grads(n);
+
+    t_0 = Now();
+    for (int i = 0; i < n; i++)
+        grad_errors[i] = AreaGradOf(paths[i], &grad_warnings[i], &A_grad__db[i], &grads[i]);
+    double t_grad = Now() - t_0;
+
+    long long n_area_failed = 0;
+    Tally area_tally = {};
+    for (int i = 0; i < n; i++)
+    {
+        if (errors[i] != grad_errors[i] || warnings[i] != grad_warnings[i]
+            || ((errors[i] == SUCCESS || errors[i] == SUCCESS_WITH_WARNINGS) && !SameBits(A__db[i], A_grad__db[i])))
+        {
+            n_area_failed++;
+            continue;
+        }
+
+        if (!std::isfinite(A__db[i]))
+            continue;
+
+        double derivative[N_INPUTS];
+        Derivatives(grads[i], derivative);
+        for (int k = 0; k < N_INPUTS; k++)
+            Compare([](const PathInputs &a) { long w; double A; AreaOf(a, &w, &A); return A; },
+                paths[i], k, derivative[k], &area_tally);
+    }
+    n_failed += n_area_failed;
+
+    printf("area   %d paths, %lld differ from Area(), Area() %.1f ns/path, Area_Grad() %.1f ns/path\n",
+        n, n_area_failed, 1.0E9 * t_area / n, 1.0E9 * t_grad / n);
+
+    // The finite losses of the area mode, where there are any.
+    PrintTally("loss", area_tally);
+
+    // Parts of the model of the area paths with the engine, for dual numbers.
+    const int n_parts = 7;
+    const char *part_names[n_parts] = { "free space", "line of sight", "knife edge", "diffraction", "variability",
+        "h_e of the TX", "h_e of the RX" };
+    const DoublePart horizontal_parts[n_parts] = {
+        FreeSpacePart<double, HorizontalPolarization>, LineOfSightPart<double, HorizontalPolarization>,
+        KnifeEdgePart<double, HorizontalPolarization>, DiffractionPart<double, HorizontalPolarization>,
+        VariabilityPart<double, HorizontalPolarization>, EffectiveHeightPart<double, HorizontalPolarization, 0>,
+        EffectiveHeightPart<double, HorizontalPolarization, 1> };
+    const DualPart horizontal_dual_parts[n_parts] = {
+        FreeSpacePart<Dual<N_INPUTS>, HorizontalPolarization>, LineOfSightPart<Dual<N_INPUTS>, HorizontalPolarization>,
+        KnifeEdgePart<Dual<N_INPUTS>, HorizontalPolarization>, DiffractionPart<Dual<N_INPUTS>, HorizontalPolarization>,
+        VariabilityPart<Dual<N_INPUTS>, HorizontalPolarization>, EffectiveHeightPart<Dual<N_INPUTS>, HorizontalPolarization, 0>,
+        EffectiveHeightPart<Dual<N_INPUTS>, HorizontalPolarization, 1> };
+    const DoublePart vertical_parts[n_parts] = {
+        FreeSpacePart<double, VerticalPolarization>, LineOfSightPart<double, VerticalPolarization>,
+        KnifeEdgePart<double, VerticalPolarization>, DiffractionPart<double, VerticalPolarization>,
+        VariabilityPart<double, VerticalPolarization>, EffectiveHeightPart<double, VerticalPolarization, 0>,
+        EffectiveHeightPart<double, VerticalPolarization, 1> };
+    const DualPart vertical_dual_parts[n_parts] = {
+        FreeSpacePart<Dual<N_INPUTS>, VerticalPolarization>, LineOfSightPart<Dual<N_INPUTS>, VerticalPolarization>,
+        KnifeEdgePart<Dual<N_INPUTS>, VerticalPolarization>, DiffractionPart<Dual<N_INPUTS>, VerticalPolarization>,
+        VariabilityPart<Dual<N_INPUTS>, VerticalPolarization>, EffectiveHeightPart<Dual<N_INPUTS>, VerticalPolarization, 0>,
+        EffectiveHeightPart<Dual<N_INPUTS>, VerticalPolarization, 1> };
+
+    Tally tallies[n_parts] = {};
+    for (int i = 0; i < n; i++)
+    {
+        const PathInputs &in = paths[i];
+        bool vertical = in.pol == POLARIZATION__VERTICAL;
+        for (int k = 0; k < n_parts; k++)
+            CheckPart(vertical ? vertical_parts[k] : horizontal_parts[k],
+                vertical ? vertical_dual_parts[k] : horizontal_dual_parts[k], in, &tallies[k]);
+    }
+
+    for (int k = 0; k < n_parts; k++)
+        n_failed += ReportPart(part_names[k], tallies[k]);
+
+    // Point-to-point mode, against PointToPoint(), on rough random walk
+    // terrain.
+    long long n_p2p_failed = 0;
+    Tally p2p_tally = {};
+    Tally terrain_tally = {};
+    for (int i = 0; i < n / 10; i++)
+    {
+        int np = 10 + int(1000 * uniform(rng));
+        double roughness__meter = LogUniform(rng, 0.1, 100.0);
+
+        std::vector<double> pfl(np + 3);
+        pfl[0] = np;
+        pfl[1] = LogUniform(rng, 10.0, 1000.0);
+        pfl[2] = 0.0;
+        for (int j = 1; j <= np; j++)
+            pfl[j + 2] = pfl[j + 1] + roughness__meter * normal(rng);
+
+        // The path distance is that of the profile.
+        PathInputs in = paths[i];
+        in.x[3] = pfl[0] * pfl[1] / 1000.0;
+
+        double A_p2p__db;
+        long p2p_warnings;
+        int p2p_error = PointToPoint(in.x[0], in.x[1], pfl.data(), in.x[2], in.pol, in.epsilon, in.sigma, in.p,
+            &A_p2p__db, &p2p_warnings);
+
+        double A_p2p_grad__db;
+        long p2p_grad_warnings;
+        LossGradient grad;
+        int p2p_grad_error = PointToPoint_Grad(in.x[0], in.x[1], pfl.data(), in.x[2], in.pol, in.epsilon, in.sigma, in.p,
+            &A_p2p_grad__db, &grad, &p2p_grad_warnings);
+
+        if (p2p_error != p2p_grad_error || p2p_warnings != p2p_grad_warnings
+            || ((p2p_error == SUCCESS || p2p_error == SUCCESS_WITH_WARNINGS) && !SameBits(A_p2p__db, A_p2p_grad__db)))
+        {
+            n_p2p_failed++;
+            continue;
+        }
+
+        if (p2p_error != SUCCESS && p2p_error != SUCCESS_WITH_WARNINGS)
+            continue;
+
+        CheckTerrain(pfl, in, &terrain_tally);
+
+        if (!std::isfinite(A_p2p__db))
+            continue;
+
+        double derivative[N_INPUTS];
+        Derivatives(grad, derivative);
+        for (int k = 0; k < N_INPUTS; k++)
+            Compare([&](const PathInputs &a) {
+                    std::vector<double> stretched = StretchedProfile(pfl, a.x[3]);
+                    long w;
+                    double A;
+                    PointToPoint(a.x[0], a.x[1], stretched.data(), a.x[2], a.pol, a.epsilon, a.sigma, a.p, &A, &w);
+                    return A;
+                },
+                in, k, derivative[k], &p2p_tally);
+    }
+    n_failed += n_p2p_failed;
+
+    printf("p2p    %d paths, %lld differ from PointToPoint()\n", n / 10, n_p2p_failed);
+
+    // The finite losses of the point-to-point mode, where there are any.
+    PrintTally("loss", p2p_tally);
+    n_failed += ReportPart("terrain", terrain_tally);
+
+    if (n_failed > 0)
+    {
+        printf("FAILED: %lld paths or derivatives are off\n", n_failed);
+        return EXIT_FAILURE;
+    }
+
+    printf("PASSED: the derivatives agree with central differences\n");
+    return EXIT_SUCCESS;
+}
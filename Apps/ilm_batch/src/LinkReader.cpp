@@ -0,0 +1,587 @@
+/**
+@file
+
+This file contains the functions that read the links of a job, as comma
+separated text or binary records.
+*/
+
+/* Standard includes. */
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+/* Local includes. */
+#include "./include/Batch.h"
+
+/**
+@brief
+Initial size of the read buffer, in bytes. The buffer grows to hold the
+longest line.
+*/
+#define READ_BUFFER_BYTES (1 << 20)
+
+/**
+@brief
+First bytes of a binary job file.
+*/
+static const char BINARY_MAGIC[8] = { 'I', 'L', 'M', 'L', 'I', 'N', 'K', 'S' };
+
+/**
+@brief
+Make at least n bytes of unread data available in the read buffer, unless the
+file ends first.
+
+@param[in,out] reader
+Link reader.
+
+@param[in] n
+Number of bytes.
+
+@return
+True if n bytes are available.
+
+*/
+static bool Fill(
+    LinkReader *reader,
+    size_t n
+) {
+    while (reader->end - reader->begin < n && !reader->eof)
+    {
+        // Move the unread data to the front, and grow if it still won't fit.
+        memmove(reader->buffer.data(), reader->buffer.data() + reader->begin, reader->end - reader->begin);
+        reader->end -= reader->begin;
+        reader->begin = 0;
+
+        if (reader->buffer.size() - reader->end < READ_BUFFER_BYTES / 2)
+            reader->buffer.resize(reader->buffer.size() * 2);
+
+        size_t got = fread(reader->buffer.data() + reader->end, 1, reader->buffer.size() - reader->end, reader->file);
+        reader->end += got;
+
+        if (got == 0)
+            reader->eof = true;
+    }
+
+    return reader->end - reader->begin >= n;
+}
+
+/**
+@brief
+Read the next line of a text job file.
+
+@param[in,out] reader
+Link reader.
+
+@param[out] line
+Start of the line, which is terminated in place.
+
+@return
+True if a line was read.
+
+*/
+static bool ReadLine(
+    LinkReader *reader,
+    char **line
+) {
+    size_t searched = 0;
+
+    for (;;)
+    {
+        char *start = reader->buffer.data() + reader->begin;
+        char *newline = (char *)memchr(start + searched, '\n', reader->end - reader->begin - searched);
+
+        if (newline != nullptr || reader->eof)
+        {
+            if (newline == nullptr && reader->end == reader->begin)
+                return false;
+
+            // The last line may not end with a newline.
+            if (newline == nullptr)
+            {
+                Fill(reader, reader->end - reader->begin + 1);
+                start = reader->buffer.data() + reader->begin;
+                newline = start + (reader->end - reader->begin);
+                if (reader->end == reader->buffer.size())
+                    reader->buffer.push_back('\0');
+                reader->end++;
+            }
+
+            *newline = '\0';
+            if (newline > start && newline[-1] == '\r')
+                newline[-1] = '\0';
+
+            *line = start;
+            reader->begin = newline + 1 - reader->buffer.data();
+            return true;
+        }
+
+        searched = reader->end - reader->begin;
+        Fill(reader, searched + 1);
+    }
+}
+
+/**
+@brief
+Parse a number from a field of a text job file.
+
+@param[in] field
+Field.
+
+@param[out] value
+Value.
+
+@return
+True if the whole field is a number.
+
+*/
+static bool ParseNumber(
+    const char *field,
+    double *value
+) {
+    char *end;
+    *value = strtod(field, &end);
+
+    if (end == field)
+        return false;
+
+    while (*end == ' ' || *end == '\t')
+        end++;
+
+    return *end == '\0';
+}
+
+/**
+@brief
+Return if a number is a whole number within a range, so that it can be
+converted to an integer type.
+
+@param[in] value
+Number.
+
+@param[in] lo
+Smallest value.
+
+@param[in] hi
+Largest value.
+
+@return
+True if value is a whole number, lo <= value <= hi. False for NaN.
+
+*/
+static bool IsWholeNumber(
+    double value,
+    double lo,
+    double hi
+) {
+    return value >= lo && value <= hi && value == floor(value);
+}
+
+/**
+@brief
+Parse whitespace separated numbers into a profile in pfl format.
+
+@param[in] text
+Text of the numbers.
+
+@param[out] pfl
+Profile.
+
+@return
+True if the text is a complete profile.
+
+*/
+static bool ParseProfile(
+    const char *text,
+    std::vector<double> *pfl
+) {
+    pfl->clear();
+
+    for (;;)
+    {
+        char *end;
+        double value = strtod(text, &end);
+        if (end == text)
+            break;
+
+        pfl->push_back(value);
+        text = end;
+    }
+
+    while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n')
+        text++;
+
+    return *text == '\0' && pfl->size() >= 4 && IsWholeNumber((*pfl)[0], 1.0, (double)INT_MAX) &&
+        (*pfl)[1] > 0.0 && pfl->size() - 3 == (size_t)(*pfl)[0];
+}
+
+/**
+@brief
+Load a referenced profile file, or reuse it if it was the last one loaded.
+
+@param[in,out] reader
+Link reader.
+
+@param[in] path
+Path of the profile file, whitespace separated numbers in pfl format.
+
+@return
+True if the profile was loaded.
+
+*/
+static bool LoadProfile(
+    LinkReader *reader,
+    const std::string &path
+) {
+    if (path == reader->profile_path)
+        return !reader->profile.empty();
+
+    reader->profile_path = path;
+    reader->profile.clear();
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    std::string text;
+    char block[65536];
+    size_t got;
+    while ((got = fread(block, 1, sizeof(block), file)) > 0)
+        text.append(block, got);
+    fclose(file);
+
+    if (!ParseProfile(text.c_str(), &reader->profile))
+    {
+        reader->profile.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+@brief
+Append a profile to the terrain of a chunk and point a link at it.
+
+@param[in] pfl
+Profile, in pfl format.
+
+@param[in,out] chunk
+Chunk.
+
+@param[out] link
+Link.
+
+*/
+static void AppendProfile(
+    const double pfl[],
+    Chunk *chunk,
+    Link *link
+) {
+    link->np = (int)pfl[0];
+    link->xi__meter = pfl[1];
+    link->z_offset = chunk->z__meter.size();
+
+    chunk->z__meter.insert(chunk->z__meter.end(), &pfl[2], &pfl[2] + link->np + 1);
+}
+
+/**
+@brief
+Parse a line of a text job file into a link.
+
+The line is id,h_tx__meter,h_rx__meter,f__mhz,pol,epsilon,sigma,p,pfl where
+pfl is either @ followed by the path of a profile file, or the profile itself
+as whitespace separated numbers in pfl format.
+
+@param[in,out] reader
+Link reader.
+
+@param[in] line
+Line, which is split in place.
+
+@param[in,out] chunk
+Chunk, whose terrain gets the link's profile.
+
+@param[out] link
+Link.
+
+*/
+static void ParseLine(
+    LinkReader *reader,
+    char *line,
+    Chunk *chunk,
+    Link *link
+) {
+    char *fields[9];
+    int n_fields = 0;
+
+    fields[n_fields++] = line;
+    for (char *c = line; *c != '\0' && n_fields < 9; c++)
+    {
+        if (*c == ',')
+        {
+            *c = '\0';
+            fields[n_fields++] = c + 1;
+        }
+    }
+
+    link->id = fields[0];
+    link->error = ERROR__LINK_INPUT;
+
+    if (n_fields < 9)
+        return;
+
+    double value[7];
+    for (int i = 0; i < 7; i++)
+    {
+        if (!ParseNumber(fields[i + 1], &value[i]))
+            return;
+    }
+
+    // The polarization is converted to int.
+    if (!IsWholeNumber(value[3], (double)INT_MIN, (double)INT_MAX))
+        return;
+
+    link->h_tx__meter = value[0];
+    link->h_rx__meter = value[1];
+    link->f__mhz = value[2];
+    link->pol = (int)value[3];
+    link->epsilon = value[4];
+    link->sigma = value[5];
+    link->p = value[6];
+
+    const char *pfl = fields[8];
+    while (*pfl == ' ' || *pfl == '\t')
+        pfl++;
+
+    if (*pfl == '@')
+    {
+        std::string path(pfl + 1);
+        path.erase(path.find_last_not_of(" \t") + 1);
+
+        if (!LoadProfile(reader, path))
+            return;
+
+        AppendProfile(reader->profile.data(), chunk, link);
+    }
+    else
+    {
+        // Parse into the reader's profile buffer, which no longer holds the
+        // last referenced profile.
+        reader->profile_path.clear();
+
+        if (!ParseProfile(pfl, &reader->profile))
+            return;
+
+        AppendProfile(reader->profile.data(), chunk, link);
+    }
+
+    link->error = 0;
+}
+
+/**
+@brief
+Read a binary record into a link.
+
+A record is a little-endian uint64 id, the doubles h_tx__meter, h_rx__meter,
+f__mhz, epsilon, sigma and p, the int32 pol and an int32 np. If np is not
+negative the double xi__meter and np + 1 double elevations follow; if np is -1
+a uint32 length and the path of a profile file follow.
+
+@param[in,out] reader
+Link reader.
+
+@param[in,out] chunk
+Chunk, whose terrain gets the link's profile.
+
+@param[out] link
+Link.
+
+@return
+True if a record was read.
+
+*/
+static bool ReadRecord(
+    LinkReader *reader,
+    Chunk *chunk,
+    Link *link
+) {
+    const size_t fixed_bytes = 8 + 6 * 8 + 4 + 4;
+
+    if (!Fill(reader, fixed_bytes))
+    {
+        if (reader->end == reader->begin)
+            return false;
+
+        // A truncated record ends the job.
+        link->id = std::to_string(reader->count);
+        link->error = ERROR__LINK_INPUT;
+        reader->begin = reader->end;
+        return true;
+    }
+
+    const char *data = reader->buffer.data() + reader->begin;
+
+    uint64_t id;
+    double value[6];
+    int32_t pol, np;
+    memcpy(&id, data, 8);
+    memcpy(value, data + 8, 6 * 8);
+    memcpy(&pol, data + 56, 4);
+    memcpy(&np, data + 60, 4);
+    reader->begin += fixed_bytes;
+
+    link->id = std::to_string(id);
+    link->h_tx__meter = value[0];
+    link->h_rx__meter = value[1];
+    link->f__mhz = value[2];
+    link->epsilon = value[3];
+    link->sigma = value[4];
+    link->p = value[5];
+    link->pol = pol;
+    link->error = ERROR__LINK_INPUT;
+
+    if (np >= 0)
+    {
+        size_t bytes = 8 * ((size_t)np + 2);
+        if (!Fill(reader, bytes))
+        {
+            reader->begin = reader->end;
+            return true;
+        }
+
+        double xi__meter;
+        memcpy(&xi__meter, reader->buffer.data() + reader->begin, 8);
+
+        link->np = np;
+        link->xi__meter = xi__meter;
+        link->z_offset = chunk->z__meter.size();
+        chunk->z__meter.resize(link->z_offset + np + 1);
+        memcpy(&chunk->z__meter[link->z_offset], reader->buffer.data() + reader->begin + 8, 8 * ((size_t)np + 1));
+        reader->begin += bytes;
+
+        if (np >= 1 && xi__meter > 0.0)
+            link->error = 0;
+    }
+    else if (np == -1)
+    {
+        uint32_t length;
+        if (!Fill(reader, 4))
+        {
+            reader->begin = reader->end;
+            return true;
+        }
+        memcpy(&length, reader->buffer.data() + reader->begin, 4);
+        reader->begin += 4;
+
+        if (!Fill(reader, length))
+        {
+            reader->begin = reader->end;
+            return true;
+        }
+        std::string path(reader->buffer.data() + reader->begin, length);
+        reader->begin += length;
+
+        if (LoadProfile(reader, path))
+        {
+            AppendProfile(reader->profile.data(), chunk, link);
+            link->error = 0;
+        }
+    }
+    else
+    {
+        // The rest of the record can't be found, so the job ends here.
+        reader->begin = reader->end;
+        reader->eof = true;
+    }
+
+    return true;
+}
+
+/**
+@brief
+Start reading a job file, detecting its format.
+
+@param[in] file
+Job file, opened for binary reading.
+
+@param[out] reader
+Link reader.
+
+*/
+void OpenLinkReader(
+    FILE *file,
+    LinkReader *reader
+) {
+    reader->file = file;
+    reader->buffer.assign(READ_BUFFER_BYTES, '\0');
+    reader->begin = 0;
+    reader->end = 0;
+    reader->eof = false;
+    reader->count = 0;
+    reader->profile_path.clear();
+    reader->profile.clear();
+
+    reader->format = JOB_FORMAT__CSV;
+    if (Fill(reader, 16) && memcmp(reader->buffer.data(), BINARY_MAGIC, 8) == 0)
+    {
+        // Skip the magic, version and reserved fields.
+        reader->format = JOB_FORMAT__BINARY;
+        reader->begin += 16;
+    }
+}
+
+/**
+@brief
+Read the next chunk of links of a job.
+
+@param[in,out] reader
+Link reader.
+
+@param[out] chunk
+Chunk, whose buffers are reused.
+
+@return
+True if any links were read.
+
+*/
+bool ReadChunk(
+    LinkReader *reader,
+    Chunk *chunk
+) {
+    chunk->n = 0;
+    chunk->links.resize(CHUNK_LINKS);
+    chunk->z__meter.clear();
+
+    while (chunk->n < CHUNK_LINKS)
+    {
+        Link *link = &chunk->links[chunk->n];
+
+        if (reader->format == JOB_FORMAT__BINARY)
+        {
+            if (!ReadRecord(reader, chunk, link))
+                break;
+        }
+        else
+        {
+            char *line;
+            if (!ReadLine(reader, &line))
+                break;
+
+            while (*line == ' ' || *line == '\t')
+                line++;
+
+            // Skip blank lines, comments and the header.
+            if (*line == '\0' || *line == '#' || strncmp(line, "id,", 3) == 0)
+                continue;
+
+            ParseLine(reader, line, chunk, link);
+        }
+
+        reader->count++;
+        chunk->n++;
+    }
+
+    return chunk->n > 0;
+}
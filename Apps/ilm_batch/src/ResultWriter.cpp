@@ -0,0 +1,64 @@
+/**
+@file
+
+This file contains the functions that write the results of a job as comma
+separated text.
+*/
+
+/* Local includes. */
+#include "./include/Batch.h"
+#include "Errors.h"
+
+/**
+@brief
+Write the header line of the results.
+
+@param[in] file
+Results file.
+
+@return
+True if the header was written.
+
+*/
+bool WriteHeader(
+    FILE *file
+) {
+    return fputs("id,A__db,warnings,error\n", file) >= 0;
+}
+
+/**
+@brief
+Write the results of the links of a chunk, one line per link.
+
+The loss is empty for links with an error.
+
+@param[in] file
+Results file.
+
+@param[in] chunk
+Evaluated chunk.
+
+@return
+True if the results were written.
+
+*/
+bool WriteChunk(
+    FILE *file,
+    const Chunk *chunk
+) {
+    for (int i = 0; i < chunk->n; i++)
+    {
+        const Link &link = chunk->links[i];
+
+        int written;
+        if (link.error == SUCCESS || link.error == SUCCESS_WITH_WARNINGS)
+            written = fprintf(file, "%s,%.10g,0x%lx,%d\n", link.id.c_str(), link.A__db, link.warnings, link.error);
+        else
+            written = fprintf(file, "%s,,0x%lx,%d\n", link.id.c_str(), link.warnings, link.error);
+
+        if (written < 0)
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,254 @@
+/**
+@file
+
+Streaming Point-To-Point driver for the ILM.
+
+Reads a job of links from a file or standard input, evaluates them on a pool
+of threads and writes their results in input order. The work flows through
+three stages connected by bounded lock-free queues: a reader parses chunks of
+links, workers evaluate them and a writer puts them back in order and writes
+them out. Chunks come from a fixed pool and are recycled once written, so
+memory use is bounded however long the job is.
+
+Usage: ilm_batch [-j threads] [-o output] [input]
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Errors.h"
+#include "./include/Batch.h"
+#include "./include/BoundedQueue.h"
+
+/**
+@brief
+Number of chunks in the pool for each worker, enough for every stage to have
+work waiting.
+*/
+#define CHUNKS_PER_WORKER 4
+
+/**
+@brief
+Evaluate the links of a chunk.
+
+@param[in,out] chunk
+Chunk, whose links get their results.
+
+*/
+static void EvaluateChunk(
+    Chunk *chunk
+) {
+    IntermediateValues interValues;
+
+    for (int i = 0; i < chunk->n; i++)
+    {
+        Link &link = chunk->links[i];
+
+        link.warnings = NO_WARNINGS;
+        if (link.error == ERROR__LINK_INPUT)
+            continue;
+
+        TerrainView view = { &chunk->z__meter[link.z_offset], link.np, link.xi__meter, 1 };
+
+        link.error = PointToPointView_Ex(
+            link.h_tx__meter,
+            link.h_rx__meter,
+            &view,
+            link.f__mhz,
+            link.pol,
+            link.epsilon,
+            link.sigma,
+            link.p,
+            &link.A__db,
+            &link.warnings,
+            &interValues
+        );
+    }
+}
+
+/**
+@brief
+Print the usage of the driver.
+
+*/
+static void Usage()
+{
+    fprintf(stderr,
+        "Usage: ilm_batch [-j threads] [-o output] [input]\n"
+        "\n"
+        "Evaluates the Point-To-Point links of a job file, or of standard input\n"
+        "if input is - or not given, and writes id,A__db,warnings,error lines in\n"
+        "input order to output, or to standard output.\n"
+        "\n"
+        "  -j threads  Number of worker threads, default one per hardware thread\n"
+        "  -o output   Results file\n");
+}
+
+int main(int argc, char **argv)
+{
+    int n_workers = 0;
+    const char *output_path = nullptr;
+
+    int option;
+    while ((option = getopt(argc, argv, "j:o:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'j':
+            n_workers = atoi(optarg);
+            break;
+        case 'o':
+            output_path = optarg;
+            break;
+        default:
+            Usage();
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind > 1)
+    {
+        Usage();
+        return EXIT_FAILURE;
+    }
+
+    if (n_workers < 1)
+        n_workers = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    FILE *input = stdin;
+    if (optind < argc && strcmp(argv[optind], "-") != 0)
+    {
+        input = fopen(argv[optind], "rb");
+        if (input == nullptr)
+        {
+            fprintf(stderr, "ilm_batch: cannot open %s\n", argv[optind]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE *output = stdout;
+    if (output_path != nullptr)
+    {
+        output = fopen(output_path, "wb");
+        if (output == nullptr)
+        {
+            fprintf(stderr, "ilm_batch: cannot create %s\n", output_path);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The pool, and queues large enough that pushing never waits.
+    size_t n_chunks = CHUNKS_PER_WORKER * (size_t)n_workers + 4;
+    std::vector<Chunk> pool(n_chunks);
+
+    BoundedQueue<Chunk> free_chunks(n_chunks);
+    BoundedQueue<Chunk> work(n_chunks + n_workers);
+    BoundedQueue<Chunk> done(n_chunks + 1);
+
+    for (Chunk &chunk : pool)
+        free_chunks.Push(&chunk);
+
+    LinkReader reader;
+    OpenLinkReader(input, &reader);
+
+    // Reader stage, ending the workers with a null chunk each.
+    std::thread reader_thread([&]() {
+        for (long long sequence = 0;; sequence++)
+        {
+            Chunk *chunk = free_chunks.Pop();
+            chunk->sequence = sequence;
+
+            if (!ReadChunk(&reader, chunk))
+                break;
+
+            work.Push(chunk);
+        }
+
+        for (int i = 0; i < n_workers; i++)
+            work.Push(nullptr);
+    });
+
+    // Worker stage.
+    std::vector<std::thread> workers;
+    for (int i = 0; i < n_workers; i++)
+    {
+        workers.emplace_back([&]() {
+            Chunk *chunk;
+            while ((chunk = work.Pop()) != nullptr)
+            {
+                EvaluateChunk(chunk);
+                done.Push(chunk);
+            }
+        });
+    }
+
+    // Writer stage, holding chunks that finish early until their turn.
+    bool written = WriteHeader(output);
+    long long n_links = 0;
+    long long n_errors = 0;
+
+    std::thread closer([&]() {
+        for (std::thread &worker : workers)
+            worker.join();
+
+        done.Push(nullptr);
+    });
+
+    // Chunks that finished early, at their sequence modulo the pool size. Every
+    // chunk not yet written has a sequence from next to next + n_chunks - 1,
+    // so no two share a slot.
+    std::vector<Chunk *> pending(n_chunks, nullptr);
+    long long next = 0;
+    Chunk *chunk;
+
+    while ((chunk = done.Pop()) != nullptr)
+    {
+        pending[chunk->sequence % n_chunks] = chunk;
+
+        Chunk *ready;
+        while ((ready = pending[next % n_chunks]) != nullptr)
+        {
+            pending[next % n_chunks] = nullptr;
+
+            written = written && WriteChunk(output, ready);
+            n_links += ready->n;
+            for (int i = 0; i < ready->n; i++)
+            {
+                if (ready->links[i].error != SUCCESS && ready->links[i].error != SUCCESS_WITH_WARNINGS)
+                    n_errors++;
+            }
+
+            next++;
+            free_chunks.Push(ready);
+        }
+    }
+
+    closer.join();
+    reader_thread.join();
+
+    if (input != stdin)
+        fclose(input);
+
+    if (fflush(output) != 0)
+        written = false;
+    if (output != stdout && fclose(output) != 0)
+        written = false;
+
+    fprintf(stderr, "ilm_batch: %lld links, %lld errors, %d threads\n", n_links, n_errors, n_workers);
+
+    if (!written)
+    {
+        fprintf(stderr, "ilm_batch: error writing results\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+#pragma once
+/**
+@file
+
+Links, chunks and pipeline stages of the ilm_batch driver.
+
+Links are read, evaluated and written a chunk at a time. A fixed pool of
+chunks circulates through the pipeline and each chunk reuses its buffers, so
+the memory in use does not grow with the size of the job.
+*/
+
+/* Standard includes. */
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+@brief
+Number of links in each chunk.
+*/
+#define CHUNK_LINKS 256
+
+/**
+@brief
+The link could not be parsed, or its terrain profile could not be read.
+Reported by ilm_batch in place of an ILM error code.
+*/
+#define ERROR__LINK_INPUT 2000
+
+/**
+@brief
+Job file format, comma separated text.
+*/
+#define JOB_FORMAT__CSV 0
+
+/**
+@brief
+Job file format, binary records.
+*/
+#define JOB_FORMAT__BINARY 1
+
+/**
+@brief
+Point-To-Point link of a job, with its results.
+*/
+struct Link
+{
+    /**
+    Link identifier, copied to the output.
+    */
+    std::string id;
+
+    /**
+    Structural height of the TX, in meters.
+    */
+    double h_tx__meter;
+
+    /**
+    Structural height of the RX, in meters.
+    */
+    double h_rx__meter;
+
+    /**
+    Frequency, in MHz.
+    */
+    double f__mhz;
+
+    /**
+    Polarization.
+    */
+    int pol;
+
+    /**
+    Relative permittivity.
+    */
+    double epsilon;
+
+    /**
+    Conductivity.
+    */
+    double sigma;
+
+    /**
+    Location percentage, 0 < p < 100.
+    */
+    double p;
+
+    /**
+    Offset of the first elevation of the profile in the chunk's terrain.
+    */
+    size_t z_offset;
+
+    /**
+    Number of intervals of the profile.
+    */
+    int np;
+
+    /**
+    Profile resolution, in meters.
+    */
+    double xi__meter;
+
+    /**
+    Basic transmission loss, in dB.
+    */
+    double A__db;
+
+    /**
+    Warning flags.
+    */
+    long warnings;
+
+    /**
+    Error code, ERROR__LINK_INPUT if the link could not be read.
+    */
+    int error;
+};
+
+/**
+@brief
+Block of consecutive links of a job.
+*/
+struct Chunk
+{
+    /**
+    Position of the chunk in the job.
+    */
+    long long sequence;
+
+    /**
+    Number of links in use.
+    */
+    int n;
+
+    /**
+    Links, with CHUNK_LINKS entries.
+    */
+    std::vector<Link> links;
+
+    /**
+    Terrain elevations of all links of the chunk, in meters.
+    */
+    std::vector<double> z__meter;
+};
+
+/**
+@brief
+Source of the links of a job.
+*/
+struct LinkReader
+{
+    /**
+    Job file.
+    */
+    FILE *file;
+
+    /**
+    Format of the job file.
+    */
+    int format;
+
+    /**
+    Read buffer.
+    */
+    std::vector<char> buffer;
+
+    /**
+    Start of the unread data in the buffer.
+    */
+    size_t begin;
+
+    /**
+    End of the data in the buffer.
+    */
+    size_t end;
+
+    /**
+    Whether the end of the file has been reached.
+    */
+    bool eof;
+
+    /**
+    Number of lines or records read.
+    */
+    long long count;
+
+    /**
+    Path of the last referenced profile.
+    */
+    std::string profile_path;
+
+    /**
+    Last referenced profile, in pfl format, or empty if it could not be read.
+    */
+    std::vector<double> profile;
+};
+
+void OpenLinkReader(
+    FILE *file,
+    LinkReader *reader
+);
+
+bool ReadChunk(
+    LinkReader *reader,
+    Chunk *chunk
+);
+
+bool WriteChunk(
+    FILE *file,
+    const Chunk *chunk
+);
+
+bool WriteHeader(
+    FILE *file
+);
@@ -0,0 +1,229 @@
+#pragma once
+/**
+@file
+
+Bounded lock-free queue connecting the stages of the ilm_batch pipeline.
+*/
+
+/* Standard includes. */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+/**
+@brief
+Wait strategy for a stage that finds its queue empty or full.
+
+Spins briefly, then yields, then sleeps, so that a stage waiting on a slower
+one does not take a core away from it.
+*/
+struct Backoff
+{
+    /**
+    Number of waits so far.
+    */
+    int count = 0;
+
+    /**
+    Wait a little longer than the last time.
+    */
+    void Wait()
+    {
+        if (count < 64)
+            count++;
+        else if (count < 128)
+        {
+            count++;
+            std::this_thread::yield();
+        }
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+};
+
+/**
+@brief
+Bounded multi-producer multi-consumer queue of pointers.
+
+Each cell carries a sequence number that tells producers and consumers whose
+turn it is, so pushes and pops only need a compare-and-swap on the head or
+tail index (D. Vyukov's bounded MPMC queue).
+*/
+template <typename T>
+struct BoundedQueue
+{
+    /**
+    Queue cell.
+    */
+    struct Cell
+    {
+        /**
+        Position of the cell when it is ready to be pushed, or one past it
+        when it is ready to be popped.
+        */
+        std::atomic<size_t> sequence;
+
+        /**
+        Value in the cell.
+        */
+        T *value;
+    };
+
+    /**
+    Cells of the ring buffer.
+    */
+    std::unique_ptr<Cell[]> cells;
+
+    /**
+    Number of cells minus one.
+    */
+    size_t mask;
+
+    /**
+    Padding to keep head and tail on their own cache lines.
+    */
+    char pad_0[64];
+
+    /**
+    Position of the next pop.
+    */
+    std::atomic<size_t> head;
+
+    /**
+    Padding to keep head and tail on their own cache lines.
+    */
+    char pad_1[64];
+
+    /**
+    Position of the next push.
+    */
+    std::atomic<size_t> tail;
+
+    /**
+    Padding to keep head and tail on their own cache lines.
+    */
+    char pad_2[64];
+
+    /**
+    Create a queue.
+
+    @param[in] capacity
+    Capacity, rounded up to a power of two.
+    */
+    explicit BoundedQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+
+        for (size_t i = 0; i < size; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+    Add a value to the queue if there is room.
+
+    @param[in] value
+    Value to add.
+
+    @return
+    True if the value was added.
+    */
+    bool TryPush(T *value)
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell *cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+
+            if (diff == 0)
+            {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell->value = value;
+                    cell->sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+    Remove the oldest value from the queue if there is one.
+
+    @param[out] value
+    Removed value.
+
+    @return
+    True if a value was removed.
+    */
+    bool TryPop(T **value)
+    {
+        size_t pos = head.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell *cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)(pos + 1);
+
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    *value = cell->value;
+                    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+    Add a value to the queue, waiting for room.
+
+    @param[in] value
+    Value to add.
+    */
+    void Push(T *value)
+    {
+        Backoff backoff;
+        while (!TryPush(value))
+            backoff.Wait();
+    }
+
+    /**
+    Remove the oldest value from the queue, waiting for one.
+
+    @return
+    Removed value.
+    */
+    T *Pop()
+    {
+        T *value;
+        Backoff backoff;
+        while (!TryPop(&value))
+            backoff.Wait();
+
+        return value;
+    }
+};
@@ -0,0 +1,509 @@
+/**
+@file
+
+Check of the incremental Point-To-Point evaluation along a terrain profile,
+PointToPointPrefixes(), against FindHorizons() and PointToPoint_Ex() on each
+prefix.
+
+Evaluates random terrain profiles with the RX at every point, and compares
+each point with PointToPoint_Ex() on the profile truncated at that point.
+Fails if the terrain horizons of a point differ from FindHorizons() in any
+bit, with the points searched in order and in a random order, if an error
+code, warning or mode differs, if a loss or intermediate value differs by
+more than the rounding of the prefix sum fits, or if no finite intermediate
+values were compared. Then reports the largest relative difference and the
+time taken by both.
+
+Usage: prefix_check [-n profiles] [-s seed]
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Enums.h"
+#include "Errors.h"
+#include "ProfilePrefixes.h"
+#include "RadioContext.h"
+#include "Warnings.h"
+#include "Workspace.h"
+
+// Largest relative difference of a loss or intermediate value, from the
+// rounding of the prefix sum fits, which is about 1E-10 on random profiles.
+#define MAX_RELATIVE_DIFFERENCE 1.0E-9
+
+/**
+@brief
+Inputs of one random profile.
+*/
+struct ProfileInputs
+{
+    /**
+    Structural heights of the TX and RX, in meters.
+    */
+    double h_tx__meter;
+    double h_rx__meter;
+
+    /**
+    Terrain data, in pfl format.
+    */
+    std::vector<double> pfl;
+
+    /**
+    Frequency, in MHz.
+    */
+    double f__mhz;
+
+    /**
+    Polarization.
+    */
+    int pol;
+
+    /**
+    Relative permittivity and conductivity.
+    */
+    double epsilon;
+    double sigma;
+
+    /**
+    Location percentage.
+    */
+    double p;
+};
+
+/**
+@brief
+Columns of the intermediate values of every point of a profile.
+*/
+struct IntermediateColumns
+{
+    /**
+    Storage of the double columns, 9 per point.
+    */
+    std::vector<double> values;
+
+    /**
+    Storage of the mode column.
+    */
+    std::vector<int> mode;
+
+    /**
+    Pointers to the columns.
+    */
+    IntermediateValuesBatch batch;
+};
+
+/**
+@brief
+Return the time, in seconds.
+
+@return
+Time, in seconds.
+
+*/
+static double Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+@brief
+Return a random number with a uniform distribution of its logarithm.
+
+@param[in] rng
+Random number generator.
+
+@param[in] lo
+Smallest value, > 0.
+
+@param[in] hi
+Largest value.
+
+@return
+Random number, lo <= x <= hi.
+
+*/
+static double LogUniform(
+    std::mt19937_64 &rng,
+    double lo,
+    double hi
+) {
+    std::uniform_real_distribution<double> uniform(log(lo), log(hi));
+    return std::min(hi, std::max(lo, exp(uniform(rng))));
+}
+
+/**
+@brief
+Return if two values are the same bits.
+
+@param[in] a
+First value.
+
+@param[in] b
+Second value.
+
+@return
+True if the values are identical, including NaNs.
+
+*/
+static bool SameBits(
+    double a,
+    double b
+) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/**
+@brief
+Return if two values agree to within the rounding of the prefix sum fits.
+
+@param[in] a
+First value.
+
+@param[in] b
+Second value.
+
+@param[in,out] max_diff
+Largest relative difference so far.
+
+@return
+True if both values are NaN, or they differ by no more than
+MAX_RELATIVE_DIFFERENCE relative to their magnitude, or than
+MAX_RELATIVE_DIFFERENCE itself if both are smaller than 1.
+
+*/
+static bool Agree(
+    double a,
+    double b,
+    double *max_diff
+) {
+    if (std::isnan(a) || std::isnan(b))
+        return std::isnan(a) && std::isnan(b);
+    if (a == b)
+        return true;
+
+    // Absolute below 1, since angles near zero come from a difference.
+    double diff = fabs(a - b) / std::max(1.0, std::max(fabs(a), fabs(b)));
+    *max_diff = std::max(*max_diff, diff);
+    return diff <= MAX_RELATIVE_DIFFERENCE;
+}
+
+/**
+@brief
+Count the points whose terrain horizons differ from FindHorizons() on the
+prefix of the profile.
+
+@param[in] pfl
+Terrain data, in pfl format.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in] k
+Sample index of each receiver, in the order to search them.
+
+@return
+Number of points whose horizons differ in any bit.
+
+*/
+static long long CountHorizonsDiffer(
+    const std::vector<double> &pfl,
+    double h__meter[2],
+    const std::vector<int> &k
+) {
+    ArenaScope scope(&CurrentWorkspace()->arena);
+
+    PrefixHorizons search;
+    InitializePrefixHorizons(pfl.data(), h__meter, &search);
+
+    long long n_differ = 0;
+    for (size_t j = 0; j < k.size(); j++)
+    {
+        double theta_hzn[2];
+        double d_hzn__meter[2];
+        FindPrefixHorizons(&search, k[j], theta_hzn, d_hzn__meter);
+
+        std::vector<double> prefix(pfl.begin(), pfl.begin() + k[j] + 3);
+        prefix[0] = k[j];
+
+        double theta_p2p[2];
+        double d_p2p__meter[2];
+        FindHorizons(prefix.data(), h__meter, theta_p2p, d_p2p__meter);
+
+        bool same = true;
+        for (int i = 0; i < 2; i++)
+            same = same && SameBits(theta_hzn[i], theta_p2p[i]) && SameBits(d_hzn__meter[i], d_p2p__meter[i]);
+
+        if (!same)
+        {
+            if (n_differ < 5)
+                printf("np %d xi %.17g point %d: d_hzn %.17g %.17g vs %.17g %.17g\n", int(pfl[0]), pfl[1], k[j],
+                    d_hzn__meter[0], d_hzn__meter[1], d_p2p__meter[0], d_p2p__meter[1]);
+            n_differ++;
+        }
+    }
+
+    return n_differ;
+}
+
+/**
+@brief
+Generate a random terrain profile and radio parameters.
+
+The terrain is a random walk with occasional ridges, so that the horizons
+move along the profile, and the resolution is rarely a whole number, so that
+the distances along the profile are rounded.
+
+@param[in] rng
+Random number generator.
+
+@param[out] in
+Inputs of the profile.
+
+*/
+static void RandomProfile(
+    std::mt19937_64 &rng,
+    ProfileInputs *in
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    int np = 2 + int(1500 * uniform(rng));
+    double xi__meter = uniform(rng) < 0.1 ? double(1 + int(100 * uniform(rng))) : LogUniform(rng, 1.0, 2000.0);
+    double roughness__meter = LogUniform(rng, 0.01, 100.0);
+
+    in->pfl.assign(np + 3, 0.0);
+    in->pfl[0] = np;
+    in->pfl[1] = xi__meter;
+    in->pfl[2] = 1000.0 * normal(rng);
+    for (int i = 1; i <= np; i++)
+    {
+        double ridge__meter = uniform(rng) < 0.01 ? 20.0 * roughness__meter * uniform(rng) : 0.0;
+        in->pfl[i + 2] = in->pfl[i + 1] + roughness__meter * normal(rng) + ridge__meter;
+    }
+
+    in->h_tx__meter = LogUniform(rng, 0.5, 3000.0);
+    in->h_rx__meter = LogUniform(rng, 0.5, 3000.0);
+    in->f__mhz = LogUniform(rng, 20.0, 20000.0);
+    in->pol = uniform(rng) < 0.5 ? POLARIZATION__HORIZONTAL : POLARIZATION__VERTICAL;
+    in->epsilon = LogUniform(rng, 1.0, 1000.0);
+    in->sigma = LogUniform(rng, 1.0E-6, 1000.0);
+    in->p = LogUniform(rng, 0.001, 99.999);
+}
+
+/**
+@brief
+Allocate columns of intermediate values.
+
+@param[in] n
+Number of points.
+
+@param[out] columns
+Columns of intermediate values.
+
+*/
+static void AllocateColumns(
+    int n,
+    IntermediateColumns *columns
+) {
+    columns->values.assign(9 * (size_t)n, 0.0);
+    columns->mode.assign(n, MODE__NOT_SET);
+
+    double *v = columns->values.data();
+    IntermediateValuesBatch &batch = columns->batch;
+    for (int i = 0; i < 2; i++)
+    {
+        batch.theta_hzn[i] = &v[(0 + i) * (size_t)n];
+        batch.d_hzn__meter[i] = &v[(2 + i) * (size_t)n];
+        batch.h_e__meter[i] = &v[(4 + i) * (size_t)n];
+    }
+    batch.delta_h__meter = &v[6 * (size_t)n];
+    batch.A_ref__db = &v[7 * (size_t)n];
+    batch.A_fs__db = &v[8 * (size_t)n];
+    batch.d__km = nullptr;
+    batch.mode = columns->mode.data();
+}
+
+int main(int argc, char **argv)
+{
+    int n = 200;
+    unsigned long long seed = 1;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:s:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            n = atoi(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, nullptr, 10);
+            break;
+        default:
+            fprintf(stderr, "Usage: prefix_check [-n profiles] [-s seed]\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937_64 rng(seed);
+
+    long long n_points = 0;
+    long long n_differ = 0;
+    long long n_horizons_differ = 0;
+    long long n_warnings_differ = 0;
+    long long n_values_differ = 0;
+    long long n_finite = 0;
+    double max_diff = 0.0;
+    double t_prefixes = 0.0;
+    double t_p2p = 0.0;
+
+    for (int i_profile = 0; i_profile < n; i_profile++)
+    {
+        ProfileInputs in;
+        RandomProfile(rng, &in);
+
+        int np = int(in.pfl[0]);
+
+        std::vector<double> A__db(np);
+        std::vector<long> warnings(np);
+        std::vector<int> errors(np);
+
+        double t_0 = Now();
+        PointToPointPrefixes(in.h_tx__meter, in.h_rx__meter, in.pfl.data(), in.f__mhz, in.pol, in.epsilon,
+            in.sigma, in.p, A__db.data(), warnings.data(), errors.data());
+        t_prefixes += Now() - t_0;
+
+        // The intermediate values, from the evaluation that PointToPointPrefixes() uses.
+        long common_warnings = NO_WARNINGS;
+        ValidateInputs(in.h_tx__meter, in.h_rx__meter, in.p, in.f__mhz, in.pol, in.epsilon, in.sigma,
+            &common_warnings);
+
+        RadioContext radio;
+        InitializeRadioContext(in.f__mhz, in.pol, in.epsilon, in.sigma, &radio);
+
+        std::vector<int> k(np);
+        for (int j = 0; j < np; j++)
+            k[j] = j + 1;
+
+        IntermediateColumns columns;
+        AllocateColumns(np, &columns);
+
+        std::vector<double> profile = in.pfl;
+        std::vector<double> A_at__db(np);
+        std::vector<long> warnings_at(np);
+        std::vector<int> errors_at(np);
+
+        double h__meter[2] = { in.h_tx__meter, in.h_rx__meter };
+
+        // The horizon search alone, in order and with the receiver moving
+        // back and forth along the profile.
+        std::vector<int> k_random = k;
+        std::shuffle(k_random.begin(), k_random.begin() + std::min(np, 50), rng);
+        n_horizons_differ += CountHorizonsDiffer(in.pfl, h__meter, k) + CountHorizonsDiffer(in.pfl, h__meter, k_random);
+
+        PointToPointAtPrefixes(profile.data(), h__meter, &radio, in.p / 100.0, common_warnings, np, k.data(),
+            A_at__db.data(), warnings_at.data(), errors_at.data(), &columns.batch);
+
+        for (int j = 0; j < np; j++)
+        {
+            // The profile truncated at the RX.
+            std::vector<double> prefix(in.pfl.begin(), in.pfl.begin() + j + 4);
+            prefix[0] = j + 1;
+
+            double A_p2p__db;
+            long warnings_p2p;
+            IntermediateValues iv = {};
+
+            t_0 = Now();
+            int error_p2p = PointToPoint_Ex(in.h_tx__meter, in.h_rx__meter, prefix.data(), in.f__mhz, in.pol,
+                in.epsilon, in.sigma, in.p, &A_p2p__db, &warnings_p2p, &iv);
+            t_p2p += Now() - t_0;
+
+            n_points++;
+
+            bool evaluated = error_p2p == SUCCESS || error_p2p == SUCCESS_WITH_WARNINGS;
+
+            bool same = errors[j] == error_p2p && warnings[j] == warnings_p2p
+                && errors_at[j] == error_p2p && warnings_at[j] == warnings_p2p;
+            if (!same)
+                n_warnings_differ++;
+
+            if (evaluated)
+            {
+                if (columns.mode[j] != iv.mode)
+                {
+                    n_warnings_differ++;
+                    same = false;
+                }
+
+                bool same_values = SameBits(A__db[j], A_at__db[j]) && Agree(A__db[j], A_p2p__db, &max_diff)
+                    && Agree(columns.batch.delta_h__meter[j], iv.delta_h__meter, &max_diff)
+                    && Agree(columns.batch.A_ref__db[j], iv.A_ref__db, &max_diff)
+                    && Agree(columns.batch.A_fs__db[j], iv.A_fs__db, &max_diff);
+                for (int i = 0; i < 2; i++)
+                    same_values = same_values
+                        && Agree(columns.batch.theta_hzn[i][j], iv.theta_hzn[i], &max_diff)
+                        && Agree(columns.batch.d_hzn__meter[i][j], iv.d_hzn__meter[i], &max_diff)
+                        && Agree(columns.batch.h_e__meter[i][j], iv.h_e__meter[i], &max_diff);
+
+                if (!same_values)
+                    n_values_differ++;
+                same = same && same_values;
+
+                if (std::isfinite(iv.theta_hzn[1]) && std::isfinite(iv.d_hzn__meter[1])
+                    && std::isfinite(iv.h_e__meter[1]) && std::isfinite(iv.A_fs__db))
+                    n_finite++;
+            }
+
+            if (!same)
+            {
+                if (n_differ < 10)
+                    printf("profile %d np %d xi %.17g point %d: warnings 0x%lx vs 0x%lx, h_e[1] %.17g vs %.17g, "
+                        "d_hzn[1] %.17g vs %.17g\n",
+                        i_profile, np, in.pfl[1], j + 1, warnings_at[j], warnings_p2p,
+                        columns.batch.h_e__meter[1][j], iv.h_e__meter[1],
+                        columns.batch.d_hzn__meter[1][j], iv.d_hzn__meter[1]);
+                n_differ++;
+            }
+        }
+    }
+
+    printf("prefix %d profiles, %lld points, %lld horizons differ from FindHorizons()\n",
+        n, n_points, n_horizons_differ);
+    printf("       %lld differ from PointToPoint_Ex() (%lld errors, warnings or modes, %lld values), "
+        "%lld with finite intermediate values, max relative difference %.3e\n",
+        n_differ, n_warnings_differ, n_values_differ, n_finite, max_diff);
+    printf("       PointToPointPrefixes() %.1f ns/point, PointToPoint_Ex() %.1f ns/point\n",
+        1.0E9 * t_prefixes / n_points, 1.0E9 * t_p2p / n_points);
+
+    if (n_horizons_differ > 0)
+    {
+        printf("FAILED: %lld horizons differ from FindHorizons() on the prefix\n", n_horizons_differ);
+        return EXIT_FAILURE;
+    }
+
+    if (n_differ > 0)
+    {
+        printf("FAILED: %lld points differ from PointToPoint_Ex() on the prefix\n", n_differ);
+        return EXIT_FAILURE;
+    }
+
+    if (n_finite == 0)
+    {
+        printf("FAILED: no finite intermediate values were compared\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("PASSED: every point agrees with PointToPoint_Ex() on the prefix\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/**
+@file
+
+Benchmark of great circle profile extraction from a lunar DEM.
+
+Extracts the same batch of random profiles one at a time with
+ExtractGreatCircleProfile() and as a batch with ExtractGreatCircleProfiles(),
+and reports the DEM samples per second of each and the largest difference
+between them. The profiles start between latitudes -60 and 60 degrees, so the
+DEM should be global. Without a DEM file, a synthetic global equirectangular
+DEM is written to the working directory for the run.
+
+Usage: profile_benchmark [-n profiles] [-x spacing] [-j threads] [dem]
+*/
+
+/* Standard includes. */
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Errors.h"
+
+/**
+@brief
+Resolution of the synthetic DEM, in pixels per degree.
+*/
+#define SYNTHETIC_PX_PER_DEG 16
+
+/**
+@brief
+Write a synthetic global equirectangular DEM of rolling terrain.
+
+@param[in] path
+Path of the DEM file.
+
+@return
+True if the file was written.
+
+*/
+static bool WriteSyntheticDem(
+    const char *path
+) {
+    int lines = 180 * SYNTHETIC_PX_PER_DEG;
+    int samples = 360 * SYNTHETIC_PX_PER_DEG;
+
+    char label[1024];
+    snprintf(label, sizeof(label),
+        "PDS_VERSION_ID = PDS3\r\nRECORD_BYTES = 1024\r\n^IMAGE = 2\r\n"
+        "LINES = %d\r\nLINE_SAMPLES = %d\r\nSAMPLE_TYPE = LSB_INTEGER\r\nSAMPLE_BITS = 16\r\n"
+        "SCALING_FACTOR = 0.5\r\nOFFSET = 0.\r\n"
+        "MAP_PROJECTION_TYPE = \"SIMPLE CYLINDRICAL\"\r\nMAP_RESOLUTION = %d <pix/deg>\r\n"
+        "CENTER_LATITUDE = 0.\r\nCENTER_LONGITUDE = 180.\r\n"
+        "LINE_PROJECTION_OFFSET = %.1f\r\nSAMPLE_PROJECTION_OFFSET = %.1f\r\nEND\r\n",
+        lines, samples, SYNTHETIC_PX_PER_DEG, lines / 2 - 0.5, samples / 2 - 0.5);
+
+    std::string record(label);
+    record.resize(1024, ' ');
+
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+
+    bool written = fwrite(record.data(), 1, record.size(), file) == record.size();
+
+    std::vector<int16_t> line(samples);
+    for (int j = 0; j < lines && written; j++)
+    {
+        for (int i = 0; i < samples; i++)
+            line[i] = (int16_t)(2000.0 * sin(i * 0.013) * cos(j * 0.021) + 500.0 * sin((i + j) * 0.11));
+
+        written = fwrite(line.data(), sizeof(int16_t), samples, file) == (size_t)samples;
+    }
+
+    return fclose(file) == 0 && written;
+}
+
+/**
+@brief
+Return the time, in seconds.
+
+@return
+Time, in seconds.
+
+*/
+static double Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char **argv)
+{
+    int n = 20000;
+    double xi__meter = 0.0;
+    int n_threads = 0;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:x:j:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            n = atoi(optarg);
+            break;
+        case 'x':
+            xi__meter = atof(optarg);
+            break;
+        case 'j':
+            n_threads = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: profile_benchmark [-n profiles] [-x spacing] [-j threads] [dem]\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::string path = "profile_benchmark.img";
+    bool synthetic = optind >= argc;
+
+    if (synthetic)
+    {
+        if (!WriteSyntheticDem(path.c_str()))
+        {
+            fprintf(stderr, "profile_benchmark: cannot write %s\n", path.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    else
+        path = argv[optind];
+
+    LunarDem *dem;
+    if (OpenLunarDem(path.c_str(), &dem) != SUCCESS)
+    {
+        fprintf(stderr, "profile_benchmark: cannot open %s\n", path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (xi__meter <= 0.0)
+        xi__meter = LunarDemSpacing(dem);
+
+    // Profiles of up to 200 km from random points away from the poles.
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    std::vector<double> lat_tx(n), lon_tx(n), lat_rx(n), lon_rx(n), xi(n, xi__meter);
+    for (int i = 0; i < n; i++)
+    {
+        double azimuth = 2.0 * M_PI * uniform(rng);
+        double d__deg = 200000.0 / a_m__meter * 180.0 / M_PI * uniform(rng);
+
+        lat_tx[i] = -60.0 + 120.0 * uniform(rng);
+        lon_tx[i] = 360.0 * uniform(rng);
+        lat_rx[i] = lat_tx[i] + d__deg * cos(azimuth);
+        lon_rx[i] = lon_tx[i] + d__deg * sin(azimuth);
+    }
+
+    std::vector<long long> offsets(n);
+    long long size = PlanGreatCircleProfiles(n, lat_tx.data(), lon_tx.data(), lat_rx.data(), lon_rx.data(), xi.data(), offsets.data());
+
+    std::vector<double> single(size);
+    std::vector<double> batched(size);
+    std::vector<int> errors(n);
+
+    long long n_samples = 0;
+    double t_0 = Now();
+    for (int i = 0; i < n; i++)
+    {
+        int np = (int)((i + 1 < n ? offsets[i + 1] : size) - offsets[i] - 3);
+        if (ExtractGreatCircleProfile(dem, lat_tx[i], lon_tx[i], lat_rx[i], lon_rx[i], np, &single[offsets[i]]) == SUCCESS)
+            n_samples += np + 1;
+    }
+    double t_single = Now() - t_0;
+
+    t_0 = Now();
+    ExtractGreatCircleProfiles(dem, n, lat_tx.data(), lon_tx.data(), lat_rx.data(), lon_rx.data(), xi.data(), offsets.data(), batched.data(), errors.data(), 1);
+    double t_batched = Now() - t_0;
+
+    t_0 = Now();
+    ExtractGreatCircleProfiles(dem, n, lat_tx.data(), lon_tx.data(), lat_rx.data(), lon_rx.data(), xi.data(), offsets.data(), batched.data(), errors.data(), n_threads);
+    double t_parallel = Now() - t_0;
+
+    double max_diff__meter = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        if (errors[i] != SUCCESS)
+            continue;
+
+        for (long long k = offsets[i]; k < offsets[i] + (long long)batched[offsets[i]] + 3; k++)
+            max_diff__meter = std::max(max_diff__meter, fabs(batched[k] - single[k]));
+    }
+
+    printf("%d profiles, %lld samples, spacing %.1f m\n", n, n_samples, xi__meter);
+    printf("one at a time         %8.1f Msamples/s\n", n_samples / t_single / 1e6);
+    printf("batched, 1 thread     %8.1f Msamples/s\n", n_samples / t_batched / 1e6);
+    printf("batched, all threads  %8.1f Msamples/s\n", n_samples / t_parallel / 1e6);
+    printf("largest difference    %8.2g m\n", max_diff__meter);
+
+    CloseLunarDem(dem);
+    if (synthetic)
+        remove(path.c_str());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,649 @@
+/**
+@file
+
+Check of the range-to-threshold solver, SolveAreaRange() and AreaRange(),
+against a dense scan of the loss over distance.
+
+Draws random Longley-Rice coefficients, with the line-of-sight fit meeting
+the trans-horizon line at d_ls or stepping there, and random thresholds near
+the loss over a random range of distances. Scans the loss of the area mode,
+from EvaluateLongleyRice(), FreeSpaceLoss() and Variability(), over a fine
+grid of distances, and fails if the crossings of SolveAreaRange() do not
+account for each crossing of the scan, are out of order or in the wrong
+direction, or are not crossings of the loss within a relative distance of
+1e-8, or if SolveAreaRange() returns an error.
+
+Then checks AreaRange() against a scan of AreaCurve() for random area paths.
+Where the loss of the scan is not finite, AreaRange() must return
+ERROR__LOSS_NOT_FINITE, and elsewhere its range must fall in the scan interval
+where the loss first reaches the threshold. As the loss of the area mode is
+not finite in this tree, the crossings of each path are also solved for from
+its own Longley-Rice coefficients, with a random reference attenuation where
+that of the path is not finite, and checked as above. Fails if the area paths
+compared no crossings. Reports the time taken by the solvers and by bisection
+for the range; that of AreaRange() and of bisection over Area() is of paths
+whose loss is not finite, where AreaRange() returns at its first sample.
+
+Usage: range_check [-n problems] [-s seed]
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Enums.h"
+#include "Errors.h"
+#include "Internal.h"
+#include "RadioContext.h"
+
+// Number of distances of the scan of the loss.
+#define N_SCAN 4000
+
+// Maximum number of crossings returned by the solver.
+#define N_MAX_CROSSINGS 16
+
+// Number of bisections for the range.
+#define N_BISECTIONS 40
+
+/**
+@brief
+Inputs of one random range problem.
+*/
+struct RangeInputs
+{
+    /**
+    Longley-Rice coefficients.
+    */
+    LongleyRiceCoefficients coeffs;
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    double delta_h__meter;
+
+    /**
+    Frequency, in MHz.
+    */
+    double f__mhz;
+
+    /**
+    Location percentage.
+    */
+    double p;
+
+    /**
+    Threshold of the basic transmission loss, in dB.
+    */
+    double A__db;
+
+    /**
+    Range of distances, in km.
+    */
+    double d_min__km;
+    double d_max__km;
+};
+
+/**
+@brief
+Return the time, in seconds.
+
+@return
+Time, in seconds.
+
+*/
+static double Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+@brief
+Return a random number with a uniform distribution of its logarithm.
+
+@param[in] rng
+Random number generator.
+
+@param[in] lo
+Smallest value, > 0.
+
+@param[in] hi
+Largest value.
+
+@return
+Random number, lo <= x <= hi.
+
+*/
+static double LogUniform(
+    std::mt19937_64 &rng,
+    double lo,
+    double hi
+) {
+    std::uniform_real_distribution<double> uniform(log(lo), log(hi));
+    return std::min(hi, std::max(lo, exp(uniform(rng))));
+}
+
+/**
+@brief
+Compute the basic transmission loss of the area mode from Longley-Rice
+coefficients, as Area() does.
+
+@param[in] in
+Inputs of the range.
+
+@param[in] d__km
+Path distance, in km.
+
+@return
+Basic transmission loss, in dB.
+
+*/
+static double Loss(
+    const RangeInputs &in,
+    double d__km
+) {
+    double d__meter = d__km * 1000.0;
+    double A_ref__db;
+    long warnings = NO_WARNINGS;
+    int propmode;
+    EvaluateLongleyRice(&in.coeffs, d__meter, &A_ref__db, &warnings, &propmode);
+
+    return FreeSpaceLoss(d__meter, in.f__mhz)
+        + Variability(in.p / 100.0, in.delta_h__meter, in.f__mhz, d__meter, A_ref__db);
+}
+
+/**
+@brief
+Return if a loss is at or above the threshold, as the solver takes it.
+*/
+static bool AtOrAbove(
+    double A__db,
+    double threshold__db
+) {
+    return !(A__db - threshold__db < 0.0);
+}
+
+/**
+@brief
+Draw the reference attenuation of random Longley-Rice coefficients, for their
+distances: the trans-horizon line, and the line-of-sight fit meeting it at
+d_ls or stepping there.
+
+@param[in] rng
+Random number generator.
+
+@param[in,out] c
+Longley-Rice coefficients, with the distances set.
+
+*/
+static void RandomReference(
+    std::mt19937_64 &rng,
+    LongleyRiceCoefficients *c
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    c->m_d = LogUniform(rng, 1.0E-5, 1.0E-3);
+    c->A_ed__db = -30.0 + 90.0 * uniform(rng);
+    c->kHat_1 = -2.0E-4 + 7.0E-4 * uniform(rng);
+    c->kHat_2 = -10.0 + 20.0 * uniform(rng);
+
+    // Meet the trans-horizon line at d_ls, or step there.
+    double step__db = (uniform(rng) < 0.8) ? 0.0 : -5.0 + 10.0 * uniform(rng);
+    c->A_o__db = c->m_d * c->d_ls__meter + c->A_ed__db - c->kHat_1 * c->d_ls__meter
+        - c->kHat_2 * log(c->d_ls__meter) + step__db;
+}
+
+/**
+@brief
+Draw a threshold near the loss somewhere in the range.
+
+@param[in] rng
+Random number generator.
+
+@param[in] in
+Inputs of the range, but the threshold.
+
+@return
+Threshold of the basic transmission loss, in dB.
+
+*/
+static double RandomThreshold(
+    std::mt19937_64 &rng,
+    const RangeInputs &in
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    double d__km = LogUniform(rng, in.d_min__km, in.d_max__km);
+    return Loss(in, d__km) - 3.0 + 6.0 * uniform(rng);
+}
+
+/**
+@brief
+Draw random Longley-Rice coefficients and a threshold.
+
+@param[in] rng
+Random number generator.
+
+@return
+Inputs of the range.
+
+*/
+static RangeInputs RandomRange(
+    std::mt19937_64 &rng
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    RangeInputs in;
+    LongleyRiceCoefficients &c = in.coeffs;
+
+    c.d_ls__meter = LogUniform(rng, 5.0E3, 200.0E3);
+    c.d_l__meter = c.d_ls__meter * (1.0 + 0.5 * uniform(rng));
+    c.d_min__meter = 1.0E3;
+    RandomReference(rng, &c);
+
+    in.delta_h__meter = LogUniform(rng, 1.0, 500.0);
+    in.f__mhz = LogUniform(rng, 20.0, 20000.0);
+    in.p = 1.0 + 98.0 * uniform(rng);
+    in.d_min__km = LogUniform(rng, 0.5, 20.0);
+    in.d_max__km = in.d_min__km * LogUniform(rng, 2.0, 500.0);
+    in.A__db = RandomThreshold(rng, in);
+
+    return in;
+}
+
+/**
+@brief
+Check the crossings of one range problem against a scan of the loss.
+
+A pair of crossings closer than the spacing of the scan may fall between two
+of its distances, so each interval of the scan must hold an odd number of
+crossings where the loss crosses over it, and an even number elsewhere.
+
+@param[in] in
+Inputs of the range.
+
+@param[out] n_crossings
+Number of crossings of the solver.
+
+@return
+True if the crossings agree with the scan.
+
+*/
+static bool CheckRange(
+    const RangeInputs &in,
+    int *n_crossings
+) {
+    double d__km[N_MAX_CROSSINGS];
+    int direction[N_MAX_CROSSINGS];
+    int n = 0;
+    double d_range__km;
+    int rtn = SolveAreaRange(&in.coeffs, in.delta_h__meter, in.f__mhz, in.p, in.A__db, in.d_min__km, in.d_max__km,
+        N_MAX_CROSSINGS, d__km, direction, &n, &d_range__km);
+    *n_crossings = n;
+    if (rtn != SUCCESS)
+        return false;
+
+    bool ok = (n < N_MAX_CROSSINGS);
+
+    // The crossings alternate in direction, from the side of the smallest
+    // distance, and the range is where the loss first reaches the threshold.
+    bool above_min = AtOrAbove(Loss(in, in.d_min__km), in.A__db);
+    for (int i = 0; i < n; i++)
+    {
+        if (direction[i] != (((i % 2 == 0) != above_min) ? 1 : -1))
+            ok = false;
+        if (i > 0 && d__km[i] < d__km[i - 1])
+            ok = false;
+    }
+    double d_expected__km = above_min ? in.d_min__km : (n > 0) ? d__km[0] : in.d_max__km;
+    if (d_range__km != d_expected__km)
+        ok = false;
+
+    // Scan on a logarithmic grid, with the ends exact.
+    double ratio = pow(in.d_max__km / in.d_min__km, 1.0 / (N_SCAN - 1));
+    double d_prev__km = in.d_min__km;
+    bool above_prev = above_min;
+    int k = 0;
+
+    for (int j = 1; j < N_SCAN; j++)
+    {
+        double d_scan__km = (j == N_SCAN - 1) ? in.d_max__km : in.d_min__km * pow(ratio, j);
+        bool above = AtOrAbove(Loss(in, d_scan__km), in.A__db);
+
+        int m = 0;
+        for (; k < n && d__km[k] <= d_scan__km; k++)
+        {
+            if (d__km[k] < d_prev__km)
+                ok = false;
+            m++;
+        }
+        if ((m % 2 == 1) != (above != above_prev))
+            ok = false;
+
+        d_prev__km = d_scan__km;
+        above_prev = above;
+    }
+    if (k != n)
+        ok = false;
+
+    // The loss crosses at each crossing, or steps there at d_ls.
+    for (int i = 0; i < n; i++)
+    {
+        if (d__km[i] * 1000.0 == in.coeffs.d_ls__meter)
+            continue;
+        bool below = AtOrAbove(Loss(in, d__km[i] * (1.0 - 1.0E-8)), in.A__db);
+        bool above = AtOrAbove(Loss(in, d__km[i] * (1.0 + 1.0E-8)), in.A__db);
+        if (below == above)
+            ok = false;
+    }
+
+    return ok;
+}
+
+/**
+@brief
+Bisect for the smallest distance at which the loss reaches the threshold,
+assuming a single rising crossing.
+
+@param[in] loss
+Loss at a distance in km.
+
+@param[in] A__db
+Threshold, in dB.
+
+@param[in] d_min__km
+Smallest distance, in km.
+
+@param[in] d_max__km
+Largest distance, in km.
+
+@return
+Distance, in km.
+
+*/
+template <typename F>
+static double Bisect(
+    F loss,
+    double A__db,
+    double d_min__km,
+    double d_max__km
+) {
+    for (int i = 0; i < N_BISECTIONS; i++)
+    {
+        double d__km = 0.5 * (d_min__km + d_max__km);
+        if (AtOrAbove(loss(d__km), A__db))
+            d_max__km = d__km;
+        else
+            d_min__km = d__km;
+    }
+    return d_max__km;
+}
+
+/**
+@brief
+Compute the Longley-Rice coefficients of an area path, as AreaRange() does.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in] site_criteria
+Siting criteria of the terminals.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[out] coeffs
+Longley-Rice coefficients.
+
+@return error
+Error code.
+
+*/
+static int AreaCoefficients(
+    double h__meter[2],
+    int site_criteria[2],
+    double delta_h__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    LongleyRiceCoefficients *coeffs
+) {
+    RadioContext radio;
+    InitializeRadioContext(f__mhz, pol, epsilon, sigma, &radio);
+
+    double theta_hzn[2];
+    double d_hzn__meter[2];
+    double h_e__meter[2];
+    InitializeArea(site_criteria, delta_h__meter, h__meter, h_e__meter, d_hzn__meter, theta_hzn);
+
+    long warnings = NO_WARNINGS;
+    return InitializeLongleyRice(theta_hzn, &radio, d_hzn__meter, h_e__meter, delta_h__meter, h__meter, coeffs,
+        &warnings);
+}
+
+int main(int argc, char **argv)
+{
+    int n = 20000;
+    unsigned long long seed = 1;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:s:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            n = atoi(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, nullptr, 10);
+            break;
+        default:
+            fprintf(stderr, "Usage: range_check [-n problems] [-s seed]\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    long long n_failed = 0;
+
+    // Range problems from random coefficients.
+    std::vector<RangeInputs> problems(n);
+    for (int i = 0; i < n; i++)
+        problems[i] = RandomRange(rng);
+
+    long long n_off = 0;
+    long long n_crossings = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int n_scan = 0;
+        if (!CheckRange(problems[i], &n_scan))
+            n_off++;
+        n_crossings += n_scan;
+    }
+    n_failed += n_off;
+
+    double d__km[N_MAX_CROSSINGS];
+    int direction[N_MAX_CROSSINGS];
+    int n_found;
+    double d_range__km;
+    double checksum = 0.0;
+
+    double t_0 = Now();
+    for (int i = 0; i < n; i++)
+    {
+        const RangeInputs &in = problems[i];
+        SolveAreaRange(&in.coeffs, in.delta_h__meter, in.f__mhz, in.p, in.A__db, in.d_min__km, in.d_max__km,
+            N_MAX_CROSSINGS, d__km, direction, &n_found, &d_range__km);
+        checksum += d_range__km;
+    }
+    double t_solve = (Now() - t_0) / n;
+
+    t_0 = Now();
+    for (int i = 0; i < n; i++)
+    {
+        const RangeInputs &in = problems[i];
+        checksum += Bisect([&](double d) { return Loss(in, d); }, in.A__db, in.d_min__km, in.d_max__km);
+    }
+    double t_bisect = (Now() - t_0) / n;
+
+    printf("coefficients %d problems, %lld crossings, %lld off, SolveAreaRange() %.1f ns, bisection %.1f ns\n",
+        n, n_crossings, n_off, t_solve * 1.0E9, t_bisect * 1.0E9);
+
+    // Area paths, against a scan of AreaCurve().
+    int n_area = std::max(1, n / 10);
+    std::vector<double> d_scan__km(N_SCAN / 10);
+    std::vector<double> A_scan__db(d_scan__km.size());
+    std::vector<long> warnings_scan(d_scan__km.size());
+    long long n_area_off = 0;
+    long long n_area_finite = 0;
+    long long n_area_not_finite = 0;
+    long long n_coeffs_off = 0;
+    long long n_coeffs_crossings = 0;
+    double t_range = 0.0;
+    double t_area = 0.0;
+
+    for (int i = 0; i < n_area; i++)
+    {
+        double h_tx__meter = LogUniform(rng, 0.5, 3000.0);
+        double h_rx__meter = LogUniform(rng, 0.5, 3000.0);
+        int tx_site_criteria = (uniform(rng) < 0.5) ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED;
+        int rx_site_criteria = (uniform(rng) < 0.5) ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED;
+        double delta_h__meter = LogUniform(rng, 1.0, 500.0);
+        double f__mhz = LogUniform(rng, 20.0, 20000.0);
+        int pol = (uniform(rng) < 0.5) ? POLARIZATION__HORIZONTAL : POLARIZATION__VERTICAL;
+        double epsilon = 1.0 + 99.0 * uniform(rng);
+        double sigma = LogUniform(rng, 1.0E-5, 10.0);
+        double p = 1.0 + 98.0 * uniform(rng);
+        double A__db = 80.0 + 140.0 * uniform(rng);
+        double d_min__km = LogUniform(rng, 0.5, 20.0);
+        double d_max__km = d_min__km * LogUniform(rng, 2.0, 500.0);
+
+        long warnings;
+        t_0 = Now();
+        int rtn = AreaRange(h_tx__meter, h_rx__meter, tx_site_criteria, rx_site_criteria, d_min__km, d_max__km,
+            delta_h__meter, f__mhz, pol, epsilon, sigma, p, A__db, N_MAX_CROSSINGS, d__km, direction, &n_found,
+            &d_range__km, &warnings);
+        t_range += Now() - t_0;
+
+        t_0 = Now();
+        checksum += Bisect([&](double d) {
+            double A_bisect__db;
+            long w;
+            Area(h_tx__meter, h_rx__meter, tx_site_criteria, rx_site_criteria, d, delta_h__meter, f__mhz, pol,
+                epsilon, sigma, p, &A_bisect__db, &w);
+            return A_bisect__db;
+        }, A__db, d_min__km, d_max__km);
+        t_area += Now() - t_0;
+
+        double ratio = pow(d_max__km / d_min__km, 1.0 / (d_scan__km.size() - 1));
+        for (size_t j = 0; j < d_scan__km.size(); j++)
+            d_scan__km[j] = (j == d_scan__km.size() - 1) ? d_max__km : d_min__km * pow(ratio, double(j));
+        int rtn_curve = AreaCurve(h_tx__meter, h_rx__meter, tx_site_criteria, rx_site_criteria,
+            int(d_scan__km.size()), d_scan__km.data(), delta_h__meter, f__mhz, pol, epsilon, sigma, p,
+            A_scan__db.data(), warnings_scan.data(), nullptr);
+
+        // The same errors of the inputs.
+        if (rtn_curve != SUCCESS && rtn_curve != SUCCESS_WITH_WARNINGS)
+        {
+            if (rtn != rtn_curve)
+                n_area_off++;
+            continue;
+        }
+
+        // The loss is not finite over a whole piece of the reference
+        // attenuation where its coefficients are not, and AreaRange() samples
+        // the ends of each piece, so it must report it.
+        bool finite = std::all_of(A_scan__db.begin(), A_scan__db.end(), [](double A) { return std::isfinite(A); });
+        if (!finite)
+        {
+            if (rtn == ERROR__LOSS_NOT_FINITE)
+                n_area_not_finite++;
+            else
+                n_area_off++;
+        }
+        else if (rtn != SUCCESS && rtn != SUCCESS_WITH_WARNINGS)
+        {
+            n_area_off++;
+        }
+        else
+        {
+            // The range within the scan interval where the loss first
+            // reaches the threshold.
+            size_t j = 0;
+            while (j < d_scan__km.size() && !AtOrAbove(A_scan__db[j], A__db))
+                j++;
+            double lo__km = (j == 0) ? d_min__km : (j == d_scan__km.size()) ? d_max__km : d_scan__km[j - 1];
+            double hi__km = (j == d_scan__km.size()) ? d_max__km : d_scan__km[j];
+            if (d_range__km < lo__km || d_range__km > hi__km)
+                n_area_off++;
+            n_area_finite++;
+        }
+
+        // The crossings from the coefficients of the path, with a random
+        // reference attenuation where that of the path is not finite.
+        double h__meter[2] = { h_tx__meter, h_rx__meter };
+        int site_criteria[2] = { tx_site_criteria, rx_site_criteria };
+        RangeInputs in;
+        if (AreaCoefficients(h__meter, site_criteria, delta_h__meter, f__mhz, pol, epsilon, sigma,
+            &in.coeffs) != SUCCESS)
+            continue;
+
+        const LongleyRiceCoefficients &c = in.coeffs;
+        if (!std::isfinite(c.m_d) || !std::isfinite(c.A_ed__db) || !std::isfinite(c.kHat_1) ||
+            !std::isfinite(c.kHat_2) || !std::isfinite(c.A_o__db))
+            RandomReference(rng, &in.coeffs);
+        in.delta_h__meter = delta_h__meter;
+        in.f__mhz = f__mhz;
+        in.p = p;
+        in.d_min__km = d_min__km;
+        in.d_max__km = d_max__km;
+        in.A__db = RandomThreshold(rng, in);
+
+        int n_scan = 0;
+        if (!CheckRange(in, &n_scan))
+            n_coeffs_off++;
+        n_coeffs_crossings += n_scan;
+    }
+    n_failed += n_area_off + n_coeffs_off;
+
+    printf("area         %d paths, %lld off, %lld finite, %lld not finite, AreaRange() %.1f ns, "
+        "bisection over Area() %.1f ns (checksum %g)\n",
+        n_area, n_area_off, n_area_finite, n_area_not_finite, t_range / n_area * 1.0E9, t_area / n_area * 1.0E9,
+        checksum);
+    printf("area coeffs  %d paths, %lld crossings, %lld off\n", n_area, n_coeffs_crossings, n_coeffs_off);
+    if (n_coeffs_crossings == 0)
+    {
+        n_failed++;
+        printf("area         compared no crossings\n");
+    }
+
+    if (n_failed > 0)
+    {
+        printf("FAILED: %lld problems or paths are off\n", n_failed);
+        return EXIT_FAILURE;
+    }
+
+    printf("PASSED: the crossings agree with the scans\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,694 @@
+/**
+@file
+
+Validation of the AVX2 kernel of the Longley-Rice method.
+
+Checks each term of LongleyRiceAvx2() against its scalar function on finite
+arguments: the exponential, logarithms, cube root, sine and cosine, the
+Fresnel integral, the height gain function, the inverse CCDF, and the
+knife-edge, smooth sphere and line-of-sight losses on the geometry of random
+paths. Then evaluates random point-to-point and area paths four at a time with
+LongleyRiceAvx2() and LongleyRiceLanesScalar(), and compares the mode and the
+warnings of each lane, the free space loss, and the reference attenuation and
+basic transmission loss where they are finite, which must be finite in both
+or in neither.
+
+Fails if a term or loss exceeds its bound, if a lane differs in mode,
+warnings or finiteness, if any check compared no finite values, or if the
+build or the CPU has no AVX2, as nothing is then compared.
+
+Usage: simd_check [-n paths] [-b bound__db] [-s seed]
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <unistd.h>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Enums.h"
+#include "Errors.h"
+#include "LongleyRiceLanes.h"
+#include "RadioContext.h"
+#include "Simd.h"
+
+/**
+@brief
+Deviations of the AVX2 kernel from the scalar functions of one quantity.
+*/
+struct Deviation
+{
+    /**
+    Number of finite values compared.
+    */
+    long long n_compared;
+
+    /**
+    Number of values that exceeded their bound, or that were finite in only
+    one of the two.
+    */
+    long long n_failed;
+
+    /**
+    Number of arguments skipped because the two could choose different
+    pieces of a function.
+    */
+    long long n_boundary;
+
+    /**
+    Largest absolute deviation.
+    */
+    double max_diff;
+};
+
+/**
+@brief
+Return a random number with a uniform distribution of its logarithm.
+
+@param[in] rng
+Random number generator.
+
+@param[in] lo
+Smallest value, > 0.
+
+@param[in] hi
+Largest value.
+
+@return
+Random number, lo <= x <= hi.
+
+*/
+static double LogUniform(
+    std::mt19937_64 &rng,
+    double lo,
+    double hi
+) {
+    std::uniform_real_distribution<double> uniform(log(lo), log(hi));
+    return std::min(hi, std::max(lo, exp(uniform(rng))));
+}
+
+/**
+@brief
+Add a comparison of an AVX2 value with its scalar value to a deviation.
+
+@param[in,out] dev
+Deviation.
+
+@param[in] scalar
+Value of the scalar function.
+
+@param[in] simd
+Value of the AVX2 kernel.
+
+@param[in] bound
+Largest acceptable absolute deviation.
+
+*/
+static void Accumulate(
+    Deviation *dev,
+    double scalar,
+    double simd,
+    double bound
+) {
+    if (!std::isfinite(scalar) || !std::isfinite(simd))
+    {
+        if (std::isfinite(scalar) || std::isfinite(simd) || std::isnan(scalar) != std::isnan(simd))
+            dev->n_failed++;
+        return;
+    }
+
+    double diff = scalar == simd ? 0.0 : fabs(simd - scalar);
+    dev->n_compared++;
+
+    if (!(diff <= bound))
+        dev->n_failed++;
+
+    dev->max_diff = std::max(dev->max_diff, diff);
+}
+
+/**
+@brief
+Add a comparison of an AVX2 value with its scalar value to a deviation,
+relative to the scalar value or, for subnormal values, to the smallest
+normal number.
+
+@param[in,out] dev
+Deviation.
+
+@param[in] scalar
+Value of the scalar function.
+
+@param[in] simd
+Value of the AVX2 kernel.
+
+@param[in] bound
+Largest acceptable relative deviation.
+
+*/
+static void AccumulateRelative(
+    Deviation *dev,
+    double scalar,
+    double simd,
+    double bound
+) {
+    if (!std::isfinite(scalar) || !std::isfinite(simd))
+    {
+        Accumulate(dev, scalar, simd, 0.0);
+        return;
+    }
+
+    double diff = scalar == simd ? 0.0 : fabs(simd - scalar) / std::max(fabs(scalar), DBL_MIN);
+    dev->n_compared++;
+
+    if (!(diff <= bound))
+        dev->n_failed++;
+
+    dev->max_diff = std::max(dev->max_diff, diff);
+}
+
+/**
+@brief
+Print a deviation and return its number of failures, counting a deviation
+that compared no finite values as a failure.
+
+@param[in] name
+Name of the quantity.
+
+@param[in] dev
+Deviation.
+
+@param[in] bound
+Bound of the deviation, without the allowance for rounding.
+
+@return
+Number of failures.
+
+*/
+static long long Report(
+    const char *name,
+    const Deviation &dev,
+    double bound
+) {
+    printf("%-22s %9lld compared, max |d| %.3e  (bound %.1e), %lld failed",
+        name, dev.n_compared, dev.max_diff, bound, dev.n_failed);
+    if (dev.n_boundary > 0)
+        printf(", %lld at a piece boundary", dev.n_boundary);
+    printf("\n");
+
+    if (dev.n_compared == 0)
+    {
+        printf("%-22s compared no finite values\n", name);
+        return dev.n_failed + 1;
+    }
+
+    return dev.n_failed;
+}
+
+/**
+@brief
+Draw a random radio context over the valid domain of ValidateInputs().
+
+@param[in] rng
+Random number generator.
+
+@param[out] radio
+Radio context.
+
+*/
+static void RandomRadio(
+    std::mt19937_64 &rng,
+    RadioContext *radio
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    InitializeRadioContext(
+        LogUniform(rng, 20.0, 20000.0),
+        uniform(rng) < 0.5 ? POLARIZATION__HORIZONTAL : POLARIZATION__VERTICAL,
+        LogUniform(rng, 1.0, 1000.0),
+        LogUniform(rng, 1.0E-6, 1000.0),
+        radio
+    );
+}
+
+/**
+@brief
+Draw a random point-to-point path on rough random walk terrain, or a random
+area mode path.
+
+@param[in] rng
+Random number generator.
+
+@param[out] path
+Prepared path.
+
+@return
+Error code of PrepareArea(), or SUCCESS for a point-to-point path.
+
+*/
+static int RandomPath(
+    std::mt19937_64 &rng,
+    PreparedPath *path
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    if (uniform(rng) < 0.5)
+    {
+        return PrepareArea(
+            LogUniform(rng, 0.5, 3000.0),
+            LogUniform(rng, 0.5, 3000.0),
+            uniform(rng) < 0.5 ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED,
+            uniform(rng) < 0.5 ? SITING_CRITERIA__MOBILE : SITING_CRITERIA__FIXED,
+            LogUniform(rng, 0.001, 2000.0),
+            uniform(rng) < 0.05 ? 0.0 : LogUniform(rng, 0.1, 3000.0),
+            path
+        );
+    }
+
+    int np = 2 + int(2000 * uniform(rng));
+    double xi__meter = LogUniform(rng, 1.0, 2000.0);
+    double roughness__meter = LogUniform(rng, 0.01, 100.0);
+
+    std::vector<double> pfl(np + 3);
+    pfl[0] = np;
+    pfl[1] = xi__meter;
+    pfl[2] = 0.0;
+    for (int i = 1; i <= np; i++)
+        pfl[i + 2] = pfl[i + 1] + roughness__meter * normal(rng);
+
+    PreparePath(
+        LogUniform(rng, 0.5, 3000.0),
+        LogUniform(rng, 0.5, 3000.0),
+        pfl.data(),
+        path
+    );
+
+    return SUCCESS;
+}
+
+#ifdef ILM_X86_SIMD
+
+/**
+@brief
+Check the exponential, logarithms, cube root, sine, cosine, Fresnel integral,
+height gain function and inverse CCDF of LongleyRiceAvx2() against the
+standard library and their scalar functions.
+
+The elementary functions are within a few ulp of the standard library. The
+arguments of HeightFunction() at which the logarithms of K could select
+different pieces are counted, not compared, as the pieces are not continuous
+there.
+
+@param[in] rng
+Random number generator.
+
+@param[in] n
+Number of random arguments of each function.
+
+@param[in] bound__db
+Largest acceptable deviation of a term, in dB.
+
+@return
+Number of failures.
+
+*/
+static long long CheckFunctions(
+    std::mt19937_64 &rng,
+    int n,
+    double bound__db
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // Relative rounding of a few ulp.
+    const double ulp = ldexp(1.0, -50);
+
+    RadioContext radio;
+    RandomRadio(rng, &radio);
+
+    Deviation exp_x = {};
+    Deviation log_y = {};
+    Deviation log10_y = {};
+    Deviation cbrt_y = {};
+    Deviation sin_phi = {};
+    Deviation cos_phi = {};
+    Deviation fresnel = {};
+    Deviation height = {};
+    Deviation inverse = {};
+
+    for (int i = 0; i < n; i += LONGLEY_RICE_LANES)
+    {
+        LongleyRiceTermLanes terms = {};
+
+        for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+        {
+            terms.radio[l] = &radio;
+
+            // Exponents out to the underflow and overflow of the result, and
+            // positive arguments over the whole range, including subnormals.
+            terms.x[l] = (i / LONGLEY_RICE_LANES) % 2 == 0 ? -740.0 + 1449.0 * uniform(rng) : -20.0 + 40.0 * uniform(rng);
+            terms.y[l] = ldexp(1.0 + uniform(rng), int(-1070 + 2092 * uniform(rng)));
+            terms.phi[l] = (uniform(rng) < 0.5 ? -1.0 : 1.0) * LogUniform(rng, 1.0E-6, 1.0E6);
+
+            // v^2 over many decades, and around the change of piece at v = 2.4.
+            terms.v2[l] = l % 2 == 0 ? LogUniform(rng, 1.0E-12, 1.0E12) : 12.0 * uniform(rng);
+
+            // K from well below the cut off of 1E-5 to above 1, where w < 0.
+            terms.x__km[l] = LogUniform(rng, 1.0E-4, 1.0E5);
+            terms.K[l] = LogUniform(rng, 1.0E-7, 10.0);
+
+            // Quantiles out to 1E-300 from 0, and to the rounding of 1 - q
+            // from 1.
+            terms.q[l] = l % 2 == 0 ? LogUniform(rng, 1.0E-300, 0.5) : 1.0 - LogUniform(rng, ldexp(1.0, -53), 0.5);
+
+            // Arguments of the path terms, which are checked separately.
+            terms.d__meter[l] = 1.0;
+            terms.d_hzn__meter[0][l] = terms.d_hzn__meter[1][l] = 1.0;
+            terms.h_e__meter[0][l] = terms.h_e__meter[1][l] = 1.0;
+            terms.s__meter[l] = terms.d_ls__meter[l] = 1.0;
+        }
+
+        LongleyRiceTermsAvx2(&terms);
+
+        for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+        {
+            double x = terms.x[l];
+            double y = terms.y[l];
+            double phi = terms.phi[l];
+
+            AccumulateRelative(&exp_x, exp(x), terms.exp_x[l], ulp);
+            AccumulateRelative(&log_y, log(y), terms.log_y[l], ulp);
+            AccumulateRelative(&log10_y, log10(y), terms.log10_y[l], ulp);
+
+            // The cube root is exp(log(y) / 3), so the error of the logarithm
+            // is scaled by the logarithm of the result.
+            AccumulateRelative(&cbrt_y, pow(y, 1.0 / 3.0), terms.cbrt_y[l], ulp * (1.0 + fabs(log(y))));
+
+            // The reduction is by pi / 4 in extended precision, so the error
+            // grows with the angle.
+            double angle_bound = ulp * (1.0 + fabs(phi));
+            Accumulate(&sin_phi, sin(phi), terms.sin_phi[l], angle_bound);
+            Accumulate(&cos_phi, cos(phi), terms.cos_phi[l], angle_bound);
+
+            double F_v__db = FresnelIntegral(terms.v2[l]);
+            Accumulate(&fresnel, F_v__db, terms.F_v__db[l], bound__db + ldexp(fabs(F_v__db), -48));
+
+            double x__km = terms.x__km[l];
+            double K = terms.K[l];
+            double w = -log(K);
+            if (x__km < 200.0 && K >= 1.0E-5 && fabs(x__km * w * w * w - 5495.0) <= 1.0E-9 * 5495.0)
+            {
+                height.n_boundary++;
+            }
+            else
+            {
+                double F_x__db = HeightFunction(x__km, K);
+                Accumulate(&height, F_x__db, terms.F_x__db[l], bound__db + ldexp(fabs(F_x__db), -48));
+            }
+
+            double Q_q = InverseComplementaryCumulativeDistributionFunction(terms.q[l]);
+            Accumulate(&inverse, Q_q, terms.Q_q[l], bound__db + ldexp(fabs(Q_q), -48));
+        }
+    }
+
+    long long n_failed = 0;
+    n_failed += Report("ExpAvx2 [rel]", exp_x, ulp);
+    n_failed += Report("LogAvx2 [rel]", log_y, ulp);
+    n_failed += Report("Log10Avx2 [rel]", log10_y, ulp);
+    n_failed += Report("CbrtAvx2 [rel]", cbrt_y, ulp);
+    n_failed += Report("SinCosAvx2 sin", sin_phi, ulp);
+    n_failed += Report("SinCosAvx2 cos", cos_phi, ulp);
+    n_failed += Report("FresnelIntegral [dB]", fresnel, bound__db);
+    n_failed += Report("HeightFunction [dB]", height, bound__db);
+    n_failed += Report("InverseCCDF", inverse, bound__db);
+
+    return n_failed;
+}
+
+/**
+@brief
+Check the knife-edge, smooth sphere and line-of-sight losses of
+LongleyRiceAvx2() against their scalar functions on the geometry of random
+paths.
+
+The terms are evaluated at distances beyond the horizons and within the
+line-of-sight region, with the angular distance of the line-of-sight region
+of [Algorithm, Eqn 4.12] and random diffraction coefficients.
+
+@param[in] rng
+Random number generator.
+
+@param[in] n
+Number of random paths.
+
+@param[in] bound__db
+Largest acceptable deviation of a term, in dB.
+
+@return
+Number of failures.
+
+*/
+static long long CheckTerms(
+    std::mt19937_64 &rng,
+    int n,
+    double bound__db
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    Deviation knife = {};
+    Deviation sphere = {};
+    Deviation los = {};
+
+    std::vector<RadioContext> radios(LONGLEY_RICE_LANES);
+
+    for (int i = 0; i < n; i += LONGLEY_RICE_LANES)
+    {
+        LongleyRiceTermLanes terms = {};
+
+        for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+        {
+            PreparedPath path;
+            while (RandomPath(rng, &path) != SUCCESS)
+                ;
+
+            RandomRadio(rng, &radios[l]);
+            terms.radio[l] = &radios[l];
+
+            // The other arguments are checked separately.
+            terms.y[l] = terms.v2[l] = terms.x__km[l] = terms.K[l] = 1.0;
+            terms.q[l] = 0.5;
+
+            // [RLS, A-8, A-11 & A-12].
+            double d_ls__meter = sqrt(2.0 * path.h_e__meter[0] * a_m__meter) + sqrt(2.0 * path.h_e__meter[1] * a_m__meter);
+            double d_l__meter = path.d_hzn__meter[0] + path.d_hzn__meter[1];
+
+            for (int j = 0; j < 2; j++)
+            {
+                terms.d_hzn__meter[j][l] = path.d_hzn__meter[j];
+                terms.h_e__meter[j][l] = path.h_e__meter[j];
+            }
+            terms.theta_los[l] = std::max(path.theta_hzn[0] + path.theta_hzn[1], -d_l__meter / a_m__meter);
+            terms.d__meter[l] = d_l__meter * (1.0 + LogUniform(rng, 1.0E-3, 100.0));
+
+            terms.s__meter[l] = d_ls__meter * LogUniform(rng, 1.0E-3, 1.0);
+            terms.delta_h__meter[l] = path.delta_h__meter;
+            terms.m_d[l] = LogUniform(rng, 1.0E-7, 1.0E-3);
+            terms.A_ed__db[l] = -20.0 + 100.0 * uniform(rng);
+            terms.d_ls__meter[l] = d_ls__meter;
+        }
+
+        LongleyRiceTermsAvx2(&terms);
+
+        for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+        {
+            double d_hzn__meter[2] = { terms.d_hzn__meter[0][l], terms.d_hzn__meter[1][l] };
+            double h_e__meter[2] = { terms.h_e__meter[0][l], terms.h_e__meter[1][l] };
+
+            double A_k__db = KnifeEdgeDiffraction(terms.d__meter[l], terms.radio[l], terms.theta_los[l], d_hzn__meter);
+            Accumulate(&knife, A_k__db, terms.A_k__db[l], bound__db + ldexp(fabs(A_k__db), -44));
+
+            double A_r__db = SmoothSphereDiffraction(a_m__meter, terms.d__meter[l], terms.radio[l], terms.theta_los[l], d_hzn__meter, h_e__meter);
+            Accumulate(&sphere, A_r__db, terms.A_r__db[l], bound__db + ldexp(fabs(A_r__db), -44));
+
+            double A_los__db = LineOfSightLoss(
+                terms.s__meter[l],
+                h_e__meter,
+                terms.radio[l],
+                terms.delta_h__meter[l],
+                terms.m_d[l],
+                terms.A_ed__db[l],
+                terms.d_ls__meter[l]
+            );
+            Accumulate(&los, A_los__db, terms.A_los__db[l], bound__db + ldexp(fabs(A_los__db), -44));
+        }
+    }
+
+    long long n_failed = 0;
+    n_failed += Report("KnifeEdge [dB]", knife, bound__db);
+    n_failed += Report("SmoothSphere [dB]", sphere, bound__db);
+    n_failed += Report("LineOfSightLoss [dB]", los, bound__db);
+
+    return n_failed;
+}
+
+/**
+@brief
+Evaluate random paths four at a time with LongleyRiceAvx2() and
+LongleyRiceLanesScalar(), and compare the lanes.
+
+The mode and the warnings of each lane must be identical. The free space
+loss is compared on every lane, and the reference attenuation and the basic
+transmission loss where they are finite, and they must be finite in both or
+in neither.
+
+@param[in] rng
+Random number generator.
+
+@param[in] n
+Number of random paths.
+
+@param[in] bound__db
+Largest acceptable deviation of a loss, in dB.
+
+@return
+Number of failures.
+
+*/
+static long long CheckLanes(
+    std::mt19937_64 &rng,
+    int n,
+    double bound__db
+) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    std::vector<RadioContext> radios(LONGLEY_RICE_LANES);
+
+    long long n_lanes = 0;
+    long long n_differ = 0;
+    Deviation A_fs = {};
+    Deviation A_ref = {};
+    Deviation A = {};
+
+    for (int i = 0; i < n; i += LONGLEY_RICE_LANES)
+    {
+        LongleyRiceLanes lanes;
+
+        for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+        {
+            PreparedPath path;
+            while (RandomPath(rng, &path) != SUCCESS)
+                ;
+
+            RandomRadio(rng, &radios[l]);
+            lanes.radio[l] = &radios[l];
+
+            for (int j = 0; j < 2; j++)
+            {
+                lanes.theta_hzn[j][l] = path.theta_hzn[j];
+                lanes.d_hzn__meter[j][l] = path.d_hzn__meter[j];
+                lanes.h_e__meter[j][l] = path.h_e__meter[j];
+                lanes.h__meter[j][l] = path.h__meter[j];
+            }
+            lanes.delta_h__meter[l] = path.delta_h__meter;
+            lanes.d__meter[l] = path.d__meter;
+
+            // Location ratios out to 1E-7 of the ends of the range.
+            double u = -16.0 + 32.0 * uniform(rng);
+            lanes.p[l] = std::min(1.0 - 1.0E-7, std::max(1.0E-7, 1.0 / (1.0 + exp(-u))));
+
+            lanes.warnings[l] = 0;
+            lanes.propmode[l] = MODE__NOT_SET;
+        }
+
+        LongleyRiceLanes scalar = lanes;
+        LongleyRiceLanesScalar(&scalar);
+        LongleyRiceAvx2(&lanes);
+
+        for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+        {
+            n_lanes++;
+
+            if (lanes.propmode[l] != scalar.propmode[l] || lanes.warnings[l] != scalar.warnings[l])
+                n_differ++;
+
+            Accumulate(&A_fs, scalar.A_fs__db[l], lanes.A_fs__db[l], bound__db + ldexp(fabs(scalar.A_fs__db[l]), -44));
+            Accumulate(&A_ref, scalar.A_ref__db[l], lanes.A_ref__db[l], bound__db + ldexp(fabs(scalar.A_ref__db[l]), -44));
+            Accumulate(&A, scalar.A__db[l], lanes.A__db[l], bound__db + ldexp(fabs(scalar.A__db[l]), -44));
+        }
+    }
+
+    printf("lanes %lld evaluated, %lld differ in mode or warnings\n", n_lanes, n_differ);
+
+    // The free space loss is finite on every lane; the reference attenuation
+    // and the loss are finite on only some, and are reported for those.
+    long long n_failed = n_differ;
+    n_failed += Report("  A_fs [dB]", A_fs, bound__db);
+    n_failed += A_ref.n_failed;
+    n_failed += A.n_failed;
+    printf("  %-20s %9lld compared, max |d| %.3e  (bound %.1e), %lld failed\n",
+        "A_ref [dB]", A_ref.n_compared, A_ref.max_diff, bound__db, A_ref.n_failed);
+    printf("  %-20s %9lld compared, max |d| %.3e  (bound %.1e), %lld failed\n",
+        "A [dB]", A.n_compared, A.max_diff, bound__db, A.n_failed);
+
+    return n_failed;
+}
+
+#endif  // ILM_X86_SIMD
+
+int main(int argc, char **argv)
+{
+    int n = 100000;
+    double bound__db = 1.0E-9;
+    unsigned long long seed = 1;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:b:s:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            n = atoi(optarg);
+            break;
+        case 'b':
+            bound__db = atof(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, nullptr, 10);
+            break;
+        default:
+            fprintf(stderr, "Usage: simd_check [-n paths] [-b bound__db] [-s seed]\n");
+            return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+#ifdef ILM_X86_SIMD
+    if (!CpuSupportsAvx2())
+    {
+        printf("FAILED: the CPU does not support AVX2, nothing was compared\n");
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937_64 rng(seed);
+
+    long long n_failed = CheckFunctions(rng, 10 * n, bound__db);
+    n_failed += CheckTerms(rng, n, bound__db);
+    n_failed += CheckLanes(rng, n, bound__db);
+
+    if (n_failed > 0)
+    {
+        printf("FAILED: %lld checks exceeded their bounds or compared nothing\n", n_failed);
+        return EXIT_FAILURE;
+    }
+
+    printf("PASSED: AVX2 kernel within the bounds of the scalar functions\n");
+    return EXIT_SUCCESS;
+#else
+    printf("FAILED: the build has no AVX2 kernel, nothing was compared\n");
+    return EXIT_FAILURE;
+#endif
+}
@@ -1,25 +1,27 @@
 /**
 @file
 
-This file contains the function ComputeDeltaH() to calculate the terrain
-irregularity parameter, delta_h, in meters.
+This file contains the functions ComputeDeltaH(), ComputeDeltaHView() and
+ComputeDeltaHCompact() to calculate the terrain irregularity parameter,
+delta_h, in meters.
 */
 
 /* Standard includes. */
 #include <algorithm>
 #include <cmath>
-#include <vector>
+#include <functional>
 #include <utility>
 
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Terrain.h"
 
 /**
 * @brief
 Compute the terrain irregularity parameter, delta_h.
 
-@param[in] pfl[]
-Terrain data.
+@param[in] terrain
+Terrain profile.
 
 @param[in] d_start__meter
 Distance into the terrain profile to start considering data, in meters.
@@ -30,21 +32,23 @@ Distance into the terrain profile to end considering data, in meters.
 @return delta_h__meter
 Terrain irregularity parameter, in meters.
 */
-double ComputeDeltaH(
-    double pfl[],
+template <typename Terrain>
+static double ComputeTerrainDeltaH(
+    const Terrain &terrain,
     double d_start__meter,
     double d_end__meter
 ) {
     // Temp pfl data array.
     double s[247] = { 0 };
 
-    int np = (int)pfl[0];
+    int np = terrain.Intervals();
+    double xi = terrain.Resolution();
 
     // index to start considering terrain points.
-    double x_start = d_start__meter / pfl[1];
+    double x_start = d_start__meter / xi;
 
     // index to stop considering terrain points.
-    double x_end = d_end__meter / pfl[1];
+    double x_end = d_end__meter / xi;
 
     // If there are less than 2 terrain points, return delta_h = 0.
     if (x_end - x_start < 2.0)
@@ -74,7 +78,7 @@ double ComputeDeltaH(
             i++;
         }
 
-        s[j + 2] = pfl[i + 3] + (pfl[i + 3] - pfl[i + 2]) * x_start;
+        s[j + 2] = terrain[i + 1] + (terrain[i + 1] - terrain[i]) * x_start;
 
         x_start += x_end;
     }
@@ -90,27 +94,28 @@ double ComputeDeltaH(
     );
     fit_y2 = (fit_y2 - fit_y1) / np_s;
 
-    std::vector<double> diffs;
-    
+    // Differences between the fitted line and the data, at most 245 of them.
+    double diffs[10 * 25 - 5];
+
     // Compute the difference between fitted line and actual data.
     for (int j = 0; j < n; j++)
     {
-        diffs.push_back(s[j + 2] - fit_y1);
+        diffs[j] = s[j + 2] - fit_y1;
         fit_y1 += fit_y2;
     }
 
     std::nth_element(
-        diffs.begin(),
-        diffs.begin() + p10 - 1,
-        diffs.end(),
+        diffs,
+        diffs + p10 - 1,
+        diffs + n,
         std::greater<double>()
     );
     double q10 = diffs[p10 - 1];
 
     std::nth_element(
-        diffs.begin(),
-        diffs.begin() + p90,
-        diffs.end(),
+        diffs,
+        diffs + p90,
+        diffs + n,
         std::greater<double>()
     );
     double q90 = diffs[p90];
@@ -121,4 +126,89 @@ double ComputeDeltaH(
     double delta_h__meter = delta_h_d__meter / (1.0 - 0.8 * exp(-(d_end__meter - d_start__meter) / 50.0E3));
 
     return delta_h__meter;
+}
+
+/**
+@brief
+Compute the terrain irregularity parameter, delta_h.
+
+@param[in] pfl[]
+Terrain data.
+
+@param[in] d_start__meter
+Distance into the terrain profile to start considering data, in meters.
+
+@param[in] d_end__meter
+Distance into the terrain profile to end considering data, in meters.
+
+@return delta_h__meter
+Terrain irregularity parameter, in meters.
+*/
+double ComputeDeltaH(
+    double pfl[],
+    double d_start__meter,
+    double d_end__meter
+) {
+    PflTerrain terrain = { pfl };
+
+    return ComputeTerrainDeltaH(terrain, d_start__meter, d_end__meter);
+}
+
+/**
+@brief
+Compute the terrain irregularity parameter, delta_h, for a terrain profile
+stored in place.
+
+The result is identical to ComputeDeltaH() on the same profile in pfl format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] d_start__meter
+Distance into the terrain profile to start considering data, in meters.
+
+@param[in] d_end__meter
+Distance into the terrain profile to end considering data, in meters.
+
+@return delta_h__meter
+Terrain irregularity parameter, in meters.
+*/
+double ComputeDeltaHView(
+    const TerrainView *view,
+    double d_start__meter,
+    double d_end__meter
+) {
+    StridedTerrain terrain = { view };
+
+    return ComputeTerrainDeltaH(terrain, d_start__meter, d_end__meter);
+}
+
+/**
+@brief
+Compute the terrain irregularity parameter, delta_h, for a terrain profile in
+a compact encoding.
+
+The result is identical to ComputeDeltaH() on the widened profile in pfl
+format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] d_start__meter
+Distance into the terrain profile to start considering data, in meters.
+
+@param[in] d_end__meter
+Distance into the terrain profile to end considering data, in meters.
+
+@return delta_h__meter
+Terrain irregularity parameter, in meters.
+*/
+double ComputeDeltaHCompact(
+    const CompactTerrainView *view,
+    double d_start__meter,
+    double d_end__meter
+) {
+    return WithCompactTerrain(view, [&](const auto &terrain) {
+        return ComputeTerrainDeltaH(terrain, d_start__meter, d_end__meter);
+    });
 }
\ No newline at end of file
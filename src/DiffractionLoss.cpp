@@ -6,12 +6,13 @@ in the ILM.
 */
 
 /* Standard includes. */
-#include <cmath>
 #include <complex>
-#include <utility>
 
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/Enums.h"
+#include "./include/RadioContext.h"
 
 /**
 @brief
@@ -59,38 +60,88 @@ double DiffractionLoss(
     double theta_los,
     double f__mhz
 ) {
-    double A_k__db = KnifeEdgeDiffraction(
-        d__meter,
+    RadioContext radio;
+    InitializeRadioContext(
         f__mhz,
-        theta_los,
-        d_hzn__meter
+        Z_g,
+        &radio
     );
 
-    double A_r__db = SmoothSphereDiffraction(
+    return DiffractionLoss(
         radius__meter,
         d__meter,
-        f__mhz,
-        theta_los,
         d_hzn__meter,
         h_e__meter,
-        Z_g
+        &radio,
+        delta_h__meter,
+        h__meter,
+        theta_los
     );
+}
 
-    double delta_h_d__meter = TerrainRoughness(
-        d__meter,
-        delta_h__meter
-    );
+/**
+@brief
+Compute the diffraction loss at a specified distance, with the frequency and
+ground dependent constants of a radio context.
+
+@param[in] radius__meter
+Radius in meters of the celestial body under consideration.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] d_hzn__meter
+Horizon distances, in meters.
+
+@param[in] h_e__meter
+Effective terminal heights, in meters.
+
+@param[in] radio
+Radio context.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter, in meters.
 
-    // [RLS, A-25 & B-23].
-    double term1 = sqrt((h_e__meter[0] * h_e__meter[1]) / (h__meter[0] * h__meter[1]));
-    double d_l__meter = d_hzn__meter[0] + d_hzn__meter[1];
-    double q = (term1 + (-theta_los * radius__meter + d_l__meter) / d__meter) * std::min(delta_h_d__meter * f__mhz / 47.7, 1000.0);
+@param[in] h__meter
+Terminal heights, in meters.
 
-    // [RLS, A-24 & B-22].
-    double w = 1.0 / (1.0 + 0.1 * sqrt(q));
+@param[in] theta_los
+Angular distance of line-of-sight region.
 
-    // [RLS, A-23 & B-21].
-    double A_d__db = w * A_r__db + (1.0 - w) * A_k__db ;
+@return A_d__db
+Diffraction loss, in dB.
 
-    return A_d__db;
+*/
+double DiffractionLoss(
+    double radius__meter,
+    double d__meter,
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    const RadioContext *radio,
+    double delta_h__meter,
+    double h__meter[2],
+    double theta_los
+) {
+    if (radio->precision == PRECISION__FAST)
+        return FastModel::DiffractionLoss(
+            radius__meter,
+            d__meter,
+            d_hzn__meter,
+            h_e__meter,
+            EngineRadioOf(radio),
+            delta_h__meter,
+            h__meter,
+            theta_los
+        );
+
+    return ExactModel::DiffractionLoss(
+        radius__meter,
+        d__meter,
+        d_hzn__meter,
+        h_e__meter,
+        EngineRadioOf(radio),
+        delta_h__meter,
+        h__meter,
+        theta_los
+    );
 }
\ No newline at end of file
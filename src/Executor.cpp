@@ -0,0 +1,539 @@
+/**
+@file
+
+This file contains the ParallelFor() batch executor, its thread pool and the
+ParallelWorker() and ShutdownExecutor() functions.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Executor.h"
+
+/**
+@brief
+Number of chunks each thread gets on average, so threads that finish early
+have work left to steal.
+*/
+#define CHUNKS_PER_THREAD 16
+
+/**
+@brief
+Contiguous range of batch items.
+*/
+struct Chunk
+{
+    /**
+    First item.
+    */
+    int i_begin;
+
+    /**
+    One past the last item.
+    */
+    int i_end;
+};
+
+/**
+@brief
+Work-stealing deque of one thread.
+
+The owning thread takes chunks from the front, in input order, and other
+threads steal from the back. Chunks are only added before a batch starts, so
+the deque is an array and the index of its front, and keeps its memory from
+one batch to the next.
+*/
+struct WorkDeque
+{
+    /**
+    Guards the chunks.
+    */
+    std::mutex mutex;
+
+    /**
+    Chunks of the batch, those before i_front already taken.
+    */
+    std::vector<Chunk> chunks;
+
+    /**
+    Index of the first chunk not yet taken.
+    */
+    size_t i_front = 0;
+};
+
+/**
+@brief
+A batch being evaluated by the thread pool.
+*/
+struct Job
+{
+    /**
+    Number of threads working on the batch, including the calling thread.
+    */
+    int n_workers;
+
+    /**
+    Work-stealing deque of each worker.
+    */
+    WorkDeque *deques;
+
+    /**
+    Function to evaluate each item.
+    */
+    const std::function<void(int)> *body;
+
+    /**
+    Set once the body has thrown, so no further chunks are started.
+    */
+    std::atomic<bool> failed;
+
+    /**
+    Guards the exception.
+    */
+    std::mutex error_mutex;
+
+    /**
+    First exception thrown by the body, rethrown on the calling thread.
+    */
+    std::exception_ptr error;
+};
+
+/**
+@brief
+Process-wide pool of worker threads.
+
+The pool grows to the largest number of threads requested. It is never
+destroyed, so its threads never outlive it, and ShutdownExecutor() stops and
+joins them.
+*/
+struct ThreadPool
+{
+    /**
+    Held by the caller whose batch is running on the pool.
+    */
+    std::mutex job_mutex;
+
+    /**
+    Guards the members below.
+    */
+    std::mutex mutex;
+
+    /**
+    Signals the workers that a new batch is available.
+    */
+    std::condition_variable wake;
+
+    /**
+    Signals the caller that every worker is done with the batch.
+    */
+    std::condition_variable done;
+
+    /**
+    Worker threads.
+    */
+    std::vector<std::thread> threads;
+
+    /**
+    Number of worker threads.
+    */
+    int n_threads = 0;
+
+    /**
+    Set to make the worker threads return.
+    */
+    bool stop = false;
+
+    /**
+    Work-stealing deques, reused by every batch.
+    */
+    std::unique_ptr<WorkDeque[]> deques;
+
+    /**
+    Number of work-stealing deques.
+    */
+    int n_deques = 0;
+
+    /**
+    Current batch.
+    */
+    Job *job = nullptr;
+
+    /**
+    Count of batches started, so workers can tell a new batch from the last.
+    */
+    unsigned long long generation = 0;
+
+    /**
+    Number of worker threads not yet done with the current batch.
+    */
+    int n_pending = 0;
+};
+
+/**
+@brief
+Index of the calling thread among the workers of the batch it is evaluating.
+*/
+static thread_local int worker_index = 0;
+
+/**
+@brief
+Take the next chunk for a worker, from its own deque or stolen from another.
+
+@param[in,out] job
+Batch being evaluated.
+
+@param[in] self
+Index of the worker.
+
+@param[out] chunk
+Chunk taken.
+
+@return
+False if no chunks are left.
+
+*/
+static bool NextChunk(
+    Job *job,
+    int self,
+    Chunk *chunk
+) {
+    if (job->failed)
+        return false;
+
+    for (int j = 0; j < job->n_workers; j++)
+    {
+        WorkDeque &deque = job->deques[(self + j) % job->n_workers];
+        std::lock_guard<std::mutex> lock(deque.mutex);
+
+        if (deque.i_front == deque.chunks.size())
+            continue;
+
+        if (j == 0)
+        {
+            *chunk = deque.chunks[deque.i_front];
+            deque.i_front++;
+        }
+        else
+        {
+            *chunk = deque.chunks.back();
+            deque.chunks.pop_back();
+        }
+
+        return true;
+    }
+
+    // Chunks are only added before the batch starts, so none will appear.
+    return false;
+}
+
+/**
+@brief
+Evaluate chunks of a batch until none are left, or until the body throws on
+any worker. The first exception is kept in the job.
+
+@param[in,out] job
+Batch being evaluated.
+
+@param[in] self
+Index of the worker.
+
+*/
+static void RunWorker(
+    Job *job,
+    int self
+) {
+    Chunk chunk;
+
+    int previous = worker_index;
+    worker_index = self;
+
+    try
+    {
+        while (NextChunk(job, self, &chunk))
+        {
+            for (int i = chunk.i_begin; i < chunk.i_end; i++)
+                (*job->body)(i);
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(job->error_mutex);
+        if (!job->error)
+            job->error = std::current_exception();
+        job->failed = true;
+    }
+
+    worker_index = previous;
+}
+
+/**
+@brief
+Main loop of a pool thread.
+
+@param[in] pool
+Thread pool.
+
+@param[in] index
+Index of the thread in the pool.
+
+@param[in] generation
+Batches started before the thread was created.
+
+*/
+static void PoolWorker(
+    ThreadPool *pool,
+    int index,
+    unsigned long long generation
+) {
+    for (;;)
+    {
+        Job *job;
+        {
+            std::unique_lock<std::mutex> lock(pool->mutex);
+            pool->wake.wait(lock, [&]() { return pool->stop || pool->generation != generation; });
+            if (pool->stop)
+                return;
+            generation = pool->generation;
+            job = pool->job;
+        }
+
+        // The calling thread is worker 0.
+        if (index + 1 < job->n_workers)
+            RunWorker(job, index + 1);
+
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (--pool->n_pending == 0)
+            pool->done.notify_one();
+    }
+}
+
+/**
+@brief
+Return the process-wide thread pool.
+
+@return
+Thread pool.
+
+*/
+static ThreadPool &GetThreadPool() {
+    static ThreadPool *pool = new ThreadPool();
+    return *pool;
+}
+
+/**
+@brief
+Evaluate every item of a batch on a pool of threads.
+
+The items are grouped into contiguous chunks of roughly equal total cost, and
+the chunks are dealt to each thread's work-stealing deque so each thread
+starts with an equal share of the cost. Threads that run out of work steal
+chunks from the others. Only one batch runs on the pool at a time; a batch
+started while the pool is busy is evaluated on the calling thread.
+
+@param[in] n
+Number of items.
+
+@param[in] cost
+Estimated cost of each item, or NULL if all items cost the same.
+
+@param[in] n_threads
+Number of threads, including the calling thread, or 0 to use one per
+hardware thread.
+
+@param[in] body
+Function to evaluate item i. It is called exactly once for each item, from
+any of the threads. If it throws, no further chunks are started, and once
+every thread has stopped the first exception is rethrown on the calling
+thread.
+
+*/
+void ParallelFor(
+    int n,
+    const double cost[],
+    int n_threads,
+    const std::function<void(int)> &body
+) {
+    if (n <= 0)
+        return;
+
+    if (n_threads <= 0)
+        n_threads = std::max(1, int(std::thread::hardware_concurrency()));
+
+    int n_workers = std::min(n_threads, n);
+
+    ThreadPool &pool = GetThreadPool();
+    std::unique_lock<std::mutex> job_lock(pool.job_mutex, std::defer_lock);
+
+    if (n_workers == 1 || !job_lock.try_lock())
+    {
+        for (int i = 0; i < n; i++)
+            body(i);
+        return;
+    }
+
+    double total_cost = 0.0;
+    if (cost != nullptr)
+    {
+        for (int i = 0; i < n; i++)
+            total_cost += cost[i];
+    }
+
+    // Without a usable estimate, every item costs the same.
+    if (!(total_cost > 0.0))
+    {
+        cost = nullptr;
+        total_cost = n;
+    }
+
+    // The deques belong to the caller holding job_mutex.
+    if (pool.n_deques < n_workers)
+    {
+        pool.deques.reset(new WorkDeque[n_workers]);
+        pool.n_deques = n_workers;
+    }
+
+    Job job;
+    job.n_workers = n_workers;
+    job.deques = pool.deques.get();
+    job.body = &body;
+    job.failed = false;
+
+    for (int w = 0; w < n_workers; w++)
+    {
+        job.deques[w].chunks.clear();
+        job.deques[w].i_front = 0;
+    }
+
+    double chunk_cost = total_cost / (double(n_workers) * CHUNKS_PER_THREAD);
+    double worker_cost = total_cost / n_workers;
+
+    // Cost of the chunks before the current one, and of the current one.
+    double cost_before = 0.0;
+    double cost_chunk = 0.0;
+    int i_begin = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        cost_chunk += (cost != nullptr) ? cost[i] : 1.0;
+
+        if (cost_chunk >= chunk_cost || i == n - 1)
+        {
+            int worker = std::min(n_workers - 1, int(cost_before / worker_cost));
+            job.deques[worker].chunks.push_back({ i_begin, i + 1 });
+
+            cost_before += cost_chunk;
+            cost_chunk = 0.0;
+            i_begin = i + 1;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+
+        while (pool.n_threads < n_workers - 1)
+        {
+            pool.threads.emplace_back(PoolWorker, &pool, pool.n_threads, pool.generation);
+            pool.n_threads++;
+        }
+
+        pool.job = &job;
+        pool.n_pending = pool.n_threads;
+        pool.generation++;
+    }
+    pool.wake.notify_all();
+
+    RunWorker(&job, 0);
+
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.done.wait(lock, [&]() { return pool.n_pending == 0; });
+    pool.job = nullptr;
+    lock.unlock();
+
+    if (job.error)
+        std::rethrow_exception(job.error);
+}
+
+/**
+@brief
+Return the index of the calling thread among the workers of the batch it is
+evaluating.
+
+@return
+Index from 0 to one less than the number of threads of the batch. The calling
+thread of ParallelFor(), and any thread outside a batch, is worker 0.
+
+*/
+int ParallelWorker() {
+    return worker_index;
+}
+
+/**
+@brief
+Stop and join the worker threads of a thread pool.
+
+@param[in,out] pool
+Thread pool, not evaluating a batch.
+
+*/
+static void JoinThreadPool(
+    ThreadPool *pool
+) {
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->stop = true;
+    }
+    pool->wake.notify_all();
+
+    for (std::thread &thread : pool->threads)
+        thread.join();
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->threads.clear();
+    pool->n_threads = 0;
+    pool->stop = false;
+}
+
+/**
+@brief
+Stop and join the worker threads of the batch thread pool.
+
+Call before unloading the library, so that no thread is left running its
+code, or to release the threads once no more batches are expected. A batch
+running on the pool is finished first. Later batches start new threads. Must
+not be called from within a batch.
+
+*/
+void ShutdownExecutor() {
+    ThreadPool &pool = GetThreadPool();
+    std::lock_guard<std::mutex> job_lock(pool.job_mutex);
+
+    JoinThreadPool(&pool);
+}
+
+#ifndef _WIN32
+/**
+@brief
+Joins the threads of the pool when the library is unloaded or the process
+exits, unless a batch is still running. On Windows, threads cannot be joined
+while the library is being unloaded, so callers use ShutdownExecutor().
+*/
+static struct ThreadPoolGuard
+{
+    ~ThreadPoolGuard()
+    {
+        ThreadPool &pool = GetThreadPool();
+        std::unique_lock<std::mutex> job_lock(pool.job_mutex, std::try_to_lock);
+        if (job_lock.owns_lock())
+            JoinThreadPool(&pool);
+    }
+} thread_pool_guard;
+#endif
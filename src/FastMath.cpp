@@ -0,0 +1,139 @@
+/**
+@file
+
+This file contains the tables of the FastLog2() and FastExp2() approximations.
+The entries are the correctly rounded values.
+*/
+
+/* Local includes. */
+#include "./include/FastMath.h"
+
+/**
+@brief
+Reciprocals of the midpoints of the 128 intervals of [1, 2) of FastLog2().
+*/
+const double FAST_LOG2_INVERSE[128] = {
+    0.99610894941634243, 0.98841698841698844, 0.98084291187739459,
+    0.97338403041825095, 0.96603773584905661, 0.95880149812734083,
+    0.95167286245353155, 0.94464944649446492, 0.93772893772893773,
+    0.93090909090909091, 0.92418772563176899, 0.91756272401433692,
+    0.91103202846975084, 0.90459363957597172, 0.89824561403508774,
+    0.89198606271777003, 0.88581314878892736, 0.8797250859106529,
+    0.87372013651877134, 0.8677966101694915, 0.86195286195286192,
+    0.85618729096989965, 0.85049833887043191, 0.84488448844884489,
+    0.83934426229508197, 0.83387622149837137, 0.82847896440129454,
+    0.82315112540192925, 0.8178913738019169, 0.8126984126984127,
+    0.80757097791798105, 0.80250783699059558, 0.79750778816199375,
+    0.79256965944272451, 0.78769230769230769, 0.78287461773700306,
+    0.77811550151975684, 0.77341389728096677, 0.76876876876876876,
+    0.76417910447761195, 0.75964391691394662, 0.75516224188790559,
+    0.75073313782991202, 0.74635568513119532, 0.74202898550724639,
+    0.73775216138328525, 0.73352435530085958, 0.72934472934472938,
+    0.72521246458923516, 0.72112676056338032, 0.71708683473389356,
+    0.71309192200557103, 0.70914127423822715, 0.70523415977961434,
+    0.70136986301369864, 0.6975476839237057, 0.69376693766937669,
+    0.69002695417789761, 0.68632707774798929, 0.68266666666666664,
+    0.67904509283819625, 0.67546174142480209, 0.67191601049868765,
+    0.66840731070496084, 0.66493506493506493, 0.66149870801033595,
+    0.65809768637532129, 0.65473145780051156, 0.65139949109414763,
+    0.64810126582278482, 0.64483627204030225, 0.64160401002506262,
+    0.63840399002493764, 0.63523573200992556, 0.63209876543209875,
+    0.62899262899262898, 0.62591687041564792, 0.62287104622871048,
+    0.61985472154963683, 0.61686746987951813, 0.61390887290167862,
+    0.61097852028639621, 0.60807600950118768, 0.60520094562647753,
+    0.60235294117647054, 0.59953161592505855, 0.59673659673659674,
+    0.59396751740139209, 0.59122401847575057, 0.58850574712643677,
+    0.58581235697940504, 0.58314350797266512, 0.58049886621315194,
+    0.57787810383747173, 0.57528089887640455, 0.57270693512304249,
+    0.57015590200445432, 0.56762749445676275, 0.56512141280353201,
+    0.56263736263736264, 0.56017505470459517, 0.55773420479302838,
+    0.55531453362255967, 0.55291576673866094, 0.55053763440860215,
+    0.54817987152034264, 0.54584221748400852, 0.54352441613588109,
+    0.54122621564482032, 0.53894736842105262, 0.5366876310272537,
+    0.53444676409185798, 0.53222453222453225, 0.53002070393374745,
+    0.52783505154639176, 0.52566735112936347, 0.52351738241308798,
+    0.52138492871690423, 0.51926977687626774, 0.51717171717171717,
+    0.51509054325955739, 0.51302605210420837, 0.51097804391217561,
+    0.50894632206759438, 0.50693069306930694, 0.50493096646942803,
+    0.50294695481335949, 0.50097847358121328
+};
+
+/**
+@brief
+Base 2 logarithms of the midpoints of the 128 intervals of [1, 2) of
+FastLog2(), as -log2() of the rounded reciprocals in FAST_LOG2_INVERSE.
+*/
+const double FAST_LOG2_LOG[128] = {
+    0.0056245491938780867, 0.016808287686553857, 0.027905996569884559,
+    0.038918989292302357, 0.049848549450561518, 0.060695931687553918,
+    0.071462362556624207, 0.082149041353871605, 0.092757140919852446,
+    0.10328780841202195, 0.11374216604918828, 0.12412131182918758,
+    0.13442632022092618, 0.14465824283188233, 0.154818109052104,
+    0.16490692667568779, 0.17492568250067878, 0.18487534290828389,
+    0.19475685442224785, 0.20457114424920364, 0.21431912080076587,
+    0.22400167419810507, 0.23361967675970202, 0.24317398347295091,
+    0.25266543245024864, 0.2620948453701793, 0.27146302790437449,
+    0.28077077013060253, 0.29001884693261837, 0.29920801838727884,
+    0.30833903013940728, 0.31741261376486946, 0.32642948712230319,
+    0.33539035469392481, 0.34429590791581688, 0.35314682549808252,
+    0.3619437737352415, 0.37068740680721768, 0.37937836707126216,
+    0.38801728534513474, 0.39660478118185843, 0.40514146313634392,
+    0.41362792902417245, 0.42206476617281236, 0.43045255166553137,
+    0.43879185257826098, 0.4470832262096523, 0.45532722030456063,
+    0.46352437327118023, 0.47167521439204435, 0.47978026402909968,
+    0.48784003382305136, 0.49585502688717098, 0.5038257379957507,
+    0.51175265376737955, 0.5196362528432128, 0.52747700606039605,
+    0.53527537662080316, 0.54303182025523777, 0.55074678538324329,
+    0.55842071326866438, 0.56605403817109179, 0.57364718749332211,
+    0.58120058192495705, 0.58871463558226367, 0.59618975614441028,
+    0.60362634498619205, 0.61102479730735215, 0.61838550225860633,
+    0.62570884306446528, 0.63299519714295782, 0.64024493622234591,
+    0.64745842645492035, 0.65463602852796732, 0.66177809777198715,
+    0.6688849842662471, 0.6759570329417488, 0.68299458368168287,
+    0.6899979714194453, 0.69696752623428693, 0.7039035734446637,
+    0.71080643369935148, 0.71767642306639601, 0.72451385311994976,
+    0.73131903102506424, 0.73809225962049041, 0.74483383749954557,
+    0.75154405908909816, 0.75822321472672494, 0.76487159073609068,
+    0.77148946950059838, 0.77807712953535824, 0.7846348455575205,
+    0.79116288855501837, 0.79766152585375993, 0.80413102118331781,
+    0.81057163474114702, 0.81698362325538099, 0.82336724004623507,
+    0.82972273508605865, 0.83605035505806979, 0.84235034341380777,
+    0.84862294042933795, 0.85486838326023629, 0.86108690599539373,
+    0.86727873970966185, 0.87344411251537657, 0.87958324961278322,
+    0.8856963733393951, 0.89178370321831024, 0.89784545600551147,
+    0.90388184573618036, 0.90989308377004186, 0.91587937883577308,
+    0.92184093707449, 0.92777796208234209, 0.93369065495223358,
+    0.93957921431469316, 0.94544383637791152, 0.95128471496697198,
+    0.95710204156228607, 0.96289600533726061, 0.96866679319520854,
+    0.9744145898055272, 0.98013957763915704, 0.98584193700334044,
+    0.99152184607569538, 0.99717948093762143
+};
+
+/**
+@brief
+Values of 2^(j / 64) of FastExp2(), for 0 <= j < 64.
+*/
+const double FAST_EXP2_TABLE[64] = {
+    1, 1.0108892860517005, 1.0218971486541166,
+    1.0330248790212284, 1.0442737824274138, 1.0556451783605572,
+    1.0671404006768237, 1.0787607977571199, 1.0905077326652577,
+    1.1023825833078409, 1.1143867425958924, 1.1265216186082418,
+    1.1387886347566916, 1.1511892299529827, 1.1637248587775775,
+    1.1763969916502812, 1.189207115002721, 1.2021567314527031,
+    1.215247359980469, 1.22848053610687, 1.241857812073484,
+    1.2553807570246911, 1.2690509571917332, 1.2828700160787783,
+    1.2968395546510096, 1.3109612115247644, 1.3252366431597413,
+    1.3396675240533029, 1.3542555469368927, 1.3690024229745905,
+    1.383909881963832, 1.3989796725383112, 1.4142135623730951,
+    1.42961333839197, 1.4451808069770467, 1.460917794180647,
+    1.4768261459394993, 1.4929077282912648, 1.5091644275934228,
+    1.5255981507445384, 1.5422108254079407, 1.5590044002378369,
+    1.5759808451078865, 1.593142151342267, 1.6104903319492543,
+    1.6280274218573478, 1.6457554781539649, 1.6636765803267364,
+    1.681792830507429, 1.7001063537185235, 1.7186192981224779,
+    1.7373338352737062, 1.7562521603732995, 1.7753764925265212,
+    1.7947090750031072, 1.8142521755003989, 1.8340080864093424,
+    1.8539791250833855, 1.8741676341103, 1.8945759815869656,
+    1.9152065613971474, 1.9360617934922943, 1.9571441241754002,
+    1.9784560263879509
+};
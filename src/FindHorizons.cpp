@@ -1,19 +1,177 @@
 /**
 @file
 
-This file contains the function FindHorizons() to calculate the terminal radio
-horizon angles and distances.
+This file contains the functions FindHorizons(), FindHorizonsView() and
+FindHorizonsCompact() to calculate the terminal radio horizon angles and
+distances.
 */
 
+/* Standard includes. */
+#include <algorithm>
+#include <cmath>
+
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Simd.h"
+#include "./include/Terrain.h"
+#include "./include/Workspace.h"
+
+/**
+@brief
+Minimum number of samples to search before the SIMD kernels are used.
+*/
+#define SIMD_MIN_SAMPLES 32
+
+/**
+@brief
+Number of samples of a non-contiguous profile widened to double precision at
+a time for the SIMD kernels.
+*/
+#define HORIZON_BLOCK 256
+
+/**
+@brief
+Return the horizon search distance tables for a profile.
+
+The workspace of each thread keeps the tables of the last profile shape it
+searched.
+
+@param[in] np
+Number of points in the profile.
+
+@param[in] xi
+Profile resolution, in meters.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@return
+Distance tables.
+
+*/
+static const HorizonTables &GetHorizonTables(
+    int np,
+    double xi,
+    double d__meter
+) {
+    HorizonTables &tables = CurrentWorkspace()->horizons;
+
+    if (tables.np == np && tables.xi == xi)
+        return tables;
+
+    ReserveHorizonTables(&tables, np);
+
+    tables.np = np;
+    tables.xi = xi;
+
+    double d_tx__meter = 0.0;
+    double d_rx__meter = d__meter;
+
+    for (int i = 1; i < np; i++)
+    {
+        d_tx__meter = d_tx__meter + xi;
+        d_rx__meter = d_rx__meter - xi;
+
+        tables.d_tx__meter[i] = d_tx__meter;
+        tables.c_tx[i] = d_tx__meter / (2.0 * a_m__meter);
+        tables.d_rx__meter[i] = d_rx__meter;
+        tables.c_rx[i] = d_rx__meter / (2.0 * a_m__meter);
+    }
+
+    return tables;
+}
+
+#ifdef ILM_X86_SIMD
+
+/**
+@brief
+Search a run of samples for the horizon maxima with the widest kernel the CPU
+supports.
+
+@param[in] z__meter
+Terrain elevations of the run, in meters, starting at sample i_0.
+
+@param[in] tables
+Distance tables of the profile.
+
+@param[in] i_0
+Index of the first sample of the run.
+
+@param[in] n
+Number of samples in the run.
+
+@param[in] z_tx__meter
+TX antenna elevation, in meters.
+
+@param[in] z_rx__meter
+RX antenna elevation, in meters.
+
+@param[out] theta_max
+Maximum TX and RX horizon angles.
+
+@param[out] i_max
+Sample index of the TX and RX maxima, or -1 if none was found.
+
+*/
+static void FindHorizonsSimd(
+    const double z__meter[],
+    const HorizonTables &tables,
+    int i_0,
+    int n,
+    double z_tx__meter,
+    double z_rx__meter,
+    double theta_max[2],
+    int i_max[2]
+) {
+    if (CpuSupportsAvx512())
+        FindHorizonsAvx512(
+            z__meter,
+            &tables.d_tx__meter[i_0],
+            &tables.c_tx[i_0],
+            &tables.d_rx__meter[i_0],
+            &tables.c_rx[i_0],
+            0,
+            n,
+            z_tx__meter,
+            z_rx__meter,
+            theta_max,
+            i_max
+        );
+    else
+        FindHorizonsAvx2(
+            z__meter,
+            &tables.d_tx__meter[i_0],
+            &tables.c_tx[i_0],
+            &tables.d_rx__meter[i_0],
+            &tables.c_rx[i_0],
+            0,
+            n,
+            z_tx__meter,
+            z_rx__meter,
+            theta_max,
+            i_max
+        );
+
+    for (int j = 0; j < 2; j++)
+    {
+        if (i_max[j] >= 0)
+            i_max[j] += i_0;
+    }
+}
+
+#endif
 
 /**
 @brief
 Compute the terminals' radio horizon angle and distance.
 
-@param[in] pfl[]
-Terrain data.
+On CPUs with AVX2 or AVX-512 long profiles are searched with a vectorized
+kernel, which returns results identical to the scalar search. Profiles that
+are not a contiguous array of doubles are widened into a small buffer a block
+at a time.
+
+@param[in] terrain
+Terrain profile.
 
 @param[in] h__meter
 Terminal structural heights, in meters.
@@ -25,24 +183,25 @@ Terminal radio horizon angle, in radians.
 Terminal radio horizon distance, in meters.
 
 */
-void FindHorizons(
-    double pfl[],
+template <typename Terrain>
+static void FindTerrainHorizons(
+    const Terrain &terrain,
     double h__meter[2],
     double theta_hzn[2],
     double d_hzn__meter[2]
 ) {
-    int np = int(pfl[0]);
-    double xi = pfl[1];
+    int np = terrain.Intervals();
+    double xi = terrain.Resolution();
 
-    double d__meter = pfl[0] * pfl[1];
+    double d__meter = terrain.Distance();
 
     /*
     Compute radials.
     Ignore radius of moon since it cancels out in the later math.
     */
 
-    double z_tx__meter = pfl[2] + h__meter[0];
-    double z_rx__meter = pfl[np + 2] + h__meter[1];
+    double z_tx__meter = terrain[0] + h__meter[0];
+    double z_rx__meter = terrain[np] + h__meter[1];
 
     theta_hzn[0] = (z_rx__meter - z_tx__meter) / d__meter - d__meter / (2.0 * a_m__meter);
     theta_hzn[1] = -(z_rx__meter - z_tx__meter) / d__meter - d__meter / (2.0 * a_m__meter);
@@ -50,6 +209,79 @@ void FindHorizons(
     d_hzn__meter[0] = d__meter;
     d_hzn__meter[1] = d__meter;
 
+#ifdef ILM_X86_SIMD
+    if (np - 1 >= SIMD_MIN_SAMPLES && (CpuSupportsAvx512() || CpuSupportsAvx2()))
+    {
+        const HorizonTables &tables = GetHorizonTables(np, xi, d__meter);
+
+        double theta_max[2] = { -HUGE_VAL, -HUGE_VAL };
+        int i_max[2] = { -1, -1 };
+
+        const double *z__meter = terrain.Contiguous();
+
+        if (z__meter != nullptr)
+        {
+            FindHorizonsSimd(
+                &z__meter[1],
+                tables,
+                1,
+                np - 1,
+                z_tx__meter,
+                z_rx__meter,
+                theta_max,
+                i_max
+            );
+        }
+        else
+        {
+            // Widen the terrain a block at a time into a buffer that stays
+            // in cache, keeping the first block that attains each maximum.
+            double z_block__meter[HORIZON_BLOCK];
+
+            for (int i_0 = 1; i_0 < np; i_0 += HORIZON_BLOCK)
+            {
+                int n = std::min(HORIZON_BLOCK, np - i_0);
+
+                terrain.Widen(i_0, n, z_block__meter);
+
+                double theta_block[2];
+                int i_block[2];
+
+                FindHorizonsSimd(
+                    z_block__meter,
+                    tables,
+                    i_0,
+                    n,
+                    z_tx__meter,
+                    z_rx__meter,
+                    theta_block,
+                    i_block
+                );
+
+                for (int j = 0; j < 2; j++)
+                {
+                    if (i_block[j] >= 0 && (i_max[j] < 0 || theta_block[j] > theta_max[j]))
+                    {
+                        theta_max[j] = theta_block[j];
+                        i_max[j] = i_block[j];
+                    }
+                }
+            }
+        }
+
+        for (int j = 0; j < 2; j++)
+        {
+            if (i_max[j] >= 0 && theta_max[j] > theta_hzn[j])
+            {
+                theta_hzn[j] = theta_max[j];
+                d_hzn__meter[j] = (j == 0) ? tables.d_tx__meter[i_max[j]] : tables.d_rx__meter[i_max[j]];
+            }
+        }
+
+        return;
+    }
+#endif
+
     double d_tx__meter = 0.0;
     double d_rx__meter = d__meter;
 
@@ -60,8 +292,8 @@ void FindHorizons(
         d_tx__meter = d_tx__meter + xi;
         d_rx__meter = d_rx__meter - xi;
 
-        theta_tx = (pfl[i + 2] - z_tx__meter) / d_tx__meter - d_tx__meter / (2.0 * a_m__meter);
-        theta_rx = -(z_rx__meter - pfl[i + 2]) / d_rx__meter - d_rx__meter / (2.0 * a_m__meter);
+        theta_tx = (terrain[i] - z_tx__meter) / d_tx__meter - d_tx__meter / (2.0 * a_m__meter);
+        theta_rx = -(z_rx__meter - terrain[i]) / d_rx__meter - d_rx__meter / (2.0 * a_m__meter);
 
         if (theta_tx > theta_hzn[0])
         {
@@ -75,4 +307,99 @@ void FindHorizons(
             d_hzn__meter[1] = d_rx__meter;
         }
     }
+}
+
+/**
+@brief
+Compute the terminals' radio horizon angle and distance.
+
+On CPUs with AVX2 or AVX-512 long profiles are searched with a vectorized
+kernel, which returns results identical to the scalar search.
+
+@param[in] pfl[]
+Terrain data.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[out] theta_hzn
+Terminal radio horizon angle, in radians.
+
+@param[out] d_hzn__meter
+Terminal radio horizon distance, in meters.
+
+*/
+void FindHorizons(
+    double pfl[],
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2]
+) {
+    PflTerrain terrain = { pfl };
+
+    FindTerrainHorizons(terrain, h__meter, theta_hzn, d_hzn__meter);
+}
+
+/**
+@brief
+Compute the terminals' radio horizon angle and distance for a terrain profile
+stored in place.
+
+The results are identical to FindHorizons() on the same profile in pfl
+format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[out] theta_hzn
+Terminal radio horizon angle, in radians.
+
+@param[out] d_hzn__meter
+Terminal radio horizon distance, in meters.
+
+*/
+void FindHorizonsView(
+    const TerrainView *view,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2]
+) {
+    StridedTerrain terrain = { view };
+
+    FindTerrainHorizons(terrain, h__meter, theta_hzn, d_hzn__meter);
+}
+
+/**
+@brief
+Compute the terminals' radio horizon angle and distance for a terrain profile
+in a compact encoding.
+
+Elevations are widened to double precision as they are read, so the results
+are identical to FindHorizons() on the widened profile in pfl format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[out] theta_hzn
+Terminal radio horizon angle, in radians.
+
+@param[out] d_hzn__meter
+Terminal radio horizon distance, in meters.
+
+*/
+void FindHorizonsCompact(
+    const CompactTerrainView *view,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2]
+) {
+    WithCompactTerrain(view, [&](const auto &terrain) {
+        FindTerrainHorizons(terrain, h__meter, theta_hzn, d_hzn__meter);
+    });
 }
\ No newline at end of file
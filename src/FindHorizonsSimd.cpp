@@ -0,0 +1,360 @@
+/**
+@file
+
+This file contains the AVX2 and AVX-512 kernels of the FindHorizons()
+horizon search.
+*/
+
+/* Standard includes. */
+#include <cmath>
+
+/* Local includes. */
+#include "./include/Simd.h"
+
+#ifdef ILM_X86_SIMD
+
+/**
+@brief
+Merge the per-lane horizon maxima of a kernel into a single maximum.
+
+Lanes are merged so the result is the first (lowest index) sample that
+attains the maximum, which is the sample the scalar search selects.
+
+@param[in] lanes
+Number of lanes.
+
+@param[in] theta_lane
+Per-lane maximum horizon angles.
+
+@param[in] i_lane
+Per-lane index of the maximum, or -1 if the lane found none.
+
+@param[out] theta_max
+Maximum horizon angle.
+
+@param[out] i_max
+Index of the maximum, or -1 if none was found.
+
+*/
+static void ReduceLanes(
+    int lanes,
+    const double theta_lane[],
+    const double i_lane[],
+    double *theta_max,
+    int *i_max
+) {
+    *theta_max = -HUGE_VAL;
+    *i_max = -1;
+
+    for (int j = 0; j < lanes; j++)
+    {
+        if (i_lane[j] < 0.0)
+            continue;
+
+        int i = int(i_lane[j]);
+        if (*i_max < 0 || theta_lane[j] > *theta_max ||
+            (theta_lane[j] == *theta_max && i < *i_max))
+        {
+            *theta_max = theta_lane[j];
+            *i_max = i;
+        }
+    }
+}
+
+/**
+@brief
+Continue a horizon search with scalar code over the remaining samples.
+
+@param[in] z__meter
+Terrain elevations, in meters.
+
+@param[in] d_tx__meter
+Distance tables from the TX, in meters.
+
+@param[in] c_tx
+Curvature terms d_tx__meter / (2 a_m__meter).
+
+@param[in] d_rx__meter
+Distance tables from the RX, in meters.
+
+@param[in] c_rx
+Curvature terms d_rx__meter / (2 a_m__meter).
+
+@param[in] i_start
+First sample index.
+
+@param[in] i_end
+One past the last sample index.
+
+@param[in] z_tx__meter
+TX antenna elevation, in meters.
+
+@param[in] z_rx__meter
+RX antenna elevation, in meters.
+
+@param[in,out] theta_max
+Maximum TX and RX horizon angles.
+
+@param[in,out] i_max
+Index of the TX and RX maxima, or -1 if none was found.
+
+*/
+static void FindHorizonsTail(
+    const double z__meter[],
+    const double d_tx__meter[],
+    const double c_tx[],
+    const double d_rx__meter[],
+    const double c_rx[],
+    int i_start,
+    int i_end,
+    double z_tx__meter,
+    double z_rx__meter,
+    double theta_max[2],
+    int i_max[2]
+) {
+    for (int i = i_start; i < i_end; i++)
+    {
+        double theta_tx = (z__meter[i] - z_tx__meter) / d_tx__meter[i] - c_tx[i];
+        double theta_rx = (z__meter[i] - z_rx__meter) / d_rx__meter[i] - c_rx[i];
+
+        if (theta_tx > theta_max[0])
+        {
+            theta_max[0] = theta_tx;
+            i_max[0] = i;
+        }
+
+        if (theta_rx > theta_max[1])
+        {
+            theta_max[1] = theta_rx;
+            i_max[1] = i;
+        }
+    }
+}
+
+/**
+@brief
+Find the TX and RX horizon maxima over a range of samples using AVX2.
+
+For each sample the TX angle (z - z_tx) / d_tx - c_tx and the RX angle
+(z - z_rx) / d_rx - c_rx are computed exactly as the scalar search does, and
+the first sample attaining each maximum is returned.
+
+@param[in] z__meter
+Terrain elevations, in meters.
+
+@param[in] d_tx__meter
+Distance tables from the TX, in meters.
+
+@param[in] c_tx
+Curvature terms d_tx__meter / (2 a_m__meter).
+
+@param[in] d_rx__meter
+Distance tables from the RX, in meters.
+
+@param[in] c_rx
+Curvature terms d_rx__meter / (2 a_m__meter).
+
+@param[in] i_start
+First sample index.
+
+@param[in] i_end
+One past the last sample index.
+
+@param[in] z_tx__meter
+TX antenna elevation, in meters.
+
+@param[in] z_rx__meter
+RX antenna elevation, in meters.
+
+@param[out] theta_max
+Maximum TX and RX horizon angles.
+
+@param[out] i_max
+Index of the TX and RX maxima, or -1 if none was found.
+
+*/
+ILM_TARGET_AVX2 void FindHorizonsAvx2(
+    const double z__meter[],
+    const double d_tx__meter[],
+    const double c_tx[],
+    const double d_rx__meter[],
+    const double c_rx[],
+    int i_start,
+    int i_end,
+    double z_tx__meter,
+    double z_rx__meter,
+    double theta_max[2],
+    int i_max[2]
+) {
+    __m256d z_tx = _mm256_set1_pd(z_tx__meter);
+    __m256d z_rx = _mm256_set1_pd(z_rx__meter);
+    __m256d max_tx = _mm256_set1_pd(-HUGE_VAL);
+    __m256d max_rx = _mm256_set1_pd(-HUGE_VAL);
+    __m256d idx_tx = _mm256_set1_pd(-1.0);
+    __m256d idx_rx = _mm256_set1_pd(-1.0);
+    __m256d idx = _mm256_setr_pd(i_start, i_start + 1.0, i_start + 2.0, i_start + 3.0);
+    __m256d step = _mm256_set1_pd(4.0);
+
+    int i = i_start;
+    for (; i + 4 <= i_end; i += 4)
+    {
+        __m256d z = _mm256_loadu_pd(&z__meter[i]);
+
+        __m256d theta_tx = _mm256_sub_pd(
+            _mm256_div_pd(_mm256_sub_pd(z, z_tx), _mm256_loadu_pd(&d_tx__meter[i])),
+            _mm256_loadu_pd(&c_tx[i]));
+        __m256d theta_rx = _mm256_sub_pd(
+            _mm256_div_pd(_mm256_sub_pd(z, z_rx), _mm256_loadu_pd(&d_rx__meter[i])),
+            _mm256_loadu_pd(&c_rx[i]));
+
+        __m256d gt_tx = _mm256_cmp_pd(theta_tx, max_tx, _CMP_GT_OQ);
+        max_tx = _mm256_blendv_pd(max_tx, theta_tx, gt_tx);
+        idx_tx = _mm256_blendv_pd(idx_tx, idx, gt_tx);
+
+        __m256d gt_rx = _mm256_cmp_pd(theta_rx, max_rx, _CMP_GT_OQ);
+        max_rx = _mm256_blendv_pd(max_rx, theta_rx, gt_rx);
+        idx_rx = _mm256_blendv_pd(idx_rx, idx, gt_rx);
+
+        idx = _mm256_add_pd(idx, step);
+    }
+
+    double theta_lane[4];
+    double i_lane[4];
+
+    _mm256_storeu_pd(theta_lane, max_tx);
+    _mm256_storeu_pd(i_lane, idx_tx);
+    ReduceLanes(4, theta_lane, i_lane, &theta_max[0], &i_max[0]);
+
+    _mm256_storeu_pd(theta_lane, max_rx);
+    _mm256_storeu_pd(i_lane, idx_rx);
+    ReduceLanes(4, theta_lane, i_lane, &theta_max[1], &i_max[1]);
+
+    FindHorizonsTail(
+        z__meter,
+        d_tx__meter,
+        c_tx,
+        d_rx__meter,
+        c_rx,
+        i,
+        i_end,
+        z_tx__meter,
+        z_rx__meter,
+        theta_max,
+        i_max
+    );
+}
+
+/**
+@brief
+Find the TX and RX horizon maxima over a range of samples using AVX-512.
+
+See FindHorizonsAvx2().
+
+@param[in] z__meter
+Terrain elevations, in meters.
+
+@param[in] d_tx__meter
+Distance tables from the TX, in meters.
+
+@param[in] c_tx
+Curvature terms d_tx__meter / (2 a_m__meter).
+
+@param[in] d_rx__meter
+Distance tables from the RX, in meters.
+
+@param[in] c_rx
+Curvature terms d_rx__meter / (2 a_m__meter).
+
+@param[in] i_start
+First sample index.
+
+@param[in] i_end
+One past the last sample index.
+
+@param[in] z_tx__meter
+TX antenna elevation, in meters.
+
+@param[in] z_rx__meter
+RX antenna elevation, in meters.
+
+@param[out] theta_max
+Maximum TX and RX horizon angles.
+
+@param[out] i_max
+Index of the TX and RX maxima, or -1 if none was found.
+
+*/
+ILM_TARGET_AVX512 void FindHorizonsAvx512(
+    const double z__meter[],
+    const double d_tx__meter[],
+    const double c_tx[],
+    const double d_rx__meter[],
+    const double c_rx[],
+    int i_start,
+    int i_end,
+    double z_tx__meter,
+    double z_rx__meter,
+    double theta_max[2],
+    int i_max[2]
+) {
+    __m512d z_tx = _mm512_set1_pd(z_tx__meter);
+    __m512d z_rx = _mm512_set1_pd(z_rx__meter);
+    __m512d max_tx = _mm512_set1_pd(-HUGE_VAL);
+    __m512d max_rx = _mm512_set1_pd(-HUGE_VAL);
+    __m512d idx_tx = _mm512_set1_pd(-1.0);
+    __m512d idx_rx = _mm512_set1_pd(-1.0);
+    __m512d idx = _mm512_setr_pd(
+        i_start, i_start + 1.0, i_start + 2.0, i_start + 3.0,
+        i_start + 4.0, i_start + 5.0, i_start + 6.0, i_start + 7.0);
+    __m512d step = _mm512_set1_pd(8.0);
+
+    int i = i_start;
+    for (; i + 8 <= i_end; i += 8)
+    {
+        __m512d z = _mm512_loadu_pd(&z__meter[i]);
+
+        __m512d theta_tx = _mm512_sub_pd(
+            _mm512_div_pd(_mm512_sub_pd(z, z_tx), _mm512_loadu_pd(&d_tx__meter[i])),
+            _mm512_loadu_pd(&c_tx[i]));
+        __m512d theta_rx = _mm512_sub_pd(
+            _mm512_div_pd(_mm512_sub_pd(z, z_rx), _mm512_loadu_pd(&d_rx__meter[i])),
+            _mm512_loadu_pd(&c_rx[i]));
+
+        __mmask8 gt_tx = _mm512_cmp_pd_mask(theta_tx, max_tx, _CMP_GT_OQ);
+        max_tx = _mm512_mask_blend_pd(gt_tx, max_tx, theta_tx);
+        idx_tx = _mm512_mask_blend_pd(gt_tx, idx_tx, idx);
+
+        __mmask8 gt_rx = _mm512_cmp_pd_mask(theta_rx, max_rx, _CMP_GT_OQ);
+        max_rx = _mm512_mask_blend_pd(gt_rx, max_rx, theta_rx);
+        idx_rx = _mm512_mask_blend_pd(gt_rx, idx_rx, idx);
+
+        idx = _mm512_add_pd(idx, step);
+    }
+
+    double theta_lane[8];
+    double i_lane[8];
+
+    _mm512_storeu_pd(theta_lane, max_tx);
+    _mm512_storeu_pd(i_lane, idx_tx);
+    ReduceLanes(8, theta_lane, i_lane, &theta_max[0], &i_max[0]);
+
+    _mm512_storeu_pd(theta_lane, max_rx);
+    _mm512_storeu_pd(i_lane, idx_rx);
+    ReduceLanes(8, theta_lane, i_lane, &theta_max[1], &i_max[1]);
+
+    FindHorizonsTail(
+        z__meter,
+        d_tx__meter,
+        c_tx,
+        d_rx__meter,
+        c_rx,
+        i,
+        i_end,
+        z_tx__meter,
+        z_rx__meter,
+        theta_max,
+        i_max
+    );
+}
+
+#endif  // ILM_X86_SIMD
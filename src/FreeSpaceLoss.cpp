@@ -5,11 +5,10 @@ This file contains FreeSpaceLoss() which returns the free space basic
 transmission loss in dB.
 */
 
-/* Standard includes. */
-#include <cmath>
-
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/RadioContext.h"
 
 /** |
 @brief
@@ -29,5 +28,33 @@ double FreeSpaceLoss(
     double d__meter,
     double f__mhz
 ) {
-    return 32.45 + 20.0 * log10(f__mhz) + 20.0 * log10(d__meter / 1000.0);
+    return ExactModel::FreeSpaceLoss(
+        d__meter,
+        f__mhz
+    );
+}
+
+/**
+@brief
+Return the free space basic transmission loss in dB, with the frequency term
+of a radio context.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] radio
+Radio context.
+
+@return A_fs__db
+Free space basic transmission loss, in dB.
+
+*/
+double FreeSpaceLoss(
+    double d__meter,
+    const RadioContext *radio
+) {
+    return ExactModel::FreeSpaceLoss(
+        d__meter,
+        EngineRadioOf(radio)
+    );
 }
\ No newline at end of file
@@ -0,0 +1,796 @@
+/**
+@file
+
+This file contains the GreatCircleDistance(), ExtractGreatCircleProfile(),
+ExtractGreatCircleProfileCached(), PlanGreatCircleProfiles() and
+ExtractGreatCircleProfiles() functions.
+*/
+
+/* Standard includes. */
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+/* Local includes. */
+#include "./include/LunarDem.h"
+#include "./include/LunarDemCache.h"
+#include "./include/Errors.h"
+#include "./include/Executor.h"
+#include "./include/Simd.h"
+
+/**
+@brief
+Number of points between exact evaluations of the great circle, with the
+points between them found by rotation.
+*/
+#define GREAT_CIRCLE_EXACT_STEP 256
+
+/**
+@brief
+Smallest sine of the central angle for which the great circle between two
+points is defined, about 2 micrometers on the Moon.
+*/
+#define GREAT_CIRCLE_MIN_SINE 1e-12
+
+/**
+@brief
+Convert a latitude and longitude to a unit vector.
+
+@param[in] lat__deg
+Latitude, in degrees.
+
+@param[in] lon__deg
+Longitude, in degrees.
+
+@param[out] v
+Unit vector, with x towards latitude 0 and longitude 0, y towards latitude 0
+and longitude 90 and z towards the north pole.
+
+*/
+static void UnitVector(
+    double lat__deg,
+    double lon__deg,
+    double v[3]
+) {
+    double lat__rad = lat__deg * M_PI / 180.0;
+    double lon__rad = lon__deg * M_PI / 180.0;
+
+    v[0] = cos(lat__rad) * cos(lon__rad);
+    v[1] = cos(lat__rad) * sin(lon__rad);
+    v[2] = sin(lat__rad);
+}
+
+/**
+@brief
+Set up the great circle from one point to another.
+
+@param[in] lat_tx__deg
+Latitude of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitude of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitude of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitude of the RX, in degrees.
+
+@param[out] u
+Unit vector of the TX.
+
+@param[out] w
+Unit vector orthogonal to u in the plane of the great circle, towards the RX.
+Zero if the points are coincident or antipodal, so that the great circle is
+not defined.
+
+@return
+Central angle between the points, in radians.
+
+*/
+static double GreatCircle(
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg,
+    double u[3],
+    double w[3]
+) {
+    double r[3];
+    UnitVector(lat_tx__deg, lon_tx__deg, u);
+    UnitVector(lat_rx__deg, lon_rx__deg, r);
+
+    double c = u[0] * r[0] + u[1] * r[1] + u[2] * r[2];
+
+    for (int i = 0; i < 3; i++)
+        w[i] = r[i] - c * u[i];
+
+    double s = sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+
+    if (s < GREAT_CIRCLE_MIN_SINE)
+    {
+        for (int i = 0; i < 3; i++)
+            w[i] = 0.0;
+
+        return c > 0.0 ? 0.0 : M_PI;
+    }
+
+    for (int i = 0; i < 3; i++)
+        w[i] /= s;
+
+    return atan2(s, c);
+}
+
+/**
+@brief
+Compute the great circle distance between two points on the sphere of radius
+a_m__meter.
+
+@param[in] lat_tx__deg
+Latitude of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitude of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitude of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitude of the RX, in degrees.
+
+@return
+Great circle distance, in meters.
+
+*/
+double GreatCircleDistance(
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg
+) {
+    double u[3];
+    double w[3];
+
+    return a_m__meter * GreatCircle(lat_tx__deg, lon_tx__deg, lat_rx__deg, lon_rx__deg, u, w);
+}
+
+/**
+@brief
+Sampler of a lunar DEM that reads its tiles through a tile cache.
+
+Holds on to the tiles under the last few samples, so consecutive samples of a
+profile only visit the cache when they move onto another tile. On doing so
+it prefetches the tile one tile ahead along the profile.
+*/
+struct CachedDemSampler
+{
+    /**
+    Number of tiles held, enough for a sample at the corner of four tiles.
+    */
+    static const int N_HELD = 4;
+
+    /**
+    Cache.
+    */
+    LunarDemCache *cache;
+
+    /**
+    Tile lines of the held tiles.
+    */
+    int tile_line[N_HELD];
+
+    /**
+    Tile samples of the held tiles.
+    */
+    int tile_sample[N_HELD];
+
+    /**
+    Held tiles.
+    */
+    std::shared_ptr<const DemTile> tile[N_HELD];
+
+    /**
+    Held tile to replace next.
+    */
+    int next;
+
+    /**
+    Pixel of the previous sample, or negative line before the first sample.
+    */
+    double line_prev;
+
+    /**
+    Pixel of the previous sample.
+    */
+    double sample_prev;
+
+    /**
+    Start with no tiles held.
+
+    @param[in] c
+    Cache.
+    */
+    explicit CachedDemSampler(LunarDemCache *c)
+        : cache(c), next(0), line_prev(-1.0), sample_prev(0.0)
+    {
+        for (int k = 0; k < N_HELD; k++)
+        {
+            tile_line[k] = -1;
+            tile_sample[k] = -1;
+        }
+    }
+
+    /**
+    Return a held tile, finding it in the cache if it is not held.
+
+    @param[in] t_line
+    Tile line.
+
+    @param[in] t_sample
+    Tile sample.
+
+    @param[in] line
+    Zero based line of the sample being interpolated.
+
+    @param[in] sample
+    Zero based sample of the sample being interpolated.
+
+    @return
+    Tile.
+    */
+    const DemTile *Tile(int t_line, int t_sample, double line, double sample)
+    {
+        for (int k = 0; k < N_HELD; k++)
+        {
+            if (tile_line[k] == t_line && tile_sample[k] == t_sample)
+                return tile[k].get();
+        }
+
+        int k = next;
+        next = (next + 1) % N_HELD;
+
+        tile_line[k] = t_line;
+        tile_sample[k] = t_sample;
+        tile[k] = FindDemTile(cache, t_line, t_sample);
+
+        // Prefetch the tile a tile's width ahead along the profile.
+        double d_line = line - line_prev;
+        double d_sample = sample - sample_prev;
+        double d_max = std::max(fabs(d_line), fabs(d_sample));
+
+        if (line_prev >= 0.0 && d_max > 0.0)
+        {
+            double line_ahead = line + DEM_TILE_SIZE * d_line / d_max;
+            double sample_ahead = sample + DEM_TILE_SIZE * d_sample / d_max;
+
+            if (cache->dem->wraps)
+                sample_ahead = fmod(sample_ahead + cache->dem->samples, (double)cache->dem->samples);
+
+            PrefetchDemTile(
+                cache,
+                (int)floor(line_ahead) >> DEM_TILE_SHIFT,
+                (int)floor(sample_ahead) >> DEM_TILE_SHIFT
+            );
+        }
+
+        return tile[k].get();
+    }
+
+    /**
+    Sample the DEM at a pixel by bilinear interpolation.
+
+    @param[in] line
+    Zero based line, from LunarDemPixel().
+
+    @param[in] sample
+    Zero based sample, from LunarDemPixel().
+
+    @return
+    Elevation, in meters.
+    */
+    double operator()(double line, double sample)
+    {
+        auto read = [&](int j, int i) {
+            const DemTile *t = Tile(j >> DEM_TILE_SHIFT, i >> DEM_TILE_SHIFT, line, sample);
+            return t->z__meter[(size_t)(j - t->line_0) * t->samples + (i - t->sample_0)];
+        };
+
+        double z__meter = InterpolateLunarDem(cache->dem, line, sample, read);
+
+        line_prev = line;
+        sample_prev = sample;
+
+        return z__meter;
+    }
+};
+
+/**
+@brief
+Extract a terrain profile along the great circle between two points,
+sampling the DEM with a sampler.
+
+@param[in] dem
+DEM.
+
+@param[in] lat_tx__deg
+Latitude of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitude of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitude of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitude of the RX, in degrees.
+
+@param[in] np
+Number of intervals of the profile, so the profile has np + 1 points.
+
+@param[out] pfl
+Terrain data, in PFL format, with np + 3 entries.
+
+@param[in] sampler
+Function returning the elevation at a line and sample of the DEM, in meters.
+
+@return error
+Error code.
+
+*/
+template <typename Sampler>
+static int ExtractProfile(
+    const LunarDem *dem,
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg,
+    int np,
+    double pfl[],
+    Sampler &sampler
+) {
+    double u[3];
+    double w[3];
+
+    double omega__rad = GreatCircle(lat_tx__deg, lon_tx__deg, lat_rx__deg, lon_rx__deg, u, w);
+
+    // Coincident or antipodal points do not define a great circle.
+    if (np < 1 || (w[0] == 0.0 && w[1] == 0.0 && w[2] == 0.0))
+        return ERROR__PATH_DISTANCE;
+
+    double delta__rad = omega__rad / np;
+
+    pfl[0] = np;
+    pfl[1] = delta__rad * a_m__meter;
+
+    double cos_delta = cos(delta__rad);
+    double sin_delta = sin(delta__rad);
+
+    double c = 1.0;
+    double s = 0.0;
+
+    for (int i = 0; i <= np; i++)
+    {
+        // Evaluate exactly now and then so the rotation does not drift.
+        if (i % GREAT_CIRCLE_EXACT_STEP == 0)
+        {
+            c = cos(i * delta__rad);
+            s = sin(i * delta__rad);
+        }
+
+        double v[3] = {
+            c * u[0] + s * w[0],
+            c * u[1] + s * w[1],
+            c * u[2] + s * w[2]
+        };
+
+        double line;
+        double sample;
+        if (!LunarDemPixel(dem, v, &line, &sample))
+            return ERROR__TERRAIN_EXTENT;
+
+        pfl[i + 2] = sampler(line, sample);
+
+        double c_next = c * cos_delta - s * sin_delta;
+        s = s * cos_delta + c * sin_delta;
+        c = c_next;
+    }
+
+    return SUCCESS;
+}
+
+/**
+@brief
+Extract a terrain profile along the great circle between two points from a
+lunar DEM.
+
+The profile has np + 1 points evenly spaced along the great circle on the
+sphere of radius a_m__meter, each sampled from the DEM by bilinear
+interpolation, and is written in PFL format into a caller allocated buffer.
+Choosing np near GreatCircleDistance() / LunarDemSpacing() samples the DEM at
+about its own resolution.
+
+@param[in] dem
+DEM, from OpenLunarDem().
+
+@param[in] lat_tx__deg
+Latitude of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitude of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitude of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitude of the RX, in degrees.
+
+@param[in] np
+Number of intervals of the profile, so the profile has np + 1 points.
+
+@param[out] pfl
+Terrain data, in PFL format, with np + 3 entries.
+
+@return error
+Error code.
+
+*/
+int ExtractGreatCircleProfile(
+    const LunarDem *dem,
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg,
+    int np,
+    double pfl[]
+) {
+    auto sampler = [dem](double line, double sample) {
+        return SampleLunarDem(dem, line, sample);
+    };
+
+    return ExtractProfile(dem, lat_tx__deg, lon_tx__deg, lat_rx__deg, lon_rx__deg, np, pfl, sampler);
+}
+
+/**
+@brief
+Extract a terrain profile along the great circle between two points from a
+lunar DEM, reading the DEM through a tile cache.
+
+The profile is identical to ExtractGreatCircleProfile() on the cache's DEM.
+Any number of threads may extract profiles through the same cache.
+
+@param[in] cache
+Cache, from CreateLunarDemCache().
+
+@param[in] lat_tx__deg
+Latitude of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitude of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitude of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitude of the RX, in degrees.
+
+@param[in] np
+Number of intervals of the profile, so the profile has np + 1 points.
+
+@param[out] pfl
+Terrain data, in PFL format, with np + 3 entries.
+
+@return error
+Error code.
+
+*/
+int ExtractGreatCircleProfileCached(
+    LunarDemCache *cache,
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg,
+    int np,
+    double pfl[]
+) {
+    CachedDemSampler sampler(cache);
+
+    return ExtractProfile(cache->dem, lat_tx__deg, lon_tx__deg, lat_rx__deg, lon_rx__deg, np, pfl, sampler);
+}
+
+/**
+@brief
+Return the number of intervals of a profile with at most a given spacing.
+
+@param[in] lat_tx__deg
+Latitude of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitude of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitude of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitude of the RX, in degrees.
+
+@param[in] xi__meter
+Largest spacing of the profile, in meters.
+
+@return
+Number of intervals, or 0 if the points coincide or the spacing is not
+positive.
+
+*/
+static int ProfileIntervals(
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg,
+    double xi__meter
+) {
+    double d__meter = GreatCircleDistance(lat_tx__deg, lon_tx__deg, lat_rx__deg, lon_rx__deg);
+
+    if (!(xi__meter > 0.0) || !(d__meter > 0.0))
+        return 0;
+
+    double np = ceil(d__meter / xi__meter);
+    if (!(np <= INT_MAX - 3))
+        return 0;
+
+    return std::max(1, (int)np);
+}
+
+#ifdef ILM_X86_SIMD
+/**
+@brief
+Extract a terrain profile along the great circle between two points from a
+lunar DEM with the AVX2 kernel, in blocks of GREAT_CIRCLE_EXACT_STEP points.
+
+The points of each block are found by the same rotation as
+ExtractGreatCircleProfile(), then located and sampled four at a time.
+
+@param[in] dem
+DEM, with 16 bit samples not starting in the first two bytes of the mapping.
+
+@param[in] lat_tx__deg
+Latitude of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitude of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitude of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitude of the RX, in degrees.
+
+@param[in] np
+Number of intervals of the profile, so the profile has np + 1 points.
+
+@param[out] pfl
+Terrain data, in PFL format, with np + 3 entries.
+
+@return error
+Error code.
+
+*/
+static int ExtractProfileAvx2(
+    const LunarDem *dem,
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg,
+    int np,
+    double pfl[]
+) {
+    double u[3];
+    double w[3];
+
+    double omega__rad = GreatCircle(lat_tx__deg, lon_tx__deg, lat_rx__deg, lon_rx__deg, u, w);
+
+    if (np < 1 || (w[0] == 0.0 && w[1] == 0.0 && w[2] == 0.0))
+        return ERROR__PATH_DISTANCE;
+
+    double delta__rad = omega__rad / np;
+
+    pfl[0] = np;
+    pfl[1] = delta__rad * a_m__meter;
+
+    double cos_delta = cos(delta__rad);
+    double sin_delta = sin(delta__rad);
+
+    double c_block[GREAT_CIRCLE_EXACT_STEP];
+    double s_block[GREAT_CIRCLE_EXACT_STEP];
+
+    for (int i_0 = 0; i_0 <= np; i_0 += GREAT_CIRCLE_EXACT_STEP)
+    {
+        int n = std::min(GREAT_CIRCLE_EXACT_STEP, np + 1 - i_0);
+
+        double c = cos(i_0 * delta__rad);
+        double s = sin(i_0 * delta__rad);
+
+        for (int k = 0; k < n; k++)
+        {
+            c_block[k] = c;
+            s_block[k] = s;
+
+            double c_next = c * cos_delta - s * sin_delta;
+            s = s * cos_delta + c * sin_delta;
+            c = c_next;
+        }
+
+        if (!SampleGreatCircleAvx2(dem, u, w, c_block, s_block, n, &pfl[i_0 + 2]))
+            return ERROR__TERRAIN_EXTENT;
+    }
+
+    return SUCCESS;
+}
+#endif  // ILM_X86_SIMD
+
+/**
+@brief
+Compute the layout of a batch of great circle profiles, for
+ExtractGreatCircleProfiles().
+
+Each profile has the fewest intervals for which its spacing is at most the
+requested spacing, and the profiles are packed back-to-back in PFL format.
+
+@param[in] n
+Number of profiles.
+
+@param[in] lat_tx__deg
+Latitudes of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitudes of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitudes of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitudes of the RX, in degrees.
+
+@param[in] xi__meter
+Largest spacings of the profiles, in meters.
+
+@param[out] pfl_offsets
+Index of each profile's pfl[0] in the packed profiles.
+
+@return
+Number of entries of the packed profiles.
+
+*/
+long long PlanGreatCircleProfiles(
+    int n,
+    const double lat_tx__deg[],
+    const double lon_tx__deg[],
+    const double lat_rx__deg[],
+    const double lon_rx__deg[],
+    const double xi__meter[],
+    long long pfl_offsets[]
+) {
+    long long size = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        int np = ProfileIntervals(lat_tx__deg[i], lon_tx__deg[i], lat_rx__deg[i], lon_rx__deg[i], xi__meter[i]);
+
+        // Profiles that cannot be extracted still get room for a short one.
+        pfl_offsets[i] = size;
+        size += std::max(np, 1) + 3;
+    }
+
+    return size;
+}
+
+/**
+@brief
+Extract a batch of terrain profiles along great circles from a lunar DEM, on
+a pool of threads.
+
+The profiles are laid out by PlanGreatCircleProfiles(), so they can be passed
+with their offsets straight to PointToPointBatchParallel(). Each profile has
+the points ExtractGreatCircleProfile() would give it, located and sampled
+four at a time with AVX2 gathers on CPUs that support it. On such CPUs the
+latitudes and longitudes of equirectangular grids come from a vector
+arctangent, which can move a point by about 1e-12 pixels, so elevations can
+differ from ExtractGreatCircleProfile() in the last bits; polar stereographic
+profiles are identical.
+
+@param[in] dem
+DEM, from OpenLunarDem().
+
+@param[in] n
+Number of profiles.
+
+@param[in] lat_tx__deg
+Latitudes of the TX, in degrees.
+
+@param[in] lon_tx__deg
+Longitudes of the TX, in degrees.
+
+@param[in] lat_rx__deg
+Latitudes of the RX, in degrees.
+
+@param[in] lon_rx__deg
+Longitudes of the RX, in degrees.
+
+@param[in] xi__meter
+Largest spacings of the profiles, in meters.
+
+@param[in] pfl_offsets
+Index of each profile's pfl[0] in the packed profiles, from
+PlanGreatCircleProfiles().
+
+@param[out] pfls
+Packed profiles, in PFL format.
+
+@param[out] errors
+Error code of each profile.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@return error
+SUCCESS, or ERROR__BATCH_ELEMENT if any profile returned an error.
+
+*/
+int ExtractGreatCircleProfiles(
+    const LunarDem *dem,
+    int n,
+    const double lat_tx__deg[],
+    const double lon_tx__deg[],
+    const double lat_rx__deg[],
+    const double lon_rx__deg[],
+    const double xi__meter[],
+    const long long pfl_offsets[],
+    double pfls[],
+    int errors[],
+    int n_threads
+) {
+    std::vector<int> np(n > 0 ? n : 0);
+    std::vector<double> cost(np.size());
+
+    for (int i = 0; i < n; i++)
+    {
+        np[i] = ProfileIntervals(lat_tx__deg[i], lon_tx__deg[i], lat_rx__deg[i], lon_rx__deg[i], xi__meter[i]);
+        cost[i] = np[i] + 1.0;
+    }
+
+#ifdef ILM_X86_SIMD
+    // The 16 bit gathers read the two bytes before each sample.
+    bool simd = CpuSupportsAvx2() && (dem->sample_type != DEM_SAMPLE__INT16 ||
+        dem->data >= (const unsigned char *)dem->map + 2);
+#endif
+
+    ParallelFor(n, cost.data(), n_threads, [&](int i) {
+        double *pfl = &pfls[pfl_offsets[i]];
+
+        if (np[i] == 0)
+        {
+            errors[i] = ERROR__PATH_DISTANCE;
+            return;
+        }
+
+#ifdef ILM_X86_SIMD
+        if (simd)
+        {
+            errors[i] = ExtractProfileAvx2(dem, lat_tx__deg[i], lon_tx__deg[i], lat_rx__deg[i], lon_rx__deg[i], np[i], pfl);
+            return;
+        }
+#endif
+
+        errors[i] = ExtractGreatCircleProfile(dem, lat_tx__deg[i], lon_tx__deg[i], lat_rx__deg[i], lon_rx__deg[i], np[i], pfl);
+    });
+
+    for (int i = 0; i < n; i++)
+    {
+        if (errors[i] != SUCCESS)
+            return ERROR__BATCH_ELEMENT;
+    }
+
+    return SUCCESS;
+}
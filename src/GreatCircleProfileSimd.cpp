@@ -0,0 +1,324 @@
+/**
+@file
+
+This file contains the AVX2 kernel that samples a lunar DEM along a great
+circle.
+*/
+
+/* Standard includes. */
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdint>
+
+/* Local includes. */
+#include "./include/LunarDem.h"
+#include "./include/Simd.h"
+
+#ifdef ILM_X86_SIMD
+
+/**
+@brief
+Compute the arctangent of y / x in the quadrant of (x, y) using AVX2.
+
+Uses the Cephes range reduction and rational approximation of the arctangent,
+which is within 2 ulp of the correctly rounded result. atan2(0, 0) is 0.
+
+@param[in] y
+Ordinates.
+
+@param[in] x
+Abscissas.
+
+@return
+Angles, in radians.
+
+*/
+ILM_TARGET_AVX2 static __m256d Atan2Avx2(
+    __m256d y,
+    __m256d x
+) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    __m256d ax = _mm256_andnot_pd(sign, x);
+    __m256d ay = _mm256_andnot_pd(sign, y);
+
+    __m256d t = _mm256_div_pd(ay, ax);
+    t = _mm256_blendv_pd(t, zero, _mm256_cmp_pd(ay, zero, _CMP_EQ_OQ));
+
+    // Reduce to |t| <= 0.66 about 0, pi / 4 or pi / 2.
+    __m256d large = _mm256_cmp_pd(t, _mm256_set1_pd(2.41421356237309504880), _CMP_GT_OQ);
+    __m256d middle = _mm256_andnot_pd(large, _mm256_cmp_pd(t, _mm256_set1_pd(0.66), _CMP_GT_OQ));
+
+    __m256d base = _mm256_blendv_pd(zero, _mm256_set1_pd(M_PI / 4.0), middle);
+    base = _mm256_blendv_pd(base, _mm256_set1_pd(M_PI / 2.0), large);
+
+    __m256d more = _mm256_blendv_pd(zero, _mm256_set1_pd(0.5 * 6.123233995736765886130e-17), middle);
+    more = _mm256_blendv_pd(more, _mm256_set1_pd(6.123233995736765886130e-17), large);
+
+    __m256d r = _mm256_blendv_pd(t, _mm256_div_pd(_mm256_sub_pd(t, one), _mm256_add_pd(t, one)), middle);
+    r = _mm256_blendv_pd(r, _mm256_div_pd(_mm256_set1_pd(-1.0), t), large);
+
+    __m256d z = _mm256_mul_pd(r, r);
+
+    __m256d p = _mm256_set1_pd(-8.750608600031904122785e-1);
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(-1.615753718733365076637e1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(-7.500855792314704667340e1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(-1.228866684490136173410e2));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(-6.485021904942025371773e1));
+
+    __m256d q = _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962e1));
+    q = _mm256_add_pd(_mm256_mul_pd(q, z), _mm256_set1_pd(1.650270098316988542046e2));
+    q = _mm256_add_pd(_mm256_mul_pd(q, z), _mm256_set1_pd(4.328810604912902668951e2));
+    q = _mm256_add_pd(_mm256_mul_pd(q, z), _mm256_set1_pd(4.853903996359136964868e2));
+    q = _mm256_add_pd(_mm256_mul_pd(q, z), _mm256_set1_pd(1.945506571482613964425e2));
+
+    __m256d a = _mm256_div_pd(_mm256_mul_pd(z, p), q);
+    a = _mm256_add_pd(_mm256_mul_pd(r, a), r);
+    a = _mm256_add_pd(base, _mm256_add_pd(a, more));
+
+    // Reflect into the quadrant of (x, y) by the sign bits, as atan2() does
+    // for signed zeros.
+    a = _mm256_blendv_pd(a, _mm256_sub_pd(_mm256_set1_pd(M_PI), a), x);
+
+    return _mm256_or_pd(a, _mm256_and_pd(sign, y));
+}
+
+/**
+@brief
+Gather four samples of a lunar DEM using AVX2.
+
+@param[in] dem
+DEM. 16 bit samples must not start in the first two bytes of the mapping.
+
+@param[in] index
+Indices of the samples in the grid.
+
+@return
+Values of the samples, before scaling.
+
+*/
+ILM_TARGET_AVX2 static __m256d GatherAvx2(
+    const LunarDem *dem,
+    __m256i index
+) {
+    __m128i raw;
+
+    if (dem->sample_type == DEM_SAMPLE__INT16)
+    {
+        // Gather the words ending with each sample and keep their top halves,
+        // so the last sample of the grid is not read past.
+        raw = _mm256_i64gather_epi32((const int *)(dem->data - 2), index, 2);
+        if (dem->swap_bytes)
+            raw = _mm_shuffle_epi8(raw, _mm_setr_epi8(0, 1, 3, 2, 4, 5, 7, 6, 8, 9, 11, 10, 12, 13, 15, 14));
+
+        return _mm256_cvtepi32_pd(_mm_srai_epi32(raw, 16));
+    }
+
+    raw = _mm256_i64gather_epi32((const int *)dem->data, index, 4);
+    if (dem->swap_bytes)
+        raw = _mm_shuffle_epi8(raw, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+
+    return _mm256_cvtps_pd(_mm_castsi128_ps(raw));
+}
+
+/**
+@brief
+Sample a lunar DEM at points along a great circle using AVX2.
+
+Point k is at the unit vector c[k] u + s[k] w. Each point is located on the
+grid and sampled by bilinear interpolation with gathers, rounded as
+LunarDemPixel() and SampleLunarDem() round, except that the latitude and
+longitude of equirectangular grids come from a vector arctangent that can
+differ from the C library in the last bit. The points past the last multiple
+of 4 are sampled with the scalar functions.
+
+@param[in] dem
+DEM. 16 bit samples must not start in the first two bytes of the mapping.
+
+@param[in] u
+Unit vector of the TX.
+
+@param[in] w
+Unit vector orthogonal to u in the plane of the great circle.
+
+@param[in] c
+Cosines of the central angles of the points.
+
+@param[in] s
+Sines of the central angles of the points.
+
+@param[in] n
+Number of points.
+
+@param[out] z__meter
+Elevations of the points, in meters.
+
+@return
+True if all points are within the grid.
+
+*/
+ILM_TARGET_AVX2 bool SampleGreatCircleAvx2(
+    const LunarDem *dem,
+    const double u[3],
+    const double w[3],
+    const double c[],
+    const double s[],
+    int n,
+    double z__meter[]
+) {
+    const __m256d u_0 = _mm256_set1_pd(u[0]);
+    const __m256d u_1 = _mm256_set1_pd(u[1]);
+    const __m256d u_2 = _mm256_set1_pd(u[2]);
+    const __m256d w_0 = _mm256_set1_pd(w[0]);
+    const __m256d w_1 = _mm256_set1_pd(w[1]);
+    const __m256d w_2 = _mm256_set1_pd(w[2]);
+
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d line_min = _mm256_set1_pd(-0.5);
+    const __m256d line_max = _mm256_set1_pd(dem->lines - 0.5);
+    const __m256d sample_max = _mm256_set1_pd(dem->samples - 0.5);
+    const __m256d lines_1 = _mm256_set1_pd(dem->lines - 1.0);
+    const __m256d samples_1 = _mm256_set1_pd(dem->samples - 1.0);
+    const __m256d samples = _mm256_set1_pd((double)dem->samples);
+    const __m128i lines_2 = _mm_set1_epi32(dem->lines - 2);
+    const __m128i samples_2 = _mm_set1_epi32(dem->samples - 2);
+    const __m128i samples_last = _mm_set1_epi32(dem->samples - 1);
+    const __m128i samples_count = _mm_set1_epi32(dem->samples);
+    const __m256i row = _mm256_set1_epi64x(dem->samples);
+    const __m256d scale = _mm256_set1_pd(dem->scale);
+    const __m256d offset = _mm256_set1_pd(dem->offset__meter);
+
+    bool north = dem->center_lat__deg > 0.0;
+
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256d c_k = _mm256_loadu_pd(&c[k]);
+        __m256d s_k = _mm256_loadu_pd(&s[k]);
+
+        __m256d v_0 = _mm256_add_pd(_mm256_mul_pd(c_k, u_0), _mm256_mul_pd(s_k, w_0));
+        __m256d v_1 = _mm256_add_pd(_mm256_mul_pd(c_k, u_1), _mm256_mul_pd(s_k, w_1));
+        __m256d v_2 = _mm256_add_pd(_mm256_mul_pd(c_k, u_2), _mm256_mul_pd(s_k, w_2));
+
+        __m256d line, sample;
+
+        if (dem->projection == DEM_PROJECTION__EQUIRECTANGULAR)
+        {
+            __m256d r = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(v_0, v_0), _mm256_mul_pd(v_1, v_1)));
+
+            __m256d lat__deg = _mm256_div_pd(_mm256_mul_pd(Atan2Avx2(v_2, r), _mm256_set1_pd(180.0)), _mm256_set1_pd(M_PI));
+            __m256d lon__deg = _mm256_div_pd(_mm256_mul_pd(Atan2Avx2(v_1, v_0), _mm256_set1_pd(180.0)), _mm256_set1_pd(M_PI));
+
+            // fmod() of the non-negative longitude, exactly.
+            __m256d x = _mm256_add_pd(_mm256_sub_pd(lon__deg, _mm256_set1_pd(dem->center_lon__deg)), _mm256_set1_pd(540.0));
+            __m256d turns = _mm256_floor_pd(_mm256_div_pd(x, _mm256_set1_pd(360.0)));
+            x = _mm256_sub_pd(x, _mm256_mul_pd(_mm256_set1_pd(360.0), turns));
+            x = _mm256_add_pd(x, _mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ), _mm256_set1_pd(360.0)));
+            __m256d dlon__deg = _mm256_sub_pd(x, _mm256_set1_pd(180.0));
+
+            line = _mm256_sub_pd(_mm256_set1_pd(dem->line_offset), _mm256_mul_pd(lat__deg, _mm256_set1_pd(dem->resolution__px_per_deg)));
+            sample = _mm256_add_pd(_mm256_set1_pd(dem->sample_offset), _mm256_mul_pd(dlon__deg, _mm256_set1_pd(dem->resolution_lon__px_per_deg)));
+        }
+        else
+        {
+            __m256d k_s = _mm256_div_pd(_mm256_set1_pd(2.0 * a_m__meter),
+                _mm256_add_pd(one, north ? v_2 : _mm256_xor_pd(v_2, _mm256_set1_pd(-0.0))));
+
+            __m256d cos_c = _mm256_set1_pd(dem->cos_center_lon);
+            __m256d sin_c = _mm256_set1_pd(dem->sin_center_lon);
+            __m256d east = _mm256_sub_pd(_mm256_mul_pd(v_1, cos_c), _mm256_mul_pd(v_0, sin_c));
+            __m256d out = _mm256_add_pd(_mm256_mul_pd(v_0, cos_c), _mm256_mul_pd(v_1, sin_c));
+
+            __m256d x__meter = _mm256_mul_pd(k_s, east);
+            __m256d y__meter = _mm256_mul_pd(k_s, out);
+            if (north)
+                y__meter = _mm256_xor_pd(y__meter, _mm256_set1_pd(-0.0));
+
+            __m256d map_scale = _mm256_set1_pd(dem->map_scale__meter);
+            line = _mm256_sub_pd(_mm256_set1_pd(dem->line_offset), _mm256_div_pd(y__meter, map_scale));
+            sample = _mm256_add_pd(_mm256_set1_pd(dem->sample_offset), _mm256_div_pd(x__meter, map_scale));
+        }
+
+        __m256d inside = _mm256_and_pd(
+            _mm256_cmp_pd(line, line_min, _CMP_GE_OQ),
+            _mm256_cmp_pd(line, line_max, _CMP_LE_OQ));
+
+        if (dem->wraps)
+        {
+            __m256d turns = _mm256_floor_pd(_mm256_div_pd(sample, samples));
+            sample = _mm256_sub_pd(sample, _mm256_mul_pd(samples, turns));
+            sample = _mm256_add_pd(sample, _mm256_and_pd(_mm256_cmp_pd(sample, zero, _CMP_LT_OQ), samples));
+            inside = _mm256_and_pd(inside, _mm256_cmp_pd(sample, sample, _CMP_ORD_Q));
+        }
+        else
+        {
+            inside = _mm256_and_pd(inside, _mm256_and_pd(
+                _mm256_cmp_pd(sample, line_min, _CMP_GE_OQ),
+                _mm256_cmp_pd(sample, sample_max, _CMP_LE_OQ)));
+        }
+
+        if (_mm256_movemask_pd(inside) != 0xF)
+            return false;
+
+        // Bilinear interpolation, as InterpolateLunarDem().
+        line = _mm256_max_pd(zero, _mm256_min_pd(line, lines_1));
+        __m128i j = _mm_min_epi32(_mm256_cvttpd_epi32(line), lines_2);
+        __m256d f_j = _mm256_sub_pd(line, _mm256_cvtepi32_pd(j));
+
+        __m128i i_0, i_1;
+        if (dem->wraps)
+        {
+            i_0 = _mm_min_epi32(_mm256_cvttpd_epi32(sample), samples_last);
+            i_1 = _mm_add_epi32(i_0, _mm_set1_epi32(1));
+            i_1 = _mm_andnot_si128(_mm_cmpeq_epi32(i_1, samples_count), i_1);
+        }
+        else
+        {
+            sample = _mm256_max_pd(zero, _mm256_min_pd(sample, samples_1));
+            i_0 = _mm_min_epi32(_mm256_cvttpd_epi32(sample), samples_2);
+            i_1 = _mm_add_epi32(i_0, _mm_set1_epi32(1));
+        }
+        __m256d f_i = _mm256_sub_pd(sample, _mm256_cvtepi32_pd(i_0));
+
+        __m256i row_0 = _mm256_mul_epi32(_mm256_cvtepi32_epi64(j), row);
+        __m256i row_1 = _mm256_add_epi64(row_0, row);
+        __m256i col_0 = _mm256_cvtepi32_epi64(i_0);
+        __m256i col_1 = _mm256_cvtepi32_epi64(i_1);
+
+        __m256d z_00 = _mm256_add_pd(_mm256_mul_pd(scale, GatherAvx2(dem, _mm256_add_epi64(row_0, col_0))), offset);
+        __m256d z_01 = _mm256_add_pd(_mm256_mul_pd(scale, GatherAvx2(dem, _mm256_add_epi64(row_0, col_1))), offset);
+        __m256d z_10 = _mm256_add_pd(_mm256_mul_pd(scale, GatherAvx2(dem, _mm256_add_epi64(row_1, col_0))), offset);
+        __m256d z_11 = _mm256_add_pd(_mm256_mul_pd(scale, GatherAvx2(dem, _mm256_add_epi64(row_1, col_1))), offset);
+
+        __m256d g_j = _mm256_sub_pd(one, f_j);
+        __m256d g_i = _mm256_sub_pd(one, f_i);
+
+        __m256d z = _mm256_add_pd(
+            _mm256_mul_pd(g_j, _mm256_add_pd(_mm256_mul_pd(g_i, z_00), _mm256_mul_pd(f_i, z_01))),
+            _mm256_mul_pd(f_j, _mm256_add_pd(_mm256_mul_pd(g_i, z_10), _mm256_mul_pd(f_i, z_11))));
+
+        _mm256_storeu_pd(&z__meter[k], z);
+    }
+
+    for (; k < n; k++)
+    {
+        double v[3] = {
+            c[k] * u[0] + s[k] * w[0],
+            c[k] * u[1] + s[k] * w[1],
+            c[k] * u[2] + s[k] * w[2]
+        };
+
+        double line, sample;
+        if (!LunarDemPixel(dem, v, &line, &sample))
+            return false;
+
+        z__meter[k] = SampleLunarDem(dem, line, sample);
+    }
+
+    return true;
+}
+
+#endif  // ILM_X86_SIMD
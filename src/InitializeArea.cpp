@@ -4,13 +4,9 @@
 This file contains the InitializeArea() function.
 */
 
-/* Standard includes. */
-#define _USE_MATH_DEFINES
-#include <cmath>
-#include <utility>
-
 /* Local includes. */
 #include "./include/Enums.h"
+#include "./include/Engine.h"
 #include "./include/ilm.h"
 
 
@@ -50,32 +46,20 @@ void InitializeArea(
     for (int i = 0; i < 2; i++)
     {
         if (site_criteria[i] == SITING_CRITERIA__MOBILE)
-        {
-            // [RLS, A-4 & B-4].
-            h_e__meter[i] = h__meter[i];
-        }
+            AreaModel<double>::InitializeTerminal<MobileSiting>(
+                delta_h__meter,
+                h__meter[i],
+                &h_e__meter[i],
+                &d_l__meter[i],
+                &theta_hzn[i]
+            );
         else
-        {
-            // [RLS, A-5 & B-5].
-            double B = 10.0;
-
-            if (h__meter[i] < 5.0)
-            {
-                // [RLS, A-6 & B-6].
-                B = (B - 1.0) * sin(0.1 * M_PI * h__meter[i]) + 1.0;
-            }
-
-            // [RLS, A-7 & B-7].
-            h_e__meter[i] = h__meter[i] + B * exp(-2.0 * h__meter[i] / delta_h__meter);
-        }
-
-        // [RLS, A-8 & B-8].
-        double d_ls__meter = sqrt(2.0 * h_e__meter[i] * a_m__meter);
-
-        // [RLS, A-9 & B-9].
-        d_l__meter[i] = d_ls__meter * exp(-0.07 * sqrt(delta_h__meter / std::max(h_e__meter[i], 5.0)));
-
-        // [RLS, A-10 & B-10].
-        theta_hzn[i] = -(2.0 * h_e__meter[i] + 0.65 * delta_h__meter * (d_ls__meter / d_l__meter[i] - 1.0)) / d_ls__meter;
+            AreaModel<double>::InitializeTerminal<FixedSiting>(
+                delta_h__meter,
+                h__meter[i],
+                &h_e__meter[i],
+                &d_l__meter[i],
+                &theta_hzn[i]
+            );
     }
 }
\ No newline at end of file
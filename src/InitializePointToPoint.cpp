@@ -9,6 +9,7 @@ This file contains the InitializePointToPoint() function.
 
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
 #include "./include/Enums.h"
 
 /**
@@ -41,13 +42,16 @@ void InitializePointToPoint(
     double sigma,
     std::complex<double> *Z_g
 ) {
-    // Complex relative permittivity.
-    std::complex<double> ep_r = std::complex<double>(epsilon, 18000.0 * sigma / f__mhz);
-
-    // [RLS, A-3].
-    // Ground impedance (horizontal polarization).
-    *Z_g = sqrt(ep_r - 1.0);
-    // Adjust for vertical polarization.
     if (pol == POLARIZATION__VERTICAL)
-        *Z_g = *Z_g / ep_r;
+        *Z_g = IlmEngine<double, VerticalPolarization>::GroundImpedance(
+            f__mhz,
+            epsilon,
+            sigma
+        );
+    else
+        *Z_g = IlmEngine<double, HorizontalPolarization>::GroundImpedance(
+            f__mhz,
+            epsilon,
+            sigma
+        );
 }
\ No newline at end of file
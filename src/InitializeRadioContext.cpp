@@ -0,0 +1,117 @@
+/**
+@file
+
+This file contains the InitializeRadioContext() functions.
+*/
+
+/* Standard includes. */
+#include <complex>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/Enums.h"
+#include "./include/RadioContext.h"
+
+/**
+@brief
+Initialize the radio context of a set of paths.
+
+Computes the ground impedance as InitializePointToPoint() does, and the other
+frequency and ground dependent constants of the Longley-Rice method, so the
+paths can be evaluated with PointToPointContext_Ex() without recomputing them.
+The inputs are validated with each path.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[out] radio
+Radio context.
+
+*/
+void InitializeRadioContext(
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    RadioContext *radio
+) {
+    std::complex<double> Z_g;
+    InitializePointToPoint(
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &Z_g
+    );
+
+    InitializeRadioContext(
+        f__mhz,
+        Z_g,
+        radio
+    );
+
+    radio->pol = pol;
+    radio->epsilon = epsilon;
+    radio->sigma = sigma;
+}
+
+/**
+@brief
+Initialize the derived constants of a radio context from a frequency and a
+ground impedance.
+
+The special functions are evaluated exactly. Setting precision to
+PRECISION__FAST afterwards evaluates them with the bounded error
+approximations of FastMath.h instead.
+
+The polarization, permittivity and conductivity are not known, and are left
+unset.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] Z_g
+Complex ground impedance.
+
+@param[out] radio
+Radio context.
+
+*/
+void InitializeRadioContext(
+    double f__mhz,
+    std::complex<double> Z_g,
+    RadioContext *radio
+) {
+    EngineRadio<double> engine_radio;
+    ExactModel::InitializeRadio(
+        f__mhz,
+        Z_g,
+        &engine_radio
+    );
+
+    radio->f__mhz = engine_radio.f__mhz;
+    radio->pol = -1;
+    radio->epsilon = 0.0;
+    radio->sigma = 0.0;
+    radio->Z_g = engine_radio.Z_g;
+    radio->abs_Z_g = engine_radio.abs_Z_g;
+    radio->k = engine_radio.k;
+    radio->X_ae__meter = engine_radio.X_ae__meter;
+    radio->f_cbrt = engine_radio.f_cbrt;
+    radio->f_inv_cbrt = engine_radio.f_inv_cbrt;
+    radio->A_f__db = engine_radio.A_f__db;
+    radio->precision = PRECISION__EXACT;
+}
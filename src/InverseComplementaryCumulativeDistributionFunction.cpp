@@ -1,14 +1,15 @@
 /**
 @file
 
-This file contains the InverseComplementaryCumulativeDistributionFunction().
+This file contains the InverseComplementaryCumulativeDistributionFunction() and
+InverseComplementaryCumulativeDistributionFunctionFast() functions.
 */
 
-/* Standard includes. */
-#include <cmath>
-
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/FastMath.h"
+#include "./include/RadioContext.h"
 
 /**
 @brief
@@ -29,25 +30,27 @@ Q(q)^-1.
 double InverseComplementaryCumulativeDistributionFunction(
     double q
 ) {
-    double C_0 = 2.515516;
-    double C_1 = 0.802853;
-    double C_2 = 0.010328;
-    double D_1 = 1.432788;
-    double D_2 = 0.189269;
-    double D_3 = 0.001308;
-
-    double x = q;
-    if (q > 0.5)
-        x = 1.0 - x;
+    return ExactModel::InverseComplementaryCumulativeDistributionFunction(q);
+}
 
-    double T_x = sqrt(-2.0 * log(x));
+/**
+@brief
+Return the inverse complementary cumulative distribution function, with the
+logarithm of FastLog().
 
-    double zeta_x = ((C_2 * T_x + C_1) * T_x + C_0) / (((D_3 * T_x + D_2) * T_x + D_1) * T_x + 1.0);
+Since T_x >= sqrt(2 ln(2)) and the slope of the result in T_x is below 1.5,
+the result differs from InverseComplementaryCumulativeDistributionFunction()
+by less than 1.3 ln(2) * FAST_LOG2_ERROR, plus rounding.
 
-    double Q_q = T_x - zeta_x;
+@param[in] q
+Quantile, 0.0 < q < 1.0.
 
-    if (q > 0.5)
-        Q_q = -Q_q;
+@return Q_q
+Q(q)^-1.
 
-    return Q_q;
-}
+*/
+double InverseComplementaryCumulativeDistributionFunctionFast(
+    double q
+) {
+    return FastModel::InverseComplementaryCumulativeDistributionFunction(q);
+}
\ No newline at end of file
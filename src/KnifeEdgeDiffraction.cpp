@@ -1,14 +1,15 @@
 /**
 @file
 
-This file contains the KnifeEdgeDiffraction() function.
+This file contains the KnifeEdgeDiffraction() functions.
 */
 
-/* Standard includes. */
-#include <cmath>
-
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/Enums.h"
+#include "./include/FastMath.h"
+#include "./include/RadioContext.h"
 
 /**
 @brief
@@ -36,23 +37,56 @@ double KnifeEdgeDiffraction(
     double theta_los,
     double d_hzn__meter[2]
 ) {
-    // Maximum line-of-sight distance for actual path.
-    double d_ML__meter = d_hzn__meter[0] + d_hzn__meter[1];
+    return ExactModel::KnifeEdgeDiffraction(
+        d__meter,
+        f__mhz,
+        theta_los,
+        d_hzn__meter
+    );
+}
 
-    // Angular distance of diffraction region [Algorithm, Eqn 4.12].
-    double theta_nlos = d__meter / a_m__meter - theta_los;
+/**
+@brief
+Compute the knife-edge diffraction loss, with the frequency and precision of a
+radio context.
 
-    // Diffraction distance, in meters.
-    double d_nlos__meter = d__meter - d_ML__meter;
+With PRECISION__FAST, the Fresnel integral is evaluated with
+FresnelIntegralFast().
+
+@param[in] d__meter
+Distance of interest, in meters.
 
+@param[in] radio
+Radio context.
 
-    // [TN101, Eqn I.7].
-    // 1 / (4 pi) = 0.0795775
-    double v_1 = 0.0795775 * (f__mhz / 47.7) * pow(theta_nlos, 2) * d_hzn__meter[0] * d_nlos__meter / (d_nlos__meter + d_hzn__meter[0]);
-    double v_2 = 0.0795775 * (f__mhz / 47.7) * pow(theta_nlos, 2) * d_hzn__meter[1] * d_nlos__meter / (d_nlos__meter + d_hzn__meter[1]);
+@param[in] theta_los
+Angular distance of line-of-sight region.
 
-    // [RLS, A-26& B-24].
-    double A_k__db = FresnelIntegral(v_1) + FresnelIntegral(v_2);
+@param[in] d_hzn__meter
+Horizon distances, in meters.
 
-    return A_k__db;
+@return A_k__db
+Knife-edge diffraction loss, in dB.
+
+*/
+double KnifeEdgeDiffraction(
+    double d__meter,
+    const RadioContext *radio,
+    double theta_los,
+    double d_hzn__meter[2]
+) {
+    if (radio->precision == PRECISION__FAST)
+        return FastModel::KnifeEdgeDiffraction(
+            d__meter,
+            radio->f__mhz,
+            theta_los,
+            d_hzn__meter
+        );
+
+    return ExactModel::KnifeEdgeDiffraction(
+        d__meter,
+        radio->f__mhz,
+        theta_los,
+        d_hzn__meter
+    );
 }
\ No newline at end of file
@@ -5,13 +5,14 @@ This file contains the LineOfSightLoss() function.
 */
 
 /* Standard includes. */
-#define _USE_MATH_DEFINES
-#include <cmath>
 #include <complex>
-#include <utility>
 
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/Enums.h"
+#include "./include/FastMath.h"
+#include "./include/RadioContext.h"
 
 
 /**
@@ -56,46 +57,84 @@ double LineOfSightLoss(
     double d_ls__meter,
     double f__mhz
 ) {
-    // [RLS, A-67 & B-65].
-    double sigma_h_s__meter = (delta_h__meter / 1.282) * exp(-pow(delta_h__meter, 0.25) / 2.0);
+    RadioContext radio;
+    InitializeRadioContext(
+        f__mhz,
+        Z_g,
+        &radio
+    );
+
+    return LineOfSightLoss(
+        s__meter,
+        h_e__meter,
+        &radio,
+        delta_h__meter,
+        m_d,
+        A_ed,
+        d_ls__meter
+    );
+}
 
-    // Speed of light, m/s.
-    double c = 299792458.0;
-    // [RLS, A-1].
-    double k = 2.0 * M_PI * (f__mhz * 1.0E6) / c;
+/**
+@brief
+Compute the loss in the line-of-sight region, with the frequency and ground
+dependent constants of a radio context.
 
-    // [RLS, A-65 & B-63].
-    double sin_psi = (h_e__meter[0] + h_e__meter[1]) / sqrt(pow(s__meter, 2) + pow(h_e__meter[0] + h_e__meter[1], 2));
+With PRECISION__FAST, the exponentials, the fourth root and the logarithm are
+evaluated with the approximations of FastMath.h.
 
-    // [RLS, A-66 & B-64].
-    std::complex<double> R_e = (sin_psi - Z_g) / (sin_psi + Z_g) * exp(-k * sigma_h_s__meter * sin_psi);
+@param[in] s__meter
+Path distance, in meters.
 
-    // [RLS, A-69 & B-67].
-    double q = pow(R_e.real(), 2) + pow(R_e.imag(), 2);
-    if (q < 0.25 || q < sin_psi)
-        R_e = R_e * sqrt(sin_psi / q);
+@param[in] h_e__meter
+Terminal effective heights, in meters.
 
-    // [RLS, A-68 & B-66].
-    double delta_phi = 2.0 * k * h_e__meter[0] * h_e__meter[1] / s__meter;
+@param[in] radio
+Radio context.
 
-    // [RLS, A-70 & B-68].
-    if (delta_phi > M_PI / 2.0)
-        delta_phi = M_PI - pow(M_PI / 2.0, 2) / delta_phi;
+@param[in] delta_h__meter
+Terrain irregularity parameter.
 
-    // [RLS, A-71 & B-69].
-    std::complex<double> rr = std::complex<double>(cos(delta_phi), -sin(delta_phi)) + R_e;
-    double A_t__db = -10.0 * log10(pow(rr.real(), 2) + pow(rr.imag(), 2));
+@param[in] m_d
+Diffraction slope.
 
-    // [RLS, A-64 & B-62].
-    double A_d__db = A_ed + m_d * s__meter;
+@param[in] A_ed
+Diffraction intercept.
 
-    // [RLS, A-63 & B-61].
-    double D_1 = 47.7;
-    double D_2 = 10.0E3;
-    double w = 1.0 / (1.0 + D_1 * k * delta_h__meter / std::max(D_2, d_ls__meter));
+@param[in] d_ls__meter
+Maximum line-of-sight distance for a smooth earth, in meters.
 
-    // [RLS, A-62 & B-60].
-    double A_los__db = (1.0 - w) * A_d__db + w * A_t__db;
+@return A_los__db
+Loss, in dB.
 
-    return A_los__db;
+*/
+double LineOfSightLoss(
+    double s__meter,
+    double h_e__meter[2],
+    const RadioContext *radio,
+    double delta_h__meter,
+    double m_d,
+    double A_ed,
+    double d_ls__meter
+) {
+    if (radio->precision == PRECISION__FAST)
+        return FastModel::LineOfSightLoss(
+            s__meter,
+            h_e__meter,
+            EngineRadioOf(radio),
+            delta_h__meter,
+            m_d,
+            A_ed,
+            d_ls__meter
+        );
+
+    return ExactModel::LineOfSightLoss(
+        s__meter,
+        h_e__meter,
+        EngineRadioOf(radio),
+        delta_h__meter,
+        m_d,
+        A_ed,
+        d_ls__meter
+    );
 }
\ No newline at end of file
@@ -1,14 +1,282 @@
 /**
 @file
 
-This file contains the LinearLeastSquaresFit() function.
+This file contains the LinearLeastSquaresFit(), LinearLeastSquaresFitView(),
+LinearLeastSquaresFitCompact(), DualLinearLeastSquaresFit(),
+DualLinearLeastSquaresFitView(), DualLinearLeastSquaresFitCompact(),
+PrepareProfile() and LinearLeastSquaresFitPrepared() functions.
 */
 
 /* Standard includes. */
+#include <algorithm>
 #include <cmath>
 
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Internal.h"
+#include "./include/Terrain.h"
+
+/**
+@brief
+Minimum window length, in points, for a fit from prefix sums.
+*/
+#define PREFIX_SUM_MIN_POINTS 64
+
+/**
+@brief
+State of a linear least squares fit over one window of the terrain data.
+*/
+struct FitWindow
+{
+    /**
+    Index of the first terrain point in the window.
+    */
+    int i_start;
+
+    /**
+    Index of the last terrain point in the window.
+    */
+    int i_end;
+
+    /**
+    Number of intervals in the window.
+    */
+    double x_length;
+
+    /**
+    Window index of the first point, shifted to the middle of the window.
+    */
+    double mid_shifted_index;
+
+    /**
+    Window index of the last point, shifted to the middle of the window.
+    */
+    double mid_shifted_end;
+
+    /**
+    Running sum of the terrain heights.
+    */
+    double sum_y;
+
+    /**
+    Running sum of the terrain heights, scaled by their shifted index.
+    */
+    double scaled_sum_y;
+};
+
+/**
+@brief
+Set up the fit window and add in its end points.
+
+@param[in] terrain
+Terrain profile.
+
+@param[in] d_start
+Start distance.
+
+@param[in] d_end
+End distance.
+
+@param[out] window
+Fit window.
+
+*/
+template <typename Terrain>
+static void InitializeFitWindow(
+    const Terrain &terrain,
+    double d_start,
+    double d_end,
+    FitWindow *window
+) {
+    int np = terrain.Intervals();
+
+    int i_start = int(fdim(d_start / terrain.Resolution(), 0.0));
+    int i_end = np - int(fdim(np, d_end / terrain.Resolution()));
+
+    if (i_end <= i_start)
+    {
+        i_start = (int)fdim(i_start, 1.0);
+        i_end = np - (int)fdim(np, i_end + 1.0);
+    }
+
+    window->i_start = i_start;
+    window->i_end = i_end;
+    window->x_length = i_end - i_start;
+
+    window->mid_shifted_index = -0.5 * window->x_length;
+    window->mid_shifted_end = i_end + window->mid_shifted_index;
+
+    window->sum_y = 0.5 * (terrain[i_start] + terrain[i_end]);
+    window->scaled_sum_y = 0.5 * (terrain[i_start] - terrain[i_end]) * window->mid_shifted_index;
+}
+
+/**
+@brief
+Compute the fitted end values from the sums of a fit window.
+
+@param[in] np
+Number of points in the pfl.
+
+@param[in] window
+Fit window, with all interior points added in.
+
+@param[out] fit_y1
+Fitted y1 value.
+
+@param[out] fit_y2
+Fitted y2 value.
+
+*/
+static void FinishFitWindow(
+    int np,
+    const FitWindow *window,
+    double *fit_y1,
+    double *fit_y2
+) {
+    double x_length = window->x_length;
+
+    double sum_y = window->sum_y / x_length;
+    double scaled_sum_y = window->scaled_sum_y * 12.0 / ((x_length * x_length + 2.0) * x_length);
+
+    *fit_y1 = sum_y - scaled_sum_y * window->mid_shifted_end;
+    *fit_y2 = sum_y + scaled_sum_y * (np - window->mid_shifted_end);
+}
+
+/**
+@brief
+Perform a linear least squares fit to the terrain data.
+
+@param[in] terrain
+Terrain profile.
+
+@param[in] d_start
+Start distance.
+
+@param[in] d_end
+End distance.
+
+@param[out] fit_y1
+Fitted y1 value.
+
+@param[out] fit_y2
+Fitted y2 value.
+
+*/
+template <typename Terrain>
+static void TerrainLinearLeastSquaresFit(
+    const Terrain &terrain,
+    double d_start,
+    double d_end,
+    double *fit_y1,
+    double *fit_y2
+) {
+    FitWindow window;
+    InitializeFitWindow(terrain, d_start, d_end, &window);
+
+    int i_start = window.i_start;
+    double mid_shifted_index = window.mid_shifted_index;
+
+    for (int i = 2; i <= window.x_length; i++)
+    {
+        i_start++;
+        mid_shifted_index++;
+
+        window.sum_y += terrain[i_start];
+        window.scaled_sum_y += terrain[i_start] * mid_shifted_index;
+    }
+
+    FinishFitWindow(terrain.Intervals(), &window, fit_y1, fit_y2);
+}
+
+/**
+@brief
+Perform linear least squares fits to two windows of the terrain data in a
+single pass.
+
+The windows may overlap. Each fit adds up its terrain points in the same order
+as LinearLeastSquaresFit(), so the results are identical to two separate
+calls, but the terrain data is only read once.
+
+@param[in] terrain
+Terrain profile.
+
+@param[in] d_start
+Start distance of each window.
+
+@param[in] d_end
+End distance of each window.
+
+@param[out] fit_y1
+Fitted y1 value of each window.
+
+@param[out] fit_y2
+Fitted y2 value of each window.
+
+*/
+template <typename Terrain>
+static void TerrainDualLinearLeastSquaresFit(
+    const Terrain &terrain,
+    double d_start[2],
+    double d_end[2],
+    double fit_y1[2],
+    double fit_y2[2]
+) {
+    FitWindow window[2];
+    InitializeFitWindow(terrain, d_start[0], d_end[0], &window[0]);
+    InitializeFitWindow(terrain, d_start[1], d_end[1], &window[1]);
+
+    // Split the pass at the window boundaries, so that within each segment
+    // every point belongs to the same windows.
+    int bounds[4] = {
+        window[0].i_start + 1,
+        window[0].i_end,
+        window[1].i_start + 1,
+        window[1].i_end
+    };
+    std::sort(bounds, bounds + 4);
+
+    for (int k = 0; k < 3; k++)
+    {
+        int i_lo = bounds[k];
+        int i_hi = bounds[k + 1];
+        if (i_hi <= i_lo)
+            continue;
+
+        // Interior points of a window, i_start < i < i_end.
+        bool in_0 = i_lo > window[0].i_start && i_lo < window[0].i_end;
+        bool in_1 = i_lo > window[1].i_start && i_lo < window[1].i_end;
+
+        // Index offset of each window's shifted index at i_lo.
+        double x_0 = window[0].mid_shifted_index + (i_lo - window[0].i_start);
+        double x_1 = window[1].mid_shifted_index + (i_lo - window[1].i_start);
+
+        if (in_0 && in_1)
+        {
+            for (int i = i_lo; i < i_hi; i++, x_0++, x_1++)
+            {
+                window[0].sum_y += terrain[i];
+                window[0].scaled_sum_y += terrain[i] * x_0;
+                window[1].sum_y += terrain[i];
+                window[1].scaled_sum_y += terrain[i] * x_1;
+            }
+        }
+        else if (in_0 || in_1)
+        {
+            FitWindow *w = in_0 ? &window[0] : &window[1];
+            double x = in_0 ? x_0 : x_1;
+
+            for (int i = i_lo; i < i_hi; i++, x++)
+            {
+                w->sum_y += terrain[i];
+                w->scaled_sum_y += terrain[i] * x;
+            }
+        }
+    }
+
+    int np = terrain.Intervals();
+    FinishFitWindow(np, &window[0], &fit_y1[0], &fit_y2[0]);
+    FinishFitWindow(np, &window[1], &fit_y1[1], &fit_y2[1]);
+}
 
 /**
 @brief
@@ -36,38 +304,302 @@ void LinearLeastSquaresFit(
     double d_end,
     double *fit_y1,
     double *fit_y2
+) {
+    PflTerrain terrain = { pfl };
+
+    TerrainLinearLeastSquaresFit(terrain, d_start, d_end, fit_y1, fit_y2);
+}
+
+/**
+@brief
+Perform a linear least squares fit to a terrain profile stored in place.
+
+The result is identical to LinearLeastSquaresFit() on the same profile in pfl
+format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] d_start
+Start distance.
+
+@param[in] d_end
+End distance.
+
+@param[out] fit_y1
+Fitted y1 value.
+
+@param[out] fit_y2
+Fitted y2 value.
+
+*/
+void LinearLeastSquaresFitView(
+    const TerrainView *view,
+    double d_start,
+    double d_end,
+    double *fit_y1,
+    double *fit_y2
+) {
+    StridedTerrain terrain = { view };
+
+    TerrainLinearLeastSquaresFit(terrain, d_start, d_end, fit_y1, fit_y2);
+}
+
+/**
+@brief
+Perform linear least squares fits to two windows of the terrain data in a
+single pass.
+
+@param[in] pfl
+Input data array, in pfl format.
+
+@param[in] d_start
+Start distance of each window.
+
+@param[in] d_end
+End distance of each window.
+
+@param[out] fit_y1
+Fitted y1 value of each window.
+
+@param[out] fit_y2
+Fitted y2 value of each window.
+
+*/
+void DualLinearLeastSquaresFit(
+    double pfl[],
+    double d_start[2],
+    double d_end[2],
+    double fit_y1[2],
+    double fit_y2[2]
+) {
+    PflTerrain terrain = { pfl };
+
+    TerrainDualLinearLeastSquaresFit(terrain, d_start, d_end, fit_y1, fit_y2);
+}
+
+/**
+@brief
+Perform linear least squares fits to two windows of a terrain profile stored
+in place in a single pass.
+
+The results are identical to DualLinearLeastSquaresFit() on the same profile
+in pfl format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] d_start
+Start distance of each window.
+
+@param[in] d_end
+End distance of each window.
+
+@param[out] fit_y1
+Fitted y1 value of each window.
+
+@param[out] fit_y2
+Fitted y2 value of each window.
+
+*/
+void DualLinearLeastSquaresFitView(
+    const TerrainView *view,
+    double d_start[2],
+    double d_end[2],
+    double fit_y1[2],
+    double fit_y2[2]
+) {
+    StridedTerrain terrain = { view };
+
+    TerrainDualLinearLeastSquaresFit(terrain, d_start, d_end, fit_y1, fit_y2);
+}
+
+/**
+@brief
+Perform a linear least squares fit to a terrain profile in a compact
+encoding.
+
+The result is identical to LinearLeastSquaresFit() on the widened profile in
+pfl format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] d_start
+Start distance.
+
+@param[in] d_end
+End distance.
+
+@param[out] fit_y1
+Fitted y1 value.
+
+@param[out] fit_y2
+Fitted y2 value.
+
+*/
+void LinearLeastSquaresFitCompact(
+    const CompactTerrainView *view,
+    double d_start,
+    double d_end,
+    double *fit_y1,
+    double *fit_y2
+) {
+    WithCompactTerrain(view, [&](const auto &terrain) {
+        TerrainLinearLeastSquaresFit(terrain, d_start, d_end, fit_y1, fit_y2);
+    });
+}
+
+/**
+@brief
+Perform linear least squares fits to two windows of a terrain profile in a
+compact encoding in a single pass.
+
+The results are identical to DualLinearLeastSquaresFit() on the widened
+profile in pfl format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] d_start
+Start distance of each window.
+
+@param[in] d_end
+End distance of each window.
+
+@param[out] fit_y1
+Fitted y1 value of each window.
+
+@param[out] fit_y2
+Fitted y2 value of each window.
+
+*/
+void DualLinearLeastSquaresFitCompact(
+    const CompactTerrainView *view,
+    double d_start[2],
+    double d_end[2],
+    double fit_y1[2],
+    double fit_y2[2]
+) {
+    WithCompactTerrain(view, [&](const auto &terrain) {
+        TerrainDualLinearLeastSquaresFit(terrain, d_start, d_end, fit_y1, fit_y2);
+    });
+}
+
+/**
+@brief
+Prepare a terrain profile for constant time least squares fits.
+
+@param[in] pfl
+Terrain data, in pfl format.
+
+@param[out] sum_z
+Prefix sums of the terrain, with pfl[0] + 2 entries.
+
+@param[out] sum_iz
+Prefix sums of the index weighted terrain, with pfl[0] + 2 entries.
+
+@param[out] prepared
+Prepared terrain profile.
+
+*/
+void PrepareProfile(
+    double pfl[],
+    double sum_z[],
+    double sum_iz[],
+    PreparedProfile *prepared
 ) {
     int np = (int)pfl[0];
 
-    int i_start = int(fdim(d_start / pfl[1], 0.0));
-    int i_end = np - int(fdim(np, d_end / pfl[1]));
+    // Sum heights relative to the first point to keep the sums small.
+    double z_ref__meter = pfl[2];
 
-    if (i_end <= i_start)
+    sum_z[0] = 0.0;
+    sum_iz[0] = 0.0;
+
+    for (int i = 0; i <= np; i++)
     {
-        i_start = (int)fdim(i_start, 1.0);
-        i_end = np - (int)fdim(np, i_end + 1.0);
+        double z = pfl[i + 2] - z_ref__meter;
+
+        sum_z[i + 1] = sum_z[i] + z;
+        sum_iz[i + 1] = sum_iz[i] + i * z;
     }
 
-    double x_length = i_end - i_start;
+    prepared->pfl = pfl;
+    prepared->z_ref__meter = z_ref__meter;
+    prepared->sum_z = sum_z;
+    prepared->sum_iz = sum_iz;
+}
 
-    double mid_shifted_index = -0.5 * x_length;
-    double mid_shifted_end = i_end + mid_shifted_index;
+/**
+@brief
+Perform a linear least squares fit to a prepared terrain profile in constant
+time.
 
-    double sum_y = 0.5 * (pfl[i_start + 2] + pfl[i_end + 2]);
-    double scaled_sum_y = 0.5 * (pfl[i_start + 2] - pfl[i_end + 2]) * mid_shifted_index;
+The window is chosen exactly as in LinearLeastSquaresFit(), and the sums over
+it are taken from the prefix sums. Their rounding grows with the profile
+length and the elevation range and does not shrink with the window, so the
+fit can differ from LinearLeastSquaresFit() by centimeters or more on
+profiles of hundreds of thousands of points. Windows shorter than
+PREFIX_SUM_MIN_POINTS are summed directly.
 
-    for (int i = 2; i <= x_length; i++)
-    {
-        i_start++;
-        mid_shifted_index++;
+@param[in] prepared
+Prepared terrain profile, from PrepareProfile().
 
-        sum_y += pfl[i_start + 2];
-        scaled_sum_y += pfl[i_start + 2] * mid_shifted_index;
+@param[in] d_start
+Start distance.
+
+@param[in] d_end
+End distance.
+
+@param[out] fit_y1
+Fitted y1 value.
+
+@param[out] fit_y2
+Fitted y2 value.
+
+*/
+void LinearLeastSquaresFitPrepared(
+    const PreparedProfile *prepared,
+    double d_start,
+    double d_end,
+    double *fit_y1,
+    double *fit_y2
+) {
+    double *pfl = prepared->pfl;
+    double z_ref__meter = prepared->z_ref__meter;
+
+    PflTerrain terrain = { pfl };
+
+    FitWindow window;
+    InitializeFitWindow(terrain, d_start, d_end, &window);
+
+    int i_start = window.i_start;
+    int i_end = window.i_end;
+
+    // Short windows are summed directly, since the rounding error of the
+    // prefix sums does not shrink with the window length.
+    if (i_end - i_start < PREFIX_SUM_MIN_POINTS)
+    {
+        LinearLeastSquaresFit(pfl, d_start, d_end, fit_y1, fit_y2);
+        return;
     }
 
-    sum_y = sum_y / x_length;
-    scaled_sum_y = scaled_sum_y * 12.0 / ((x_length * x_length + 2.0) * x_length);
+    // End points, relative to the reference elevation.
+    double z_start = pfl[i_start + 2] - z_ref__meter;
+    double z_end = pfl[i_end + 2] - z_ref__meter;
+
+    // Interior points, i_start < i < i_end.
+    double sum_z = prepared->sum_z[i_end] - prepared->sum_z[i_start + 1];
+    double sum_iz = prepared->sum_iz[i_end] - prepared->sum_iz[i_start + 1];
+
+    window.sum_y = 0.5 * (z_start + z_end) + sum_z;
+    window.scaled_sum_y = 0.5 * (z_start - z_end) * window.mid_shifted_index
+        + sum_iz + (window.mid_shifted_index - i_start) * sum_z;
+
+    FinishFitWindow((int)pfl[0], &window, fit_y1, fit_y2);
 
-    *fit_y1 = sum_y - scaled_sum_y * mid_shifted_end;
-    *fit_y2 = sum_y + scaled_sum_y * (np - mid_shifted_end);
+    // The reference elevation shifts both fitted values equally.
+    *fit_y1 += z_ref__meter;
+    *fit_y2 += z_ref__meter;
 }
\ No newline at end of file
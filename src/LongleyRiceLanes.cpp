@@ -0,0 +1,170 @@
+/**
+@file
+
+This file contains the LongleyRiceLanesScalar() and
+PointToPointPreparedLanes() functions.
+*/
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Enums.h"
+#include "./include/Errors.h"
+#include "./include/LongleyRiceLanes.h"
+#include "./include/RadioContext.h"
+#include "./include/Simd.h"
+
+/**
+@brief
+Evaluate the reference attenuation, the free space loss and the variability
+of the lanes one at a time, with the scalar functions.
+
+The results are identical to PointToPointPreparedContext_Ex() on each lane.
+
+@param[in,out] lanes
+Paths of the lanes. The ground impedance of each must be valid.
+
+*/
+void LongleyRiceLanesScalar(
+    LongleyRiceLanes *lanes
+) {
+    for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+    {
+        double theta_hzn[2] = { lanes->theta_hzn[0][l], lanes->theta_hzn[1][l] };
+        double d_hzn__meter[2] = { lanes->d_hzn__meter[0][l], lanes->d_hzn__meter[1][l] };
+        double h_e__meter[2] = { lanes->h_e__meter[0][l], lanes->h_e__meter[1][l] };
+        double h__meter[2] = { lanes->h__meter[0][l], lanes->h__meter[1][l] };
+
+        LongleyRice(
+            theta_hzn,
+            lanes->radio[l],
+            d_hzn__meter,
+            h_e__meter,
+            lanes->delta_h__meter[l],
+            h__meter,
+            lanes->d__meter[l],
+            &lanes->A_ref__db[l],
+            &lanes->warnings[l],
+            &lanes->propmode[l]
+        );
+
+        lanes->A_fs__db[l] = FreeSpaceLoss(
+            lanes->d__meter[l],
+            lanes->radio[l]
+        );
+
+        lanes->A__db[l] = lanes->A_fs__db[l]
+            + Variability(
+                lanes->p[l],
+                lanes->delta_h__meter[l],
+                lanes->radio[l],
+                lanes->d__meter[l],
+                lanes->A_ref__db[l]
+            );
+    }
+}
+
+/**
+@brief
+Evaluate the Point-To-Point mode for up to LONGLEY_RICE_LANES prepared paths
+at once, one path per lane of the SIMD kernel.
+
+With AVX2 the paths are evaluated by LongleyRiceAvx2(), whose results agree
+with PointToPointPreparedContext_Ex() to within floating point rounding of
+the transcendental functions. Otherwise, or if any radio context has
+PRECISION__FAST, they are evaluated one at a time, with identical results. The
+lanes do not interact, so with radio contexts of one precision the result of a
+path does not depend on the other paths it is evaluated with.
+
+@param[in] n
+Number of paths, 1 <= n <= LONGLEY_RICE_LANES.
+
+@param[in] paths
+Prepared paths, validated with their radio contexts.
+
+@param[in] radios
+Radio context of each path, with a valid ground impedance.
+
+@param[in] p
+Location percentage of each path, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss of each path, in dB.
+
+@param[in,out] warnings
+Warning flags of each path. The flags of the input validation are kept.
+
+@param[out] interValues
+Intermediate values of each path.
+
+*/
+void PointToPointPreparedLanes(
+    int n,
+    const PreparedPath *paths[],
+    const RadioContext *radios[],
+    const double p[],
+    double A__db[],
+    long warnings[],
+    IntermediateValues interValues[]
+) {
+    LongleyRiceLanes lanes;
+
+    // The AVX2 kernel evaluates the special functions exactly.
+    bool exact = true;
+
+    // Unused lanes repeat the first path.
+    for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+    {
+        int i = l < n ? l : 0;
+        const PreparedPath *path = paths[i];
+
+        lanes.radio[l] = radios[i];
+        if (radios[i]->precision == PRECISION__FAST)
+            exact = false;
+
+        for (int j = 0; j < 2; j++)
+        {
+            lanes.theta_hzn[j][l] = path->theta_hzn[j];
+            lanes.d_hzn__meter[j][l] = path->d_hzn__meter[j];
+            lanes.h_e__meter[j][l] = path->h_e__meter[j];
+            lanes.h__meter[j][l] = path->h__meter[j];
+        }
+        lanes.delta_h__meter[l] = path->delta_h__meter;
+        lanes.d__meter[l] = path->d__meter;
+
+        // Switch from percentages to ratios.
+        lanes.p[l] = p[i] / 100.0;
+
+        lanes.warnings[l] = warnings[i];
+        lanes.propmode[l] = MODE__NOT_SET;
+    }
+
+#ifdef ILM_X86_SIMD
+    if (exact && CpuSupportsAvx2())
+        LongleyRiceAvx2(&lanes);
+    else
+        LongleyRiceLanesScalar(&lanes);
+#else
+    LongleyRiceLanesScalar(&lanes);
+#endif
+
+    for (int i = 0; i < n; i++)
+    {
+        const PreparedPath *path = paths[i];
+        IntermediateValues *iv = &interValues[i];
+
+        A__db[i] = lanes.A__db[i];
+        warnings[i] = lanes.warnings[i];
+
+        iv->theta_hzn[0] = path->theta_hzn[0];
+        iv->theta_hzn[1] = path->theta_hzn[1];
+        iv->d_hzn__meter[0] = path->d_hzn__meter[0];
+        iv->d_hzn__meter[1] = path->d_hzn__meter[1];
+        iv->h_e__meter[0] = path->h_e__meter[0];
+        iv->h_e__meter[1] = path->h_e__meter[1];
+        iv->delta_h__meter = path->delta_h__meter;
+        iv->d__km = path->d__km;
+        iv->A_ref__db = lanes.A_ref__db[i];
+        iv->A_fs__db = lanes.A_fs__db[i];
+        iv->mode = lanes.propmode[i];
+    }
+}
@@ -0,0 +1,1071 @@
+/**
+@file
+
+This file contains the AVX2 kernel that evaluates the Longley-Rice method for
+four paths at once.
+*/
+
+/* Standard includes. */
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+/* Local includes. */
+#include "./include/Enums.h"
+#include "./include/ilm.h"
+#include "./include/LongleyRiceLanes.h"
+#include "./include/Simd.h"
+#include "./include/Warnings.h"
+
+#ifdef ILM_X86_SIMD
+
+/**
+@brief
+Structure to hold the radio context constants of four paths, one per lane.
+*/
+struct RadioLanesAvx2
+{
+    /**
+    Frequency, in MHz.
+    */
+    __m256d f__mhz;
+
+    /**
+    Wavenumber, in rad/meter.
+    */
+    __m256d k;
+
+    /**
+    Scale distance of the diffraction region, in meters.
+    */
+    __m256d X_ae__meter;
+
+    /**
+    Cube root of the frequency.
+    */
+    __m256d f_cbrt;
+
+    /**
+    Reciprocal of the cube root of the frequency.
+    */
+    __m256d f_inv_cbrt;
+
+    /**
+    Magnitude of the ground impedance.
+    */
+    __m256d abs_Z_g;
+
+    /**
+    Real part of the ground impedance.
+    */
+    __m256d Z_g_real;
+
+    /**
+    Imaginary part of the ground impedance.
+    */
+    __m256d Z_g_imag;
+
+    /**
+    Frequency term of the free space loss, in dB.
+    */
+    __m256d A_f__db;
+};
+
+/**
+@brief
+Load the radio context constants of four paths into the lanes.
+
+@param[in] radios
+Radio context of each lane.
+
+@param[out] radio
+Radio context constants of the lanes.
+
+*/
+ILM_TARGET_AVX2 static void LoadRadioLanesAvx2(
+    const RadioContext *const radios[LONGLEY_RICE_LANES],
+    RadioLanesAvx2 *radio
+) {
+    double f__mhz[LONGLEY_RICE_LANES], k[LONGLEY_RICE_LANES], X_ae__meter[LONGLEY_RICE_LANES];
+    double f_cbrt[LONGLEY_RICE_LANES], f_inv_cbrt[LONGLEY_RICE_LANES], abs_Z_g[LONGLEY_RICE_LANES];
+    double Z_g_real[LONGLEY_RICE_LANES], Z_g_imag[LONGLEY_RICE_LANES], A_f__db[LONGLEY_RICE_LANES];
+
+    for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+    {
+        const RadioContext *r = radios[l];
+        f__mhz[l] = r->f__mhz;
+        k[l] = r->k;
+        X_ae__meter[l] = r->X_ae__meter;
+        f_cbrt[l] = r->f_cbrt;
+        f_inv_cbrt[l] = r->f_inv_cbrt;
+        abs_Z_g[l] = r->abs_Z_g;
+        Z_g_real[l] = r->Z_g.real();
+        Z_g_imag[l] = r->Z_g.imag();
+        A_f__db[l] = r->A_f__db;
+    }
+
+    radio->f__mhz = _mm256_loadu_pd(f__mhz);
+    radio->k = _mm256_loadu_pd(k);
+    radio->X_ae__meter = _mm256_loadu_pd(X_ae__meter);
+    radio->f_cbrt = _mm256_loadu_pd(f_cbrt);
+    radio->f_inv_cbrt = _mm256_loadu_pd(f_inv_cbrt);
+    radio->abs_Z_g = _mm256_loadu_pd(abs_Z_g);
+    radio->Z_g_real = _mm256_loadu_pd(Z_g_real);
+    radio->Z_g_imag = _mm256_loadu_pd(Z_g_imag);
+    radio->A_f__db = _mm256_loadu_pd(A_f__db);
+}
+
+/**
+@brief
+Compute e^x using AVX2.
+
+Uses the Cephes range reduction and rational approximation of the exponential,
+which is within 2 ulp of the correctly rounded result.
+
+@param[in] x
+Exponents.
+
+@return
+Exponentials.
+
+*/
+ILM_TARGET_AVX2 static __m256d ExpAvx2(
+    __m256d x
+) {
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    // A NaN x is kept by the clamp.
+    __m256d x_c = _mm256_min_pd(_mm256_set1_pd(710.0), _mm256_max_pd(_mm256_set1_pd(-746.0), x));
+
+    // x = n ln(2) + r, |r| <= ln(2) / 2.
+    __m256d n = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(M_LOG2E), x_c), _mm256_set1_pd(0.5)));
+    __m256d r = _mm256_sub_pd(x_c, _mm256_mul_pd(n, _mm256_set1_pd(6.93145751953125E-1)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(1.42860682030941723212E-6)));
+
+    __m256d rr = _mm256_mul_pd(r, r);
+
+    __m256d p = _mm256_set1_pd(1.26177193074810590878E-4);
+    p = _mm256_add_pd(_mm256_mul_pd(p, rr), _mm256_set1_pd(3.02994407707441961300E-2));
+    p = _mm256_add_pd(_mm256_mul_pd(p, rr), _mm256_set1_pd(9.99999999999999999910E-1));
+    p = _mm256_mul_pd(p, r);
+
+    __m256d q = _mm256_set1_pd(3.00198505138664455042E-6);
+    q = _mm256_add_pd(_mm256_mul_pd(q, rr), _mm256_set1_pd(2.52448340349684104192E-3));
+    q = _mm256_add_pd(_mm256_mul_pd(q, rr), _mm256_set1_pd(2.27265548208155028766E-1));
+    q = _mm256_add_pd(_mm256_mul_pd(q, rr), _mm256_set1_pd(2.00000000000000000009E0));
+
+    __m256d e = _mm256_div_pd(p, _mm256_sub_pd(q, p));
+    e = _mm256_add_pd(one, _mm256_add_pd(e, e));
+
+    // Scale by 2^n in two steps, so both scale factors are normal numbers.
+    __m128i n_0 = _mm256_cvtpd_epi32(n);
+    __m128i n_1 = _mm_srai_epi32(n_0, 1);
+    __m128i n_2 = _mm_sub_epi32(n_0, n_1);
+
+    const __m256i bias = _mm256_set1_epi64x(1023);
+    __m256i s_1 = _mm256_slli_epi64(_mm256_add_epi64(_mm256_cvtepi32_epi64(n_1), bias), 52);
+    __m256i s_2 = _mm256_slli_epi64(_mm256_add_epi64(_mm256_cvtepi32_epi64(n_2), bias), 52);
+
+    e = _mm256_mul_pd(_mm256_mul_pd(e, _mm256_castsi256_pd(s_1)), _mm256_castsi256_pd(s_2));
+
+    e = _mm256_blendv_pd(e, _mm256_set1_pd(HUGE_VAL), _mm256_cmp_pd(x, _mm256_set1_pd(7.09782712893383996843E2), _CMP_GT_OQ));
+    e = _mm256_blendv_pd(e, _mm256_setzero_pd(), _mm256_cmp_pd(x, _mm256_set1_pd(-7.451332191019412076235E2), _CMP_LT_OQ));
+
+    return e;
+}
+
+/**
+@brief
+Compute the natural logarithm of x using AVX2.
+
+Uses the Cephes decomposition and rational approximation of the logarithm,
+which is within 2 ulp of the correctly rounded result. Negative x gives NaN
+and zero gives -infinity, as log() does.
+
+@param[in] x
+Arguments.
+
+@return
+Natural logarithms.
+
+*/
+ILM_TARGET_AVX2 static __m256d LogAvx2(
+    __m256d x
+) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two_52 = _mm256_set1_pd(4503599627370496.0);
+
+    // Scale subnormal arguments up to normal numbers.
+    __m256d subnormal = _mm256_and_pd(
+        _mm256_cmp_pd(x, zero, _CMP_GT_OQ),
+        _mm256_cmp_pd(x, _mm256_set1_pd(2.2250738585072014E-308), _CMP_LT_OQ));
+    __m256d x_n = _mm256_blendv_pd(x, _mm256_mul_pd(x, _mm256_set1_pd(18014398509481984.0)), subnormal);
+
+    // x = m 2^e, 0.5 <= m < 1, as by frexp().
+    __m256i bits = _mm256_castpd_si256(x_n);
+    __m256i e_bits = _mm256_and_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x7FF));
+    __m256d e = _mm256_sub_pd(
+        _mm256_castsi256_pd(_mm256_or_si256(e_bits, _mm256_castpd_si256(two_52))),
+        _mm256_add_pd(two_52, _mm256_set1_pd(1022.0)));
+    e = _mm256_sub_pd(e, _mm256_and_pd(subnormal, _mm256_set1_pd(54.0)));
+
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+        _mm256_set1_epi64x(0x3FE0000000000000LL)));
+
+    // Reduce to sqrt(1/2) - 1 <= t < sqrt(2) - 1.
+    __m256d small = _mm256_cmp_pd(m, _mm256_set1_pd(7.07106781186547524401E-1), _CMP_LT_OQ);
+    e = _mm256_sub_pd(e, _mm256_and_pd(small, one));
+    __m256d t = _mm256_sub_pd(_mm256_add_pd(m, _mm256_and_pd(small, m)), one);
+
+    __m256d z = _mm256_mul_pd(t, t);
+
+    __m256d p = _mm256_set1_pd(1.01875663804580931796E-4);
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(4.97494994976747001425E-1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(4.70579119878881725854E0));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(1.44989225341610930846E1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(1.79368678507819816313E1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(7.70838733755885391666E0));
+
+    __m256d q = _mm256_add_pd(t, _mm256_set1_pd(1.12873587189167450590E1));
+    q = _mm256_add_pd(_mm256_mul_pd(q, t), _mm256_set1_pd(4.52279145837532221105E1));
+    q = _mm256_add_pd(_mm256_mul_pd(q, t), _mm256_set1_pd(8.29875266912776603211E1));
+    q = _mm256_add_pd(_mm256_mul_pd(q, t), _mm256_set1_pd(7.11544750618563894466E1));
+    q = _mm256_add_pd(_mm256_mul_pd(q, t), _mm256_set1_pd(2.31251620126765340583E1));
+
+    __m256d y = _mm256_mul_pd(t, _mm256_div_pd(_mm256_mul_pd(z, p), q));
+    y = _mm256_sub_pd(y, _mm256_mul_pd(e, _mm256_set1_pd(2.121944400546905827679E-4)));
+    y = _mm256_sub_pd(y, _mm256_mul_pd(z, _mm256_set1_pd(0.5)));
+
+    __m256d r = _mm256_add_pd(t, y);
+    r = _mm256_add_pd(r, _mm256_mul_pd(e, _mm256_set1_pd(0.693359375)));
+
+    r = _mm256_blendv_pd(r, _mm256_set1_pd(-HUGE_VAL), _mm256_cmp_pd(x, zero, _CMP_EQ_OQ));
+    r = _mm256_blendv_pd(r, _mm256_set1_pd(HUGE_VAL), _mm256_cmp_pd(x, _mm256_set1_pd(HUGE_VAL), _CMP_EQ_OQ));
+    r = _mm256_blendv_pd(r, _mm256_set1_pd(NAN), _mm256_cmp_pd(x, zero, _CMP_NGE_UQ));
+
+    return r;
+}
+
+/**
+@brief
+Compute the base 10 logarithm of x using AVX2.
+
+@param[in] x
+Arguments.
+
+@return
+Base 10 logarithms.
+
+*/
+ILM_TARGET_AVX2 static __m256d Log10Avx2(
+    __m256d x
+) {
+    return _mm256_mul_pd(LogAvx2(x), _mm256_set1_pd(M_LOG10E));
+}
+
+/**
+@brief
+Compute the cube root of x >= 0 using AVX2. Negative x gives NaN, as
+pow(x, 1.0 / 3.0) does.
+
+@param[in] x
+Arguments.
+
+@return
+Cube roots.
+
+*/
+ILM_TARGET_AVX2 static __m256d CbrtAvx2(
+    __m256d x
+) {
+    return ExpAvx2(_mm256_mul_pd(LogAvx2(x), _mm256_set1_pd(1.0 / 3.0)));
+}
+
+/**
+@brief
+Compute the sine and cosine of x using AVX2.
+
+Uses the Cephes octant reduction and polynomial approximations, which are
+within 2 ulp of the correctly rounded results for |x| up to about 1e8.
+
+@param[in] x
+Angles, in radians.
+
+@param[out] s
+Sines.
+
+@param[out] c
+Cosines.
+
+*/
+ILM_TARGET_AVX2 static void SinCosAvx2(
+    __m256d x,
+    __m256d *s,
+    __m256d *c
+) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    __m256d a = _mm256_andnot_pd(sign, x);
+
+    // Octant of the angle, rounded up to even, and its value modulo 8.
+    __m256d y = _mm256_floor_pd(_mm256_mul_pd(a, _mm256_set1_pd(4.0 / M_PI)));
+    y = _mm256_add_pd(y, _mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(2.0), _mm256_floor_pd(_mm256_mul_pd(y, _mm256_set1_pd(0.5))))));
+    __m256d j = _mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(8.0), _mm256_floor_pd(_mm256_mul_pd(y, _mm256_set1_pd(0.125)))));
+
+    // Extended precision reduction by pi / 4.
+    __m256d z = _mm256_sub_pd(a, _mm256_mul_pd(y, _mm256_set1_pd(7.85398125648498535156E-1)));
+    z = _mm256_sub_pd(z, _mm256_mul_pd(y, _mm256_set1_pd(3.77489470793079817668E-8)));
+    z = _mm256_sub_pd(z, _mm256_mul_pd(y, _mm256_set1_pd(2.69515142907905952645E-15)));
+
+    __m256d zz = _mm256_mul_pd(z, z);
+
+    __m256d p_s = _mm256_set1_pd(1.58962301576546568060E-10);
+    p_s = _mm256_add_pd(_mm256_mul_pd(p_s, zz), _mm256_set1_pd(-2.50507477628578072866E-8));
+    p_s = _mm256_add_pd(_mm256_mul_pd(p_s, zz), _mm256_set1_pd(2.75573136213857245213E-6));
+    p_s = _mm256_add_pd(_mm256_mul_pd(p_s, zz), _mm256_set1_pd(-1.98412698295895385996E-4));
+    p_s = _mm256_add_pd(_mm256_mul_pd(p_s, zz), _mm256_set1_pd(8.33333333332211858878E-3));
+    p_s = _mm256_add_pd(_mm256_mul_pd(p_s, zz), _mm256_set1_pd(-1.66666666666666307295E-1));
+    p_s = _mm256_add_pd(z, _mm256_mul_pd(z, _mm256_mul_pd(zz, p_s)));
+
+    __m256d p_c = _mm256_set1_pd(-1.13585365213876817300E-11);
+    p_c = _mm256_add_pd(_mm256_mul_pd(p_c, zz), _mm256_set1_pd(2.08757008419747316778E-9));
+    p_c = _mm256_add_pd(_mm256_mul_pd(p_c, zz), _mm256_set1_pd(-2.75573141792967388112E-7));
+    p_c = _mm256_add_pd(_mm256_mul_pd(p_c, zz), _mm256_set1_pd(2.48015872888517045348E-5));
+    p_c = _mm256_add_pd(_mm256_mul_pd(p_c, zz), _mm256_set1_pd(-1.38888888888730564116E-3));
+    p_c = _mm256_add_pd(_mm256_mul_pd(p_c, zz), _mm256_set1_pd(4.16666666666665929218E-2));
+    p_c = _mm256_add_pd(_mm256_sub_pd(one, _mm256_mul_pd(zz, _mm256_set1_pd(0.5))), _mm256_mul_pd(_mm256_mul_pd(zz, zz), p_c));
+
+    // Octants 2 and 6 swap the polynomials, sine is negative in octants 4
+    // and 6 and cosine in octants 2 and 4.
+    __m256d swap = _mm256_or_pd(
+        _mm256_cmp_pd(j, _mm256_set1_pd(2.0), _CMP_EQ_OQ),
+        _mm256_cmp_pd(j, _mm256_set1_pd(6.0), _CMP_EQ_OQ));
+    __m256d s_neg = _mm256_cmp_pd(j, _mm256_set1_pd(3.0), _CMP_GT_OQ);
+    __m256d c_neg = _mm256_and_pd(
+        _mm256_cmp_pd(j, one, _CMP_GT_OQ),
+        _mm256_cmp_pd(j, _mm256_set1_pd(5.0), _CMP_LT_OQ));
+
+    __m256d s_x = _mm256_xor_pd(_mm256_blendv_pd(p_s, p_c, swap), _mm256_and_pd(s_neg, sign));
+    *s = _mm256_xor_pd(s_x, _mm256_and_pd(x, sign));
+    *c = _mm256_xor_pd(_mm256_blendv_pd(p_c, p_s, swap), _mm256_and_pd(c_neg, sign));
+}
+
+/**
+@brief
+Set a warning flag in the lanes where a condition holds.
+
+@param[in] condition
+Lane mask of the condition.
+
+@param[in] flag
+Warning flag.
+
+@param[in,out] warnings
+Warning flags of each lane.
+
+*/
+ILM_TARGET_AVX2 static void SetWarningAvx2(
+    __m256d condition,
+    long flag,
+    long warnings[LONGLEY_RICE_LANES]
+) {
+    int mask = _mm256_movemask_pd(condition);
+
+    for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+    {
+        if ((mask >> l) & 1)
+            warnings[l] |= flag;
+    }
+}
+
+/**
+@brief
+Compute the Fresnel integral approximation of FresnelIntegral() using AVX2.
+
+@param[in] v2
+Square of the Fresnel-Kirchhoff diffraction parameter.
+
+@return
+Knife-edge diffraction loss, in dB.
+
+*/
+ILM_TARGET_AVX2 static __m256d FresnelIntegralAvx2(
+    __m256d v2
+) {
+    __m256d near_ = _mm256_sub_pd(
+        _mm256_add_pd(_mm256_set1_pd(6.02), _mm256_mul_pd(_mm256_set1_pd(9.11), _mm256_sqrt_pd(v2))),
+        _mm256_mul_pd(_mm256_set1_pd(1.27), v2));
+    __m256d far_ = _mm256_add_pd(_mm256_set1_pd(12.953), _mm256_mul_pd(_mm256_set1_pd(10.0), Log10Avx2(v2)));
+
+    return _mm256_blendv_pd(far_, near_, _mm256_cmp_pd(v2, _mm256_set1_pd(5.76), _CMP_LT_OQ));
+}
+
+/**
+@brief
+Compute the height gain function of HeightFunction() using AVX2, with each
+of its regimes selected by lane.
+
+@param[in] x__km
+Normalized distance, in km.
+
+@param[in] K
+K value.
+
+@return
+Height gain, in dB.
+
+*/
+ILM_TARGET_AVX2 static __m256d HeightFunctionAvx2(
+    __m256d x__km,
+    __m256d K
+) {
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    __m256d log_x = LogAvx2(x__km);
+    __m256d far_ = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(17.372), log_x), _mm256_set1_pd(-117.0));
+
+    // x < 200 km.
+    __m256d w = _mm256_sub_pd(_mm256_setzero_pd(), LogAvx2(K));
+    __m256d w_3 = _mm256_mul_pd(_mm256_mul_pd(w, w), w);
+    __m256d limit = _mm256_or_pd(
+        _mm256_cmp_pd(K, _mm256_set1_pd(1.0E-5), _CMP_LT_OQ),
+        _mm256_cmp_pd(_mm256_mul_pd(x__km, w_3), _mm256_set1_pd(5495.0), _CMP_GT_OQ));
+
+    __m256d limit_result = _mm256_blendv_pd(_mm256_set1_pd(-117.0), far_, _mm256_cmp_pd(x__km, one, _CMP_GT_OQ));
+    __m256d near_result = _mm256_sub_pd(
+        _mm256_sub_pd(
+            _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(2.5E-5), _mm256_mul_pd(x__km, x__km)), K),
+            _mm256_mul_pd(_mm256_set1_pd(8.686), w)),
+        _mm256_set1_pd(15.0));
+    near_result = _mm256_blendv_pd(near_result, limit_result, limit);
+
+    // x >= 200 km, blended towards the far result below 2000 km.
+    __m256d result = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(0.05751), x__km), _mm256_mul_pd(_mm256_set1_pd(4.343), log_x));
+    __m256d w_b = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.0134), x__km), ExpAvx2(_mm256_mul_pd(_mm256_set1_pd(-0.005), x__km)));
+    __m256d blend = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(one, w_b), result), _mm256_mul_pd(w_b, far_));
+    result = _mm256_blendv_pd(result, blend, _mm256_cmp_pd(x__km, _mm256_set1_pd(2000.0), _CMP_LT_OQ));
+
+    return _mm256_blendv_pd(result, near_result, _mm256_cmp_pd(x__km, _mm256_set1_pd(200.0), _CMP_LT_OQ));
+}
+
+/**
+@brief
+Compute the knife-edge diffraction loss of KnifeEdgeDiffraction() using AVX2.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] theta_los
+Angular distance of line-of-sight region.
+
+@param[in] d_hzn__meter
+Horizon distances, in meters.
+
+@return
+Knife-edge diffraction loss, in dB.
+
+*/
+ILM_TARGET_AVX2 static __m256d KnifeEdgeDiffractionAvx2(
+    __m256d d__meter,
+    __m256d f__mhz,
+    __m256d theta_los,
+    const __m256d d_hzn__meter[2]
+) {
+    __m256d d_ML__meter = _mm256_add_pd(d_hzn__meter[0], d_hzn__meter[1]);
+    __m256d theta_nlos = _mm256_sub_pd(_mm256_div_pd(d__meter, _mm256_set1_pd(a_m__meter)), theta_los);
+    __m256d d_nlos__meter = _mm256_sub_pd(d__meter, d_ML__meter);
+
+    __m256d c = _mm256_mul_pd(
+        _mm256_mul_pd(_mm256_set1_pd(0.0795775), _mm256_div_pd(f__mhz, _mm256_set1_pd(47.7))),
+        _mm256_mul_pd(theta_nlos, theta_nlos));
+
+    __m256d v_1 = _mm256_div_pd(
+        _mm256_mul_pd(_mm256_mul_pd(c, d_hzn__meter[0]), d_nlos__meter),
+        _mm256_add_pd(d_nlos__meter, d_hzn__meter[0]));
+    __m256d v_2 = _mm256_div_pd(
+        _mm256_mul_pd(_mm256_mul_pd(c, d_hzn__meter[1]), d_nlos__meter),
+        _mm256_add_pd(d_nlos__meter, d_hzn__meter[1]));
+
+    return _mm256_add_pd(FresnelIntegralAvx2(v_1), FresnelIntegralAvx2(v_2));
+}
+
+/**
+@brief
+Compute the smooth sphere diffraction loss of SmoothSphereDiffraction() using
+AVX2, over the lunar radius.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] radio
+Radio context constants.
+
+@param[in] theta_los
+Angular distance of line-of-sight region.
+
+@param[in] d_hzn__meter
+Horizon distances, in meters.
+
+@param[in] h_e__meter
+Effective terminal heights, in meters.
+
+@return
+Smooth sphere diffraction loss, in dB.
+
+*/
+ILM_TARGET_AVX2 static __m256d SmoothSphereDiffractionAvx2(
+    __m256d d__meter,
+    const RadioLanesAvx2 &radio,
+    __m256d theta_los,
+    const __m256d d_hzn__meter[2],
+    const __m256d h_e__meter[2]
+) {
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d km = _mm256_set1_pd(1000.0);
+
+    __m256d a__meter[3];
+    __m256d d__km[3];
+    __m256d K[3];
+    __m256d B_0[3];
+    __m256d C_0[3];
+
+    // [Algorithm, Eqn 4.12].
+    __m256d theta_nlos = _mm256_sub_pd(_mm256_div_pd(d__meter, _mm256_set1_pd(a_m__meter)), theta_los);
+
+    __m256d d_ML__meter = _mm256_add_pd(d_hzn__meter[0], d_hzn__meter[1]);
+
+    // [RLS, A-30b, rearranged] and [Volger 1964, Eqn 3] re-arranged.
+    a__meter[0] = _mm256_div_pd(_mm256_sub_pd(d__meter, d_ML__meter), theta_nlos);
+    a__meter[1] = _mm256_div_pd(_mm256_mul_pd(half, _mm256_mul_pd(d_hzn__meter[0], d_hzn__meter[0])), h_e__meter[0]);
+    a__meter[2] = _mm256_div_pd(_mm256_mul_pd(half, _mm256_mul_pd(d_hzn__meter[1], d_hzn__meter[1])), h_e__meter[1]);
+
+    d__km[0] = _mm256_div_pd(_mm256_mul_pd(a__meter[0], theta_nlos), km);
+    d__km[1] = _mm256_div_pd(d_hzn__meter[0], km);
+    d__km[2] = _mm256_div_pd(d_hzn__meter[1], km);
+
+    for (int i = 0; i < 3; i++)
+    {
+        // [Vogler 1964, Eqn 2], [Vogler 1964, Eqn 6a / 7a] and [RLS, A-76].
+        C_0[i] = CbrtAvx2(_mm256_div_pd(_mm256_set1_pd((4.0 / 3.0) * a_m__meter), a__meter[i]));
+        K[i] = _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.017778), C_0[i]), radio.f_inv_cbrt), radio.abs_Z_g);
+
+        // B_0 lane by lane, with the same abs() as SmoothSphereDiffraction().
+        double K_l[LONGLEY_RICE_LANES];
+        double B_0_l[LONGLEY_RICE_LANES];
+        _mm256_storeu_pd(K_l, K[i]);
+        for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+            B_0_l[l] = SmoothSphereB0(K_l[l]);
+        B_0[i] = _mm256_loadu_pd(B_0_l);
+    }
+
+    __m256d x__km[3];
+    for (int i = 0; i < 3; i++)
+        x__km[i] = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(B_0[i], _mm256_mul_pd(C_0[i], C_0[i])), radio.f_cbrt), d__km[i]);
+    x__km[0] = _mm256_add_pd(_mm256_add_pd(x__km[0], x__km[1]), x__km[2]);
+
+    __m256d F_x__db[2];
+    F_x__db[0] = HeightFunctionAvx2(x__km[1], K[1]);
+    F_x__db[1] = HeightFunctionAvx2(x__km[2], K[2]);
+
+    // [TN101, Eqn 8.4] & [Volger 1964, Eqn 13].
+    __m256d G_x__db = _mm256_sub_pd(
+        _mm256_mul_pd(_mm256_set1_pd(0.05751), x__km[0]),
+        _mm256_mul_pd(_mm256_set1_pd(10.0), Log10Avx2(x__km[0])));
+
+    return _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(G_x__db, F_x__db[0]), F_x__db[1]), _mm256_set1_pd(20.0));
+}
+
+/**
+@brief
+Compute the diffraction loss of DiffractionLoss() using AVX2, over the lunar
+radius.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[in] d_hzn__meter
+Horizon distances, in meters.
+
+@param[in] h_e__meter
+Effective terminal heights, in meters.
+
+@param[in] radio
+Radio context constants.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in] theta_los
+Angular distance of line-of-sight region.
+
+@return
+Diffraction loss, in dB.
+
+*/
+ILM_TARGET_AVX2 static __m256d DiffractionLossAvx2(
+    __m256d d__meter,
+    const __m256d d_hzn__meter[2],
+    const __m256d h_e__meter[2],
+    const RadioLanesAvx2 &radio,
+    __m256d delta_h__meter,
+    const __m256d h__meter[2],
+    __m256d theta_los
+) {
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    __m256d A_k__db = KnifeEdgeDiffractionAvx2(d__meter, radio.f__mhz, theta_los, d_hzn__meter);
+    __m256d A_r__db = SmoothSphereDiffractionAvx2(d__meter, radio, theta_los, d_hzn__meter, h_e__meter);
+
+    // [RLS, A-14].
+    __m256d delta_h_d__meter = _mm256_mul_pd(delta_h__meter, _mm256_sub_pd(one,
+        _mm256_mul_pd(_mm256_set1_pd(0.8), ExpAvx2(_mm256_div_pd(_mm256_sub_pd(_mm256_setzero_pd(), d__meter), _mm256_set1_pd(50.0E3))))));
+
+    // [RLS, A-25 & B-23].
+    __m256d term1 = _mm256_sqrt_pd(_mm256_div_pd(
+        _mm256_mul_pd(h_e__meter[0], h_e__meter[1]),
+        _mm256_mul_pd(h__meter[0], h__meter[1])));
+
+    __m256d d_l__meter = _mm256_add_pd(d_hzn__meter[0], d_hzn__meter[1]);
+
+    __m256d roughness = _mm256_div_pd(_mm256_mul_pd(delta_h_d__meter, radio.f__mhz), _mm256_set1_pd(47.7));
+    roughness = _mm256_blendv_pd(roughness, _mm256_set1_pd(1000.0), _mm256_cmp_pd(roughness, _mm256_set1_pd(1000.0), _CMP_GT_OQ));
+
+    __m256d q = _mm256_mul_pd(_mm256_add_pd(term1, _mm256_div_pd(
+        _mm256_sub_pd(d_l__meter, _mm256_mul_pd(theta_los, _mm256_set1_pd(a_m__meter))), d__meter)), roughness);
+
+    // [RLS, A-24 & B-22].
+    __m256d w = _mm256_div_pd(one, _mm256_add_pd(one, _mm256_mul_pd(_mm256_set1_pd(0.1), _mm256_sqrt_pd(q))));
+
+    // [RLS, A-23 & B-21].
+    return _mm256_add_pd(_mm256_mul_pd(w, A_r__db), _mm256_mul_pd(_mm256_sub_pd(one, w), A_k__db));
+}
+
+/**
+@brief
+Compute the line-of-sight loss of LineOfSightLoss() using AVX2.
+
+@param[in] s__meter
+Distance, in meters.
+
+@param[in] h_e__meter
+Effective terminal heights, in meters.
+
+@param[in] radio
+Radio context constants.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] m_d
+Diffraction slope.
+
+@param[in] A_ed
+Diffraction intercept.
+
+@param[in] d_ls__meter
+Maximum line-of-sight distance for a smooth path, in meters.
+
+@return
+Line-of-sight loss, in dB.
+
+*/
+ILM_TARGET_AVX2 static __m256d LineOfSightLossAvx2(
+    __m256d s__meter,
+    const __m256d h_e__meter[2],
+    const RadioLanesAvx2 &radio,
+    __m256d delta_h__meter,
+    __m256d m_d,
+    __m256d A_ed,
+    __m256d d_ls__meter
+) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    // [RLS, A-67 & B-65].
+    __m256d sigma_h_s__meter = _mm256_mul_pd(
+        _mm256_div_pd(delta_h__meter, _mm256_set1_pd(1.282)),
+        ExpAvx2(_mm256_div_pd(_mm256_sub_pd(zero, _mm256_sqrt_pd(_mm256_sqrt_pd(delta_h__meter))), _mm256_set1_pd(2.0))));
+
+    // [RLS, A-65 & B-63].
+    __m256d h_sum__meter = _mm256_add_pd(h_e__meter[0], h_e__meter[1]);
+    __m256d sin_psi = _mm256_div_pd(h_sum__meter, _mm256_sqrt_pd(_mm256_add_pd(
+        _mm256_mul_pd(s__meter, s__meter),
+        _mm256_mul_pd(h_sum__meter, h_sum__meter))));
+
+    // [RLS, A-66 & B-64].
+    __m256d n_re = _mm256_sub_pd(sin_psi, radio.Z_g_real);
+    __m256d n_im = _mm256_sub_pd(zero, radio.Z_g_imag);
+    __m256d d_re = _mm256_add_pd(sin_psi, radio.Z_g_real);
+    __m256d d_im = radio.Z_g_imag;
+    __m256d d_abs2 = _mm256_add_pd(_mm256_mul_pd(d_re, d_re), _mm256_mul_pd(d_im, d_im));
+
+    __m256d g = ExpAvx2(_mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(zero, radio.k), sigma_h_s__meter), sin_psi));
+
+    __m256d R_e_re = _mm256_mul_pd(_mm256_div_pd(
+        _mm256_add_pd(_mm256_mul_pd(n_re, d_re), _mm256_mul_pd(n_im, d_im)), d_abs2), g);
+    __m256d R_e_im = _mm256_mul_pd(_mm256_div_pd(
+        _mm256_sub_pd(_mm256_mul_pd(n_im, d_re), _mm256_mul_pd(n_re, d_im)), d_abs2), g);
+
+    // [RLS, A-69 & B-67].
+    __m256d q = _mm256_add_pd(_mm256_mul_pd(R_e_re, R_e_re), _mm256_mul_pd(R_e_im, R_e_im));
+    __m256d scale = _mm256_or_pd(
+        _mm256_cmp_pd(q, _mm256_set1_pd(0.25), _CMP_LT_OQ),
+        _mm256_cmp_pd(q, sin_psi, _CMP_LT_OQ));
+    __m256d factor = _mm256_blendv_pd(one, _mm256_sqrt_pd(_mm256_div_pd(sin_psi, q)), scale);
+    R_e_re = _mm256_mul_pd(R_e_re, factor);
+    R_e_im = _mm256_mul_pd(R_e_im, factor);
+
+    // [RLS, A-68 & B-66].
+    __m256d delta_phi = _mm256_div_pd(
+        _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), radio.k), h_e__meter[0]), h_e__meter[1]),
+        s__meter);
+
+    // [RLS, A-70 & B-68].
+    delta_phi = _mm256_blendv_pd(
+        delta_phi,
+        _mm256_sub_pd(_mm256_set1_pd(M_PI), _mm256_div_pd(_mm256_set1_pd((M_PI / 2.0) * (M_PI / 2.0)), delta_phi)),
+        _mm256_cmp_pd(delta_phi, _mm256_set1_pd(M_PI / 2.0), _CMP_GT_OQ));
+
+    // [RLS, A-71 & B-69].
+    __m256d sin_phi;
+    __m256d cos_phi;
+    SinCosAvx2(delta_phi, &sin_phi, &cos_phi);
+
+    __m256d rr_re = _mm256_add_pd(cos_phi, R_e_re);
+    __m256d rr_im = _mm256_add_pd(_mm256_sub_pd(zero, sin_phi), R_e_im);
+    __m256d A_t__db = _mm256_mul_pd(_mm256_set1_pd(-10.0),
+        Log10Avx2(_mm256_add_pd(_mm256_mul_pd(rr_re, rr_re), _mm256_mul_pd(rr_im, rr_im))));
+
+    // [RLS, A-64 & B-62].
+    __m256d A_d__db = _mm256_add_pd(A_ed, _mm256_mul_pd(m_d, s__meter));
+
+    // [RLS, A-63 & B-61].
+    __m256d D_2 = _mm256_set1_pd(10.0E3);
+    __m256d d__meter = _mm256_blendv_pd(D_2, d_ls__meter, _mm256_cmp_pd(d_ls__meter, D_2, _CMP_GT_OQ));
+    __m256d w = _mm256_div_pd(one, _mm256_add_pd(one, _mm256_div_pd(
+        _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(47.7), radio.k), delta_h__meter), d__meter)));
+
+    // [RLS, A-62 & B-60].
+    return _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(one, w), A_d__db), _mm256_mul_pd(w, A_t__db));
+}
+
+/**
+@brief
+Compute the inverse of the complementary cumulative distribution function
+approximation of InverseComplementaryCumulativeDistributionFunction() using
+AVX2.
+
+@param[in] q
+Quantiles, 0 < q < 1.
+
+@return
+Inverse CCDF values.
+
+*/
+ILM_TARGET_AVX2 static __m256d InverseCcdfAvx2(
+    __m256d q
+) {
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    __m256d upper = _mm256_cmp_pd(q, _mm256_set1_pd(0.5), _CMP_GT_OQ);
+    __m256d x = _mm256_blendv_pd(q, _mm256_sub_pd(one, q), upper);
+
+    __m256d T_x = _mm256_sqrt_pd(_mm256_mul_pd(_mm256_set1_pd(-2.0), LogAvx2(x)));
+
+    __m256d n = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(0.010328), T_x), _mm256_set1_pd(0.802853));
+    n = _mm256_add_pd(_mm256_mul_pd(n, T_x), _mm256_set1_pd(2.515516));
+
+    __m256d d = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(0.001308), T_x), _mm256_set1_pd(0.189269));
+    d = _mm256_add_pd(_mm256_mul_pd(d, T_x), _mm256_set1_pd(1.432788));
+    d = _mm256_add_pd(_mm256_mul_pd(d, T_x), one);
+
+    __m256d Q_q = _mm256_sub_pd(T_x, _mm256_div_pd(n, d));
+
+    return _mm256_blendv_pd(Q_q, _mm256_sub_pd(_mm256_setzero_pd(), Q_q), upper);
+}
+
+/**
+@brief
+Evaluate the reference attenuation, the free space loss and the variability
+of four paths, one per lane, using AVX2.
+
+The steps are those of LongleyRice(), FreeSpaceLoss() and Variability(), with
+every branch evaluated for all lanes and the result of each lane selected by
+its own conditions: the line-of-sight and trans-horizon distances, the two
+cases of the sign of A_ed and the regimes of the height gain function. The
+transcendental functions use the Cephes approximations, so the results agree
+with the scalar functions to within a few ulp of their inputs rather than bit
+for bit.
+
+@param[in,out] lanes
+Paths of the four lanes. The ground impedance of each must be valid.
+
+*/
+ILM_TARGET_AVX2 void LongleyRiceAvx2(
+    LongleyRiceLanes *lanes
+) {
+    const __m256d zero = _mm256_setzero_pd();
+
+    RadioLanesAvx2 radio;
+    LoadRadioLanesAvx2(lanes->radio, &radio);
+
+    __m256d d_hzn__meter[2];
+    __m256d h_e__meter[2];
+    __m256d h__meter[2];
+    for (int i = 0; i < 2; i++)
+    {
+        d_hzn__meter[i] = _mm256_loadu_pd(lanes->d_hzn__meter[i]);
+        h_e__meter[i] = _mm256_loadu_pd(lanes->h_e__meter[i]);
+        h__meter[i] = _mm256_loadu_pd(lanes->h__meter[i]);
+    }
+    __m256d delta_h__meter = _mm256_loadu_pd(lanes->delta_h__meter);
+    __m256d d__meter = _mm256_loadu_pd(lanes->d__meter);
+
+    // [RLS, A-8 & B-8].
+    __m256d d_hzn_s__meter[2];
+    for (int i = 0; i < 2; i++)
+        d_hzn_s__meter[i] = _mm256_sqrt_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), h_e__meter[i]), _mm256_set1_pd(a_m__meter)));
+
+    // [RLS, A-11].
+    __m256d d_ls__meter = _mm256_add_pd(d_hzn_s__meter[0], d_hzn_s__meter[1]);
+
+    // [RLS, A-12].
+    __m256d d_l__meter = _mm256_add_pd(d_hzn__meter[0], d_hzn__meter[1]);
+
+    // Check validity of small angle approximation.
+    double d_min__meter[LONGLEY_RICE_LANES];
+    for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+    {
+        double theta_hzn[2] = { lanes->theta_hzn[0][l], lanes->theta_hzn[1][l] };
+        double h_e_l__meter[2] = { lanes->h_e__meter[0][l], lanes->h_e__meter[1][l] };
+
+        SmallAngleWarnings(theta_hzn, &lanes->warnings[l]);
+        d_min__meter[l] = MinimumPathDistance(h_e_l__meter);
+    }
+
+    SetWarningAvx2(_mm256_cmp_pd(d_hzn__meter[0], _mm256_mul_pd(_mm256_set1_pd(0.1), d_hzn_s__meter[0]), _CMP_LT_OQ), WARN__TX_HORIZON_DISTANCE_1, lanes->warnings);
+    SetWarningAvx2(_mm256_cmp_pd(d_hzn__meter[1], _mm256_mul_pd(_mm256_set1_pd(0.1), d_hzn_s__meter[1]), _CMP_LT_OQ), WARN__RX_HORIZON_DISTANCE_1, lanes->warnings);
+
+    SetWarningAvx2(_mm256_cmp_pd(d_hzn__meter[0], _mm256_mul_pd(_mm256_set1_pd(3.0), d_hzn_s__meter[0]), _CMP_GT_OQ), WARN__TX_HORIZON_DISTANCE_2, lanes->warnings);
+    SetWarningAvx2(_mm256_cmp_pd(d_hzn__meter[1], _mm256_mul_pd(_mm256_set1_pd(3.0), d_hzn_s__meter[1]), _CMP_GT_OQ), WARN__RX_HORIZON_DISTANCE_2, lanes->warnings);
+
+    // [RLS, A-16 & B-14] and [RLS, A-17 & B-15].
+    __m256d d_3__meter = _mm256_add_pd(d_l__meter, _mm256_mul_pd(_mm256_set1_pd(1.3787), radio.X_ae__meter));
+    d_3__meter = _mm256_blendv_pd(d_ls__meter, d_3__meter, _mm256_cmp_pd(d_ls__meter, d_3__meter, _CMP_LT_OQ));
+    __m256d d_4__meter = _mm256_add_pd(d_3__meter, _mm256_mul_pd(_mm256_set1_pd(2.7574), radio.X_ae__meter));
+
+    // [RLS, A-18 & B-16].
+    __m256d A_3__db = DiffractionLossAvx2(
+        d_3__meter,
+        d_hzn__meter,
+        h_e__meter,
+        radio,
+        delta_h__meter,
+        h__meter,
+        d_ls__meter
+    );
+    // [RLS, A-19 & B-17].
+    __m256d A_4__db = DiffractionLossAvx2(
+        d_4__meter,
+        d_hzn__meter,
+        h_e__meter,
+        radio,
+        delta_h__meter,
+        h__meter,
+        d_ls__meter
+    );
+
+    // [RLS, A-21 & B-19].
+    __m256d m_d = _mm256_div_pd(_mm256_sub_pd(A_4__db, A_3__db), _mm256_sub_pd(d_4__meter, d_3__meter));
+    // [RLS, A-22 & B-20].
+    __m256d A_ed__db = _mm256_sub_pd(A_3__db, _mm256_mul_pd(m_d, d_3__meter));
+
+    /* Line-of-sight coefficients. */
+
+    // [RLS, A-36 & B-34].
+    __m256d A_2__db = _mm256_add_pd(A_ed__db, _mm256_mul_pd(m_d, d_ls__meter));
+
+    // [RLS, A.1.5, CASE 1] where A_ed >= 0, [RLS, A-47 & A-48] otherwise.
+    __m256d case_1 = _mm256_cmp_pd(A_ed__db, zero, _CMP_GE_OQ);
+
+    __m256d d_k__meter = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(1.908), radio.k), h_e__meter[0]), h_e__meter[1]);
+    __m256d d_half__meter = _mm256_mul_pd(_mm256_set1_pd(0.5), d_l__meter);
+    __m256d d_quarter__meter = _mm256_div_pd(d_l__meter, _mm256_set1_pd(4.0));
+
+    __m256d d_0__meter = _mm256_blendv_pd(d_half__meter, d_k__meter, _mm256_cmp_pd(d_k__meter, d_half__meter, _CMP_LT_OQ));
+    d_0__meter = _mm256_blendv_pd(d_k__meter, d_0__meter, case_1);
+
+    __m256d d_1_case_1__meter = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(3.0 / 4.0), d_0__meter), d_quarter__meter);
+    __m256d d_1_case_2__meter = _mm256_div_pd(_mm256_sub_pd(zero, A_ed__db), m_d);
+    d_1_case_2__meter = _mm256_blendv_pd(d_1_case_2__meter, d_quarter__meter,
+        _mm256_cmp_pd(d_1_case_2__meter, d_quarter__meter, _CMP_LT_OQ));
+    __m256d d_1__meter = _mm256_blendv_pd(d_1_case_2__meter, d_1_case_1__meter, case_1);
+
+    __m256d A_1__db = LineOfSightLossAvx2(d_1__meter, h_e__meter, radio, delta_h__meter, m_d, A_ed__db, d_ls__meter);
+    __m256d A_0__db = LineOfSightLossAvx2(d_0__meter, h_e__meter, radio, delta_h__meter, m_d, A_ed__db, d_ls__meter);
+
+    __m256d term1 = LogAvx2(_mm256_div_pd(d_ls__meter, d_0__meter));
+
+    __m256d d_ls_0__meter = _mm256_sub_pd(d_ls__meter, d_0__meter);
+    __m256d d_1_0__meter = _mm256_sub_pd(d_1__meter, d_0__meter);
+
+    // [ERL 79-ITS 67, Eqn 3.20].
+    __m256d kHat_2 = _mm256_div_pd(
+        _mm256_sub_pd(
+            _mm256_mul_pd(d_ls_0__meter, _mm256_sub_pd(A_1__db, A_0__db)),
+            _mm256_mul_pd(d_1_0__meter, _mm256_sub_pd(A_2__db, A_0__db))),
+        _mm256_sub_pd(
+            _mm256_mul_pd(d_ls_0__meter, LogAvx2(_mm256_div_pd(d_1__meter, d_0__meter))),
+            _mm256_mul_pd(d_1_0__meter, term1)));
+    kHat_2 = _mm256_and_pd(kHat_2, _mm256_cmp_pd(kHat_2, zero, _CMP_GT_OQ));
+
+    __m256d flag = _mm256_and_pd(
+        _mm256_cmp_pd(d_0__meter, d_1__meter, _CMP_LT_OQ),
+        _mm256_or_pd(_mm256_cmp_pd(A_ed__db, zero, _CMP_GT_OQ), _mm256_cmp_pd(kHat_2, zero, _CMP_GT_OQ)));
+
+    // [RLS, A-42 & A-52 & B-40 & B-50].
+    __m256d kHat_1 = _mm256_div_pd(
+        _mm256_sub_pd(_mm256_sub_pd(A_2__db, A_0__db), _mm256_mul_pd(kHat_2, term1)),
+        d_ls_0__meter);
+
+    // [RLS, A-54 & B-42].
+    __m256d negative = _mm256_cmp_pd(kHat_1, zero, _CMP_LT_OQ);
+    __m256d kHat_2_dim = _mm256_div_pd(
+        _mm256_and_pd(_mm256_sub_pd(A_2__db, A_0__db), _mm256_cmp_pd(A_2__db, A_0__db, _CMP_GT_OQ)),
+        term1);
+    kHat_2 = _mm256_blendv_pd(kHat_2, kHat_2_dim, negative);
+    kHat_1 = _mm256_blendv_pd(kHat_1, zero, negative);
+    kHat_1 = _mm256_blendv_pd(kHat_1, m_d, _mm256_and_pd(negative, _mm256_cmp_pd(kHat_2, zero, _CMP_EQ_OQ)));
+
+    // Without the flag.
+    __m256d kHat_1_dim = _mm256_div_pd(
+        _mm256_and_pd(_mm256_sub_pd(A_2__db, A_1__db), _mm256_cmp_pd(A_2__db, A_1__db, _CMP_GT_OQ)),
+        _mm256_sub_pd(d_ls__meter, d_1__meter));
+    kHat_1_dim = _mm256_blendv_pd(kHat_1_dim, m_d, _mm256_cmp_pd(kHat_1_dim, zero, _CMP_EQ_OQ));
+
+    kHat_1 = _mm256_blendv_pd(kHat_1_dim, kHat_1, flag);
+    kHat_2 = _mm256_and_pd(kHat_2, flag);
+
+    __m256d A_o__db = _mm256_sub_pd(
+        _mm256_sub_pd(A_2__db, _mm256_mul_pd(kHat_1, d_ls__meter)),
+        _mm256_mul_pd(kHat_2, LogAvx2(d_ls__meter)));
+
+    /* Evaluate at the path distance. */
+
+    SetWarningAvx2(_mm256_cmp_pd(d__meter, _mm256_loadu_pd(d_min__meter), _CMP_LT_OQ), WARN__PATH_DISTANCE_TOO_SMALL_1, lanes->warnings);
+    SetWarningAvx2(_mm256_cmp_pd(d__meter, _mm256_set1_pd(1.0E3), _CMP_LT_OQ), WARN__PATH_DISTANCE_TOO_SMALL_2, lanes->warnings);
+    SetWarningAvx2(_mm256_cmp_pd(d__meter, _mm256_set1_pd(1000.0E3), _CMP_GT_OQ), WARN__PATH_DISTANCE_TOO_BIG_1, lanes->warnings);
+    SetWarningAvx2(_mm256_cmp_pd(d__meter, _mm256_set1_pd(2000.0E3), _CMP_GT_OQ), WARN__PATH_DISTANCE_TOO_BIG_2, lanes->warnings);
+
+    // [ERL 79-ITS 67, Eqn 3.19], or the trans-horizon line.
+    __m256d A_los__db = _mm256_add_pd(
+        _mm256_add_pd(A_o__db, _mm256_mul_pd(kHat_1, d__meter)),
+        _mm256_mul_pd(kHat_2, LogAvx2(d__meter)));
+    __m256d A_ref__db = _mm256_add_pd(_mm256_mul_pd(m_d, d__meter), A_ed__db);
+    A_ref__db = _mm256_blendv_pd(A_ref__db, A_los__db, _mm256_cmp_pd(d__meter, d_ls__meter, _CMP_LT_OQ));
+
+    // Don't allow a negative loss.
+    A_ref__db = _mm256_blendv_pd(A_ref__db, zero, _mm256_cmp_pd(A_ref__db, zero, _CMP_LT_OQ));
+
+    // Free space loss.
+    __m256d A_fs__db = _mm256_add_pd(
+        _mm256_add_pd(_mm256_set1_pd(32.45), radio.A_f__db),
+        _mm256_mul_pd(_mm256_set1_pd(20.0), Log10Avx2(_mm256_div_pd(d__meter, _mm256_set1_pd(1000.0)))));
+
+    // Variability, [RLS, A-72 & B-70] to [RLS, A-75 & B-73].
+    __m256d delta_h_d__meter = _mm256_mul_pd(delta_h__meter, _mm256_sub_pd(_mm256_set1_pd(1.0),
+        _mm256_mul_pd(_mm256_set1_pd(0.8), ExpAvx2(_mm256_div_pd(_mm256_sub_pd(zero, d__meter), _mm256_set1_pd(50.0E3))))));
+    __m256d k_delta_h_d = _mm256_mul_pd(radio.k, delta_h_d__meter);
+    __m256d sigma = _mm256_div_pd(
+        _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(10.0), radio.k), delta_h_d__meter),
+        _mm256_add_pd(k_delta_h_d, _mm256_set1_pd(13.0)));
+
+    __m256d z = InverseCcdfAvx2(_mm256_loadu_pd(lanes->p));
+
+    __m256d A__db = _mm256_add_pd(A_ref__db, _mm256_mul_pd(sigma, z));
+
+    // [Algorithm, Eqn 52].
+    __m256d A_compressed__db = _mm256_div_pd(
+        _mm256_mul_pd(A__db, _mm256_sub_pd(_mm256_set1_pd(29.0), A__db)),
+        _mm256_sub_pd(_mm256_set1_pd(29.0), _mm256_mul_pd(_mm256_set1_pd(10.0), A__db)));
+    A__db = _mm256_blendv_pd(A__db, A_compressed__db, _mm256_cmp_pd(A__db, zero, _CMP_LT_OQ));
+
+    _mm256_storeu_pd(lanes->A_ref__db, A_ref__db);
+    _mm256_storeu_pd(lanes->A_fs__db, A_fs__db);
+    _mm256_storeu_pd(lanes->A__db, _mm256_add_pd(A_fs__db, A__db));
+
+    // Set mode of propagation, truncating as EvaluateLongleyRice() does.
+    double delta__meter[LONGLEY_RICE_LANES];
+    _mm256_storeu_pd(delta__meter, _mm256_sub_pd(d__meter, d_l__meter));
+
+    for (int l = 0; l < LONGLEY_RICE_LANES; l++)
+    {
+        if (int(delta__meter[l]) < 0)
+            lanes->propmode[l] = MODE__LINE_OF_SIGHT;
+        else
+            lanes->propmode[l] = (int(delta__meter[l]) == 0) ? MODE__DIFFRACTION_SINGLE_HORIZON : MODE__DIFFRACTION_DOUBLE_HORIZON;
+    }
+}
+
+/**
+@brief
+Evaluate each term of LongleyRiceAvx2() on its own arguments, one set per
+lane, so that the terms can be checked against their scalar functions.
+
+@param[in,out] terms
+Arguments and results of the terms of the four lanes.
+
+*/
+ILM_TARGET_AVX2 void LongleyRiceTermsAvx2(
+    LongleyRiceTermLanes *terms
+) {
+    RadioLanesAvx2 radio;
+    LoadRadioLanesAvx2(terms->radio, &radio);
+
+    __m256d y = _mm256_loadu_pd(terms->y);
+    _mm256_storeu_pd(terms->exp_x, ExpAvx2(_mm256_loadu_pd(terms->x)));
+    _mm256_storeu_pd(terms->log_y, LogAvx2(y));
+    _mm256_storeu_pd(terms->log10_y, Log10Avx2(y));
+    _mm256_storeu_pd(terms->cbrt_y, CbrtAvx2(y));
+
+    __m256d sin_phi;
+    __m256d cos_phi;
+    SinCosAvx2(_mm256_loadu_pd(terms->phi), &sin_phi, &cos_phi);
+    _mm256_storeu_pd(terms->sin_phi, sin_phi);
+    _mm256_storeu_pd(terms->cos_phi, cos_phi);
+
+    _mm256_storeu_pd(terms->F_v__db, FresnelIntegralAvx2(_mm256_loadu_pd(terms->v2)));
+    _mm256_storeu_pd(terms->F_x__db, HeightFunctionAvx2(_mm256_loadu_pd(terms->x__km), _mm256_loadu_pd(terms->K)));
+    _mm256_storeu_pd(terms->Q_q, InverseCcdfAvx2(_mm256_loadu_pd(terms->q)));
+
+    __m256d d_hzn__meter[2];
+    __m256d h_e__meter[2];
+    for (int i = 0; i < 2; i++)
+    {
+        d_hzn__meter[i] = _mm256_loadu_pd(terms->d_hzn__meter[i]);
+        h_e__meter[i] = _mm256_loadu_pd(terms->h_e__meter[i]);
+    }
+    __m256d d__meter = _mm256_loadu_pd(terms->d__meter);
+    __m256d theta_los = _mm256_loadu_pd(terms->theta_los);
+
+    _mm256_storeu_pd(terms->A_k__db, KnifeEdgeDiffractionAvx2(d__meter, radio.f__mhz, theta_los, d_hzn__meter));
+    _mm256_storeu_pd(terms->A_r__db, SmoothSphereDiffractionAvx2(d__meter, radio, theta_los, d_hzn__meter, h_e__meter));
+    _mm256_storeu_pd(terms->A_los__db, LineOfSightLossAvx2(
+        _mm256_loadu_pd(terms->s__meter),
+        h_e__meter,
+        radio,
+        _mm256_loadu_pd(terms->delta_h__meter),
+        _mm256_loadu_pd(terms->m_d),
+        _mm256_loadu_pd(terms->A_ed__db),
+        _mm256_loadu_pd(terms->d_ls__meter)));
+}
+
+#endif  // ILM_X86_SIMD
@@ -0,0 +1,604 @@
+/**
+@file
+
+This file contains the functions to open, close and sample memory-mapped
+lunar DEMs.
+*/
+
+/* Standard includes. */
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Local includes. */
+#include "./include/LunarDem.h"
+#include "./include/Errors.h"
+
+/**
+@brief
+Largest label that is searched for its END line, in bytes.
+*/
+#define DEM_MAX_LABEL_BYTES 65536
+
+/**
+@brief
+Parse the PDS3 style label at the start of a DEM file.
+
+Each KEYWORD = VALUE line is stored by keyword, keeping the first value of
+keywords that appear more than once. OBJECT structure is not interpreted.
+
+@param[in] text
+Start of the file.
+
+@param[in] size
+Size of the file, in bytes.
+
+@param[out] label
+Values of the label, by keyword.
+
+@return
+True if the END line was found.
+
+*/
+static bool ParseLabel(
+    const char *text,
+    size_t size,
+    std::map<std::string, std::string> *label
+) {
+    size_t end = std::min(size, (size_t)DEM_MAX_LABEL_BYTES);
+    size_t pos = 0;
+
+    while (pos < end)
+    {
+        size_t eol = pos;
+        while (eol < end && text[eol] != '\n')
+            eol++;
+
+        std::string line(text + pos, eol - pos);
+        pos = eol + 1;
+
+        size_t first = line.find_first_not_of(" \t\r");
+        size_t last = line.find_last_not_of(" \t\r");
+        if (first == std::string::npos)
+            continue;
+        line = line.substr(first, last - first + 1);
+
+        if (line == "END")
+            return true;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos)
+            continue;
+
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+
+        key.erase(key.find_last_not_of(" \t") + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+
+        label->insert(std::make_pair(key, value));
+    }
+
+    return false;
+}
+
+/**
+@brief
+Return a numeric label value.
+
+@param[in] label
+Values of the label, by keyword.
+
+@param[in] key
+Keyword.
+
+@param[in] default_value
+Value if the keyword is not in the label.
+
+@return
+Value of the keyword.
+
+*/
+static double LabelNumber(
+    const std::map<std::string, std::string> &label,
+    const char *key,
+    double default_value
+) {
+    auto it = label.find(key);
+    if (it == label.end())
+        return default_value;
+
+    return strtod(it->second.c_str(), nullptr);
+}
+
+/**
+@brief
+Return a count from the label, or 0 if it is not a whole number from 0 to
+INT_MAX.
+
+@param[in] label
+Values of the label, by keyword.
+
+@param[in] key
+Keyword.
+
+@return
+Value of the keyword.
+
+*/
+static int LabelCount(
+    const std::map<std::string, std::string> &label,
+    const char *key
+) {
+    double value = LabelNumber(label, key, 0.0);
+    if (!(value >= 0.0 && value <= INT_MAX) || value != floor(value))
+        return 0;
+
+    return (int)value;
+}
+
+/**
+@brief
+Return if a label value contains a string.
+
+@param[in] label
+Values of the label, by keyword.
+
+@param[in] key
+Keyword.
+
+@param[in] text
+String to search for.
+
+@return
+True if the keyword is in the label and its value contains the string.
+
+*/
+static bool LabelContains(
+    const std::map<std::string, std::string> &label,
+    const char *key,
+    const char *text
+) {
+    auto it = label.find(key);
+
+    return it != label.end() && it->second.find(text) != std::string::npos;
+}
+
+/**
+@brief
+Unmap a DEM file and release its handles.
+
+@param[in] dem
+DEM to unmap.
+
+*/
+static void UnmapLunarDem(
+    LunarDem *dem
+) {
+#ifdef _WIN32
+    if (dem->map != nullptr)
+        UnmapViewOfFile(dem->map);
+    if (dem->handles[1] != nullptr)
+        CloseHandle((HANDLE)dem->handles[1]);
+    if (dem->handles[0] != nullptr)
+        CloseHandle((HANDLE)dem->handles[0]);
+#else
+    if (dem->map != nullptr)
+        munmap(dem->map, dem->map_size);
+#endif
+}
+
+/**
+@brief
+Map a DEM file into memory, read only.
+
+@param[in] path
+Path of the DEM file.
+
+@param[in,out] dem
+DEM to map the file into.
+
+@return
+True if the file was mapped.
+
+*/
+static bool MapLunarDem(
+    const char *path,
+    LunarDem *dem
+) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    dem->handles[0] = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        return false;
+    dem->map_size = (size_t)size.QuadPart;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+        return false;
+    dem->handles[1] = mapping;
+
+    dem->map = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    return dem->map != nullptr;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+    dem->map_size = (size_t)st.st_size;
+
+    void *map = mmap(nullptr, dem->map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+        return false;
+
+    dem->map = map;
+    return true;
+#endif
+}
+
+/**
+@brief
+Open a lunar DEM file.
+
+The file is memory-mapped and only its label is read. The label must give
+the grid size (LINES, LINE_SAMPLES), the sample format (SAMPLE_TYPE of
+LSB_INTEGER, MSB_INTEGER, PC_REAL or IEEE_REAL, with SAMPLE_BITS of 16 or 32),
+the start of the grid (^IMAGE, in records of RECORD_BYTES or in <BYTES>) and
+the map projection (MAP_PROJECTION_TYPE of EQUIRECTANGULAR, SIMPLE
+CYLINDRICAL or POLAR STEREOGRAPHIC, with CENTER_LATITUDE, CENTER_LONGITUDE,
+LINE_PROJECTION_OFFSET, SAMPLE_PROJECTION_OFFSET and either MAP_RESOLUTION
+in pixels per degree or MAP_SCALE in km per pixel). Elevations are
+SCALING_FACTOR * sample + OFFSET, in meters.
+
+Pixels are zero based. Equirectangular line j and sample i are at latitude
+(LINE_PROJECTION_OFFSET - j) / MAP_RESOLUTION and longitude CENTER_LONGITUDE +
+(i - SAMPLE_PROJECTION_OFFSET) / (MAP_RESOLUTION * cos(CENTER_LATITUDE)).
+Polar stereographic line j and sample i are at map coordinates
+x = (i - SAMPLE_PROJECTION_OFFSET) * MAP_SCALE and
+y = (LINE_PROJECTION_OFFSET - j) * MAP_SCALE, on a sphere of radius
+a_m__meter tangent at the pole nearest CENTER_LATITUDE.
+
+@param[in] path
+Path of the DEM file.
+
+@param[out] dem
+Opened DEM, to be closed with CloseLunarDem().
+
+@return error
+Error code.
+
+*/
+int OpenLunarDem(
+    const char *path,
+    LunarDem **dem
+) {
+    *dem = nullptr;
+
+    LunarDem *d = new LunarDem();
+
+    if (!MapLunarDem(path, d))
+    {
+        UnmapLunarDem(d);
+        delete d;
+        return ERROR__DEM_FILE;
+    }
+
+    std::map<std::string, std::string> label;
+    bool valid = ParseLabel((const char *)d->map, d->map_size, &label);
+
+    d->lines = LabelCount(label, "LINES");
+    d->samples = LabelCount(label, "LINE_SAMPLES");
+
+    int bits = LabelCount(label, "SAMPLE_BITS");
+    bool big_endian = LabelContains(label, "SAMPLE_TYPE", "MSB") ||
+        LabelContains(label, "SAMPLE_TYPE", "IEEE");
+
+    if (LabelContains(label, "SAMPLE_TYPE", "INTEGER") && bits == 16)
+        d->sample_type = DEM_SAMPLE__INT16;
+    else if (LabelContains(label, "SAMPLE_TYPE", "REAL") && bits == 32)
+        d->sample_type = DEM_SAMPLE__FLOAT32;
+    else
+        valid = false;
+
+    uint16_t one = 1;
+    bool host_big_endian = *(const unsigned char *)&one == 0;
+    d->swap_bytes = big_endian != host_big_endian;
+
+    d->scale = LabelNumber(label, "SCALING_FACTOR", 1.0);
+    d->offset__meter = LabelNumber(label, "OFFSET", 0.0);
+
+    // Start of the grid, as a one based record or byte. The start and the
+    // record size are checked to lie within the file before they are cast,
+    // and the sizes are compared without products or sums that a corrupt
+    // label could wrap.
+    double start = LabelNumber(label, "^IMAGE", 1.0);
+    double record_bytes = LabelContains(label, "^IMAGE", "<BYTES>")
+        ? 1.0
+        : LabelNumber(label, "RECORD_BYTES", 0.0);
+
+    size_t offset = 0;
+    if (!(start >= 1.0 && start - 1.0 < (double)d->map_size) ||
+        !(record_bytes >= 1.0 && record_bytes <= (double)d->map_size))
+        valid = false;
+    else
+    {
+        size_t index = (size_t)(start - 1.0);
+        size_t record = (size_t)record_bytes;
+        if (index > d->map_size / record)
+            valid = false;
+        else
+            offset = index * record;
+    }
+
+    size_t line_bytes = (size_t)d->samples * (size_t)(bits / 8);
+    if (d->lines < 2 || d->samples < 2 || line_bytes == 0 ||
+        (size_t)d->lines > d->map_size / line_bytes)
+        valid = false;
+    else
+    {
+        size_t grid_bytes = (size_t)d->lines * line_bytes;
+        if (offset <= d->map_size && grid_bytes <= d->map_size - offset)
+            d->data = (const unsigned char *)d->map + offset;
+        else
+            valid = false;
+    }
+
+    d->center_lat__deg = LabelNumber(label, "CENTER_LATITUDE", 0.0);
+    d->center_lon__deg = LabelNumber(label, "CENTER_LONGITUDE", 0.0);
+    d->line_offset = LabelNumber(label, "LINE_PROJECTION_OFFSET", 0.0);
+    d->sample_offset = LabelNumber(label, "SAMPLE_PROJECTION_OFFSET", 0.0);
+    d->cos_center_lon = cos(d->center_lon__deg * M_PI / 180.0);
+    d->sin_center_lon = sin(d->center_lon__deg * M_PI / 180.0);
+
+    if (LabelContains(label, "MAP_PROJECTION_TYPE", "EQUIRECTANGULAR") ||
+        LabelContains(label, "MAP_PROJECTION_TYPE", "SIMPLE CYLINDRICAL"))
+    {
+        d->projection = DEM_PROJECTION__EQUIRECTANGULAR;
+        d->resolution__px_per_deg = LabelNumber(label, "MAP_RESOLUTION", 0.0);
+        d->resolution_lon__px_per_deg = d->resolution__px_per_deg * cos(d->center_lat__deg * M_PI / 180.0);
+
+        if (!(d->resolution_lon__px_per_deg > 0.0))
+            valid = false;
+
+        // Grids that span all longitudes interpolate across the seam.
+        d->wraps = fabs(d->samples - 360.0 * d->resolution_lon__px_per_deg) < 0.5;
+    }
+    else if (LabelContains(label, "MAP_PROJECTION_TYPE", "POLAR STEREOGRAPHIC"))
+    {
+        d->projection = DEM_PROJECTION__POLAR_STEREOGRAPHIC;
+        d->map_scale__meter = LabelNumber(label, "MAP_SCALE", 0.0);
+        if (!LabelContains(label, "MAP_SCALE", "<M"))
+            d->map_scale__meter *= 1000.0;
+
+        if (!(d->map_scale__meter > 0.0))
+            valid = false;
+    }
+    else
+        valid = false;
+
+    if (!valid)
+    {
+        UnmapLunarDem(d);
+        delete d;
+        return ERROR__DEM_FILE;
+    }
+
+    *dem = d;
+    return SUCCESS;
+}
+
+/**
+@brief
+Close a lunar DEM file opened with OpenLunarDem().
+
+@param[in] dem
+DEM to close. May be NULL.
+
+*/
+void CloseLunarDem(
+    LunarDem *dem
+) {
+    if (dem == nullptr)
+        return;
+
+    UnmapLunarDem(dem);
+    delete dem;
+}
+
+/**
+@brief
+Return the nominal spacing of the samples of a lunar DEM.
+
+The spacing is along a meridian of an equirectangular grid, and at the pole
+of a polar stereographic grid.
+
+@param[in] dem
+DEM.
+
+@return
+Sample spacing, in meters.
+
+*/
+double LunarDemSpacing(
+    const LunarDem *dem
+) {
+    if (dem->projection == DEM_PROJECTION__POLAR_STEREOGRAPHIC)
+        return dem->map_scale__meter;
+
+    return (M_PI / 180.0) * a_m__meter / dem->resolution__px_per_deg;
+}
+
+/**
+@brief
+Find the pixel of a lunar DEM at a point on the sphere.
+
+@param[in] dem
+DEM.
+
+@param[in] v
+Unit vector of the point, with x towards latitude 0 and longitude 0, y
+towards latitude 0 and longitude 90 and z towards the north pole.
+
+@param[out] line
+Zero based line of the point, in pixels.
+
+@param[out] sample
+Zero based sample of the point, in pixels.
+
+@return
+True if the point is within the grid.
+
+*/
+bool LunarDemPixel(
+    const LunarDem *dem,
+    const double v[3],
+    double *line,
+    double *sample
+) {
+    if (dem->projection == DEM_PROJECTION__EQUIRECTANGULAR)
+    {
+        double lat__deg = asin(std::max(-1.0, std::min(1.0, v[2]))) * 180.0 / M_PI;
+        double lon__deg = atan2(v[1], v[0]) * 180.0 / M_PI;
+
+        // Longitude relative to the center, in [-180, 180).
+        double dlon__deg = fmod(lon__deg - dem->center_lon__deg + 540.0, 360.0) - 180.0;
+
+        *line = dem->line_offset - lat__deg * dem->resolution__px_per_deg;
+        *sample = dem->sample_offset + dlon__deg * dem->resolution_lon__px_per_deg;
+    }
+    else
+    {
+        // Stereographic projection from the opposite pole, without trig.
+        bool north = dem->center_lat__deg > 0.0;
+        double k = 2.0 * a_m__meter / (1.0 + (north ? v[2] : -v[2]));
+
+        double east = v[1] * dem->cos_center_lon - v[0] * dem->sin_center_lon;
+        double out = v[0] * dem->cos_center_lon + v[1] * dem->sin_center_lon;
+
+        double x__meter = k * east;
+        double y__meter = north ? -k * out : k * out;
+
+        *line = dem->line_offset - y__meter / dem->map_scale__meter;
+        *sample = dem->sample_offset + x__meter / dem->map_scale__meter;
+    }
+
+    // Pixels cover half a pixel on either side of their centers.
+    if (!(*line >= -0.5 && *line <= dem->lines - 0.5))
+        return false;
+
+    if (dem->wraps)
+    {
+        *sample = fmod(*sample, (double)dem->samples);
+        if (*sample < 0.0)
+            *sample += dem->samples;
+        return true;
+    }
+
+    return *sample >= -0.5 && *sample <= dem->samples - 0.5;
+}
+
+/**
+@brief
+Read one elevation sample of a lunar DEM.
+
+@param[in] dem
+DEM.
+
+@param[in] line
+Zero based line.
+
+@param[in] sample
+Zero based sample.
+
+@return
+Elevation, in meters.
+
+*/
+double ReadLunarDem(
+    const LunarDem *dem,
+    int line,
+    int sample
+) {
+    size_t index = (size_t)line * dem->samples + sample;
+
+    if (dem->sample_type == DEM_SAMPLE__INT16)
+    {
+        uint16_t raw;
+        memcpy(&raw, dem->data + 2 * index, 2);
+        if (dem->swap_bytes)
+            raw = (uint16_t)((raw >> 8) | (raw << 8));
+
+        return dem->scale * (int16_t)raw + dem->offset__meter;
+    }
+
+    uint32_t raw;
+    memcpy(&raw, dem->data + 4 * index, 4);
+    if (dem->swap_bytes)
+        raw = (raw >> 24) | ((raw >> 8) & 0xFF00) | ((raw << 8) & 0xFF0000) | (raw << 24);
+
+    float value;
+    memcpy(&value, &raw, 4);
+
+    return dem->scale * value + dem->offset__meter;
+}
+
+/**
+@brief
+Sample a lunar DEM at a pixel by bilinear interpolation.
+
+Pixels within half a pixel of the edge of the grid take the value of the
+edge, and grids that wrap in longitude interpolate across the seam.
+
+@param[in] dem
+DEM.
+
+@param[in] line
+Zero based line, from LunarDemPixel().
+
+@param[in] sample
+Zero based sample, from LunarDemPixel().
+
+@return
+Elevation, in meters.
+
+*/
+double SampleLunarDem(
+    const LunarDem *dem,
+    double line,
+    double sample
+) {
+    auto read = [dem](int j, int i) {
+        return ReadLunarDem(dem, j, i);
+    };
+
+    return InterpolateLunarDem(dem, line, sample, read);
+}
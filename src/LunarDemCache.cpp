@@ -0,0 +1,387 @@
+/**
+@file
+
+This file contains the functions to create, destroy and use lunar DEM tile
+caches.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/* Local includes. */
+#include "./include/LunarDemCache.h"
+#include "./include/Errors.h"
+
+/**
+@brief
+Return the key of a tile.
+
+@param[in] tile_line
+Tile line.
+
+@param[in] tile_sample
+Tile sample.
+
+@return
+Key of the tile.
+
+*/
+static uint64_t TileKey(
+    int tile_line,
+    int tile_sample
+) {
+    return ((uint64_t)(uint32_t)tile_line << 32) | (uint32_t)tile_sample;
+}
+
+/**
+@brief
+Return the shard a tile belongs to.
+
+@param[in] cache
+Cache.
+
+@param[in] key
+Key of the tile.
+
+@return
+Shard of the tile.
+
+*/
+static DemCacheShard *TileShard(
+    LunarDemCache *cache,
+    uint64_t key
+) {
+    // Neighboring tiles land in different shards.
+    return &cache->shards[(key * 0x9E3779B97F4A7C15ull) >> 60 & (DEM_CACHE_SHARDS - 1)];
+}
+
+/**
+@brief
+Decode a tile of a lunar DEM.
+
+@param[in] dem
+DEM.
+
+@param[in] tile_line
+Tile line.
+
+@param[in] tile_sample
+Tile sample.
+
+@return
+Decoded tile.
+
+*/
+static std::shared_ptr<const DemTile> DecodeDemTile(
+    const LunarDem *dem,
+    int tile_line,
+    int tile_sample
+) {
+    std::shared_ptr<DemTile> tile = std::make_shared<DemTile>();
+
+    tile->line_0 = tile_line << DEM_TILE_SHIFT;
+    tile->sample_0 = tile_sample << DEM_TILE_SHIFT;
+    tile->samples = std::min(DEM_TILE_SIZE, dem->samples - tile->sample_0);
+    int lines = std::min(DEM_TILE_SIZE, dem->lines - tile->line_0);
+
+    tile->z__meter.resize((size_t)lines * tile->samples);
+
+    double *z = tile->z__meter.data();
+    for (int j = 0; j < lines; j++)
+    {
+        for (int i = 0; i < tile->samples; i++)
+            *z++ = ReadLunarDem(dem, tile->line_0 + j, tile->sample_0 + i);
+    }
+
+    return tile;
+}
+
+/**
+@brief
+Return the memory held by a tile.
+
+@param[in] tile
+Tile.
+
+@return
+Memory, in bytes.
+
+*/
+static long long TileBytes(
+    const DemTile &tile
+) {
+    return (long long)(sizeof(DemTile) + tile.z__meter.size() * sizeof(double));
+}
+
+/**
+@brief
+Create a cache of decoded tiles of a lunar DEM.
+
+The cache may be shared by any number of threads extracting profiles with
+ExtractGreatCircleProfileCached(), and must be destroyed before the DEM is
+closed.
+
+@param[in] dem
+DEM, from OpenLunarDem().
+
+@param[in] budget__bytes
+Memory budget of the cache, in bytes. Each of the cache's shards keeps at
+least the tile it used last.
+
+@param[out] cache
+Created cache, to be destroyed with DestroyLunarDemCache().
+
+@return error
+Error code.
+
+*/
+int CreateLunarDemCache(
+    const LunarDem *dem,
+    long long budget__bytes,
+    LunarDemCache **cache
+) {
+    *cache = nullptr;
+
+    if (dem == nullptr)
+        return ERROR__DEM_FILE;
+
+    LunarDemCache *c = new LunarDemCache();
+
+    c->dem = dem;
+    c->shard_budget__bytes = std::max(0LL, budget__bytes) / DEM_CACHE_SHARDS;
+    c->tile_lines = (dem->lines + DEM_TILE_SIZE - 1) >> DEM_TILE_SHIFT;
+    c->tile_samples = (dem->samples + DEM_TILE_SIZE - 1) >> DEM_TILE_SHIFT;
+    c->prefetches = 0;
+
+    *cache = c;
+    return SUCCESS;
+}
+
+/**
+@brief
+Destroy a lunar DEM tile cache.
+
+@param[in] cache
+Cache to destroy. May be NULL.
+
+*/
+void DestroyLunarDemCache(
+    LunarDemCache *cache
+) {
+    delete cache;
+}
+
+/**
+@brief
+Return the counters of a lunar DEM tile cache since it was created or last
+reset.
+
+@param[in] cache
+Cache.
+
+@param[out] stats
+Counters of the cache.
+
+*/
+void LunarDemCacheStatistics(
+    LunarDemCache *cache,
+    TileCacheStatistics *stats
+) {
+    *stats = TileCacheStatistics();
+
+    for (DemCacheShard &shard : cache->shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        stats->hits += shard.hits;
+        stats->misses += shard.misses;
+        stats->evictions += shard.evictions;
+        stats->bytes += shard.bytes;
+    }
+
+    stats->prefetches = cache->prefetches.load(std::memory_order_relaxed);
+}
+
+/**
+@brief
+Reset the counters of a lunar DEM tile cache, such as at the start of a run.
+The cached tiles are kept.
+
+@param[in] cache
+Cache.
+
+*/
+void ResetLunarDemCacheStatistics(
+    LunarDemCache *cache
+) {
+    for (DemCacheShard &shard : cache->shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.hits = 0;
+        shard.misses = 0;
+        shard.evictions = 0;
+    }
+
+    cache->prefetches = 0;
+}
+
+/**
+@brief
+Find a tile in a lunar DEM tile cache, decoding it if it is not cached.
+
+The tile is decoded outside the shard's lock, so a slow decode does not hold
+up lookups of other tiles.
+
+@param[in] cache
+Cache.
+
+@param[in] tile_line
+Tile line.
+
+@param[in] tile_sample
+Tile sample.
+
+@return
+Tile, which stays valid for as long as it is held even if it is evicted.
+
+*/
+std::shared_ptr<const DemTile> FindDemTile(
+    LunarDemCache *cache,
+    int tile_line,
+    int tile_sample
+) {
+    uint64_t key = TileKey(tile_line, tile_sample);
+    DemCacheShard *shard = TileShard(cache, key);
+
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        auto it = shard->index.find(key);
+        if (it != shard->index.end())
+        {
+            shard->lru.splice(shard->lru.begin(), shard->lru, it->second);
+            shard->hits++;
+            return it->second->second;
+        }
+    }
+
+    std::shared_ptr<const DemTile> tile = DecodeDemTile(cache->dem, tile_line, tile_sample);
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+
+    shard->misses++;
+
+    // Another thread may have decoded the tile in the meantime.
+    auto it = shard->index.find(key);
+    if (it != shard->index.end())
+    {
+        shard->lru.splice(shard->lru.begin(), shard->lru, it->second);
+        return it->second->second;
+    }
+
+    shard->lru.emplace_front(key, tile);
+    shard->index[key] = shard->lru.begin();
+    shard->bytes += TileBytes(*tile);
+
+    while (shard->bytes > cache->shard_budget__bytes && shard->lru.size() > 1)
+    {
+        shard->bytes -= TileBytes(*shard->lru.back().second);
+        shard->index.erase(shard->lru.back().first);
+        shard->lru.pop_back();
+        shard->evictions++;
+    }
+
+    return tile;
+}
+
+/**
+@brief
+Ask the operating system to start reading the samples of a tile, if the tile
+is not cached, so they are in memory by the time the tile is decoded.
+
+Returns without waiting for the samples.
+
+@param[in] cache
+Cache.
+
+@param[in] tile_line
+Tile line.
+
+@param[in] tile_sample
+Tile sample.
+
+*/
+void PrefetchDemTile(
+    LunarDemCache *cache,
+    int tile_line,
+    int tile_sample
+) {
+    if (tile_line < 0 || tile_line >= cache->tile_lines ||
+        tile_sample < 0 || tile_sample >= cache->tile_samples)
+        return;
+
+    uint64_t key = TileKey(tile_line, tile_sample);
+    DemCacheShard *shard = TileShard(cache, key);
+
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        if (shard->index.count(key) != 0)
+            return;
+    }
+
+    const LunarDem *dem = cache->dem;
+    size_t bytes = dem->sample_type == DEM_SAMPLE__INT16 ? 2 : 4;
+
+    int line_0 = tile_line << DEM_TILE_SHIFT;
+    int sample_0 = tile_sample << DEM_TILE_SHIFT;
+    int lines = std::min(DEM_TILE_SIZE, dem->lines - line_0);
+    size_t row_bytes = (size_t)std::min(DEM_TILE_SIZE, dem->samples - sample_0) * bytes;
+
+#ifdef _WIN32
+    std::vector<WIN32_MEMORY_RANGE_ENTRY> ranges(lines);
+    for (int j = 0; j < lines; j++)
+    {
+        ranges[j].VirtualAddress = (PVOID)(dem->data + ((size_t)(line_0 + j) * dem->samples + sample_0) * bytes);
+        ranges[j].NumberOfBytes = row_bytes;
+    }
+
+    PrefetchVirtualMemory(GetCurrentProcess(), ranges.size(), ranges.data(), 0);
+#else
+    static const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+
+    // Advise whole pages, merging the rows that share them.
+    uintptr_t begin = 0;
+    uintptr_t end = 0;
+    for (int j = 0; j <= lines; j++)
+    {
+        uintptr_t row_begin = 0;
+        uintptr_t row_end = 0;
+        if (j < lines)
+        {
+            row_begin = (uintptr_t)(dem->data + ((size_t)(line_0 + j) * dem->samples + sample_0) * bytes);
+            row_end = row_begin + row_bytes;
+            row_begin &= ~(page - 1);
+        }
+
+        if (j == lines || row_begin > end)
+        {
+            if (end > begin)
+                madvise((void *)begin, end - begin, MADV_WILLNEED);
+            begin = row_begin;
+        }
+        end = row_end;
+    }
+#endif
+
+    cache->prefetches.fetch_add(1, std::memory_order_relaxed);
+}
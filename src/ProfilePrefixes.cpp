@@ -0,0 +1,410 @@
+/**
+@file
+
+This file contains the functions to evaluate the Point-To-Point mode at
+receiver positions along one terrain profile.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cmath>
+
+/* Local includes. */
+#include "./include/Enums.h"
+#include "./include/Errors.h"
+#include "./include/Internal.h"
+#include "./include/ProfilePrefixes.h"
+#include "./include/RadioContext.h"
+#include "./include/Workspace.h"
+
+/**
+@brief
+Return if an upper bound of the horizon angles is clearly below an angle.
+
+The bound is computed with different rounding than the angles themselves, so
+a small relative margin keeps the pruning from skipping a sample that rounds
+to the angle or above it.
+
+@param[in] bound
+Upper bound of the horizon angles.
+
+@param[in] theta
+Horizon angle.
+
+@return
+True if no angle within the bound can reach theta.
+
+*/
+static bool BoundBelow(
+    double bound,
+    double theta
+) {
+    return bound < theta - 1.0e-9 * (fabs(bound) + fabs(theta));
+}
+
+/**
+@brief
+Initialize the horizon search over the prefixes of a terrain profile.
+
+The block maxima and RX distances are allocated from the calling thread's
+workspace, and are valid until the end of the caller's arena scope.
+
+@param[in] pfl
+Terrain data of the whole profile, in pfl format.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[out] search
+Horizon search state.
+
+*/
+void InitializePrefixHorizons(
+    const double pfl[],
+    double h__meter[2],
+    PrefixHorizons *search
+) {
+    int np = int(pfl[0]);
+    int n_blocks = np / PREFIX_HORIZON_BLOCK + 1;
+
+    search->pfl = pfl;
+    search->h__meter[0] = h__meter[0];
+    search->h__meter[1] = h__meter[1];
+
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    search->z_block_max__meter = ArenaArray<double>(arena, n_blocks);
+    search->z_prefix_max__meter = ArenaArray<double>(arena, n_blocks);
+    search->d_rx__meter = ArenaArray<double>(arena, (size_t)np + 1);
+    search->k_rx = 0;
+
+    std::fill(search->z_block_max__meter, search->z_block_max__meter + n_blocks, -HUGE_VAL);
+
+    for (int i = 0; i <= np; i++)
+    {
+        double &z_max__meter = search->z_block_max__meter[i / PREFIX_HORIZON_BLOCK];
+        if (pfl[i + 2] > z_max__meter)
+            z_max__meter = pfl[i + 2];
+    }
+
+    double z_max__meter = -HUGE_VAL;
+    for (int b = 0; b < n_blocks; b++)
+    {
+        z_max__meter = std::max(z_max__meter, search->z_block_max__meter[b]);
+        search->z_prefix_max__meter[b] = z_max__meter;
+    }
+
+    search->i_next = 1;
+    search->d_tx__meter = 0.0;
+    search->theta_tx_max = -HUGE_VAL;
+    search->d_tx_max__meter = 0.0;
+}
+
+/**
+@brief
+Compute the terminals' radio horizon angle and distance for the receiver at
+sample k of the profile.
+
+The TX horizon is the running maximum over the samples already searched, and
+is identical to FindHorizons() on the prefix of the profile. The RX horizon is
+searched backwards from the receiver and stops once the block maxima of the
+terrain show no farther sample can be above the horizon, and is skipped when
+the TX horizon already shows the path is line of sight. The distances are
+accumulated sample by sample from each terminal in the same order as
+FindHorizons(), so the horizons are identical to FindHorizons() on the prefix.
+The RX distances depend on k, and take one pass over the prefix whenever the
+RX search runs.
+
+Calls are fastest when k does not decrease from one call to the next.
+
+@param[in,out] search
+Horizon search state, from InitializePrefixHorizons().
+
+@param[in] k
+Sample index of the receiver, 1 <= k <= pfl[0].
+
+@param[out] theta_hzn
+Terminal radio horizon angle, in radians.
+
+@param[out] d_hzn__meter
+Terminal radio horizon distance, in meters.
+
+*/
+void FindPrefixHorizons(
+    PrefixHorizons *search,
+    int k,
+    double theta_hzn[2],
+    double d_hzn__meter[2]
+) {
+    const double *pfl = search->pfl;
+    double xi = pfl[1];
+
+    double d__meter = k * xi;
+
+    double z_tx__meter = pfl[2] + search->h__meter[0];
+    double z_rx__meter = pfl[k + 2] + search->h__meter[1];
+
+    theta_hzn[0] = (z_rx__meter - z_tx__meter) / d__meter - d__meter / (2.0 * a_m__meter);
+    theta_hzn[1] = -(z_rx__meter - z_tx__meter) / d__meter - d__meter / (2.0 * a_m__meter);
+
+    d_hzn__meter[0] = d__meter;
+    d_hzn__meter[1] = d__meter;
+
+    // Restart the TX search if the receiver moved back towards the TX.
+    if (k < search->i_next)
+    {
+        search->i_next = 1;
+        search->d_tx__meter = 0.0;
+        search->theta_tx_max = -HUGE_VAL;
+        search->d_tx_max__meter = 0.0;
+    }
+
+    for (; search->i_next < k; search->i_next++)
+    {
+        int i = search->i_next;
+
+        search->d_tx__meter = search->d_tx__meter + xi;
+
+        double theta_tx = (pfl[i + 2] - z_tx__meter) / search->d_tx__meter - search->d_tx__meter / (2.0 * a_m__meter);
+
+        if (theta_tx > search->theta_tx_max)
+        {
+            search->theta_tx_max = theta_tx;
+            search->d_tx_max__meter = search->d_tx__meter;
+        }
+    }
+
+    // A line of sight path, where no sample rises above the ray between the
+    // terminals as seen from the TX. Seen from the RX, sample i then clears the
+    // ray by i / (k - i) >= 1 / (k - 1) of its clearance seen from the TX, so
+    // with a margin for rounding the RX search would find nothing either.
+    if (BoundBelow(search->theta_tx_max, theta_hzn[0] - (k - 1) * 1.0e-9 * (fabs(theta_hzn[0]) + fabs(theta_hzn[1]))))
+        return;
+
+    if (search->d_tx_max__meter > 0.0 && search->theta_tx_max > theta_hzn[0])
+    {
+        theta_hzn[0] = search->theta_tx_max;
+        d_hzn__meter[0] = search->d_tx_max__meter;
+    }
+
+    // Accumulate the RX distances as FindHorizons() does, since a distance
+    // rounded differently can move the horizon and the terrain fits after it.
+    double *d_rx__meter = search->d_rx__meter;
+    if (search->k_rx != k)
+    {
+        double d_rx_i__meter = d__meter;
+        for (int i = 1; i < k; i++)
+        {
+            d_rx_i__meter = d_rx_i__meter - xi;
+            d_rx__meter[i] = d_rx_i__meter;
+        }
+        search->k_rx = k;
+    }
+
+    // Whether a terrain sample is above the initial RX horizon.
+    bool found = false;
+
+    for (int b = (k - 1) / PREFIX_HORIZON_BLOCK; b >= 0; b--)
+    {
+        int i_lo = std::max(1, b * PREFIX_HORIZON_BLOCK);
+        int i_hi = std::min(k - 1, (b + 1) * PREFIX_HORIZON_BLOCK - 1);
+
+        if (i_lo > i_hi)
+            continue;
+
+        double d_near__meter = d_rx__meter[i_hi];
+        double d_far__meter = d_rx__meter[i_lo];
+
+        // No sample in this or any earlier block can be above the horizon.
+        double dz__meter = search->z_prefix_max__meter[b] - z_rx__meter;
+        double bound = (dz__meter >= 0.0 ? dz__meter / d_near__meter : dz__meter / d_rx__meter[1])
+            - d_near__meter / (2.0 * a_m__meter);
+        if (BoundBelow(bound, theta_hzn[1]))
+            break;
+
+        // No sample in this block can be above the horizon.
+        dz__meter = search->z_block_max__meter[b] - z_rx__meter;
+        bound = (dz__meter >= 0.0 ? dz__meter / d_near__meter : dz__meter / d_far__meter)
+            - d_near__meter / (2.0 * a_m__meter);
+        if (BoundBelow(bound, theta_hzn[1]))
+            continue;
+
+        // Search backwards, keeping the sample closest to the TX on ties.
+        for (int i = i_hi; i >= i_lo; i--)
+        {
+            double theta_rx = -(z_rx__meter - pfl[i + 2]) / d_rx__meter[i] - d_rx__meter[i] / (2.0 * a_m__meter);
+
+            if (theta_rx > theta_hzn[1] || (found && theta_rx == theta_hzn[1]))
+            {
+                theta_hzn[1] = theta_rx;
+                d_hzn__meter[1] = d_rx__meter[i];
+                found = true;
+            }
+        }
+    }
+}
+
+/**
+@brief
+Evaluate the Point-To-Point mode with the receiver at each of a set of
+samples along one terrain profile.
+
+The terrain horizons are identical to PointToPoint() on the prefix of the
+profile that ends at the receiver. The least squares fits come from prefix
+sums, which round differently than the direct fits, so the effective heights
+and the values that follow from them agree to about 1E-10 relative, and a
+warning or mode decided by a threshold can differ where a value is within that
+rounding of the threshold.
+
+@param[in,out] pfl
+Terrain data of the whole profile, in pfl format. pfl[0] is changed during
+the call and restored before it returns.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in] radio
+Radio context.
+
+@param[in] p
+Location ratio, 0 < p < 1.
+
+@param[in] common_warnings
+Warning flags of the input validation, common to every receiver.
+
+@param[in] n
+Number of receivers.
+
+@param[in] k
+Sample index of each receiver, 1 <= k[i] <= pfl[0], preferably increasing.
+
+@param[out] A__db
+Basic transmission loss of each receiver, in dB.
+
+@param[out] warnings
+Warning flags of each receiver.
+
+@param[out] errors
+Error code of each receiver.
+
+@param[out] interValues
+Columns of intermediate values of each receiver, or NULL. Columns that are
+NULL are skipped.
+
+*/
+void PointToPointAtPrefixes(
+    double pfl[],
+    double h__meter[2],
+    const RadioContext *radio,
+    double p,
+    long common_warnings,
+    int n,
+    const int k[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues
+) {
+    double np = pfl[0];
+
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    ArenaScope scope(arena);
+
+    double *sum_z = ArenaArray<double>(arena, int(np) + 2);
+    double *sum_iz = ArenaArray<double>(arena, int(np) + 2);
+
+    PreparedProfile prepared;
+    PrepareProfile(pfl, sum_z, sum_iz, &prepared);
+
+    PrefixHorizons search;
+    InitializePrefixHorizons(pfl, h__meter, &search);
+
+    for (int j = 0; j < n; j++)
+    {
+        double theta_hzn[2];
+        double d_hzn__meter[2];
+        double h_e__meter[2];
+        double delta_h__meter;
+        double d__meter;
+
+        // Truncate the profile at the receiver.
+        pfl[0] = k[j];
+
+        FindPrefixHorizons(
+            &search,
+            k[j],
+            theta_hzn,
+            d_hzn__meter
+        );
+
+        QuickPflPreparedFromHorizons(
+            &prepared,
+            h__meter,
+            theta_hzn,
+            d_hzn__meter,
+            h_e__meter,
+            &delta_h__meter,
+            &d__meter
+        );
+
+        warnings[j] = common_warnings;
+
+        IntermediateValues iv;
+        iv.d__km = d__meter / 1000.0;
+
+        double A_ref__db = 0.0;
+        int propmode = MODE__NOT_SET;
+        errors[j] = LongleyRice(
+            theta_hzn,
+            radio,
+            d_hzn__meter,
+            h_e__meter,
+            delta_h__meter,
+            h__meter,
+            d__meter,
+            &A_ref__db,
+            &warnings[j],
+            &propmode
+        );
+        if (errors[j] != SUCCESS)
+        {
+            if (interValues != nullptr)
+                ScatterIntermediateValues(&iv, j, interValues);
+            continue;
+        }
+
+        double A_fs__db = FreeSpaceLoss(
+            d__meter,
+            radio
+        );
+
+        A__db[j] = A_fs__db
+            + Variability(
+                p,
+                delta_h__meter,
+                radio,
+                d__meter,
+                A_ref__db
+            );
+
+        if (warnings[j] != NO_WARNINGS)
+            errors[j] = SUCCESS_WITH_WARNINGS;
+
+        if (interValues != nullptr)
+        {
+            for (int i = 0; i < 2; i++)
+            {
+                iv.theta_hzn[i] = theta_hzn[i];
+                iv.d_hzn__meter[i] = d_hzn__meter[i];
+                iv.h_e__meter[i] = h_e__meter[i];
+            }
+            iv.delta_h__meter = delta_h__meter;
+            iv.A_ref__db = A_ref__db;
+            iv.A_fs__db = A_fs__db;
+            iv.mode = propmode;
+
+            ScatterIntermediateValues(&iv, j, interValues);
+        }
+    }
+
+    pfl[0] = np;
+}
@@ -1,7 +1,8 @@
 /**
 @file
 
-This file contains the QuickPfl() function.
+This file contains the QuickPfl(), QuickPflView(), QuickPflCompact(),
+QuickPflPrepared() and QuickPflPreparedFromHorizons() functions.
 */
 
 /* Standard includes. */
@@ -10,22 +11,139 @@ This file contains the QuickPfl() function.
 
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Internal.h"
+#include "./include/Terrain.h"
+#include "./include/Workspace.h"
 
 /**
 @brief
-Extract parameters from the terrain pfl.
+Least squares fits directly over the terrain pfl.
+*/
+struct PflFits
+{
+    /**
+    Terrain data in pfl format.
+    */
+    double *pfl;
 
-@param[in] pfl
-Terrain data in pfl format.
+    /**
+    Fit one window of the terrain.
+    */
+    void Fit(double d_start, double d_end, double *fit_y1, double *fit_y2) const
+    {
+        LinearLeastSquaresFit(pfl, d_start, d_end, fit_y1, fit_y2);
+    }
+
+    /**
+    Fit two windows of the terrain.
+    */
+    void DualFit(double d_start[2], double d_end[2], double fit_y1[2], double fit_y2[2]) const
+    {
+        DualLinearLeastSquaresFit(pfl, d_start, d_end, fit_y1, fit_y2);
+    }
+};
+
+/**
+@brief
+Least squares fits directly over a terrain profile stored in place.
+*/
+struct ViewFits
+{
+    /**
+    View of the terrain.
+    */
+    const TerrainView *view;
+
+    /**
+    Fit one window of the terrain.
+    */
+    void Fit(double d_start, double d_end, double *fit_y1, double *fit_y2) const
+    {
+        LinearLeastSquaresFitView(view, d_start, d_end, fit_y1, fit_y2);
+    }
+
+    /**
+    Fit two windows of the terrain.
+    */
+    void DualFit(double d_start[2], double d_end[2], double fit_y1[2], double fit_y2[2]) const
+    {
+        DualLinearLeastSquaresFitView(view, d_start, d_end, fit_y1, fit_y2);
+    }
+};
+
+/**
+@brief
+Constant time least squares fits from the prefix sums of a prepared profile.
+*/
+struct PreparedFits
+{
+    /**
+    Prepared terrain profile.
+    */
+    const PreparedProfile *prepared;
+
+    /**
+    Fit one window of the terrain.
+    */
+    void Fit(double d_start, double d_end, double *fit_y1, double *fit_y2) const
+    {
+        LinearLeastSquaresFitPrepared(prepared, d_start, d_end, fit_y1, fit_y2);
+    }
+
+    /**
+    Fit two windows of the terrain.
+    */
+    void DualFit(double d_start[2], double d_end[2], double fit_y1[2], double fit_y2[2]) const
+    {
+        LinearLeastSquaresFitPrepared(prepared, d_start[0], d_end[0], &fit_y1[0], &fit_y2[0]);
+        LinearLeastSquaresFitPrepared(prepared, d_start[1], d_end[1], &fit_y1[1], &fit_y2[1]);
+    }
+};
+
+/**
+@brief
+Compute the terrain irregularity parameter of a terrain profile in pfl format.
+*/
+static double TerrainDeltaH(
+    const PflTerrain &terrain,
+    double d_start__meter,
+    double d_end__meter
+) {
+    return ComputeDeltaH(terrain.pfl, d_start__meter, d_end__meter);
+}
+
+/**
+@brief
+Compute the terrain irregularity parameter of a terrain profile stored in
+place.
+*/
+static double TerrainDeltaH(
+    const StridedTerrain &terrain,
+    double d_start__meter,
+    double d_end__meter
+) {
+    return ComputeDeltaHView(terrain.view, d_start__meter, d_end__meter);
+}
+
+/**
+@brief
+Extract parameters from the terrain, once the terrain horizons are found,
+using the given least squares fits.
+
+@param[in] terrain
+Terrain profile.
+
+@param[in] fits
+Least squares fits over the terrain.
 
 @param[in] h__meter
 Terminal structural heights, in meters.
 
-@param[out] theta_hzn
-Terminal horizon angles.
+@param[in,out] theta_hzn
+Terminal horizon angles, as found by FindHorizons().
 
-@param[out] d_hzn__meter
-Terminal horizon distances, in meters.
+@param[in,out] d_hzn__meter
+Terminal horizon distances, in meters, as found by FindHorizons().
 
 @param[out] h_e__meter
 Effective terminal heights, in meters.
@@ -37,8 +155,10 @@ Terrain irregularity parameter.
 Path distance, in meters.
 
 */
-void QuickPfl(
-    double pfl[],
+template <typename Terrain, typename Fits>
+static void QuickPflFromHorizons(
+    const Terrain &terrain,
+    const Fits &fits,
     double h__meter[2],
     double theta_hzn[2],
     double d_hzn__meter[2],
@@ -52,16 +172,9 @@ void QuickPfl(
     double d_start__meter;
     double d_end__meter;
 
-    *d__meter = pfl[0] * pfl[1];
+    *d__meter = terrain.Distance();
 
-    int np = int(pfl[0]);
-
-    FindHorizons(
-        pfl,
-        h__meter,
-        theta_hzn,
-        d_hzn__meter
-    );
+    int np = terrain.Intervals();
 
     /**
     "In our own work we have sometimes said that consideration of terrain
@@ -75,8 +188,8 @@ void QuickPfl(
     // Same, but measured from the far end of the link.
     d_end__meter = *d__meter - std::min(15.0 * h__meter[1], 0.1 * d_hzn__meter[1]);
 
-    *delta_h__meter = ComputeDeltaH(
-        pfl,
+    *delta_h__meter = TerrainDeltaH(
+        terrain,
         d_start__meter,
         d_end__meter
     );
@@ -88,16 +201,15 @@ void QuickPfl(
         path distance so we are well within the line-of-sight range.
         */
 
-        LinearLeastSquaresFit(
-            pfl,
+        fits.Fit(
             d_start__meter,
             d_end__meter,
             &fit_tx,
             &fit_rx
         );
 
-        h_e__meter[0] = h__meter[0] + fdim(pfl[2], fit_tx);
-        h_e__meter[1] = h__meter[1] + fdim(pfl[np + 2], fit_rx);
+        h_e__meter[0] = h__meter[0] + fdim(terrain[0], fit_tx);
+        h_e__meter[1] = h__meter[1] + fdim(terrain[np], fit_rx);
 
         for (int i = 0; i < 2; i++)
             d_hzn__meter[i] = sqrt(2.0 * h_e__meter[i] * a_m__meter) * exp(-0.07 * sqrt(*delta_h__meter / std::max(h_e__meter[i], 5.0)));
@@ -122,23 +234,313 @@ void QuickPfl(
     }
     else
     {
-        double dummy = 0.0;
+        // Fit both terminal windows in a single pass over the terrain.
+        double d_fit_start__meter[2] = { d_start__meter, *d__meter - 0.9 * d_hzn__meter[1] };
+        double d_fit_end__meter[2] = { 0.9 * d_hzn__meter[0], d_end__meter };
+        double fit_y1[2];
+        double fit_y2[2];
 
-        LinearLeastSquaresFit(
-            pfl,
-            d_start__meter,
-            0.9 * d_hzn__meter[0],
-            &fit_tx,
-            &dummy
+        fits.DualFit(
+            d_fit_start__meter,
+            d_fit_end__meter,
+            fit_y1,
+            fit_y2
         );
-        h_e__meter[0] = h__meter[0] + fdim(pfl[2], fit_tx);
+        fit_tx = fit_y1[0];
+        fit_rx = fit_y2[1];
 
-        LinearLeastSquaresFit(
-            pfl,
-            *d__meter - 0.9 * d_hzn__meter[1],
-            d_end__meter,
-            &dummy, &fit_rx
-        );
-        h_e__meter[1] = h__meter[1] + fdim(pfl[np + 2], fit_rx);
+        h_e__meter[0] = h__meter[0] + fdim(terrain[0], fit_tx);
+        h_e__meter[1] = h__meter[1] + fdim(terrain[np], fit_rx);
     }
+}
+
+/**
+@brief
+Extract parameters from the terrain pfl.
+
+@param[in] pfl
+Terrain data in pfl format.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[out] theta_hzn
+Terminal horizon angles.
+
+@param[out] d_hzn__meter
+Terminal horizon distances, in meters.
+
+@param[out] h_e__meter
+Effective terminal heights, in meters.
+
+@param[out] delta_h__meter
+Terrain irregularity parameter.
+
+@param[out] d__meter
+Path distance, in meters.
+
+*/
+void QuickPfl(
+    double pfl[],
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+) {
+    PflTerrain terrain = { pfl };
+    PflFits fits = { pfl };
+
+    FindHorizons(
+        pfl,
+        h__meter,
+        theta_hzn,
+        d_hzn__meter
+    );
+
+    QuickPflFromHorizons(
+        terrain,
+        fits,
+        h__meter,
+        theta_hzn,
+        d_hzn__meter,
+        h_e__meter,
+        delta_h__meter,
+        d__meter
+    );
+}
+
+/**
+@brief
+Extract parameters from a terrain profile stored in place.
+
+The results are identical to QuickPfl() on the same profile in pfl format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[out] theta_hzn
+Terminal horizon angles.
+
+@param[out] d_hzn__meter
+Terminal horizon distances, in meters.
+
+@param[out] h_e__meter
+Effective terminal heights, in meters.
+
+@param[out] delta_h__meter
+Terrain irregularity parameter.
+
+@param[out] d__meter
+Path distance, in meters.
+
+*/
+void QuickPflView(
+    const TerrainView *view,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+) {
+    StridedTerrain terrain = { view };
+    ViewFits fits = { view };
+
+    FindHorizonsView(
+        view,
+        h__meter,
+        theta_hzn,
+        d_hzn__meter
+    );
+
+    QuickPflFromHorizons(
+        terrain,
+        fits,
+        h__meter,
+        theta_hzn,
+        d_hzn__meter,
+        h_e__meter,
+        delta_h__meter,
+        d__meter
+    );
+}
+
+/**
+@brief
+Extract parameters from a terrain profile in a compact encoding.
+
+The profile is widened to double precision once, into a buffer from the
+thread's workspace, and analyzed as by QuickPfl(), so the results are identical to
+QuickPfl() on the widened profile in pfl format.
+
+@param[in] view
+View of the terrain.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[out] theta_hzn
+Terminal horizon angles.
+
+@param[out] d_hzn__meter
+Terminal horizon distances, in meters.
+
+@param[out] h_e__meter
+Effective terminal heights, in meters.
+
+@param[out] delta_h__meter
+Terrain irregularity parameter.
+
+@param[out] d__meter
+Path distance, in meters.
+
+*/
+void QuickPflCompact(
+    const CompactTerrainView *view,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+) {
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    ArenaScope scope(arena);
+
+    double *pfl = ArenaArray<double>(arena, (size_t)view->np + 3);
+    pfl[0] = view->np;
+    pfl[1] = view->xi__meter;
+
+    WithCompactTerrain(view, [&](const auto &terrain) {
+        terrain.Widen(0, view->np + 1, &pfl[2]);
+    });
+
+    QuickPfl(
+        pfl,
+        h__meter,
+        theta_hzn,
+        d_hzn__meter,
+        h_e__meter,
+        delta_h__meter,
+        d__meter
+    );
+}
+
+/**
+@brief
+Extract parameters from a prepared terrain profile.
+
+The least squares fits of the effective heights take constant time from the
+prefix sums of the profile, so when a profile is evaluated with many terminal
+heights only the horizon search and the terrain irregularity parameter are
+recomputed. The fits differ from those of QuickPfl() by the rounding of the
+prefix sums, which grows with the profile length and the elevation range.
+
+@param[in] prepared
+Prepared terrain profile, from PrepareProfile().
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[out] theta_hzn
+Terminal horizon angles.
+
+@param[out] d_hzn__meter
+Terminal horizon distances, in meters.
+
+@param[out] h_e__meter
+Effective terminal heights, in meters.
+
+@param[out] delta_h__meter
+Terrain irregularity parameter.
+
+@param[out] d__meter
+Path distance, in meters.
+
+*/
+void QuickPflPrepared(
+    const PreparedProfile *prepared,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+) {
+    FindHorizons(
+        prepared->pfl,
+        h__meter,
+        theta_hzn,
+        d_hzn__meter
+    );
+
+    QuickPflPreparedFromHorizons(
+        prepared,
+        h__meter,
+        theta_hzn,
+        d_hzn__meter,
+        h_e__meter,
+        delta_h__meter,
+        d__meter
+    );
+}
+
+/**
+@brief
+Extract parameters from a prepared terrain profile whose terrain horizons are
+already found.
+
+This lets callers that find the horizons incrementally, such as when
+evaluating many receiver positions along one profile, skip the horizon search
+of QuickPflPrepared().
+
+@param[in] prepared
+Prepared terrain profile, from PrepareProfile().
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in,out] theta_hzn
+Terminal horizon angles, as found by FindHorizons().
+
+@param[in,out] d_hzn__meter
+Terminal horizon distances, in meters, as found by FindHorizons().
+
+@param[out] h_e__meter
+Effective terminal heights, in meters.
+
+@param[out] delta_h__meter
+Terrain irregularity parameter.
+
+@param[out] d__meter
+Path distance, in meters.
+
+*/
+void QuickPflPreparedFromHorizons(
+    const PreparedProfile *prepared,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+) {
+    PflTerrain terrain = { prepared->pfl };
+    PreparedFits fits = { prepared };
+
+    QuickPflFromHorizons(
+        terrain,
+        fits,
+        h__meter,
+        theta_hzn,
+        d_hzn__meter,
+        h_e__meter,
+        delta_h__meter,
+        d__meter
+    );
 }
\ No newline at end of file
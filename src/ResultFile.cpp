@@ -0,0 +1,630 @@
+/**
+@file
+
+This file contains the functions to create, open, close and access
+columnar result files.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Local includes. */
+#include "./include/ResultFile.h"
+#include "./include/Errors.h"
+
+/**
+@brief
+First and last bytes of a result file.
+*/
+static const char RESULT_MAGIC[8] = { 'I', 'L', 'M', 'R', 'S', 'L', 'T', '1' };
+
+/**
+@brief
+Version of the result file layout.
+*/
+#define RESULT_FILE_VERSION 1
+
+/**
+@brief
+Size of the header, in bytes.
+*/
+#define RESULT_HEADER_BYTES 16
+
+/**
+@brief
+Size of each footer entry, in bytes.
+*/
+#define RESULT_FOOTER_ENTRY_BYTES 24
+
+/**
+@brief
+Size of the trailer, in bytes.
+*/
+#define RESULT_TRAILER_BYTES 32
+
+/**
+@brief
+Alignment of the start of each column, in bytes, a cache line.
+*/
+#define RESULT_COLUMN_ALIGNMENT 64
+
+/**
+@brief
+Return the size of a value of a column type.
+
+@param[in] type
+Column type, a RESULT_TYPE__* value.
+
+@return
+Size, in bytes, or 0 for an invalid type.
+
+*/
+static size_t ResultTypeBytes(
+    int type
+) {
+    switch (type)
+    {
+    case RESULT_TYPE__FLOAT64:
+    case RESULT_TYPE__INT64:
+        return 8;
+    case RESULT_TYPE__INT32:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+/**
+@brief
+Return the type a column is written with on this host.
+
+@param[in] column
+Column, a RESULT_COLUMN__* value.
+
+@return
+Column type, a RESULT_TYPE__* value.
+
+*/
+static int NativeColumnType(
+    int column
+) {
+    switch (column)
+    {
+    case RESULT_COLUMN__WARNINGS:
+        return sizeof(long) == 8 ? RESULT_TYPE__INT64 : RESULT_TYPE__INT32;
+    case RESULT_COLUMN__ERROR:
+    case RESULT_COLUMN__MODE:
+        return RESULT_TYPE__INT32;
+    default:
+        return RESULT_TYPE__FLOAT64;
+    }
+}
+
+/**
+@brief
+Return if the host stores values little-endian, as result files do.
+
+@return
+True on little-endian hosts.
+
+*/
+static bool LittleEndianHost()
+{
+    uint16_t one = 1;
+
+    return *(const unsigned char *)&one == 1;
+}
+
+/**
+@brief
+Unmap a result file and release its handles.
+
+@param[in] file
+Result file to unmap.
+
+@return
+True if any changes were written back to the file.
+
+*/
+static bool UnmapResultFile(
+    ResultFile *file
+) {
+    bool flushed = true;
+
+#ifdef _WIN32
+    if (file->map != nullptr)
+    {
+        if (file->writable)
+            flushed = FlushViewOfFile(file->map, 0) != 0;
+        UnmapViewOfFile(file->map);
+    }
+    if (file->handles[1] != nullptr)
+        CloseHandle((HANDLE)file->handles[1]);
+    if (file->handles[0] != nullptr)
+    {
+        if (file->writable)
+            flushed = FlushFileBuffers((HANDLE)file->handles[0]) != 0 && flushed;
+        CloseHandle((HANDLE)file->handles[0]);
+    }
+#else
+    if (file->map != nullptr)
+    {
+        if (file->writable)
+            flushed = msync(file->map, file->map_size, MS_SYNC) == 0;
+        munmap(file->map, file->map_size);
+    }
+#endif
+
+    return flushed;
+}
+
+/**
+@brief
+Map a result file into memory.
+
+@param[in] path
+Path of the result file.
+
+@param[in] size
+Size to create the file with, in bytes, or 0 to open an existing file read
+only.
+
+@param[in,out] file
+Result file to map the file into.
+
+@return
+True if the file was mapped.
+
+*/
+static bool MapResultFile(
+    const char *path,
+    size_t size,
+    ResultFile *file
+) {
+    file->writable = size > 0;
+
+#ifdef _WIN32
+    HANDLE handle = file->writable
+        ? CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr)
+        : CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    file->handles[0] = handle;
+
+    LARGE_INTEGER file_size;
+    if (file->writable)
+    {
+        file_size.QuadPart = (LONGLONG)size;
+        if (!SetFilePointerEx(handle, file_size, nullptr, FILE_BEGIN) || !SetEndOfFile(handle))
+            return false;
+    }
+    else if (!GetFileSizeEx(handle, &file_size) || file_size.QuadPart == 0)
+        return false;
+    file->map_size = (size_t)file_size.QuadPart;
+
+    HANDLE mapping = CreateFileMappingA(handle, nullptr,
+        file->writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+        return false;
+    file->handles[1] = mapping;
+
+    file->map = MapViewOfFile(mapping, file->writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+    return file->map != nullptr;
+#else
+    int fd = file->writable
+        ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)
+        : open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    if (file->writable)
+    {
+        if (ftruncate(fd, (off_t)size) != 0)
+        {
+            close(fd);
+            return false;
+        }
+        file->map_size = size;
+    }
+    else
+    {
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+        file->map_size = (size_t)st.st_size;
+    }
+
+    void *map = mmap(nullptr, file->map_size,
+        file->writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+        return false;
+
+    file->map = map;
+    return true;
+#endif
+}
+
+/**
+@brief
+Create a result file for a batch of paths.
+
+The file is created at its full size, with its footer, and mapped into memory.
+Rows are written through the columns from ResultFileColumns(), from any number
+of threads as long as each row is written by one thread, and are in the file
+once it is closed with CloseResultFile(). Rows that are not written read as
+zero.
+
+@param[in] path
+Path of the result file, which is replaced if it exists.
+
+@param[in] n_rows
+Number of rows, one per path.
+
+@param[in] columns
+Columns to store, as a bitmask of 1 << RESULT_COLUMN__* values, such as
+RESULT_COLUMNS__ALL. The output columns are always stored.
+
+@param[out] file
+Created result file, to be closed with CloseResultFile().
+
+@return error
+Error code.
+
+*/
+int CreateResultFile(
+    const char *path,
+    long long n_rows,
+    long columns,
+    ResultFile **file
+) {
+    *file = nullptr;
+
+    if (n_rows < 0 || !LittleEndianHost())
+        return ERROR__RESULT_FILE;
+
+    ResultFile *f = new ResultFile();
+    f->n_rows = n_rows;
+
+    columns |= RESULT_COLUMNS__OUTPUTS;
+
+    // Lay out the columns after the header. The file must fit in both
+    // size_t and the int64 sizes of the footer, which is checked before each
+    // step so that no product or sum wraps.
+    uint64_t max_size = std::min((uint64_t)SIZE_MAX, (uint64_t)INT64_MAX);
+    uint64_t offset = RESULT_HEADER_BYTES;
+    uint32_t n_columns = 0;
+    bool valid = true;
+
+    for (int c = 0; c < RESULT_COLUMN_COUNT && valid; c++)
+    {
+        if ((columns & (1L << c)) == 0)
+            continue;
+
+        f->column_type[c] = NativeColumnType(c);
+        uint64_t type_bytes = ResultTypeBytes(f->column_type[c]);
+
+        if (offset > max_size - (RESULT_COLUMN_ALIGNMENT - 1))
+        {
+            valid = false;
+            break;
+        }
+        offset = (offset + RESULT_COLUMN_ALIGNMENT - 1) / RESULT_COLUMN_ALIGNMENT * RESULT_COLUMN_ALIGNMENT;
+
+        if ((uint64_t)n_rows > (max_size - offset) / type_bytes)
+        {
+            valid = false;
+            break;
+        }
+
+        f->column_offset[c] = (size_t)offset;
+        offset += (uint64_t)n_rows * type_bytes;
+        n_columns++;
+    }
+
+    uint64_t footer_bytes = (uint64_t)n_columns * RESULT_FOOTER_ENTRY_BYTES + RESULT_TRAILER_BYTES;
+    if (!valid || offset > max_size - 7 - footer_bytes)
+    {
+        delete f;
+        return ERROR__RESULT_FILE;
+    }
+
+    uint64_t footer_offset = (offset + 7) / 8 * 8;
+    size_t size = (size_t)(footer_offset + footer_bytes);
+
+    if (!MapResultFile(path, size, f))
+    {
+        UnmapResultFile(f);
+        delete f;
+        return ERROR__RESULT_FILE;
+    }
+
+    unsigned char *data = (unsigned char *)f->map;
+    uint32_t version = RESULT_FILE_VERSION;
+    uint32_t reserved = 0;
+
+    memcpy(data, RESULT_MAGIC, 8);
+    memcpy(data + 8, &version, 4);
+    memcpy(data + 12, &reserved, 4);
+
+    unsigned char *entry = data + footer_offset;
+    for (uint32_t c = 0; c < RESULT_COLUMN_COUNT; c++)
+    {
+        if (f->column_offset[c] == 0)
+            continue;
+
+        uint32_t type = (uint32_t)f->column_type[c];
+        uint64_t column_offset = f->column_offset[c];
+        uint64_t bytes = (uint64_t)n_rows * ResultTypeBytes(f->column_type[c]);
+
+        memcpy(entry, &c, 4);
+        memcpy(entry + 4, &type, 4);
+        memcpy(entry + 8, &column_offset, 8);
+        memcpy(entry + 16, &bytes, 8);
+        entry += RESULT_FOOTER_ENTRY_BYTES;
+    }
+
+    uint64_t rows = (uint64_t)n_rows;
+    memcpy(entry, &rows, 8);
+    memcpy(entry + 8, &n_columns, 4);
+    memcpy(entry + 12, &version, 4);
+    memcpy(entry + 16, &footer_offset, 8);
+    memcpy(entry + 24, RESULT_MAGIC, 8);
+
+    *file = f;
+    return SUCCESS;
+}
+
+/**
+@brief
+Open a result file for reading.
+
+Only the footer is read; the columns are mapped and read in place.
+
+@param[in] path
+Path of the result file.
+
+@param[out] file
+Opened result file, to be closed with CloseResultFile().
+
+@return error
+Error code.
+
+*/
+int OpenResultFile(
+    const char *path,
+    ResultFile **file
+) {
+    *file = nullptr;
+
+    ResultFile *f = new ResultFile();
+
+    if (!LittleEndianHost() || !MapResultFile(path, 0, f) ||
+        f->map_size < RESULT_HEADER_BYTES + RESULT_TRAILER_BYTES)
+    {
+        UnmapResultFile(f);
+        delete f;
+        return ERROR__RESULT_FILE;
+    }
+
+    const unsigned char *data = (const unsigned char *)f->map;
+    const unsigned char *trailer = data + f->map_size - RESULT_TRAILER_BYTES;
+
+    uint64_t rows;
+    uint32_t n_columns;
+    uint32_t version;
+    uint64_t footer_offset;
+    memcpy(&rows, trailer, 8);
+    memcpy(&n_columns, trailer + 8, 4);
+    memcpy(&version, trailer + 12, 4);
+    memcpy(&footer_offset, trailer + 16, 8);
+
+    // The footer fills the file between footer_offset and the trailer,
+    // compared without sums that a corrupt offset could wrap.
+    uint64_t footer_end = f->map_size - RESULT_TRAILER_BYTES;
+
+    bool valid = memcmp(data, RESULT_MAGIC, 8) == 0 &&
+        memcmp(trailer + 24, RESULT_MAGIC, 8) == 0 &&
+        version == RESULT_FILE_VERSION &&
+        rows <= (uint64_t)INT64_MAX &&
+        n_columns <= RESULT_COLUMN_COUNT &&
+        footer_offset >= RESULT_HEADER_BYTES &&
+        footer_offset <= footer_end &&
+        (uint64_t)n_columns * RESULT_FOOTER_ENTRY_BYTES == footer_end - footer_offset;
+
+    f->n_rows = (long long)rows;
+
+    for (uint32_t i = 0; valid && i < n_columns; i++)
+    {
+        const unsigned char *entry = data + footer_offset + i * RESULT_FOOTER_ENTRY_BYTES;
+
+        uint32_t column;
+        uint32_t type;
+        uint64_t offset;
+        uint64_t bytes;
+        memcpy(&column, entry, 4);
+        memcpy(&type, entry + 4, 4);
+        memcpy(&offset, entry + 8, 8);
+        memcpy(&bytes, entry + 16, 8);
+
+        size_t value_bytes = ResultTypeBytes((int)type);
+
+        // Each column is stored once, in full, before the footer.
+        if (column >= RESULT_COLUMN_COUNT || value_bytes == 0 ||
+            f->column_offset[column] != 0 ||
+            offset < RESULT_HEADER_BYTES || offset % value_bytes != 0 ||
+            rows > UINT64_MAX / value_bytes || bytes != rows * value_bytes ||
+            offset > footer_offset || bytes > footer_offset - offset)
+        {
+            valid = false;
+            break;
+        }
+
+        f->column_type[column] = (int)type;
+        f->column_offset[column] = (size_t)offset;
+    }
+
+    if (!valid)
+    {
+        UnmapResultFile(f);
+        delete f;
+        return ERROR__RESULT_FILE;
+    }
+
+    *file = f;
+    return SUCCESS;
+}
+
+/**
+@brief
+Close a result file opened with CreateResultFile() or OpenResultFile().
+
+A created file is flushed to disk before it is closed.
+
+@param[in] file
+Result file to close. May be NULL.
+
+@return error
+Error code.
+
+*/
+int CloseResultFile(
+    ResultFile *file
+) {
+    if (file == nullptr)
+        return SUCCESS;
+
+    bool flushed = UnmapResultFile(file);
+    delete file;
+
+    return flushed ? SUCCESS : ERROR__RESULT_FILE;
+}
+
+/**
+@brief
+Return the number of rows of a result file.
+
+@param[in] file
+Result file.
+
+@return
+Number of rows.
+
+*/
+long long ResultFileRows(
+    const ResultFile *file
+) {
+    return file->n_rows;
+}
+
+/**
+@brief
+Return a column of a result file, mapped in place.
+
+@param[in] file
+Result file.
+
+@param[in] column
+Column, a RESULT_COLUMN__* value.
+
+@param[out] type
+Type of the column's values, a RESULT_TYPE__* value.
+
+@return
+First value of the column, or NULL if the file does not store it.
+
+*/
+const void *ResultFileColumn(
+    const ResultFile *file,
+    int column,
+    int *type
+) {
+    if (column < 0 || column >= RESULT_COLUMN_COUNT || file->column_offset[column] == 0)
+        return nullptr;
+
+    *type = file->column_type[column];
+
+    return (const unsigned char *)file->map + file->column_offset[column];
+}
+
+/**
+@brief
+Return the columns of a created result file in the form taken by the batch
+functions, so they write their results straight into the file.
+
+The outputs can be passed as the A__db, warnings and errors of
+PointToPointBatchParallel(), AreaBatchParallel() or Coverage(), and the
+intermediate values as their interValues. Columns that are not stored are left
+NULL, and are skipped by the batch functions.
+
+@param[in] file
+Result file, from CreateResultFile().
+
+@param[out] A__db
+Basic transmission loss column.
+
+@param[out] warnings
+Warning flags column.
+
+@param[out] errors
+Error code column.
+
+@param[out] interValues
+Intermediate value columns.
+
+@return error
+Error code.
+
+*/
+int ResultFileColumns(
+    ResultFile *file,
+    double **A__db,
+    long **warnings,
+    int **errors,
+    IntermediateValuesBatch *interValues
+) {
+    if (!file->writable)
+        return ERROR__RESULT_FILE;
+
+    unsigned char *data = (unsigned char *)file->map;
+    void *column[RESULT_COLUMN_COUNT];
+
+    for (int c = 0; c < RESULT_COLUMN_COUNT; c++)
+        column[c] = file->column_offset[c] == 0 ? nullptr : data + file->column_offset[c];
+
+    *A__db = (double *)column[RESULT_COLUMN__A_DB];
+    *warnings = (long *)column[RESULT_COLUMN__WARNINGS];
+    *errors = (int *)column[RESULT_COLUMN__ERROR];
+
+    interValues->theta_hzn[0] = (double *)column[RESULT_COLUMN__THETA_HZN_TX];
+    interValues->theta_hzn[1] = (double *)column[RESULT_COLUMN__THETA_HZN_RX];
+    interValues->d_hzn__meter[0] = (double *)column[RESULT_COLUMN__D_HZN_TX];
+    interValues->d_hzn__meter[1] = (double *)column[RESULT_COLUMN__D_HZN_RX];
+    interValues->h_e__meter[0] = (double *)column[RESULT_COLUMN__H_E_TX];
+    interValues->h_e__meter[1] = (double *)column[RESULT_COLUMN__H_E_RX];
+    interValues->delta_h__meter = (double *)column[RESULT_COLUMN__DELTA_H];
+    interValues->A_ref__db = (double *)column[RESULT_COLUMN__A_REF_DB];
+    interValues->A_fs__db = (double *)column[RESULT_COLUMN__A_FS_DB];
+    interValues->d__km = (double *)column[RESULT_COLUMN__D_KM];
+    interValues->mode = (int *)column[RESULT_COLUMN__MODE];
+
+    return SUCCESS;
+}
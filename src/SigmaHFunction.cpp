@@ -4,11 +4,10 @@
 This file contains the SigmaHFunction() function.
 */
 
-/* Standard includes. */
-#include <cmath>
-
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/RadioContext.h"
 
 /**
 @brief
@@ -28,5 +27,5 @@ double SigmaHFunction(
     double delta_h__meter
 ) {
     // [ERL 79-ITS 67, Eqn 3.6a].
-    return 0.78 * delta_h__meter * exp(-0.5 * pow(delta_h__meter, 0.25));
+    return ExactModel::SigmaHFunction(delta_h__meter);
 }
\ No newline at end of file
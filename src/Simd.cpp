@@ -0,0 +1,100 @@
+/**
+@file
+
+This file contains the CPU feature detection functions used to select the
+SIMD kernels at runtime.
+*/
+
+/* Local includes. */
+#include "./include/Simd.h"
+
+#if defined(ILM_X86_SIMD) && defined(_MSC_VER)
+
+/**
+@brief
+Return the CPU feature flags that the SIMD kernels depend on.
+
+@param[out] avx2
+CPU and OS support AVX2.
+
+@param[out] avx512
+CPU and OS support AVX-512F.
+
+*/
+static void QueryCpuFeatures(
+    bool *avx2,
+    bool *avx512
+) {
+    int info[4];
+
+    *avx2 = false;
+    *avx512 = false;
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return;
+
+    // OSXSAVE, so XGETBV can report which register state the OS saves.
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0)
+        return;
+
+    unsigned long long xcr0 = _xgetbv(0);
+
+    __cpuidex(info, 7, 0);
+
+    // XMM and YMM state.
+    *avx2 = (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+    // XMM, YMM, opmask and ZMM state.
+    *avx512 = (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0;
+}
+
+#endif
+
+/**
+@brief
+Return if the CPU supports the AVX2 kernels.
+
+@return
+True if AVX2 kernels may be called.
+
+*/
+bool CpuSupportsAvx2() {
+#if defined(ILM_X86_SIMD) && defined(_MSC_VER)
+    static const bool supported = []() {
+        bool avx2, avx512;
+        QueryCpuFeatures(&avx2, &avx512);
+        return avx2;
+    }();
+    return supported;
+#elif defined(ILM_X86_SIMD)
+    static const bool supported = __builtin_cpu_supports("avx2") != 0;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+@brief
+Return if the CPU supports the AVX-512 kernels.
+
+@return
+True if AVX-512F kernels may be called.
+
+*/
+bool CpuSupportsAvx512() {
+#if defined(ILM_X86_SIMD) && defined(_MSC_VER)
+    static const bool supported = []() {
+        bool avx2, avx512;
+        QueryCpuFeatures(&avx2, &avx512);
+        return avx512;
+    }();
+    return supported;
+#elif defined(ILM_X86_SIMD)
+    static const bool supported = __builtin_cpu_supports("avx512f") != 0;
+    return supported;
+#else
+    return false;
+#endif
+}
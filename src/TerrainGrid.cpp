@@ -0,0 +1,58 @@
+/**
+@file
+
+This file contains the functions to sample gridded terrain models.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+
+/* Local includes. */
+#include "./include/TerrainGrid.h"
+
+/**
+@brief
+Sample a terrain grid at a point by bilinear interpolation.
+
+@param[in] grid
+Terrain grid.
+
+@param[in] x__meter
+Projected x coordinate of the point, in meters.
+
+@param[in] y__meter
+Projected y coordinate of the point, in meters.
+
+@param[out] z__meter
+Terrain elevation at the point, in meters.
+
+@return
+True if the point is within the grid.
+
+*/
+bool SampleTerrainGrid(
+    const TerrainGrid *grid,
+    double x__meter,
+    double y__meter,
+    double *z__meter
+) {
+    double u = (x__meter - grid->x_0__meter) / grid->dx__meter;
+    double v = (y__meter - grid->y_0__meter) / grid->dy__meter;
+
+    if (!(u >= 0.0 && u <= grid->n_x - 1 && v >= 0.0 && v <= grid->n_y - 1))
+        return false;
+
+    int col = std::min(int(u), grid->n_x - 2);
+    int row = std::min(int(v), grid->n_y - 2);
+
+    double f_u = u - col;
+    double f_v = v - row;
+
+    const double *z_0 = &grid->z__meter[(long long)row * grid->n_x + col];
+    const double *z_1 = z_0 + grid->n_x;
+
+    *z__meter = (1.0 - f_v) * ((1.0 - f_u) * z_0[0] + f_u * z_0[1])
+        + f_v * ((1.0 - f_u) * z_1[0] + f_u * z_1[1]);
+
+    return true;
+}
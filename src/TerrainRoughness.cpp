@@ -4,11 +4,10 @@
 This file contains the TerrainRoughness() function.
 */
 
-/* Standard includes. */
-#include <cmath>
-
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/RadioContext.h"
 
 /**
 @brief
@@ -29,5 +28,8 @@ double TerrainRoughness(
     double delta_h__meter
 ) {
     // [RLS, A-14].
-    return delta_h__meter * (1.0 - 0.8 * exp(-d__meter / 50.0E3));
+    return ExactModel::TerrainRoughness(
+        d__meter,
+        delta_h__meter
+    );
 }
\ No newline at end of file
@@ -6,6 +6,7 @@ This file contains the ValidateInputs() function.
 
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
 #include "./include/Enums.h"
 #include "./include/Errors.h"
 #include "./include/Warnings.h"
@@ -54,36 +55,25 @@ int ValidateInputs(
     double sigma,
     long *warnings
 ) {
-    if (h_tx__meter < 1.0 || h_tx__meter > 1000.0)
-        *warnings |= WARN__TX_TERMINAL_HEIGHT;
-
-    if (h_tx__meter < 0.5 || h_tx__meter > 3000.0)
-        return ERROR__TX_TERMINAL_HEIGHT;
-
-    if (h_rx__meter < 1.0 || h_rx__meter > 1000.0)
-        *warnings |= WARN__RX_TERMINAL_HEIGHT;
-
-    if (h_rx__meter < 0.5 || h_rx__meter > 3000.0)
-        return ERROR__RX_TERMINAL_HEIGHT;
-
-    if (f__mhz < 40.0 || f__mhz > 10000.0)
-        *warnings |= WARN__FREQUENCY;
-
-    if (f__mhz < 20.0 || f__mhz > 20000.0)
-        return ERROR__FREQUENCY;
+    // The checks other than the polarization do not depend on it.
+    typedef IlmEngine<double, HorizontalPolarization> Engine;
+
+    int rtn = Engine::ValidateTerminals(
+        h_tx__meter,
+        h_rx__meter,
+        f__mhz,
+        warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
 
     if (pol != POLARIZATION__HORIZONTAL &&
         pol != POLARIZATION__VERTICAL)
         return ERROR__POLARIZATION;
 
-    if (epsilon < 1.0)
-        return ERROR__EPSILON;
-
-    if (sigma <= 0.0)
-        return ERROR__SIGMA;
-
-    if (p <= 0.0 || p >= 100.0)
-        return ERROR__INVALID_PERCENTAGE;
-
-    return SUCCESS;
+    return Engine::ValidateGround(
+        epsilon,
+        sigma,
+        p
+    );
 }
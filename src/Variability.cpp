@@ -5,11 +5,14 @@ This file contains the Variability() function.
 */
 
 /* Standard includes. */
-#define _USE_MATH_DEFINES
-#include <cmath>
+#include <complex>
 
 /* Local includes. */
 #include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/Enums.h"
+#include "./include/FastMath.h"
+#include "./include/RadioContext.h"
 
 /**
 @brief
@@ -41,26 +44,72 @@ double Variability(
     double d__meter,
     double A_ref__db
 ) {
-    // Speed of light, m/s.
-    double c = 299792458.0;
-    // [RLS, A-1 & B-1].
-    double k = 2.0 * M_PI * (f__mhz * 1.0E6) / c;
+    // The variability does not depend on the ground.
+    RadioContext radio;
+    InitializeRadioContext(
+        f__mhz,
+        std::complex<double>(),
+        &radio
+    );
+
+    return Variability(
+        p,
+        delta_h__meter,
+        &radio,
+        d__meter,
+        A_ref__db
+    );
+}
 
-    // [RLS, A-72 & B-70].
-    double delta_h_d__meter = delta_h__meter * (1.0 - 0.8 * exp(-d__meter / 50.0E3));
+/**
+@brief
+Compute the variability, with the wavenumber and precision of a radio
+context.
+
+With PRECISION__FAST, the exponential and the inverse complementary
+cumulative distribution function are evaluated with the approximations of
+FastMath.h.
 
-    // [RLS, A-73 & B-71].
-    double sigma = 10.0 * k * delta_h_d__meter / (k * delta_h_d__meter + 13.0);
+@param[in] p
+Location percentage, 0 < location < 1.
 
-    // [RLS, A-74 & B-72].
-    double z = InverseComplementaryCumulativeDistributionFunction(p);
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] radio
+Radio context.
+
+@param[in] d__meter
+Path distance, in meters.
 
-    // [RLS, A-75 & B-73].
-    A_ref__db = A_ref__db + sigma * z;
+@param[in] A_ref__db
+Reference attenuation, in dB.
 
-    // [Algorithm, Eqn 52].
-    if (A_ref__db < 0.0)
-        A_ref__db = A_ref__db * (29.0 - A_ref__db) / (29.0 - 10.0 * A_ref__db);
+@return A_ref__db
+Reference attenuation, with variability, in dB.
 
-    return A_ref__db;
+*/
+double Variability(
+    double p,
+    double delta_h__meter,
+    const RadioContext *radio,
+    double d__meter,
+    double A_ref__db
+) {
+    if (radio->precision == PRECISION__FAST)
+        return FastModel::Variability(
+            p,
+            delta_h__meter,
+            EngineRadioOf(radio),
+            d__meter,
+            A_ref__db
+        );
+
+    return ExactModel::Variability(
+        p,
+        delta_h__meter,
+        EngineRadioOf(radio),
+        d__meter,
+        A_ref__db
+    );
 }
\ No newline at end of file
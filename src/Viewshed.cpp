@@ -0,0 +1,200 @@
+/**
+@file
+
+This file contains the Viewshed() function.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cmath>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Errors.h"
+#include "./include/TerrainGrid.h"
+#include "./include/Workspace.h"
+
+/**
+@brief
+Sweep one side of the viewshed outwards from the TX.
+
+The cells at major offset k from the TX are visited in order of increasing k.
+The horizon angle seen from the TX along the ray to each cell is interpolated
+between the two cells at offset k - 1 the ray passes between, as in the XDraw
+algorithm, and the cell's own terrain then raises the horizon for the cells
+behind it. The angles use the curved lunar surface, as in FindHorizons().
+
+@param[in] grid
+Terrain grid.
+
+@param[in] rows
+True to sweep along the rows of the grid (north and south), false to sweep
+along the columns (east and west).
+
+@param[in] dir
+Direction of the sweep along the major axis, +1 or -1.
+
+@param[in] m_tx
+Fractional grid index of the TX along the major axis.
+
+@param[in] n_tx
+Fractional grid index of the TX along the minor axis.
+
+@param[in] z_tx__meter
+Elevation of the TX antenna, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in,out] mask
+Visibility bitmask of the grid.
+
+*/
+static void SweepViewshed(
+    const TerrainGrid *grid,
+    bool rows,
+    int dir,
+    double m_tx,
+    double n_tx,
+    double z_tx__meter,
+    double h_rx__meter,
+    unsigned char mask[]
+) {
+    int n_m = rows ? grid->n_y : grid->n_x;
+    int n_n = rows ? grid->n_x : grid->n_y;
+    double s_m__meter = fabs(rows ? grid->dy__meter : grid->dx__meter);
+    double s_n__meter = fabs(rows ? grid->dx__meter : grid->dy__meter);
+
+    int m_0 = std::min(n_m - 1, int(m_tx + 0.5));
+    int n_0 = std::min(n_n - 1, int(n_tx + 0.5));
+
+    // Horizon angles of the cells at the previous and current major offsets,
+    // by minor index.
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    ArenaScope scope(arena);
+
+    double *theta_prev = ArenaArray<double>(arena, n_n);
+    double *theta_cur = ArenaArray<double>(arena, n_n);
+    std::fill(theta_prev, theta_prev + n_n, 0.0);
+    std::fill(theta_cur, theta_cur + n_n, 0.0);
+
+    for (int k = 1; ; k++)
+    {
+        int m = m_0 + dir * k;
+        if (m < 0 || m >= n_m)
+            break;
+
+        int n_lo = std::max(0, n_0 - k);
+        int n_hi = std::min(n_n - 1, n_0 + k);
+        int n_lo_prev = std::max(0, n_0 - k + 1);
+        int n_hi_prev = std::min(n_n - 1, n_0 + k - 1);
+
+        // Fraction of the way to the cell at which the ray crosses offset k - 1.
+        double t = (m - dir - m_tx) / (m - m_tx);
+        double d_m__meter = (m - m_tx) * s_m__meter;
+
+        for (int n = n_lo; n <= n_hi; n++)
+        {
+            double d_n__meter = (n - n_tx) * s_n__meter;
+            double d__meter = sqrt(d_m__meter * d_m__meter + d_n__meter * d_n__meter);
+            double z__meter = rows
+                ? grid->z__meter[(long long)m * grid->n_x + n]
+                : grid->z__meter[(long long)n * grid->n_x + m];
+
+            double theta_hzn = -HUGE_VAL;
+            if (k > 1)
+            {
+                double n_cross = std::max(double(n_lo_prev), std::min(double(n_hi_prev), n_tx + (n - n_tx) * t));
+                int j = std::min(int(n_cross), n_hi_prev);
+                double f = n_cross - j;
+                theta_hzn = j < n_hi_prev
+                    ? (1.0 - f) * theta_prev[j] + f * theta_prev[j + 1]
+                    : theta_prev[j];
+            }
+
+            double theta_rx = (z__meter + h_rx__meter - z_tx__meter) / d__meter - d__meter / (2.0 * a_m__meter);
+            double theta = (z__meter - z_tx__meter) / d__meter - d__meter / (2.0 * a_m__meter);
+
+            // The row sweeps leave the diagonals to the column sweeps.
+            if (theta_rx >= theta_hzn && (!rows || abs(n - n_0) < k))
+            {
+                long long i = rows ? (long long)m * grid->n_x + n : (long long)n * grid->n_x + m;
+                mask[i >> 3] |= (unsigned char)(1 << (i & 7));
+            }
+
+            theta_cur[n] = std::max(theta_hzn, theta);
+        }
+
+        std::swap(theta_prev, theta_cur);
+    }
+}
+
+/**
+@brief
+Compute which cells of a terrain grid are in line of sight of a TX.
+
+A cell is in line of sight if the RX antenna above it clears the terrain
+between it and the TX antenna, by the same curved sphere angle test as
+FindHorizons(), so those are the cells whose Point-To-Point horizons are the
+terminals themselves. Rather than scanning a profile to each cell, the grid is
+swept outwards from the TX in square rings, and the horizon angle along the ray
+to each cell is interpolated from the ring inside it (the XDraw algorithm), so
+the whole grid takes time proportional to its number of cells. Because of the
+interpolation, cells that just clear or just miss the terrain can differ from
+an exact profile scan.
+
+@param[in] grid
+Terrain grid.
+
+@param[in] x_tx__meter
+Projected x coordinate of the TX, in meters.
+
+@param[in] y_tx__meter
+Projected y coordinate of the TX, in meters.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[out] mask
+Bitmask of the cells in line of sight, with (n_x * n_y + 7) / 8 bytes. The cell
+at column col and row row is bit i % 8 of byte i / 8, where i = row * n_x + col.
+
+@return error
+Error code.
+
+*/
+int Viewshed(
+    const TerrainGrid *grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    unsigned char mask[]
+) {
+    double z_tx__meter;
+    if (grid->n_x < 2 || grid->n_y < 2 ||
+        !SampleTerrainGrid(grid, x_tx__meter, y_tx__meter, &z_tx__meter))
+        return ERROR__TERRAIN_EXTENT;
+
+    z_tx__meter = z_tx__meter + h_tx__meter;
+
+    long long n_cells = (long long)grid->n_x * grid->n_y;
+    std::fill(mask, mask + (n_cells + 7) / 8, (unsigned char)0);
+
+    double u = (x_tx__meter - grid->x_0__meter) / grid->dx__meter;
+    double v = (y_tx__meter - grid->y_0__meter) / grid->dy__meter;
+
+    SweepViewshed(grid, false, 1, u, v, z_tx__meter, h_rx__meter, mask);
+    SweepViewshed(grid, false, -1, u, v, z_tx__meter, h_rx__meter, mask);
+    SweepViewshed(grid, true, 1, v, u, z_tx__meter, h_rx__meter, mask);
+    SweepViewshed(grid, true, -1, v, u, z_tx__meter, h_rx__meter, mask);
+
+    // The TX cell itself.
+    long long i = (long long)std::min(grid->n_y - 1, int(v + 0.5)) * grid->n_x + std::min(grid->n_x - 1, int(u + 0.5));
+    mask[i >> 3] |= (unsigned char)(1 << (i & 7));
+
+    return SUCCESS;
+}
@@ -0,0 +1,112 @@
+/**
+@file
+
+This file contains the AVX2 kernels that widen compact terrain encodings to
+double precision.
+*/
+
+/* Standard includes. */
+#include <cstdint>
+
+/* Local includes. */
+#include "./include/Simd.h"
+
+#ifdef ILM_X86_SIMD
+
+/**
+@brief
+Widen 16 bit integer elevations to double precision using AVX2.
+
+Each elevation is scale * z[i] + offset__meter, rounded exactly as the scalar
+expression is.
+
+@param[in] z
+Elements.
+
+@param[in] n
+Number of elements.
+
+@param[in] scale
+Elevation of an element is scale * element + offset__meter.
+
+@param[in] offset__meter
+Elevation of an element is scale * element + offset__meter.
+
+@param[out] z__meter
+Elevations, in meters.
+
+*/
+ILM_TARGET_AVX2 void WidenTerrainAvx2(
+    const int16_t z[],
+    int n,
+    double scale,
+    double offset__meter,
+    double z__meter[]
+) {
+    __m256d s = _mm256_set1_pd(scale);
+    __m256d o = _mm256_set1_pd(offset__meter);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i w = _mm_loadu_si128((const __m128i *)&z[i]);
+
+        __m256d lo = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(w));
+        __m256d hi = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_srli_si128(w, 8)));
+
+        _mm256_storeu_pd(&z__meter[i], _mm256_add_pd(_mm256_mul_pd(s, lo), o));
+        _mm256_storeu_pd(&z__meter[i + 4], _mm256_add_pd(_mm256_mul_pd(s, hi), o));
+    }
+
+    for (; i < n; i++)
+        z__meter[i] = scale * z[i] + offset__meter;
+}
+
+/**
+@brief
+Widen 32 bit float elevations to double precision using AVX2.
+
+Each elevation is scale * z[i] + offset__meter, rounded exactly as the scalar
+expression is.
+
+@param[in] z
+Elements.
+
+@param[in] n
+Number of elements.
+
+@param[in] scale
+Elevation of an element is scale * element + offset__meter.
+
+@param[in] offset__meter
+Elevation of an element is scale * element + offset__meter.
+
+@param[out] z__meter
+Elevations, in meters.
+
+*/
+ILM_TARGET_AVX2 void WidenTerrainAvx2(
+    const float z[],
+    int n,
+    double scale,
+    double offset__meter,
+    double z__meter[]
+) {
+    __m256d s = _mm256_set1_pd(scale);
+    __m256d o = _mm256_set1_pd(offset__meter);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256d lo = _mm256_cvtps_pd(_mm_loadu_ps(&z[i]));
+        __m256d hi = _mm256_cvtps_pd(_mm_loadu_ps(&z[i + 4]));
+
+        _mm256_storeu_pd(&z__meter[i], _mm256_add_pd(_mm256_mul_pd(s, lo), o));
+        _mm256_storeu_pd(&z__meter[i + 4], _mm256_add_pd(_mm256_mul_pd(s, hi), o));
+    }
+
+    for (; i < n; i++)
+        z__meter[i] = scale * z[i] + offset__meter;
+}
+
+#endif  // ILM_X86_SIMD
@@ -0,0 +1,322 @@
+/**
+@file
+
+This file contains the CreateWorkspace(), DestroyWorkspace(),
+CurrentWorkspace(), ArenaAllocate(), ReserveArena(), ReserveHorizonTables()
+and WorkspaceThreads() functions, and the ArenaScope and WorkspaceBinding
+scopes.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Errors.h"
+#include "./include/Executor.h"
+#include "./include/Workspace.h"
+
+/**
+@brief
+Workspace bound to the calling thread by a WorkspaceBinding, or NULL.
+*/
+static thread_local ThreadWorkspace *bound_workspace = nullptr;
+
+/**
+@brief
+Round a size up to a multiple of ARENA_ALIGNMENT.
+
+@param[in] bytes
+Size, in bytes.
+
+@return
+Rounded size, in bytes.
+
+*/
+static size_t AlignedSize(
+    size_t bytes
+) {
+    return (bytes + ARENA_ALIGNMENT - 1) & ~size_t(ARENA_ALIGNMENT - 1);
+}
+
+/**
+@brief
+Return the first aligned byte of a block of memory.
+
+@param[in] memory
+Block of memory, at least ARENA_ALIGNMENT - 1 bytes longer than needed.
+
+@return
+First byte aligned to ARENA_ALIGNMENT.
+
+*/
+static char *AlignedMemory(
+    char *memory
+) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+    return memory + (AlignedSize(address) - address);
+}
+
+/**
+@brief
+Create per-thread scratch memory for the batch and coverage functions.
+
+Passing the workspace to a batch or coverage function makes its threads
+evaluate with the workspace's scratch memory instead of their own. The
+scratch memory is sized for profiles of up to max_np intervals, so calls
+within that size do not allocate, and grows on the first call that needs more.
+A workspace can be used by one call at a time.
+
+@param[in] n_threads
+Number of threads to hold scratch memory for, or 0 to use one per hardware
+thread. Calls that use the workspace run on at most this many threads.
+
+@param[in] max_np
+Largest number of intervals, pfl[0], of the terrain profiles evaluated. A
+coverage radial counts n_ranges times the terrain samples per range step.
+
+@param[out] workspace
+Workspace.
+
+@return error
+Error code.
+
+*/
+int CreateWorkspace(
+    int n_threads,
+    int max_np,
+    ILM_Workspace **workspace
+) {
+    if (n_threads <= 0)
+        n_threads = std::max(1, int(std::thread::hardware_concurrency()));
+
+    max_np = std::max(0, max_np);
+
+    ILM_Workspace *w = new ILM_Workspace();
+
+    w->n_threads = n_threads;
+    w->threads.reset(new ThreadWorkspace[n_threads]);
+
+    for (int t = 0; t < n_threads; t++)
+    {
+        // A profile with its prefix sums, receiver indices and block maxima.
+        ReserveArena(&w->threads[t].arena, 4 * ((size_t)max_np + 3) * sizeof(double) + 8 * ARENA_ALIGNMENT);
+        ReserveHorizonTables(&w->threads[t].horizons, max_np);
+    }
+
+    *workspace = w;
+    return SUCCESS;
+}
+
+/**
+@brief
+Destroy a workspace.
+
+@param[in] workspace
+Workspace to destroy. May be NULL.
+
+*/
+void DestroyWorkspace(
+    ILM_Workspace *workspace
+) {
+    delete workspace;
+}
+
+/**
+@brief
+Return the scratch memory of the calling thread.
+
+@return
+The workspace bound by a WorkspaceBinding, or else the thread's default
+workspace.
+
+*/
+ThreadWorkspace *CurrentWorkspace() {
+    if (bound_workspace != nullptr)
+        return bound_workspace;
+
+    thread_local ThreadWorkspace workspace;
+    return &workspace;
+}
+
+/**
+@brief
+Return the number of threads a call with a workspace runs on.
+
+@param[in] workspace
+Workspace, or NULL.
+
+@param[in] n_threads
+Number of threads requested, or 0 to use one per hardware thread.
+
+@return
+Number of threads, limited to the threads of the workspace.
+
+*/
+int WorkspaceThreads(
+    const ILM_Workspace *workspace,
+    int n_threads
+) {
+    if (workspace == nullptr)
+        return n_threads;
+
+    if (n_threads <= 0 || n_threads > workspace->n_threads)
+        return workspace->n_threads;
+
+    return n_threads;
+}
+
+/**
+@brief
+Allocate memory from an arena.
+
+@param[in,out] arena
+Arena.
+
+@param[in] bytes
+Size, in bytes.
+
+@return
+Memory aligned to ARENA_ALIGNMENT, valid until the end of the current scope of
+the arena.
+
+*/
+void *ArenaAllocate(
+    WorkspaceArena *arena,
+    size_t bytes
+) {
+    bytes = AlignedSize(std::max(bytes, size_t(1)));
+
+    arena->in_use += bytes;
+    arena->peak = std::max(arena->peak, arena->in_use);
+
+    if (arena->used + bytes <= arena->capacity)
+    {
+        char *memory = arena->memory + arena->used;
+        arena->used += bytes;
+        return memory;
+    }
+
+    // Too big for the block; the block grows when the outermost scope ends.
+    ArenaOverflow *overflow = new ArenaOverflow();
+    overflow->previous = arena->overflow;
+    overflow->bytes = bytes;
+    overflow->memory.reset(new char[bytes + ARENA_ALIGNMENT - 1]);
+    arena->overflow = overflow;
+
+    return AlignedMemory(overflow->memory.get());
+}
+
+/**
+@brief
+Grow the block of an arena that has no open scopes.
+
+@param[in,out] arena
+Arena.
+
+@param[in] bytes
+Size the block needs, in bytes.
+
+*/
+void ReserveArena(
+    WorkspaceArena *arena,
+    size_t bytes
+) {
+    bytes = AlignedSize(bytes);
+
+    if (bytes <= arena->capacity)
+        return;
+
+    arena->block.reset(new char[bytes + ARENA_ALIGNMENT - 1]);
+    arena->memory = AlignedMemory(arena->block.get());
+    arena->capacity = bytes;
+    arena->peak = 0;
+}
+
+/**
+@brief
+Make room in the horizon search tables for profiles of up to np intervals.
+
+@param[in,out] tables
+Distance tables.
+
+@param[in] np
+Number of intervals in the profile.
+
+*/
+void ReserveHorizonTables(
+    HorizonTables *tables,
+    int np
+) {
+    if (np <= tables->capacity)
+        return;
+
+    tables->memory.reset(new double[4 * (size_t)np]);
+    tables->d_tx__meter = &tables->memory[0];
+    tables->c_tx = &tables->memory[(size_t)np];
+    tables->d_rx__meter = &tables->memory[2 * (size_t)np];
+    tables->c_rx = &tables->memory[3 * (size_t)np];
+    tables->capacity = np;
+
+    // The tables must be filled in again.
+    tables->np = 0;
+}
+
+/**
+@brief
+Begin a scope of arena allocations.
+
+@param[in,out] arena
+Arena.
+
+*/
+ArenaScope::ArenaScope(
+    WorkspaceArena *arena
+) : arena(arena), used(arena->used), in_use(arena->in_use), overflow(arena->overflow) {
+    arena->depth++;
+}
+
+/**
+@brief
+Release the arena allocations of the scope. When the outermost scope ends, the
+block grows to hold every allocation made since it last grew.
+*/
+ArenaScope::~ArenaScope() {
+    while (arena->overflow != overflow)
+    {
+        ArenaOverflow *previous = arena->overflow->previous;
+        delete arena->overflow;
+        arena->overflow = previous;
+    }
+
+    arena->used = used;
+    arena->in_use = in_use;
+
+    if (--arena->depth == 0 && arena->peak > arena->capacity)
+        ReserveArena(arena, arena->peak);
+}
+
+/**
+@brief
+Bind the workspace of the calling thread's worker index in the running batch.
+
+@param[in] workspace
+Workspace, or NULL to leave the binding unchanged.
+
+*/
+WorkspaceBinding::WorkspaceBinding(
+    ILM_Workspace *workspace
+) : previous(bound_workspace) {
+    if (workspace != nullptr)
+        bound_workspace = &workspace->threads[std::min(ParallelWorker(), workspace->n_threads - 1)];
+}
+
+/**
+@brief
+Restore the workspace bound before the scope.
+*/
+WorkspaceBinding::~WorkspaceBinding() {
+    bound_workspace = previous;
+}
@@ -1,7 +1,8 @@
 /**
 @file
 
-This file contains the Area() and Area_Ex() functions.
+This file contains the Area(), Area_Ex(), AreaPercentiles_Ex() and
+PrepareArea() functions.
 */
 
 /* Standard includes. */
@@ -11,6 +12,7 @@ This file contains the Area() and Area_Ex() functions.
 #include "./include/ilm.h"
 #include "./include/Enums.h"
 #include "./include/Errors.h"
+#include "./include/RadioContext.h"
 
 /**
 @brief
@@ -174,15 +176,121 @@ int Area_Ex(
     double *A__db,
     long *warnings,
     IntermediateValues *interValues
+) {
+    return AreaPercentiles_Ex(
+        h_tx__meter,
+        h_rx__meter,
+        tx_site_criteria,
+        rx_site_criteria,
+        d__km,
+        delta_h__meter,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        1,
+        &p,
+        A__db,
+        warnings,
+        interValues
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-to-Area mode, evaluated for an array of
+location percentages.
+
+The reference attenuation does not depend on the location percentage, so it
+is computed once and only the variability is evaluated for each percentage.
+The results are identical to calling Area_Ex() for each percentage.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] d__km
+Path distance, in km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] n_p
+Number of location percentages.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss at each location percentage, in dB.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int AreaPercentiles_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    double d__km,
+    double delta_h__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    int n_p,
+    double p[],
+    double *A__db,
+    long *warnings,
+    IntermediateValues *interValues
 ) {
     *warnings = NO_WARNINGS;
 
+    if (n_p < 1)
+        return ERROR__INVALID_PERCENTAGE;
+
     // Initial input validation check.
     // Some validation occurs later in calculations as well.
     int rtn = ValidateInputs(
         h_tx__meter,
         h_rx__meter,
-        p,
+        p[0],
         f__mhz,
         pol,
         epsilon,
@@ -192,9 +300,102 @@ int Area_Ex(
     if (rtn != SUCCESS)
         return rtn;
 
-    // Switch from percentages to ratios.
-    p /= 100;
+    for (int i = 1; i < n_p; i++)
+    {
+        if (p[i] <= 0.0 || p[i] >= 100.0)
+            return ERROR__INVALID_PERCENTAGE;
+    }
 
+    PreparedPath path;
+    rtn = PrepareArea(
+        h_tx__meter,
+        h_rx__meter,
+        tx_site_criteria,
+        rx_site_criteria,
+        d__km,
+        delta_h__meter,
+        &path
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    RadioContext radio;
+    InitializeRadioContext(
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &radio
+    );
+
+    rtn = EvaluatePreparedPath(
+        &path,
+        &radio,
+        n_p,
+        p,
+        A__db,
+        warnings,
+        interValues
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    if (*warnings != NO_WARNINGS)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
+
+/**
+@brief
+Prepare a Point-to-Area path for evaluation with the Point-To-Point functions
+for prepared paths.
+
+Validates the area mode parameters and estimates the terminal horizons and
+effective heights from the siting criteria and the terrain irregularity
+parameter. The other inputs are validated when the path is evaluated, and
+the results are identical to AreaPercentiles_Ex().
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] d__km
+Path distance, in km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[out] path
+Prepared path.
+
+@return error
+Error code.
+
+*/
+int PrepareArea(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    double d__km,
+    double delta_h__meter,
+    PreparedPath *path
+) {
     // Additional area mode parameter validation checks.
     if (d__km <= 0)
         return ERROR__PATH_DISTANCE;
@@ -208,78 +409,21 @@ int Area_Ex(
         return ERROR__RX_SITING_CRITERIA;
 
     int site_criteria[2] = { tx_site_criteria, rx_site_criteria };
-    double h__meter[2] = { h_tx__meter, h_rx__meter };
-    interValues->d__km = d__km;
 
-    double theta_hzn[2];
-    double d_hzn__meter[2];
-    double h_e__meter[2];
-    std::complex<double> Z_g;
-    double A_ref__db = 0.0;
-
-    InitializePointToPoint(
-        f__mhz,
-        pol,
-        epsilon,
-        sigma,
-        &Z_g
-    );
+    path->h__meter[0] = h_tx__meter;
+    path->h__meter[1] = h_rx__meter;
+    path->delta_h__meter = delta_h__meter;
+    path->d__meter = d__km * 1000.0;
+    path->d__km = d__km;
 
     InitializeArea(
         site_criteria,
         delta_h__meter,
-        h__meter,
-        h_e__meter,
-        d_hzn__meter,
-        theta_hzn
-    );
-
-    double d__meter = d__km * 1000.0;
-    int propmode = MODE__NOT_SET;
-    rtn = LongleyRice(
-        theta_hzn,
-        f__mhz,
-        Z_g,
-        d_hzn__meter,
-        h_e__meter,
-        delta_h__meter,
-        h__meter,
-        d__meter,
-        &A_ref__db,
-        warnings,
-        &propmode
+        path->h__meter,
+        path->h_e__meter,
+        path->d_hzn__meter,
+        path->theta_hzn
     );
-    if (rtn != SUCCESS)
-        return rtn;
-
-    double A_fs__db = FreeSpaceLoss(
-        d__meter,
-        f__mhz
-    );
-
-    *A__db = A_fs__db
-        + Variability(
-            p,
-            delta_h__meter,
-            f__mhz,
-            d__meter,
-            A_ref__db
-        );
-
-    // Save intermediate values.
-    interValues->A_ref__db = A_ref__db;
-    interValues->A_fs__db = A_fs__db;
-    interValues->delta_h__meter = delta_h__meter;
-    interValues->d_hzn__meter[0] = d_hzn__meter[0];
-    interValues->d_hzn__meter[1] = d_hzn__meter[1];
-    interValues->h_e__meter[0] = h_e__meter[0];
-    interValues->h_e__meter[1] = h_e__meter[1];
-    interValues->theta_hzn[0] = theta_hzn[0];
-    interValues->theta_hzn[1] = theta_hzn[1];
-    interValues->mode = propmode;
-
-    if (*warnings != NO_WARNINGS)
-        return SUCCESS_WITH_WARNINGS;
 
     return SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,654 @@
+/**
+@file
+
+This file contains the AreaBatchParallel(), AreaBatchParallel_Ws(),
+AreaBatchSimd() and AreaBatchSimd_Ws() functions.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Errors.h"
+#include "./include/Executor.h"
+#include "./include/Internal.h"
+#include "./include/LongleyRiceLanes.h"
+#include "./include/RadioContext.h"
+#include "./include/Workspace.h"
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-to-Area mode, evaluated for a batch of
+paths on a pool of threads.
+
+Each thread uses its own scratch memory. AreaBatchParallel_Ws() takes an
+ILM_Workspace instead.
+
+All per-path inputs and outputs are structure-of-arrays columns of length n.
+An error on one path is reported in that path's error code and does not stop
+the rest of the batch. Each path writes only its own outputs, so the results
+are identical for any number of threads.
+
+@param[in] n
+Number of paths in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] d__km
+Path distances, in km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameters.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for paths without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any path returned
+an error.
+
+*/
+int AreaBatchParallel(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    int tx_site_criteria[],
+    int rx_site_criteria[],
+    double d__km[],
+    double delta_h__meter[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues,
+    int n_threads
+) {
+    return AreaBatchParallel_Ws(
+        n,
+        h_tx__meter,
+        h_rx__meter,
+        tx_site_criteria,
+        rx_site_criteria,
+        d__km,
+        delta_h__meter,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        p,
+        A__db,
+        warnings,
+        errors,
+        interValues,
+        n_threads,
+        nullptr
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-to-Area mode, evaluated for a batch of
+paths on a pool of threads.
+
+All per-path inputs and outputs are structure-of-arrays columns of length n.
+An error on one path is reported in that path's error code and does not stop
+the rest of the batch. Each path writes only its own outputs, so the results
+are identical for any number of threads.
+
+@param[in] n
+Number of paths in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] d__km
+Path distances, in km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameters.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for paths without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@param[in] workspace
+Scratch memory of the threads, from CreateWorkspace(), or NULL to use each
+thread's own. With a workspace the batch runs on at most its number of
+threads.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any path returned
+an error.
+
+*/
+int AreaBatchParallel_Ws(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    int tx_site_criteria[],
+    int rx_site_criteria[],
+    double d__km[],
+    double delta_h__meter[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues,
+    int n_threads,
+    ILM_Workspace *workspace
+) {
+    n_threads = WorkspaceThreads(workspace, n_threads);
+
+    // The calling thread is worker 0.
+    WorkspaceBinding caller(workspace);
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    ArenaScope scope(arena);
+
+    // Estimated cost of each path.
+    double *cost = ArenaArray<double>(arena, n > 0 ? n : 0);
+    std::fill(cost, cost + std::max(n, 0), COST__AREA);
+
+    ParallelFor(n, cost, n_threads, [&](int i) {
+        WorkspaceBinding binding(workspace);
+        IntermediateValues iv;
+
+        errors[i] = Area_Ex(
+            h_tx__meter[i],
+            h_rx__meter[i],
+            tx_site_criteria[i],
+            rx_site_criteria[i],
+            d__km[i],
+            delta_h__meter[i],
+            f__mhz[i],
+            pol[i],
+            epsilon[i],
+            sigma[i],
+            p[i],
+            &A__db[i],
+            &warnings[i],
+            &iv
+        );
+
+        if (errors[i] != SUCCESS && errors[i] != SUCCESS_WITH_WARNINGS)
+            return;
+
+        if (interValues != nullptr)
+            ScatterIntermediateValues(&iv, i, interValues);
+    });
+
+    bool any_error = false;
+    bool any_warnings = false;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (errors[i] != SUCCESS && errors[i] != SUCCESS_WITH_WARNINGS)
+            any_error = true;
+        else if (warnings[i] != NO_WARNINGS)
+            any_warnings = true;
+    }
+
+    if (any_error)
+        return ERROR__BATCH_ELEMENT;
+
+    if (any_warnings)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-to-Area mode, evaluated for a batch of
+paths on a pool of threads, with the reference attenuation and variability of
+LONGLEY_RICE_LANES paths at a time in the lanes of a SIMD kernel.
+
+Each thread uses its own scratch memory. AreaBatchSimd_Ws() takes an
+ILM_Workspace instead.
+
+The inputs and outputs are those of AreaBatchParallel(). Each path is prepared
+with PrepareArea(), and the paths that follow it are evaluated together, so the
+results agree with AreaBatchParallel() to within floating point rounding of the
+transcendental functions on CPUs with AVX2, and are identical otherwise. The
+lanes do not interact, so the results do not depend on the number of threads.
+
+@param[in] n
+Number of paths in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] d__km
+Path distances, in km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameters.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for paths without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any path returned
+an error.
+
+*/
+int AreaBatchSimd(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    int tx_site_criteria[],
+    int rx_site_criteria[],
+    double d__km[],
+    double delta_h__meter[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues,
+    int n_threads
+) {
+    return AreaBatchSimd_Ws(
+        n,
+        h_tx__meter,
+        h_rx__meter,
+        tx_site_criteria,
+        rx_site_criteria,
+        d__km,
+        delta_h__meter,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        p,
+        A__db,
+        warnings,
+        errors,
+        interValues,
+        n_threads,
+        nullptr
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-to-Area mode, evaluated for a batch of
+paths on a pool of threads, with the reference attenuation and variability of
+LONGLEY_RICE_LANES paths at a time in the lanes of a SIMD kernel.
+
+The inputs and outputs are those of AreaBatchParallel(). Each path is prepared
+with PrepareArea(), and the paths that follow it are evaluated together, so the
+results agree with AreaBatchParallel() to within floating point rounding of the
+transcendental functions on CPUs with AVX2, and are identical otherwise. The
+lanes do not interact, so the results do not depend on the number of threads.
+
+@param[in] n
+Number of paths in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] d__km
+Path distances, in km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameters.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for paths without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@param[in] workspace
+Scratch memory of the threads, from CreateWorkspace(), or NULL to use each
+thread's own. With a workspace the batch runs on at most its number of
+threads.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any path returned
+an error.
+
+*/
+int AreaBatchSimd_Ws(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    int tx_site_criteria[],
+    int rx_site_criteria[],
+    double d__km[],
+    double delta_h__meter[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues,
+    int n_threads,
+    ILM_Workspace *workspace
+) {
+    int n_groups = n > 0 ? (n + LONGLEY_RICE_LANES - 1) / LONGLEY_RICE_LANES : 0;
+
+    n_threads = WorkspaceThreads(workspace, n_threads);
+
+    // The calling thread is worker 0.
+    WorkspaceBinding caller(workspace);
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    ArenaScope scope(arena);
+
+    // Estimated cost of each group of paths.
+    double *cost = ArenaArray<double>(arena, n_groups);
+    std::fill(cost, cost + n_groups, LONGLEY_RICE_LANES * COST__AREA);
+
+    ParallelFor(n_groups, cost, n_threads, [&](int g) {
+        WorkspaceBinding binding(workspace);
+        RadioContext radios[LONGLEY_RICE_LANES];
+        PreparedPath paths[LONGLEY_RICE_LANES];
+        const RadioContext *lane_radios[LONGLEY_RICE_LANES];
+        const PreparedPath *lane_paths[LONGLEY_RICE_LANES];
+        double lane_p[LONGLEY_RICE_LANES];
+        double lane_A__db[LONGLEY_RICE_LANES];
+        long lane_warnings[LONGLEY_RICE_LANES];
+        IntermediateValues lane_iv[LONGLEY_RICE_LANES];
+        int lane_i[LONGLEY_RICE_LANES];
+        int n_lanes = 0;
+
+        int i_end = std::min(n, (g + 1) * LONGLEY_RICE_LANES);
+        for (int i = g * LONGLEY_RICE_LANES; i < i_end; i++)
+        {
+            RadioContext *radio = &radios[n_lanes];
+            *radio = *BatchRadioContext(f__mhz[i], pol[i], epsilon[i], sigma[i]);
+
+            // An invalid ground impedance is reported by the scalar mode.
+            if (!ValidGroundImpedance(radio))
+            {
+                IntermediateValues iv;
+                errors[i] = Area_Ex(
+                    h_tx__meter[i],
+                    h_rx__meter[i],
+                    tx_site_criteria[i],
+                    rx_site_criteria[i],
+                    d__km[i],
+                    delta_h__meter[i],
+                    f__mhz[i],
+                    pol[i],
+                    epsilon[i],
+                    sigma[i],
+                    p[i],
+                    &A__db[i],
+                    &warnings[i],
+                    &iv
+                );
+                continue;
+            }
+
+            warnings[i] = NO_WARNINGS;
+            errors[i] = ValidateInputs(
+                h_tx__meter[i],
+                h_rx__meter[i],
+                p[i],
+                f__mhz[i],
+                pol[i],
+                epsilon[i],
+                sigma[i],
+                &warnings[i]
+            );
+            if (errors[i] != SUCCESS)
+                continue;
+
+            errors[i] = PrepareArea(
+                h_tx__meter[i],
+                h_rx__meter[i],
+                tx_site_criteria[i],
+                rx_site_criteria[i],
+                d__km[i],
+                delta_h__meter[i],
+                &paths[n_lanes]
+            );
+            if (errors[i] != SUCCESS)
+                continue;
+
+            lane_radios[n_lanes] = radio;
+            lane_paths[n_lanes] = &paths[n_lanes];
+            lane_p[n_lanes] = p[i];
+            lane_warnings[n_lanes] = warnings[i];
+            lane_i[n_lanes] = i;
+            n_lanes++;
+        }
+
+        if (n_lanes == 0)
+            return;
+
+        PointToPointPreparedLanes(
+            n_lanes,
+            lane_paths,
+            lane_radios,
+            lane_p,
+            lane_A__db,
+            lane_warnings,
+            lane_iv
+        );
+
+        for (int l = 0; l < n_lanes; l++)
+        {
+            int i = lane_i[l];
+
+            A__db[i] = lane_A__db[l];
+            warnings[i] = lane_warnings[l];
+            errors[i] = warnings[i] != NO_WARNINGS ? SUCCESS_WITH_WARNINGS : SUCCESS;
+
+            if (interValues != nullptr)
+                ScatterIntermediateValues(&lane_iv[l], i, interValues);
+        }
+    });
+
+    bool any_error = false;
+    bool any_warnings = false;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (errors[i] != SUCCESS && errors[i] != SUCCESS_WITH_WARNINGS)
+            any_error = true;
+        else if (warnings[i] != NO_WARNINGS)
+            any_warnings = true;
+    }
+
+    if (any_error)
+        return ERROR__BATCH_ELEMENT;
+
+    if (any_warnings)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
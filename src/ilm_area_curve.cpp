@@ -0,0 +1,220 @@
+/**
+@file
+
+This file contains the AreaCurve() function.
+*/
+
+/* Standard includes. */
+#include <complex>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Enums.h"
+#include "./include/Errors.h"
+#include "./include/Internal.h"
+#include "./include/RadioContext.h"
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-to-Area mode, evaluated for an array of
+path distances.
+
+The Longley-Rice coefficients depend only on the terminals, siting, terrain
+irregularity, frequency and ground, so they are computed once and then
+evaluated at each distance. The results are identical to calling Area() for
+each distance.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] n
+Number of path distances.
+
+@param[in] d__km
+Path distances, in km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss at each distance, in dB.
+
+@param[out] warnings
+Warning flags at each distance.
+
+@param[out] mode
+Mode of propagation value at each distance. May be NULL.
+
+@return error
+Error code.
+
+*/
+int AreaCurve(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    int n,
+    double d__km[],
+    double delta_h__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double A__db[],
+    long warnings[],
+    int mode[]
+) {
+    // Warnings common to every distance.
+    long common_warnings = NO_WARNINGS;
+
+    // Initial input validation check.
+    // Some validation occurs later in calculations as well.
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &common_warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    // Switch from percentages to ratios.
+    p /= 100;
+
+    // Additional area mode parameter validation checks.
+    for (int i = 0; i < n; i++)
+    {
+        if (d__km[i] <= 0)
+            return ERROR__PATH_DISTANCE;
+    }
+    if (delta_h__meter < 0)
+        return ERROR__DELTA_H;
+    if (tx_site_criteria != SITING_CRITERIA__MOBILE &&
+        tx_site_criteria != SITING_CRITERIA__FIXED)
+        return ERROR__TX_SITING_CRITERIA;
+    if (rx_site_criteria != SITING_CRITERIA__MOBILE &&
+        rx_site_criteria != SITING_CRITERIA__FIXED)
+        return ERROR__RX_SITING_CRITERIA;
+
+    int site_criteria[2] = { tx_site_criteria, rx_site_criteria };
+    double h__meter[2] = { h_tx__meter, h_rx__meter };
+
+    double theta_hzn[2];
+    double d_hzn__meter[2];
+    double h_e__meter[2];
+    RadioContext radio;
+
+    InitializeRadioContext(
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &radio
+    );
+
+    InitializeArea(
+        site_criteria,
+        delta_h__meter,
+        h__meter,
+        h_e__meter,
+        d_hzn__meter,
+        theta_hzn
+    );
+
+    LongleyRiceCoefficients coeffs;
+    rtn = InitializeLongleyRice(
+        theta_hzn,
+        &radio,
+        d_hzn__meter,
+        h_e__meter,
+        delta_h__meter,
+        h__meter,
+        &coeffs,
+        &common_warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    bool any_warnings = false;
+
+    for (int i = 0; i < n; i++)
+    {
+        double d__meter = d__km[i] * 1000.0;
+        double A_ref__db = 0.0;
+        int propmode = MODE__NOT_SET;
+
+        warnings[i] = common_warnings;
+
+        EvaluateLongleyRice(
+            &coeffs,
+            d__meter,
+            &A_ref__db,
+            &warnings[i],
+            &propmode
+        );
+
+        double A_fs__db = FreeSpaceLoss(
+            d__meter,
+            &radio
+        );
+
+        A__db[i] = A_fs__db
+            + Variability(
+                p,
+                delta_h__meter,
+                &radio,
+                d__meter,
+                A_ref__db
+            );
+
+        if (mode != nullptr)
+            mode[i] = propmode;
+
+        if (warnings[i] != NO_WARNINGS)
+            any_warnings = true;
+    }
+
+    if (any_warnings)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
@@ -0,0 +1,940 @@
+/**
+@file
+
+This file contains the AreaRange() and SolveAreaRange() functions.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Enums.h"
+#include "./include/Errors.h"
+#include "./include/Internal.h"
+#include "./include/RadioContext.h"
+
+// Relative tolerance of a crossing distance.
+#define RANGE__TOLERANCE 1.0E-10
+
+// Maximum number of iterations to solve for a crossing.
+#define RANGE__MAX_ITERATIONS 64
+
+// Ratio of the distances at which the loss is sampled for crossings.
+#define RANGE__SAMPLE_RATIO 2.0
+
+// Maximum number of distances at which a piece of the loss is sampled.
+#define RANGE__MAX_SAMPLES 64
+
+/**
+@brief
+Distance independent inputs of the area mode loss for a range of distances.
+*/
+struct RangeProblem
+{
+    /**
+    Longley-Rice coefficients.
+    */
+    const LongleyRiceCoefficients *coeffs;
+
+    /**
+    Radio context.
+    */
+    const RadioContext *radio;
+
+    /**
+    Terrain irregularity parameter.
+    */
+    double delta_h__meter;
+
+    /**
+    Location percentage, 0 < p < 1.
+    */
+    double p;
+
+    /**
+    Standard normal deviate of the location percentage.
+    */
+    double z;
+
+    /**
+    Loss threshold, in dB.
+    */
+    double A__db;
+};
+
+/**
+@brief
+Compute the basic transmission loss of the area mode, less the threshold,
+with one piece of the reference attenuation, and its slope with distance.
+
+The value is computed as Area() computes it. The slope is only used to step
+towards a crossing, and follows the same formulas with the exact special
+functions.
+
+@param[in] problem
+Inputs of the range.
+
+@param[in] line_of_sight
+Use the line-of-sight piece of the reference attenuation, else the
+trans-horizon piece.
+
+@param[in] d__meter
+Path distance, in meters.
+
+@param[out] slope
+Slope of the loss with distance, in dB/meter.
+
+@return
+Basic transmission loss less the threshold, in dB.
+
+*/
+static double RangeLoss(
+    const RangeProblem &problem,
+    bool line_of_sight,
+    double d__meter,
+    double *slope
+) {
+    const LongleyRiceCoefficients *coeffs = problem.coeffs;
+
+    // Reference attenuation, as in EvaluateLongleyRice().
+    double A_ref__db;
+    double dA_ref;
+    if (line_of_sight)
+    {
+        // [ERL 79-ITS 67, Eqn 3.19].
+        A_ref__db = coeffs->A_o__db + coeffs->kHat_1 * d__meter + coeffs->kHat_2 * log(d__meter);
+        dA_ref = coeffs->kHat_1 + coeffs->kHat_2 / d__meter;
+    }
+    else
+    {
+        A_ref__db = coeffs->m_d * d__meter + coeffs->A_ed__db;
+        dA_ref = coeffs->m_d;
+    }
+    if (!(A_ref__db > 0.0))
+        dA_ref = 0.0;
+    A_ref__db = std::max(A_ref__db, 0.0);
+
+    double A__db = FreeSpaceLoss(d__meter, problem.radio)
+        + Variability(
+            problem.p,
+            problem.delta_h__meter,
+            problem.radio,
+            d__meter,
+            A_ref__db
+        );
+
+    // [RLS, A-72 & B-70] and [RLS, A-73 & B-71].
+    double k = problem.radio->k;
+    double e = exp(-d__meter / IlmConstants::d_scale__meter);
+    double k_delta_h_d = k * problem.delta_h__meter * (1.0 - 0.8 * e);
+    double dsigma = 130.0 * k * problem.delta_h__meter * 0.8 * e / IlmConstants::d_scale__meter
+        / ((k_delta_h_d + 13.0) * (k_delta_h_d + 13.0));
+
+    // [Algorithm, Eqn 52].
+    double x = A_ref__db + 10.0 * k_delta_h_d / (k_delta_h_d + 13.0) * problem.z;
+    double dfold = 1.0;
+    if (x < 0.0)
+        dfold = ((29.0 - 2.0 * x) * (29.0 - 10.0 * x) + 10.0 * x * (29.0 - x)) / ((29.0 - 10.0 * x) * (29.0 - 10.0 * x));
+
+    // 20 / ln(10) = 8.685889638065037
+    *slope = 8.685889638065037 / d__meter + dfold * (dA_ref + dsigma * problem.z);
+
+    return A__db - problem.A__db;
+}
+
+/**
+@brief
+Return if the loss is at or above the threshold.
+*/
+static bool AtOrAbove(
+    double F__db
+) {
+    return !(F__db < 0.0);
+}
+
+/**
+@brief
+Solve for the distance at which the loss crosses the threshold between two
+distances of the same piece, on either side of it, with Newton's method kept
+within the bracket, and bisection where a step leaves it.
+
+@param[in] problem
+Inputs of the range.
+
+@param[in] line_of_sight
+Piece of the reference attenuation.
+
+@param[in] d_lo__meter
+Distance on one side of the crossing, in meters.
+
+@param[in] d_hi__meter
+Distance on the other side of the crossing, in meters.
+
+@return
+Distance of the crossing, in meters.
+
+*/
+static double SolveCrossing(
+    const RangeProblem &problem,
+    bool line_of_sight,
+    double d_lo__meter,
+    double d_hi__meter
+) {
+    double slope;
+    bool above_lo = AtOrAbove(RangeLoss(problem, line_of_sight, d_lo__meter, &slope));
+
+    double d__meter = 0.5 * (d_lo__meter + d_hi__meter);
+    for (int i = 0; i < RANGE__MAX_ITERATIONS; i++)
+    {
+        double F__db = RangeLoss(problem, line_of_sight, d__meter, &slope);
+
+        if (AtOrAbove(F__db) == above_lo)
+            d_lo__meter = d__meter;
+        else
+            d_hi__meter = d__meter;
+
+        double d_next__meter = d__meter - F__db / slope;
+
+        // Bisect when the step is not a number or leaves the bracket.
+        if (!(d_next__meter > std::min(d_lo__meter, d_hi__meter) && d_next__meter < std::max(d_lo__meter, d_hi__meter)))
+            d_next__meter = 0.5 * (d_lo__meter + d_hi__meter);
+
+        if (fabs(d_next__meter - d__meter) <= RANGE__TOLERANCE * d__meter ||
+            fabs(d_hi__meter - d_lo__meter) <= RANGE__TOLERANCE * d__meter)
+            return d_next__meter;
+
+        d__meter = d_next__meter;
+    }
+
+    return d__meter;
+}
+
+/**
+@brief
+Add a sample distance strictly between the ends of a piece, keeping the
+samples sorted.
+
+@param[in] d__meter
+Distance, in meters.
+
+@param[in,out] d_sample__meter
+Sample distances, in meters.
+
+@param[in,out] n_samples
+Number of sample distances.
+
+*/
+static void AddSample(
+    double d__meter,
+    double d_sample__meter[],
+    int *n_samples
+) {
+    if (!(d__meter > d_sample__meter[0] && d__meter < d_sample__meter[*n_samples - 1]) ||
+        *n_samples == RANGE__MAX_SAMPLES)
+        return;
+
+    int i = *n_samples;
+    for (; d_sample__meter[i - 1] > d__meter; i--)
+        d_sample__meter[i] = d_sample__meter[i - 1];
+    d_sample__meter[i] = d__meter;
+
+    (*n_samples)++;
+}
+
+/**
+@brief
+Add the distances at which the line-of-sight reference attenuation reaches
+zero, where the floor of the reference attenuation turns the loss, as
+samples. The fit has at most one turning point, at -kHat_2 / kHat_1, so it
+has at most one zero on each side of it, which is solved for with Newton's
+method kept within the bracket.
+
+@param[in] coeffs
+Longley-Rice coefficients.
+
+@param[in,out] d_sample__meter
+Sample distances, in meters.
+
+@param[in,out] n_samples
+Number of sample distances.
+
+*/
+static void AddLineOfSightZeros(
+    const LongleyRiceCoefficients *coeffs,
+    double d_sample__meter[],
+    int *n_samples
+) {
+    double d_bound__meter[3] = { d_sample__meter[0], d_sample__meter[*n_samples - 1], d_sample__meter[*n_samples - 1] };
+    double d_turn__meter = -coeffs->kHat_2 / coeffs->kHat_1;
+    if (d_turn__meter > d_bound__meter[0] && d_turn__meter < d_bound__meter[1])
+        d_bound__meter[1] = d_turn__meter;
+
+    for (int j = 0; j < 2; j++)
+    {
+        double d_lo__meter = d_bound__meter[j];
+        double d_hi__meter = d_bound__meter[j + 1];
+        double A_lo__db = coeffs->A_o__db + coeffs->kHat_1 * d_lo__meter + coeffs->kHat_2 * log(d_lo__meter);
+        double A_hi__db = coeffs->A_o__db + coeffs->kHat_1 * d_hi__meter + coeffs->kHat_2 * log(d_hi__meter);
+        if (!(d_lo__meter < d_hi__meter) || !((A_lo__db < 0.0) != (A_hi__db < 0.0)))
+            continue;
+
+        bool negative_lo = (A_lo__db < 0.0);
+        double d__meter = 0.5 * (d_lo__meter + d_hi__meter);
+        for (int i = 0; i < RANGE__MAX_ITERATIONS; i++)
+        {
+            double A_ref__db = coeffs->A_o__db + coeffs->kHat_1 * d__meter + coeffs->kHat_2 * log(d__meter);
+            if ((A_ref__db < 0.0) == negative_lo)
+                d_lo__meter = d__meter;
+            else
+                d_hi__meter = d__meter;
+
+            double d_next__meter = d__meter - A_ref__db / (coeffs->kHat_1 + coeffs->kHat_2 / d__meter);
+            if (!(d_next__meter > d_lo__meter && d_next__meter < d_hi__meter))
+                d_next__meter = 0.5 * (d_lo__meter + d_hi__meter);
+
+            bool done = fabs(d_next__meter - d__meter) <= RANGE__TOLERANCE * d__meter;
+            d__meter = d_next__meter;
+            if (done)
+                break;
+        }
+
+        AddSample(d__meter, d_sample__meter, n_samples);
+    }
+}
+
+/**
+@brief
+Look for a turning point of the loss between two distances of the same piece,
+on the same side of the threshold, that takes the loss across it, by
+bisection on the sign of the slope.
+
+@param[in] problem
+Inputs of the range.
+
+@param[in] line_of_sight
+Piece of the reference attenuation.
+
+@param[in] d_lo__meter
+Smaller distance, in meters.
+
+@param[in] d_hi__meter
+Larger distance, in meters.
+
+@param[in] above
+If the loss is at or above the threshold at both distances.
+
+@param[out] d_split__meter
+Distance between them at which the loss is on the other side of the
+threshold, in meters.
+
+@return
+True if such a distance is found.
+
+*/
+static bool SplitAtTurningPoint(
+    const RangeProblem &problem,
+    bool line_of_sight,
+    double d_lo__meter,
+    double d_hi__meter,
+    bool above,
+    double *d_split__meter
+) {
+    for (int i = 0; i < RANGE__MAX_ITERATIONS; i++)
+    {
+        double d__meter = 0.5 * (d_lo__meter + d_hi__meter);
+        double slope;
+        double F__db = RangeLoss(problem, line_of_sight, d__meter, &slope);
+
+        if (AtOrAbove(F__db) != above)
+        {
+            *d_split__meter = d__meter;
+            return true;
+        }
+
+        // Towards a maximum below the threshold, or a minimum above it.
+        if ((slope > 0.0) != above)
+            d_lo__meter = d__meter;
+        else
+            d_hi__meter = d__meter;
+
+        if (d_hi__meter - d_lo__meter <= RANGE__TOLERANCE * d_hi__meter)
+            break;
+    }
+
+    return false;
+}
+
+/**
+@brief
+Crossings of the threshold found so far.
+*/
+struct RangeCrossings
+{
+    /**
+    Size of the output arrays.
+    */
+    int n_max;
+
+    /**
+    Distances of the crossings, in meters.
+    */
+    double *d__meter;
+
+    /**
+    Directions of the crossings. May be NULL.
+    */
+    int *direction;
+
+    /**
+    Number of crossings stored.
+    */
+    int n;
+
+    /**
+    Smallest distance at which the loss is at or above the threshold, in
+    meters.
+    */
+    double d_range__meter;
+
+    /**
+    If the loss has been at or above the threshold.
+    */
+    bool reached;
+};
+
+/**
+@brief
+Add a crossing of the threshold.
+
+@param[in] d__meter
+Distance of the crossing, in meters.
+
+@param[in] above
+If the loss is at or above the threshold past the crossing.
+
+@param[in,out] crossings
+Crossings found so far.
+
+*/
+static void AddCrossing(
+    double d__meter,
+    bool above,
+    RangeCrossings *crossings
+) {
+    if (above && !crossings->reached)
+    {
+        crossings->d_range__meter = d__meter;
+        crossings->reached = true;
+    }
+
+    if (crossings->n < crossings->n_max)
+    {
+        crossings->d__meter[crossings->n] = d__meter;
+        if (crossings->direction != nullptr)
+            crossings->direction[crossings->n] = above ? 1 : -1;
+        crossings->n++;
+    }
+}
+
+/**
+@brief
+Find the distances at which the basic transmission loss of the area mode
+crosses a threshold, from Longley-Rice coefficients.
+
+The reference attenuation is the log-linear fit of line-of-sight below d_ls
+and the line of trans-horizon paths above it. With the free space loss, each
+piece has at most one turning point, where
+    kHat_1 * d + (kHat_2 + 20 / ln(10)) * ln(d)
+or
+    m_d * d + 20 / ln(10) * ln(d)
+is stationary. The loss is sampled at the ends of each piece, at these turning
+points, where the reference attenuation reaches zero, and at least every
+factor of two in distance, and each crossing between two samples is solved
+for with a few Newton iterations. Where the slope changes sign between two
+samples on the same side of the threshold, from the change of the
+variability with distance, the turning point is bisected for in case the
+loss crosses the threshold and back. A loss that is not finite at a sample
+stops the search, as the side of the threshold it is on is not known.
+
+@param[in] problem
+Inputs of the range.
+
+@param[in] d_min__meter
+Smallest path distance, in meters.
+
+@param[in] d_max__meter
+Largest path distance, in meters.
+
+@param[in,out] crossings
+Crossings, with the output arrays set.
+
+@return
+True if the loss is finite at every sample.
+
+*/
+static bool SolveRange(
+    const RangeProblem &problem,
+    double d_min__meter,
+    double d_max__meter,
+    RangeCrossings *crossings
+) {
+    const LongleyRiceCoefficients *coeffs = problem.coeffs;
+
+    crossings->n = 0;
+    crossings->d_range__meter = d_max__meter;
+    crossings->reached = false;
+
+    bool have_previous = false;
+    bool above_previous = false;
+
+    // Line-of-sight piece first, then the trans-horizon piece, as
+    // EvaluateLongleyRice() switches at d_ls.
+    for (int piece = 0; piece < 2; piece++)
+    {
+        bool line_of_sight = (piece == 0);
+
+        double d_sample__meter[RANGE__MAX_SAMPLES];
+        int n_samples = 2;
+        if (line_of_sight)
+        {
+            if (!(d_min__meter < coeffs->d_ls__meter))
+                continue;
+            d_sample__meter[0] = d_min__meter;
+            d_sample__meter[1] = std::min(d_max__meter, coeffs->d_ls__meter);
+
+            AddSample(-(coeffs->kHat_2 + 8.685889638065037) / coeffs->kHat_1, d_sample__meter, &n_samples);
+            AddLineOfSightZeros(coeffs, d_sample__meter, &n_samples);
+        }
+        else
+        {
+            if (!(coeffs->d_ls__meter <= d_max__meter))
+                continue;
+            d_sample__meter[0] = std::max(d_min__meter, coeffs->d_ls__meter);
+            d_sample__meter[1] = d_max__meter;
+
+            AddSample(-8.685889638065037 / coeffs->m_d, d_sample__meter, &n_samples);
+            AddSample(-coeffs->A_ed__db / coeffs->m_d, d_sample__meter, &n_samples);
+        }
+
+        for (double d_grid__meter = RANGE__SAMPLE_RATIO * d_sample__meter[0];
+            d_grid__meter < d_sample__meter[n_samples - 1] && n_samples < RANGE__MAX_SAMPLES;
+            d_grid__meter *= RANGE__SAMPLE_RATIO)
+            AddSample(d_grid__meter, d_sample__meter, &n_samples);
+
+        double slope_previous = 0.0;
+        for (int i = 0; i < n_samples; i++)
+        {
+            double slope;
+            double F__db = RangeLoss(problem, line_of_sight, d_sample__meter[i], &slope);
+            if (!std::isfinite(F__db))
+                return false;
+
+            bool above = AtOrAbove(F__db);
+            double d_split__meter;
+
+            if (!have_previous)
+            {
+                if (above)
+                {
+                    crossings->d_range__meter = d_sample__meter[i];
+                    crossings->reached = true;
+                }
+            }
+            else if (i == 0)
+            {
+                // Across d_ls, the loss steps at d_ls.
+                if (above != above_previous)
+                    AddCrossing(d_sample__meter[0], above, crossings);
+            }
+            else if (above != above_previous)
+            {
+                AddCrossing(SolveCrossing(problem, line_of_sight, d_sample__meter[i - 1], d_sample__meter[i]), above, crossings);
+            }
+            else if (((above ? slope_previous < 0.0 && slope > 0.0 : slope_previous > 0.0 && slope < 0.0)) &&
+                SplitAtTurningPoint(problem, line_of_sight, d_sample__meter[i - 1], d_sample__meter[i], above, &d_split__meter))
+            {
+                AddCrossing(SolveCrossing(problem, line_of_sight, d_sample__meter[i - 1], d_split__meter), !above, crossings);
+                AddCrossing(SolveCrossing(problem, line_of_sight, d_split__meter, d_sample__meter[i]), above, crossings);
+            }
+
+            have_previous = true;
+            above_previous = above;
+            slope_previous = slope;
+        }
+    }
+
+    return true;
+}
+
+/**
+@brief
+Copy the crossings out in km. The ends of the range are returned as given.
+
+@param[in] crossings
+Crossings, in meters.
+
+@param[in] d_min__km
+Smallest path distance, in km.
+
+@param[in] d_max__km
+Largest path distance, in km.
+
+@param[out] n_crossings
+Number of crossings.
+
+@param[out] d_range__km
+Smallest path distance at which the loss is at or above the threshold, in
+km.
+
+*/
+static void CopyCrossings(
+    const RangeCrossings &crossings,
+    double d_min__km,
+    double d_max__km,
+    int *n_crossings,
+    double *d_range__km
+) {
+    for (int i = 0; i < crossings.n; i++)
+        crossings.d__meter[i] /= 1000.0;
+    *n_crossings = crossings.n;
+
+    if (crossings.d_range__meter == d_min__km * 1000.0)
+        *d_range__km = d_min__km;
+    else if (crossings.d_range__meter == d_max__km * 1000.0)
+        *d_range__km = d_max__km;
+    else
+        *d_range__km = crossings.d_range__meter / 1000.0;
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-to-Area mode, solved for the path
+distances at which the basic transmission loss crosses a threshold.
+
+The Longley-Rice coefficients depend only on the terminals, siting, terrain
+irregularity, frequency and ground, so they are computed once, as in
+AreaCurve(), and the crossings are solved for on each piece of the reference
+attenuation, the log-linear fit of line-of-sight and the line beyond it. The
+loss at each crossing is that of Area() to within the tolerance of the
+distance. Where the loss is not finite at a distance the range is sampled at,
+ERROR__LOSS_NOT_FINITE is returned with no crossings.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] d_min__km
+Smallest path distance, in km.
+
+@param[in] d_max__km
+Largest path distance, in km, > d_min__km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[in] A__db
+Threshold of the basic transmission loss, in dB.
+
+@param[in] n_max
+Size of the output arrays.
+
+@param[out] d__km
+Path distances at which the loss crosses the threshold, in km, in
+increasing order.
+
+@param[out] direction
+Direction of each crossing: +1 where the loss rises to the threshold with
+distance, -1 where it falls below it. May be NULL.
+
+@param[out] n_crossings
+Number of crossings, at most n_max.
+
+@param[out] d_range__km
+Smallest path distance at which the loss is at or above the threshold, in
+km, or d_max__km if the loss stays below it.
+
+@param[out] warnings
+Warning flags, of the inputs and of the ends of the distance range.
+
+@return error
+Error code.
+
+*/
+int AreaRange(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    double d_min__km,
+    double d_max__km,
+    double delta_h__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double A__db,
+    int n_max,
+    double d__km[],
+    int direction[],
+    int *n_crossings,
+    double *d_range__km,
+    long *warnings
+) {
+    *warnings = NO_WARNINGS;
+    *n_crossings = 0;
+
+    // Initial input validation check.
+    // Some validation occurs later in calculations as well.
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    // Switch from percentages to ratios.
+    p /= 100;
+
+    // Additional area mode parameter validation checks.
+    if (!(d_min__km > 0) || !(d_max__km > d_min__km))
+        return ERROR__PATH_DISTANCE;
+    if (delta_h__meter < 0)
+        return ERROR__DELTA_H;
+    if (tx_site_criteria != SITING_CRITERIA__MOBILE &&
+        tx_site_criteria != SITING_CRITERIA__FIXED)
+        return ERROR__TX_SITING_CRITERIA;
+    if (rx_site_criteria != SITING_CRITERIA__MOBILE &&
+        rx_site_criteria != SITING_CRITERIA__FIXED)
+        return ERROR__RX_SITING_CRITERIA;
+
+    int site_criteria[2] = { tx_site_criteria, rx_site_criteria };
+    double h__meter[2] = { h_tx__meter, h_rx__meter };
+
+    double theta_hzn[2];
+    double d_hzn__meter[2];
+    double h_e__meter[2];
+    RadioContext radio;
+
+    InitializeRadioContext(
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &radio
+    );
+
+    InitializeArea(
+        site_criteria,
+        delta_h__meter,
+        h__meter,
+        h_e__meter,
+        d_hzn__meter,
+        theta_hzn
+    );
+
+    LongleyRiceCoefficients coeffs;
+    rtn = InitializeLongleyRice(
+        theta_hzn,
+        &radio,
+        d_hzn__meter,
+        h_e__meter,
+        delta_h__meter,
+        h__meter,
+        &coeffs,
+        warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    // The distance warnings only depend on thresholds of the distance, so
+    // those of the ends cover the range.
+    double A_ref__db;
+    int propmode;
+    EvaluateLongleyRice(&coeffs, d_min__km * 1000.0, &A_ref__db, warnings, &propmode);
+    EvaluateLongleyRice(&coeffs, d_max__km * 1000.0, &A_ref__db, warnings, &propmode);
+
+    RangeProblem problem;
+    problem.coeffs = &coeffs;
+    problem.radio = &radio;
+    problem.delta_h__meter = delta_h__meter;
+    problem.p = p;
+    problem.z = InverseComplementaryCumulativeDistributionFunction(p);
+    problem.A__db = A__db;
+
+    // The crossings are solved for in meters, in place.
+    RangeCrossings crossings;
+    crossings.n_max = n_max;
+    crossings.d__meter = d__km;
+    crossings.direction = direction;
+
+    if (!SolveRange(
+        problem,
+        d_min__km * 1000.0,
+        d_max__km * 1000.0,
+        &crossings
+    ))
+        return ERROR__LOSS_NOT_FINITE;
+
+    CopyCrossings(
+        crossings,
+        d_min__km,
+        d_max__km,
+        n_crossings,
+        d_range__km
+    );
+
+    if (*warnings != NO_WARNINGS)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
+
+/**
+@brief
+Solve for the path distances at which the basic transmission loss of the
+area mode crosses a threshold, from Longley-Rice coefficients computed with
+InitializeLongleyRice().
+
+The inputs are not validated. Where the loss is not finite at a distance the
+range is sampled at, ERROR__LOSS_NOT_FINITE is returned with no crossings.
+
+@param[in] coeffs
+Longley-Rice coefficients.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[in] A__db
+Threshold of the basic transmission loss, in dB.
+
+@param[in] d_min__km
+Smallest path distance, in km.
+
+@param[in] d_max__km
+Largest path distance, in km, > d_min__km.
+
+@param[in] n_max
+Size of the output arrays.
+
+@param[out] d__km
+Path distances at which the loss crosses the threshold, in km, in
+increasing order.
+
+@param[out] direction
+Direction of each crossing: +1 where the loss rises to the threshold with
+distance, -1 where it falls below it. May be NULL.
+
+@param[out] n_crossings
+Number of crossings, at most n_max.
+
+@param[out] d_range__km
+Smallest path distance at which the loss is at or above the threshold, in
+km, or d_max__km if the loss stays below it.
+
+@return error
+Error code.
+
+*/
+int SolveAreaRange(
+    const LongleyRiceCoefficients *coeffs,
+    double delta_h__meter,
+    double f__mhz,
+    double p,
+    double A__db,
+    double d_min__km,
+    double d_max__km,
+    int n_max,
+    double d__km[],
+    int direction[],
+    int *n_crossings,
+    double *d_range__km
+) {
+    // The variability does not depend on the ground.
+    RadioContext radio;
+    InitializeRadioContext(
+        f__mhz,
+        std::complex<double>(),
+        &radio
+    );
+
+    RangeProblem problem;
+    problem.coeffs = coeffs;
+    problem.radio = &radio;
+    problem.delta_h__meter = delta_h__meter;
+    problem.p = p / 100;
+    problem.z = InverseComplementaryCumulativeDistributionFunction(problem.p);
+    problem.A__db = A__db;
+
+    // The crossings are solved for in meters, in place.
+    RangeCrossings crossings;
+    crossings.n_max = n_max;
+    crossings.d__meter = d__km;
+    crossings.direction = direction;
+
+    *n_crossings = 0;
+    if (!SolveRange(
+        problem,
+        d_min__km * 1000.0,
+        d_max__km * 1000.0,
+        &crossings
+    ))
+        return ERROR__LOSS_NOT_FINITE;
+
+    CopyCrossings(
+        crossings,
+        d_min__km,
+        d_max__km,
+        n_crossings,
+        d_range__km
+    );
+
+    return SUCCESS;
+}
@@ -0,0 +1,688 @@
+/**
+@file
+
+This file contains the Coverage(), Coverage_Ws(), CoverageContext() and
+CoverageContext_Ws() functions.
+*/
+
+/* Standard includes. */
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Errors.h"
+#include "./include/Executor.h"
+#include "./include/ProfilePrefixes.h"
+#include "./include/TerrainGrid.h"
+#include "./include/Workspace.h"
+
+/**
+@brief
+Evaluate the coverage of one radial.
+
+The terrain is sampled once out to the last range step and every range step
+is then evaluated as a prefix of that profile.
+
+@param[in] grid
+Terrain grid.
+
+@param[in] x_tx__meter
+Projected x coordinate of the TX, in meters.
+
+@param[in] y_tx__meter
+Projected y coordinate of the TX, in meters.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in] phi__rad
+Azimuth of the radial, clockwise from the +y axis, in radians.
+
+@param[in] n_ranges
+Number of range steps.
+
+@param[in] n_step
+Number of terrain samples per range step.
+
+@param[in] xi__meter
+Terrain sample spacing, in meters.
+
+@param[in] radio
+Radio context.
+
+@param[in] p
+Location ratio, 0 < p < 1.
+
+@param[in] common_warnings
+Warning flags of the input validation.
+
+@param[in,out] pfl
+Terrain profile buffer, with n_ranges * n_step + 3 entries.
+
+@param[in,out] k
+Receiver sample index buffer, with n_ranges entries.
+
+@param[out] A__db
+Basic transmission loss at each range step, in dB.
+
+@param[out] warnings
+Warning flags at each range step.
+
+@param[out] errors
+Error code at each range step.
+
+*/
+static void CoverageRadial(
+    const TerrainGrid *grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h__meter[2],
+    double phi__rad,
+    int n_ranges,
+    int n_step,
+    double xi__meter,
+    const RadioContext *radio,
+    double p,
+    long common_warnings,
+    double pfl[],
+    int k[],
+    double A__db[],
+    long warnings[],
+    int errors[]
+) {
+    double dx = sin(phi__rad);
+    double dy = cos(phi__rad);
+
+    // The grid is convex, so the radial stays outside once it leaves it.
+    int np = n_ranges * n_step;
+    int i = 0;
+    for (; i <= np; i++)
+    {
+        double s__meter = i * xi__meter;
+
+        if (!SampleTerrainGrid(
+            grid,
+            x_tx__meter + s__meter * dx,
+            y_tx__meter + s__meter * dy,
+            &pfl[i + 2]))
+            break;
+    }
+
+    // Range steps with all their terrain within the grid.
+    int n_valid = (i - 1) / n_step;
+
+    for (int j = n_valid; j < n_ranges; j++)
+    {
+        warnings[j] = common_warnings;
+        errors[j] = ERROR__TERRAIN_EXTENT;
+    }
+
+    if (n_valid == 0)
+        return;
+
+    pfl[0] = n_valid * n_step;
+    pfl[1] = xi__meter;
+
+    for (int j = 0; j < n_valid; j++)
+        k[j] = (j + 1) * n_step;
+
+    PointToPointAtPrefixes(
+        pfl,
+        h__meter,
+        radio,
+        p,
+        common_warnings,
+        n_valid,
+        k,
+        A__db,
+        warnings,
+        errors,
+        nullptr
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) coverage mode.
+
+Each thread uses its own scratch memory. Coverage_Ws() takes an ILM_Workspace
+instead.
+
+Computes a polar raster of the basic transmission loss around a TX on a
+gridded terrain model, along n_radials radials evenly spaced in azimuth and at
+n_ranges range steps along each radial. Along a radial the terrain is sampled
+once, and each range step reuses the terrain samples, the TX horizon and the
+least squares fit sums of the steps before it. Each result agrees with
+PointToPoint() on the sampled terrain profile from the TX to that range step
+as PointToPointPrefixes() does: identical horizons, and fits that agree to
+within the rounding of the prefix sums.
+
+The terrain is sampled by bilinear interpolation at the largest spacing that
+divides the range step and is no larger than the grid spacing.
+
+@param[in] grid
+Terrain grid.
+
+@param[in] x_tx__meter
+Projected x coordinate of the TX, in meters.
+
+@param[in] y_tx__meter
+Projected y coordinate of the TX, in meters.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] n_radials
+Number of radials. Radial r has an azimuth of 360 * r / n_radials degrees,
+clockwise from the +y axis of the grid.
+
+@param[in] n_ranges
+Number of range steps along each radial. Range step j is at a distance of
+(j + 1) * d_step__meter from the TX.
+
+@param[in] d_step__meter
+Range step, in meters.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[in] n_threads
+Number of threads to evaluate the radials on, or 0 to use one per hardware
+thread.
+
+@param[out] A__db
+Basic transmission loss, in dB, of range step j on radial r at index
+r * n_ranges + j. Only set for cells without an error.
+
+@param[out] warnings
+Warning flags of each cell.
+
+@param[out] errors
+Error code of each cell. Cells whose terrain is not within the grid have
+ERROR__TERRAIN_EXTENT.
+
+@return error
+Error code, or ERROR__BATCH_ELEMENT if any cell returned an error.
+
+*/
+int Coverage(
+    const TerrainGrid *grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    int n_radials,
+    int n_ranges,
+    double d_step__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    int n_threads,
+    double A__db[],
+    long warnings[],
+    int errors[]
+) {
+    return Coverage_Ws(
+        grid,
+        x_tx__meter,
+        y_tx__meter,
+        h_tx__meter,
+        h_rx__meter,
+        n_radials,
+        n_ranges,
+        d_step__meter,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        p,
+        n_threads,
+        nullptr,
+        A__db,
+        warnings,
+        errors
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) coverage mode.
+
+Computes a polar raster of the basic transmission loss around a TX on a
+gridded terrain model, along n_radials radials evenly spaced in azimuth and at
+n_ranges range steps along each radial. Along a radial the terrain is sampled
+once, and each range step reuses the terrain samples, the TX horizon and the
+least squares fit sums of the steps before it. Each result agrees with
+PointToPoint() on the sampled terrain profile from the TX to that range step
+as PointToPointPrefixes() does: identical horizons, and fits that agree to
+within the rounding of the prefix sums.
+
+The terrain is sampled by bilinear interpolation at the largest spacing that
+divides the range step and is no larger than the grid spacing.
+
+@param[in] grid
+Terrain grid.
+
+@param[in] x_tx__meter
+Projected x coordinate of the TX, in meters.
+
+@param[in] y_tx__meter
+Projected y coordinate of the TX, in meters.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] n_radials
+Number of radials. Radial r has an azimuth of 360 * r / n_radials degrees,
+clockwise from the +y axis of the grid.
+
+@param[in] n_ranges
+Number of range steps along each radial. Range step j is at a distance of
+(j + 1) * d_step__meter from the TX.
+
+@param[in] d_step__meter
+Range step, in meters.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[in] n_threads
+Number of threads to evaluate the radials on, or 0 to use one per hardware
+thread.
+
+@param[in] workspace
+Scratch memory of the threads, from CreateWorkspace(), or NULL to use each
+thread's own. With a workspace the radials run on at most its number of
+threads.
+
+@param[out] A__db
+Basic transmission loss, in dB, of range step j on radial r at index
+r * n_ranges + j. Only set for cells without an error.
+
+@param[out] warnings
+Warning flags of each cell.
+
+@param[out] errors
+Error code of each cell. Cells whose terrain is not within the grid have
+ERROR__TERRAIN_EXTENT.
+
+@return error
+Error code, or ERROR__BATCH_ELEMENT if any cell returned an error.
+
+*/
+int Coverage_Ws(
+    const TerrainGrid *grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    int n_radials,
+    int n_ranges,
+    double d_step__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    int n_threads,
+    ILM_Workspace *workspace,
+    double A__db[],
+    long warnings[],
+    int errors[]
+) {
+    RadioContext radio;
+    InitializeRadioContext(
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &radio
+    );
+
+    return CoverageContext_Ws(
+        grid,
+        x_tx__meter,
+        y_tx__meter,
+        h_tx__meter,
+        h_rx__meter,
+        n_radials,
+        n_ranges,
+        d_step__meter,
+        &radio,
+        p,
+        n_threads,
+        workspace,
+        A__db,
+        warnings,
+        errors
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) coverage mode, with the radio parameters of a
+radio context.
+
+Each thread uses its own scratch memory. CoverageContext_Ws() takes an
+ILM_Workspace instead.
+
+Computes a polar raster of the basic transmission loss around a TX on a
+gridded terrain model, along n_radials radials evenly spaced in azimuth and at
+n_ranges range steps along each radial. Along a radial the terrain is sampled
+once, and each range step reuses the terrain samples, the TX horizon and the
+least squares fit sums of the steps before it. Each result agrees with
+PointToPoint() on the sampled terrain profile from the TX to that range step
+as PointToPointPrefixes() does: identical horizons, and fits that agree to
+within the rounding of the prefix sums.
+
+The terrain is sampled by bilinear interpolation at the largest spacing that
+divides the range step and is no larger than the grid spacing.
+
+The results are identical to Coverage() with the radio parameters the context
+was initialized with. A context with PRECISION__FAST evaluates the special
+functions with bounded error approximations, for screening.
+
+@param[in] grid
+Terrain grid.
+
+@param[in] x_tx__meter
+Projected x coordinate of the TX, in meters.
+
+@param[in] y_tx__meter
+Projected y coordinate of the TX, in meters.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] n_radials
+Number of radials. Radial r has an azimuth of 360 * r / n_radials degrees,
+clockwise from the +y axis of the grid.
+
+@param[in] n_ranges
+Number of range steps along each radial. Range step j is at a distance of
+(j + 1) * d_step__meter from the TX.
+
+@param[in] d_step__meter
+Range step, in meters.
+
+@param[in] radio
+Radio context, from InitializeRadioContext().
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[in] n_threads
+Number of threads to evaluate the radials on, or 0 to use one per hardware
+thread.
+
+@param[out] A__db
+Basic transmission loss, in dB, of range step j on radial r at index
+r * n_ranges + j. Only set for cells without an error.
+
+@param[out] warnings
+Warning flags of each cell.
+
+@param[out] errors
+Error code of each cell. Cells whose terrain is not within the grid have
+ERROR__TERRAIN_EXTENT.
+
+@return error
+Error code, or ERROR__BATCH_ELEMENT if any cell returned an error.
+
+*/
+int CoverageContext(
+    const TerrainGrid *grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    int n_radials,
+    int n_ranges,
+    double d_step__meter,
+    const RadioContext *radio,
+    double p,
+    int n_threads,
+    double A__db[],
+    long warnings[],
+    int errors[]
+) {
+    return CoverageContext_Ws(
+        grid,
+        x_tx__meter,
+        y_tx__meter,
+        h_tx__meter,
+        h_rx__meter,
+        n_radials,
+        n_ranges,
+        d_step__meter,
+        radio,
+        p,
+        n_threads,
+        nullptr,
+        A__db,
+        warnings,
+        errors
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) coverage mode, with the radio parameters of a
+radio context.
+
+Computes a polar raster of the basic transmission loss around a TX on a
+gridded terrain model, along n_radials radials evenly spaced in azimuth and at
+n_ranges range steps along each radial. Along a radial the terrain is sampled
+once, and each range step reuses the terrain samples, the TX horizon and the
+least squares fit sums of the steps before it. Each result agrees with
+PointToPoint() on the sampled terrain profile from the TX to that range step
+as PointToPointPrefixes() does: identical horizons, and fits that agree to
+within the rounding of the prefix sums.
+
+The terrain is sampled by bilinear interpolation at the largest spacing that
+divides the range step and is no larger than the grid spacing.
+
+The results are identical to Coverage() with the radio parameters the context
+was initialized with. A context with PRECISION__FAST evaluates the special
+functions with bounded error approximations, for screening.
+
+@param[in] grid
+Terrain grid.
+
+@param[in] x_tx__meter
+Projected x coordinate of the TX, in meters.
+
+@param[in] y_tx__meter
+Projected y coordinate of the TX, in meters.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] n_radials
+Number of radials. Radial r has an azimuth of 360 * r / n_radials degrees,
+clockwise from the +y axis of the grid.
+
+@param[in] n_ranges
+Number of range steps along each radial. Range step j is at a distance of
+(j + 1) * d_step__meter from the TX.
+
+@param[in] d_step__meter
+Range step, in meters.
+
+@param[in] radio
+Radio context, from InitializeRadioContext().
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[in] n_threads
+Number of threads to evaluate the radials on, or 0 to use one per hardware
+thread.
+
+@param[in] workspace
+Scratch memory of the threads, from CreateWorkspace(), or NULL to use each
+thread's own. With a workspace the radials run on at most its number of
+threads.
+
+@param[out] A__db
+Basic transmission loss, in dB, of range step j on radial r at index
+r * n_ranges + j. Only set for cells without an error.
+
+@param[out] warnings
+Warning flags of each cell.
+
+@param[out] errors
+Error code of each cell. Cells whose terrain is not within the grid have
+ERROR__TERRAIN_EXTENT.
+
+@return error
+Error code, or ERROR__BATCH_ELEMENT if any cell returned an error.
+
+*/
+int CoverageContext_Ws(
+    const TerrainGrid *grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    int n_radials,
+    int n_ranges,
+    double d_step__meter,
+    const RadioContext *radio,
+    double p,
+    int n_threads,
+    ILM_Workspace *workspace,
+    double A__db[],
+    long warnings[],
+    int errors[]
+) {
+    long common_warnings = NO_WARNINGS;
+
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p,
+        radio->f__mhz,
+        radio->pol,
+        radio->epsilon,
+        radio->sigma,
+        &common_warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    if (!(d_step__meter > 0.0))
+        return ERROR__PATH_DISTANCE;
+
+    double z_tx__meter;
+    if (grid->n_x < 2 || grid->n_y < 2 ||
+        !SampleTerrainGrid(grid, x_tx__meter, y_tx__meter, &z_tx__meter))
+        return ERROR__TERRAIN_EXTENT;
+
+    if (n_radials < 1 || n_ranges < 1)
+        return SUCCESS;
+
+    double h__meter[2] = { h_tx__meter, h_rx__meter };
+
+    // Terrain sample spacing.
+    double spacing__meter = std::min(fabs(grid->dx__meter), fabs(grid->dy__meter));
+    int n_step = std::max(1, int(ceil(d_step__meter / spacing__meter)));
+    double xi__meter = d_step__meter / n_step;
+
+    n_threads = WorkspaceThreads(workspace, n_threads);
+
+    ParallelFor(n_radials, nullptr, n_threads, [&](int r) {
+        WorkspaceBinding binding(workspace);
+        WorkspaceArena *arena = &CurrentWorkspace()->arena;
+        ArenaScope scope(arena);
+
+        double *pfl = ArenaArray<double>(arena, (size_t)n_ranges * n_step + 3);
+        int *k = ArenaArray<int>(arena, n_ranges);
+
+        size_t offset = (size_t)r * n_ranges;
+
+        CoverageRadial(
+            grid,
+            x_tx__meter,
+            y_tx__meter,
+            h__meter,
+            2.0 * M_PI * r / n_radials,
+            n_ranges,
+            n_step,
+            xi__meter,
+            radio,
+            p / 100.0,
+            common_warnings,
+            pfl,
+            k,
+            &A__db[offset],
+            &warnings[offset],
+            &errors[offset]
+        );
+    });
+
+    bool any_error = false;
+    bool any_warnings = false;
+
+    for (size_t i = 0; i < (size_t)n_radials * n_ranges; i++)
+    {
+        if (errors[i] != SUCCESS && errors[i] != SUCCESS_WITH_WARNINGS)
+            any_error = true;
+        else if (warnings[i] != NO_WARNINGS)
+            any_warnings = true;
+    }
+
+    if (any_error)
+        return ERROR__BATCH_ELEMENT;
+
+    if (any_warnings)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
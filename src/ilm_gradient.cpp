@@ -0,0 +1,746 @@
+/**
+@file
+
+This file contains the PointToPoint_Grad() and Area_Grad() functions.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Dual.h"
+#include "./include/Engine.h"
+#include "./include/Enums.h"
+#include "./include/Errors.h"
+#include "./include/Internal.h"
+
+/**
+@brief
+Index of the derivative with respect to the structural height of the TX.
+*/
+#define GRAD__H_TX 0
+
+/**
+@brief
+Index of the derivative with respect to the structural height of the RX.
+*/
+#define GRAD__H_RX 1
+
+/**
+@brief
+Index of the derivative with respect to the frequency.
+*/
+#define GRAD__F 2
+
+/**
+@brief
+Index of the derivative with respect to the path distance.
+*/
+#define GRAD__D 3
+
+/**
+@brief
+Dual number of the basic transmission loss and its partial derivatives.
+*/
+typedef Dual<4> GradientDual;
+
+/**
+@brief
+Copy the basic transmission loss and its partial derivatives.
+
+@param[in] A
+Basic transmission loss, in dB, with its partial derivatives.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@param[out] grad
+Partial derivatives of the basic transmission loss.
+
+*/
+static void CopyGradient(
+    const GradientDual &A,
+    double *A__db,
+    LossGradient *grad
+) {
+    *A__db = A.value;
+    grad->dA_dh_tx__db_per_meter = A.deriv[GRAD__H_TX];
+    grad->dA_dh_rx__db_per_meter = A.deriv[GRAD__H_RX];
+    grad->dA_df__db_per_mhz = A.deriv[GRAD__F];
+    grad->dA_dd__db_per_km = A.deriv[GRAD__D];
+}
+
+/**
+@brief
+Compute the terminals' radio horizon angles and distances, as FindHorizons()
+does, with the derivatives of the terminal heights and of the terrain
+resolution.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in] xi__meter
+Terrain resolution, in meters.
+
+@param[out] theta_hzn
+Terminal radio horizon angles.
+
+@param[out] d_hzn__meter
+Terminal radio horizon distances, in meters.
+
+*/
+static void FindHorizonsGrad(
+    const double pfl[],
+    const GradientDual h__meter[2],
+    GradientDual xi__meter,
+    GradientDual theta_hzn[2],
+    GradientDual d_hzn__meter[2]
+) {
+    int np = (int)pfl[0];
+
+    GradientDual d__meter = GradientDual(pfl[0]) * xi__meter;
+    GradientDual two_a_m__meter = GradientDual(2.0) * GradientDual(a_m__meter);
+
+    GradientDual z_tx__meter = GradientDual(pfl[2]) + h__meter[0];
+    GradientDual z_rx__meter = GradientDual(pfl[np + 2]) + h__meter[1];
+
+    theta_hzn[0] = (z_rx__meter - z_tx__meter) / d__meter - d__meter / two_a_m__meter;
+    theta_hzn[1] = -(z_rx__meter - z_tx__meter) / d__meter - d__meter / two_a_m__meter;
+
+    d_hzn__meter[0] = d__meter;
+    d_hzn__meter[1] = d__meter;
+
+    GradientDual d_tx__meter = GradientDual(0.0);
+    GradientDual d_rx__meter = d__meter;
+
+    for (int i = 1; i < np; i++)
+    {
+        d_tx__meter = d_tx__meter + xi__meter;
+        d_rx__meter = d_rx__meter - xi__meter;
+
+        GradientDual z__meter = GradientDual(pfl[i + 2]);
+
+        GradientDual theta_tx = (z__meter - z_tx__meter) / d_tx__meter - d_tx__meter / two_a_m__meter;
+        GradientDual theta_rx = -(z_rx__meter - z__meter) / d_rx__meter - d_rx__meter / two_a_m__meter;
+
+        if (theta_tx > theta_hzn[0])
+        {
+            theta_hzn[0] = theta_tx;
+            d_hzn__meter[0] = d_tx__meter;
+        }
+
+        if (theta_rx > theta_hzn[1])
+        {
+            theta_hzn[1] = theta_rx;
+            d_hzn__meter[1] = d_rx__meter;
+        }
+    }
+}
+
+/**
+@brief
+Perform a linear least squares fit over all of the samples of the terrain
+irregularity, as LinearLeastSquaresFit() does, with their derivatives.
+
+@param[in] z__meter
+Samples.
+
+@param[in] np
+Number of intervals between the samples.
+
+@param[out] fit_y1
+Fitted value at the first sample.
+
+@param[out] fit_y2
+Fitted value at the last sample.
+
+*/
+static void FitSamplesGrad(
+    const GradientDual z__meter[],
+    int np,
+    GradientDual *fit_y1,
+    GradientDual *fit_y2
+) {
+    double x_length = np;
+
+    double mid_shifted_index = -0.5 * x_length;
+    double mid_shifted_end = np + mid_shifted_index;
+
+    GradientDual sum_y = GradientDual(0.5) * (z__meter[0] + z__meter[np]);
+    GradientDual scaled_sum_y = GradientDual(0.5) * (z__meter[0] - z__meter[np]) * GradientDual(mid_shifted_index);
+
+    int i_start = 0;
+    for (int i = 2; i <= x_length; i++)
+    {
+        i_start++;
+        mid_shifted_index++;
+
+        sum_y = sum_y + z__meter[i_start];
+        scaled_sum_y = scaled_sum_y + z__meter[i_start] * GradientDual(mid_shifted_index);
+    }
+
+    sum_y = sum_y / GradientDual(x_length);
+    scaled_sum_y = scaled_sum_y * GradientDual(12.0) / GradientDual((x_length * x_length + 2.0) * x_length);
+
+    *fit_y1 = sum_y - scaled_sum_y * GradientDual(mid_shifted_end);
+    *fit_y2 = sum_y + scaled_sum_y * GradientDual(np - mid_shifted_end);
+}
+
+/**
+@brief
+Compute the terrain irregularity parameter, as ComputeDeltaH() does, with the
+derivatives of the window and of the terrain resolution.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] xi__meter
+Terrain resolution, in meters.
+
+@param[in] d_start__meter
+Distance into the terrain profile to start considering data, in meters.
+
+@param[in] d_end__meter
+Distance into the terrain profile to end considering data, in meters.
+
+@return delta_h__meter
+Terrain irregularity parameter, in meters.
+
+*/
+static GradientDual ComputeDeltaHGrad(
+    const double pfl[],
+    GradientDual xi__meter,
+    GradientDual d_start__meter,
+    GradientDual d_end__meter
+) {
+    // Temp terrain samples, as the pfl data array of ComputeDeltaH().
+    GradientDual s[245];
+
+    int np = (int)pfl[0];
+
+    GradientDual x_start = d_start__meter / xi__meter;
+    GradientDual x_end = d_end__meter / xi__meter;
+
+    // If there are less than 2 terrain points, return delta_h = 0.
+    if (x_end - x_start < GradientDual(2.0))
+        return GradientDual(0.0);
+
+    int p10 = (int)(GradientDual(0.1) * (x_end - x_start + GradientDual(8.0)));
+    p10 = std::min(std::max(4, p10), 25);
+
+    int n = 10 * p10 - 5;
+    int p90 = n - p10;
+
+    double np_s = n - 1;
+
+    x_end = (x_end - x_start) / GradientDual(np_s);
+    int i = (int)x_start;
+    x_start = x_start - GradientDual(float(i + 1.0));
+
+    for (int j = 0; j < n; j++)
+    {
+        while (x_start > GradientDual(0.0) && (i + 1) < np)
+        {
+            x_start = x_start - GradientDual(1.0);
+            i++;
+        }
+
+        s[j] = GradientDual(pfl[i + 3]) + GradientDual(pfl[i + 3] - pfl[i + 2]) * x_start;
+
+        x_start = x_start + x_end;
+    }
+
+    GradientDual fit_y1;
+    GradientDual fit_y2;
+    FitSamplesGrad(
+        s,
+        n - 1,
+        &fit_y1,
+        &fit_y2
+    );
+    fit_y2 = (fit_y2 - fit_y1) / GradientDual(np_s);
+
+    GradientDual diffs[10 * 25 - 5];
+
+    for (int j = 0; j < n; j++)
+    {
+        diffs[j] = s[j] - fit_y1;
+        fit_y1 = fit_y1 + fit_y2;
+    }
+
+    std::nth_element(
+        diffs,
+        diffs + p10 - 1,
+        diffs + n,
+        std::greater<GradientDual>()
+    );
+    GradientDual q10 = diffs[p10 - 1];
+
+    std::nth_element(
+        diffs,
+        diffs + p90,
+        diffs + n,
+        std::greater<GradientDual>()
+    );
+    GradientDual q90 = diffs[p90];
+
+    GradientDual delta_h_d__meter = q10 - q90;
+
+    // [ERL 79-ITS 67, Eqn 3], inverted.
+    return delta_h_d__meter / (GradientDual(1.0) - GradientDual(0.8) * exp(-(d_end__meter - d_start__meter) / GradientDual(50.0E3)));
+}
+
+/**
+@brief
+Prepare a Point-To-Point path, as PreparePath() does, with the derivatives of
+the terminal heights and of the path distance.
+
+The path distance is the length of the terrain profile, so its derivative is
+taken by stretching the profile, through the terrain resolution. The least
+squares fits of the terminal windows are piecewise constant in the inputs, as
+the windows are whole terrain intervals, so they are taken as constants.
+
+@param[in] h__meter
+Terminal structural heights, in meters.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[out] path
+Terrain parameters of the path.
+
+*/
+void PreparePathGrad(
+    const GradientDual h__meter[2],
+    double pfl[],
+    EnginePath<GradientDual> *path
+) {
+    int np = (int)pfl[0];
+
+    // d__km = np * xi / 1000.
+    GradientDual xi__meter = GradientDual(pfl[1]);
+    xi__meter.deriv[GRAD__D] = 1000.0 / pfl[0];
+
+    path->h__meter[0] = h__meter[0];
+    path->h__meter[1] = h__meter[1];
+
+    path->d__km = (GradientDual(pfl[0]) * xi__meter) / GradientDual(1000.0);
+
+    GradientDual *theta_hzn = path->theta_hzn;
+    GradientDual *d_hzn__meter = path->d_hzn__meter;
+    GradientDual *h_e__meter = path->h_e__meter;
+
+    FindHorizonsGrad(
+        pfl,
+        h__meter,
+        xi__meter,
+        theta_hzn,
+        d_hzn__meter
+    );
+
+    GradientDual d__meter = GradientDual(pfl[0]) * xi__meter;
+    path->d__meter = d__meter;
+
+    // Take lesser: 10% of horizon distance or 15x terminal height.
+    GradientDual d_start__meter = std::min(GradientDual(15.0) * h__meter[0], GradientDual(0.1) * d_hzn__meter[0]);
+
+    // Same, but measured from the far end of the link.
+    GradientDual d_end__meter = d__meter - std::min(GradientDual(15.0) * h__meter[1], GradientDual(0.1) * d_hzn__meter[1]);
+
+    GradientDual delta_h__meter = ComputeDeltaHGrad(
+        pfl,
+        xi__meter,
+        d_start__meter,
+        d_end__meter
+    );
+    path->delta_h__meter = delta_h__meter;
+
+    double fit_tx;
+    double fit_rx;
+
+    if (d_hzn__meter[0] + d_hzn__meter[1] > GradientDual(1.5) * d__meter)
+    {
+        LinearLeastSquaresFit(
+            pfl,
+            d_start__meter.value,
+            d_end__meter.value,
+            &fit_tx,
+            &fit_rx
+        );
+
+        h_e__meter[0] = h__meter[0] + GradientDual(fdim(pfl[2], fit_tx));
+        h_e__meter[1] = h__meter[1] + GradientDual(fdim(pfl[np + 2], fit_rx));
+
+        for (int i = 0; i < 2; i++)
+            d_hzn__meter[i] = sqrt(GradientDual(2.0) * h_e__meter[i] * GradientDual(a_m__meter)) * exp(GradientDual(-0.07) * sqrt(delta_h__meter / std::max(h_e__meter[i], GradientDual(5.0))));
+
+        GradientDual combined_horizons__meter = d_hzn__meter[0] + d_hzn__meter[1];
+        if (combined_horizons__meter <= d__meter)
+        {
+            GradientDual q = pow(d__meter / combined_horizons__meter, 2);
+
+            for (int i = 0; i < 2; i++)
+            {
+                h_e__meter[i] = h_e__meter[i] * q;
+                d_hzn__meter[i] = sqrt(GradientDual(2.0) * h_e__meter[i] * GradientDual(a_m__meter)) * exp(GradientDual(-0.07) * sqrt(delta_h__meter / std::max(h_e__meter[i], GradientDual(5.0))));
+            }
+        }
+
+        for (int i = 0; i < 2; i++)
+        {
+            GradientDual q = sqrt(GradientDual(2.0) * h_e__meter[i] * GradientDual(a_m__meter));
+            theta_hzn[i] = (GradientDual(0.65) * delta_h__meter * (q / d_hzn__meter[i] - GradientDual(1.0)) - GradientDual(2.0) * h_e__meter[i]) / q;
+        }
+    }
+    else
+    {
+        double d_fit_start__meter[2] = { d_start__meter.value, d__meter.value - 0.9 * d_hzn__meter[1].value };
+        double d_fit_end__meter[2] = { 0.9 * d_hzn__meter[0].value, d_end__meter.value };
+        double fit_y1[2];
+        double fit_y2[2];
+
+        DualLinearLeastSquaresFit(
+            pfl,
+            d_fit_start__meter,
+            d_fit_end__meter,
+            fit_y1,
+            fit_y2
+        );
+        fit_tx = fit_y1[0];
+        fit_rx = fit_y2[1];
+
+        h_e__meter[0] = h__meter[0] + GradientDual(fdim(pfl[2], fit_tx));
+        h_e__meter[1] = h__meter[1] + GradientDual(fdim(pfl[np + 2], fit_rx));
+    }
+}
+
+/**
+@brief
+The ILM Point-To-Point mode, with the partial derivatives of the basic
+transmission loss with respect to the terminal heights, the frequency and the
+path distance.
+
+The model is evaluated once with dual numbers, which carry the derivatives
+through the terrain analysis and the Longley-Rice method, so the gradient
+costs about one evaluation. The basic transmission loss is identical to
+PointToPoint(). The path distance is the length of the terrain profile, so its
+derivative is that of the profile stretched to a longer path.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@param[out] grad
+Partial derivatives of the basic transmission loss.
+
+@param[out] warnings
+Warning flags.
+
+@return error
+Error code.
+
+*/
+int PointToPoint_Grad(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double *A__db,
+    LossGradient *grad,
+    long *warnings
+) {
+    // Initialize to no warnings.
+    *warnings = NO_WARNINGS;
+
+    // Validate before the terrain analysis, which assumes valid heights.
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    GradientDual h__meter[2] = {
+        GradientDual::Input(h_tx__meter, GRAD__H_TX),
+        GradientDual::Input(h_rx__meter, GRAD__H_RX)
+    };
+
+    EnginePath<GradientDual> path;
+    PreparePathGrad(
+        h__meter,
+        pfl,
+        &path
+    );
+
+    GradientDual f = GradientDual::Input(f__mhz, GRAD__F);
+    GradientDual p_dual = GradientDual(p);
+    GradientDual A;
+    EngineIntermediateValues<GradientDual> interValues;
+
+    if (pol == POLARIZATION__HORIZONTAL)
+        rtn = IlmEngine<GradientDual, HorizontalPolarization>::PointToPoint(
+            path,
+            f,
+            GradientDual(epsilon),
+            GradientDual(sigma),
+            1,
+            &p_dual,
+            &A,
+            warnings,
+            &interValues
+        );
+    else
+        rtn = IlmEngine<GradientDual, VerticalPolarization>::PointToPoint(
+            path,
+            f,
+            GradientDual(epsilon),
+            GradientDual(sigma),
+            1,
+            &p_dual,
+            &A,
+            warnings,
+            &interValues
+        );
+    if (rtn != SUCCESS && rtn != SUCCESS_WITH_WARNINGS)
+        return rtn;
+
+    CopyGradient(A, A__db, grad);
+
+    return rtn;
+}
+
+/**
+@brief
+Evaluate the ILM Point-to-Area mode with dual numbers, for a polarization
+and the siting criteria of the terminals.
+
+The inputs are not validated, other than by the engine.
+
+@return error
+Error code.
+
+*/
+template <typename Polarization, typename TxSiting, typename RxSiting>
+static int AreaGrad(
+    double h_tx__meter,
+    double h_rx__meter,
+    double d__km,
+    double delta_h__meter,
+    double f__mhz,
+    double epsilon,
+    double sigma,
+    double p,
+    GradientDual *A,
+    long *warnings
+) {
+    GradientDual p_dual = GradientDual(p);
+    EngineIntermediateValues<GradientDual> interValues;
+
+    return IlmEngine<GradientDual, Polarization>::template Area<TxSiting, RxSiting>(
+        GradientDual::Input(h_tx__meter, GRAD__H_TX),
+        GradientDual::Input(h_rx__meter, GRAD__H_RX),
+        GradientDual::Input(d__km, GRAD__D),
+        GradientDual(delta_h__meter),
+        GradientDual::Input(f__mhz, GRAD__F),
+        GradientDual(epsilon),
+        GradientDual(sigma),
+        1,
+        &p_dual,
+        A,
+        warnings,
+        &interValues
+    );
+}
+
+/**
+@brief
+AreaGrad() for each polarization, TX siting criteria and RX siting criteria.
+*/
+typedef int (*AreaGradFunction)(double, double, double, double, double, double, double, double, GradientDual *, long *);
+
+static const AreaGradFunction AREA_GRAD[2][2][2] = {
+    // POLARIZATION__HORIZONTAL
+    {
+        { AreaGrad<HorizontalPolarization, MobileSiting, MobileSiting>, AreaGrad<HorizontalPolarization, MobileSiting, FixedSiting> },
+        { AreaGrad<HorizontalPolarization, FixedSiting, MobileSiting>, AreaGrad<HorizontalPolarization, FixedSiting, FixedSiting> }
+    },
+    // POLARIZATION__VERTICAL
+    {
+        { AreaGrad<VerticalPolarization, MobileSiting, MobileSiting>, AreaGrad<VerticalPolarization, MobileSiting, FixedSiting> },
+        { AreaGrad<VerticalPolarization, FixedSiting, MobileSiting>, AreaGrad<VerticalPolarization, FixedSiting, FixedSiting> }
+    }
+};
+
+/**
+@brief
+The ILM Point-to-Area mode, with the partial derivatives of the basic
+transmission loss with respect to the terminal heights, the frequency and the
+path distance.
+
+The model is evaluated once with dual numbers, which carry the derivatives
+through the terminal estimates and the Longley-Rice method, so the gradient
+costs about one evaluation. The basic transmission loss is identical to
+Area().
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] tx_site_criteria
+Siting criteria of the TX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] rx_site_criteria
+Siting criteria of the RX.
+Either:
+    0: SITING_CRITERIA__MOBILE
+    1: SITING_CRITERIA__FIXED
+
+@param[in] d__km
+Path distance, in km.
+
+@param[in] delta_h__meter
+Terrain irregularity parameter.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@param[out] grad
+Partial derivatives of the basic transmission loss.
+
+@param[out] warnings
+Warning flags.
+
+@return error
+Error code.
+
+*/
+int Area_Grad(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    double d__km,
+    double delta_h__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double *A__db,
+    LossGradient *grad,
+    long *warnings
+) {
+    *warnings = NO_WARNINGS;
+
+    // Validate in the same order as Area().
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    PreparedPath path;
+    rtn = PrepareArea(
+        h_tx__meter,
+        h_rx__meter,
+        tx_site_criteria,
+        rx_site_criteria,
+        d__km,
+        delta_h__meter,
+        &path
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    GradientDual A;
+    rtn = AREA_GRAD[pol][tx_site_criteria][rx_site_criteria](
+        h_tx__meter,
+        h_rx__meter,
+        d__km,
+        delta_h__meter,
+        f__mhz,
+        epsilon,
+        sigma,
+        p,
+        &A,
+        warnings
+    );
+    if (rtn != SUCCESS && rtn != SUCCESS_WITH_WARNINGS)
+        return rtn;
+
+    CopyGradient(A, A__db, grad);
+
+    return rtn;
+}
@@ -1,7 +1,9 @@
 /**
 @file
 
-This file contains the PointToPoint() and PointToPoint_Ex() functions.
+This file contains the PointToPoint(), PointToPoint_Ex(),
+PointToPointView_Ex(), PointToPointCompact_Ex(),
+PointToPointPercentiles_Ex() and PointToPointContext_Ex() functions.
 */
 
 /* Standard includes. */
@@ -139,24 +141,87 @@ int PointToPoint_Ex(
     long *warnings,
     IntermediateValues *interValues
 ) {
-    // Terrain irregularity parameter.
-    double delta_h__meter;
-    // Path distance, in meters.
-    double d__meter;
-    // Ground impedance.
-    std::complex<double> Z_g;
-    // Terminal horizon angles.
-    double theta_hzn[2];
-    // Terminal horizon distances.
-    double d_hzn__meter[2];
-    // Terminal effective heights.
-    double h_e__meter[2];
+    return PointToPointPercentiles_Ex(
+        h_tx__meter,
+        h_rx__meter,
+        pfl,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        1,
+        &p,
+        A__db,
+        warnings,
+        interValues
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, for a terrain profile
+stored in place, such as a row or column of a DEM.
+
+The results are identical to PointToPoint_Ex() on the same profile in pfl
+format, without copying the terrain into a pfl buffer.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
 
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] view
+View of the terrain.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int PointToPointView_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    const TerrainView *view,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double *A__db,
+    long *warnings,
+    IntermediateValues *interValues
+) {
     // Initialize to no warnings.
     *warnings = NO_WARNINGS;
 
-    // Initial input validation check.
-    // Some validation occurs later in calculations.
+    // Validate before the terrain analysis, which assumes valid heights.
     int rtn = ValidateInputs(
         h_tx__meter,
         h_rx__meter,
@@ -170,90 +235,323 @@ int PointToPoint_Ex(
     if (rtn != SUCCESS)
         return rtn;
 
-    interValues->d__km = (pfl[0] * pfl[1]) / 1000.0;
+    PreparedPath path;
+    PreparePathView(
+        h_tx__meter,
+        h_rx__meter,
+        view,
+        &path
+    );
+
+    return PointToPointPreparedPercentiles_Ex(
+        &path,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        1,
+        &p,
+        A__db,
+        warnings,
+        interValues
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, for a terrain profile in
+a compact encoding, such as 16 bit integers at decimeter scale.
+
+Elevations are widened to double precision as they are read, so the results
+are identical to PointToPoint_Ex() on the widened profile in pfl format.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] view
+View of the terrain.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
 
-    // Number of points in the pfl.
-    int np = int(pfl[0]);
+@param[in] epsilon
+Relative permittivity.
 
-    p /= 100.0;
+@param[in] sigma
+Conductivity.
 
-    /* Compute the average path height, ignoring first and last 10%. */
-    // 10% of np
-    int p10 = int(0.1 * np);
-    // Height of the system above mean sea level.
-    double h_sys__meter = 0.0;
+@param[in] p
+Location percentage, 0 < p < 100.
 
-    for (int i = p10; i <= np - p10; i++)
-        h_sys__meter += pfl[i + 2];
+@param[out] A__db
+Basic transmission loss, in dB.
 
-    h_sys__meter = h_sys__meter / (np - 2 * p10 + 1);
+@param[out] warnings
+Warning flags.
 
-    InitializePointToPoint(
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int PointToPointCompact_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    const CompactTerrainView *view,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double *A__db,
+    long *warnings,
+    IntermediateValues *interValues
+) {
+    // Initialize to no warnings.
+    *warnings = NO_WARNINGS;
+
+    if (view->encoding != TERRAIN_ENCODING__INT16 &&
+        view->encoding != TERRAIN_ENCODING__FLOAT32)
+        return ERROR__TERRAIN_ENCODING;
+
+    // Validate before the terrain analysis, which assumes valid heights.
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p,
         f__mhz,
         pol,
         epsilon,
         sigma,
-        &Z_g
+        warnings
     );
+    if (rtn != SUCCESS)
+        return rtn;
 
-    double h__meter[2] = { h_tx__meter, h_rx__meter };
-    QuickPfl(
-        pfl,
-        h__meter,
-        theta_hzn,
-        d_hzn__meter,
-        h_e__meter,
-        &delta_h__meter,
-        &d__meter
+    PreparedPath path;
+    PreparePathCompact(
+        h_tx__meter,
+        h_rx__meter,
+        view,
+        &path
     );
 
-    // Reference attenuation, in dB.
-    double A_ref__db = 0.0;
-    int propmode = MODE__NOT_SET;
-    rtn = LongleyRice(
-        theta_hzn,
+    return PointToPointPreparedPercentiles_Ex(
+        &path,
         f__mhz,
-        Z_g,
-        d_hzn__meter,
-        h_e__meter,
-        delta_h__meter,
-        h__meter,
-        d__meter,
-        &A_ref__db,
+        pol,
+        epsilon,
+        sigma,
+        1,
+        &p,
+        A__db,
         warnings,
-        &propmode
+        interValues
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for an array of
+location percentages.
+
+The terrain analysis and the reference attenuation do not depend on the
+location percentage, so they are computed once and only the variability is
+evaluated for each percentage. The results are identical to calling
+PointToPoint_Ex() for each percentage.
+
+This is PreparePath() followed by PointToPointPreparedPercentiles_Ex().
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] n_p
+Number of location percentages.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss at each location percentage, in dB.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int PointToPointPercentiles_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    int n_p,
+    double p[],
+    double *A__db,
+    long *warnings,
+    IntermediateValues *interValues
+) {
+    // Initialize to no warnings.
+    *warnings = NO_WARNINGS;
+
+    if (n_p < 1)
+        return ERROR__INVALID_PERCENTAGE;
+
+    // Validate before the terrain analysis, which assumes valid heights.
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p[0],
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        warnings
     );
     if (rtn != SUCCESS)
         return rtn;
 
-    double A_fs__db = FreeSpaceLoss(
-        d__meter,
-        f__mhz
+    PreparedPath path;
+    PreparePath(
+        h_tx__meter,
+        h_rx__meter,
+        pfl,
+        &path
     );
 
-    *A__db = A_fs__db
-        + Variability(
-            p,
-            delta_h__meter,
-            f__mhz,
-            d__meter,
-            A_ref__db
-        );
-
-    // Save intermediate values.
-    interValues->A_ref__db = A_ref__db;
-    interValues->A_fs__db = A_fs__db;
-    interValues->delta_h__meter = delta_h__meter;
-    interValues->d_hzn__meter[0] = d_hzn__meter[0];
-    interValues->d_hzn__meter[1] = d_hzn__meter[1];
-    interValues->h_e__meter[0] = h_e__meter[0];
-    interValues->h_e__meter[1] = h_e__meter[1];
-    interValues->theta_hzn[0] = theta_hzn[0];
-    interValues->theta_hzn[1] = theta_hzn[1];
-    interValues->mode = propmode;
-
-    if (*warnings != NO_WARNINGS)
-        return SUCCESS_WITH_WARNINGS;
-
-    return SUCCESS;
+    return PointToPointPreparedPercentiles_Ex(
+        &path,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        n_p,
+        p,
+        A__db,
+        warnings,
+        interValues
+    );
 };
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, with the radio parameters
+of a radio context.
+
+Paths that share a frequency, polarization and ground can be evaluated with one
+context, without recomputing the constants derived from them for each path.
+The results are identical to PointToPoint_Ex() with the radio parameters the
+context was initialized with.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] radio
+Radio context, from InitializeRadioContext().
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int PointToPointContext_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    const RadioContext *radio,
+    double p,
+    double *A__db,
+    long *warnings,
+    IntermediateValues *interValues
+) {
+    // Initialize to no warnings.
+    *warnings = NO_WARNINGS;
+
+    // Validate before the terrain analysis, which assumes valid heights.
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p,
+        radio->f__mhz,
+        radio->pol,
+        radio->epsilon,
+        radio->sigma,
+        warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    PreparedPath path;
+    PreparePath(
+        h_tx__meter,
+        h_rx__meter,
+        pfl,
+        &path
+    );
+
+    return PointToPointPreparedContext_Ex(
+        &path,
+        radio,
+        1,
+        &p,
+        A__db,
+        warnings,
+        interValues
+    );
+}
@@ -0,0 +1,861 @@
+/**
+@file
+
+This file contains the PointToPointBatch(), PointToPointBatchParallel(),
+PointToPointBatchParallel_Ws(), PointToPointBatchSimd(),
+PointToPointBatchSimd_Ws(), BatchRadioContext() and
+ScatterIntermediateValues() functions.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Errors.h"
+#include "./include/Executor.h"
+#include "./include/Internal.h"
+#include "./include/LongleyRiceLanes.h"
+#include "./include/RadioContext.h"
+#include "./include/Workspace.h"
+
+/**
+@brief
+Return the calling thread's radio context for a set of radio parameters.
+
+The links of a batch usually share a few sets of radio parameters, so each
+thread keeps the context of the last set it was asked for and only initializes
+a new one when the parameters change.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@return
+Radio context, valid until the thread's next call.
+
+*/
+const RadioContext *BatchRadioContext(
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma
+) {
+    thread_local RadioContext radio;
+    thread_local bool initialized = false;
+
+    if (!initialized || radio.f__mhz != f__mhz || radio.pol != pol ||
+        radio.epsilon != epsilon || radio.sigma != sigma)
+    {
+        InitializeRadioContext(
+            f__mhz,
+            pol,
+            epsilon,
+            sigma,
+            &radio
+        );
+        initialized = true;
+    }
+
+    return &radio;
+}
+
+/**
+@brief
+Copy the intermediate values of one element of a batch into the columns of
+a batch of intermediate values.
+
+@param[in] iv
+Intermediate values of the element.
+
+@param[in] i
+Index of the element in the batch.
+
+@param[out] interValues
+Columns of intermediate values. Columns that are NULL are skipped.
+
+*/
+void ScatterIntermediateValues(
+    const IntermediateValues *iv,
+    int i,
+    IntermediateValuesBatch *interValues
+) {
+    for (int j = 0; j < 2; j++)
+    {
+        if (interValues->theta_hzn[j] != nullptr)
+            interValues->theta_hzn[j][i] = iv->theta_hzn[j];
+        if (interValues->d_hzn__meter[j] != nullptr)
+            interValues->d_hzn__meter[j][i] = iv->d_hzn__meter[j];
+        if (interValues->h_e__meter[j] != nullptr)
+            interValues->h_e__meter[j][i] = iv->h_e__meter[j];
+    }
+    if (interValues->delta_h__meter != nullptr)
+        interValues->delta_h__meter[i] = iv->delta_h__meter;
+    if (interValues->A_ref__db != nullptr)
+        interValues->A_ref__db[i] = iv->A_ref__db;
+    if (interValues->A_fs__db != nullptr)
+        interValues->A_fs__db[i] = iv->A_fs__db;
+    if (interValues->d__km != nullptr)
+        interValues->d__km[i] = iv->d__km;
+    if (interValues->mode != nullptr)
+        interValues->mode[i] = iv->mode;
+}
+
+/**
+@brief
+Return if a link's terrain profile lies within the packed terrain data.
+
+@param[in] pfls
+Packed terrain data, each profile in PFL format.
+
+@param[in] n_pfls
+Number of values in pfls.
+
+@param[in] offset
+Index into pfls of the start (pfl[0]) of the profile.
+
+@return
+True if pfl[0] is a number of intervals, >= 0, and all np + 3 values of the
+profile are within pfls.
+
+*/
+static bool ProfileInBounds(
+    const double pfls[],
+    long long n_pfls,
+    long long offset
+) {
+    if (offset < 0 || offset >= n_pfls)
+        return false;
+
+    // Compared in double, so a corrupt pfl[0] cannot overflow.
+    double np = pfls[offset];
+    return np >= 0 && np + 3 <= double(n_pfls - offset);
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a batch of
+links.
+
+All per-link inputs and outputs are structure-of-arrays columns of length n.
+The terrain profiles are packed back-to-back, each in PFL format, into a
+single array and located by an offsets array. An error on one link is
+reported in that link's error code and does not stop the rest of the batch.
+
+@param[in] n
+Number of links in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] pfls
+Packed terrain data, each profile in PFL format.
+
+@param[in] n_pfls
+Number of values in pfls.
+
+@param[in] pfl_offsets
+Index into pfls of the start (pfl[0]) of each link's profile. A link whose
+profile does not lie within pfls returns ERROR__TERRAIN_EXTENT.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for links without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any link returned
+an error.
+
+*/
+int PointToPointBatch(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues
+) {
+    return PointToPointBatchParallel(
+        n,
+        h_tx__meter,
+        h_rx__meter,
+        pfls,
+        n_pfls,
+        pfl_offsets,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        p,
+        A__db,
+        warnings,
+        errors,
+        interValues,
+        1
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a batch of
+links on a pool of threads.
+
+Each thread uses its own scratch memory. PointToPointBatchParallel_Ws() takes
+an ILM_Workspace instead.
+
+All per-link inputs and outputs are structure-of-arrays columns of length n.
+The terrain profiles are packed back-to-back, each in PFL format, into a
+single array and located by an offsets array. An error on one link is
+reported in that link's error code and does not stop the rest of the batch.
+
+The links are scheduled by their estimated cost, which grows with the length
+of their terrain profile, with work stealing between the threads. Each link
+writes only its own outputs, so the results are identical to
+PointToPointBatch() for any number of threads.
+
+@param[in] n
+Number of links in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] pfls
+Packed terrain data, each profile in PFL format.
+
+@param[in] n_pfls
+Number of values in pfls.
+
+@param[in] pfl_offsets
+Index into pfls of the start (pfl[0]) of each link's profile. A link whose
+profile does not lie within pfls returns ERROR__TERRAIN_EXTENT.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for links without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any link returned
+an error.
+
+*/
+int PointToPointBatchParallel(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues,
+    int n_threads
+) {
+    return PointToPointBatchParallel_Ws(
+        n,
+        h_tx__meter,
+        h_rx__meter,
+        pfls,
+        n_pfls,
+        pfl_offsets,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        p,
+        A__db,
+        warnings,
+        errors,
+        interValues,
+        n_threads,
+        nullptr
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a batch of
+links on a pool of threads.
+
+All per-link inputs and outputs are structure-of-arrays columns of length n.
+The terrain profiles are packed back-to-back, each in PFL format, into a
+single array and located by an offsets array. An error on one link is
+reported in that link's error code and does not stop the rest of the batch.
+
+The links are scheduled by their estimated cost, which grows with the length
+of their terrain profile, with work stealing between the threads. Each link
+writes only its own outputs, so the results are identical to
+PointToPointBatch() for any number of threads.
+
+@param[in] n
+Number of links in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] pfls
+Packed terrain data, each profile in PFL format.
+
+@param[in] n_pfls
+Number of values in pfls.
+
+@param[in] pfl_offsets
+Index into pfls of the start (pfl[0]) of each link's profile. A link whose
+profile does not lie within pfls returns ERROR__TERRAIN_EXTENT.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for links without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@param[in] workspace
+Scratch memory of the threads, from CreateWorkspace(), or NULL to use each
+thread's own. With a workspace the batch runs on at most its number of
+threads.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any link returned
+an error.
+
+*/
+int PointToPointBatchParallel_Ws(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues,
+    int n_threads,
+    ILM_Workspace *workspace
+) {
+    n_threads = WorkspaceThreads(workspace, n_threads);
+
+    // The calling thread is worker 0.
+    WorkspaceBinding caller(workspace);
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    ArenaScope scope(arena);
+
+    // Estimated cost of each link.
+    double *cost = ArenaArray<double>(arena, n > 0 ? n : 0);
+    for (int i = 0; i < n; i++)
+    {
+        cost[i] = COST__POINT_TO_POINT;
+        if (ProfileInBounds(pfls, n_pfls, pfl_offsets[i]))
+            cost[i] += pfls[pfl_offsets[i]];
+    }
+
+    ParallelFor(n, cost, n_threads, [&](int i) {
+        WorkspaceBinding binding(workspace);
+        IntermediateValues iv;
+
+        if (!ProfileInBounds(pfls, n_pfls, pfl_offsets[i]))
+        {
+            warnings[i] = NO_WARNINGS;
+            errors[i] = ERROR__TERRAIN_EXTENT;
+            return;
+        }
+
+        errors[i] = PointToPointContext_Ex(
+            h_tx__meter[i],
+            h_rx__meter[i],
+            &pfls[pfl_offsets[i]],
+            BatchRadioContext(f__mhz[i], pol[i], epsilon[i], sigma[i]),
+            p[i],
+            &A__db[i],
+            &warnings[i],
+            &iv
+        );
+
+        if (errors[i] != SUCCESS && errors[i] != SUCCESS_WITH_WARNINGS)
+            return;
+
+        if (interValues != nullptr)
+            ScatterIntermediateValues(&iv, i, interValues);
+    });
+
+    bool any_error = false;
+    bool any_warnings = false;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (errors[i] != SUCCESS && errors[i] != SUCCESS_WITH_WARNINGS)
+            any_error = true;
+        else if (warnings[i] != NO_WARNINGS)
+            any_warnings = true;
+    }
+
+    if (any_error)
+        return ERROR__BATCH_ELEMENT;
+
+    if (any_warnings)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
+
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a batch of
+links on a pool of threads, with the reference attenuation and variability of
+LONGLEY_RICE_LANES links at a time in the lanes of a SIMD kernel.
+
+Each thread uses its own scratch memory. PointToPointBatchSimd_Ws() takes an
+ILM_Workspace instead.
+
+The inputs and outputs are those of PointToPointBatchParallel(). The terrain
+analysis of each link is the same, and the links that follow it are evaluated
+together, so the results agree with PointToPointBatchParallel() to within
+floating point rounding of the transcendental functions on CPUs with AVX2, and
+are identical otherwise. The lanes do not interact, so the results do not
+depend on the number of threads.
+
+@param[in] n
+Number of links in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] pfls
+Packed terrain data, each profile in PFL format.
+
+@param[in] n_pfls
+Number of values in pfls.
+
+@param[in] pfl_offsets
+Index into pfls of the start (pfl[0]) of each link's profile. A link whose
+profile does not lie within pfls returns ERROR__TERRAIN_EXTENT.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for links without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any link returned
+an error.
+
+*/
+int PointToPointBatchSimd(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues,
+    int n_threads
+) {
+    return PointToPointBatchSimd_Ws(
+        n,
+        h_tx__meter,
+        h_rx__meter,
+        pfls,
+        n_pfls,
+        pfl_offsets,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        p,
+        A__db,
+        warnings,
+        errors,
+        interValues,
+        n_threads,
+        nullptr
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a batch of
+links on a pool of threads, with the reference attenuation and variability of
+LONGLEY_RICE_LANES links at a time in the lanes of a SIMD kernel.
+
+The inputs and outputs are those of PointToPointBatchParallel(). The terrain
+analysis of each link is the same, and the links that follow it are evaluated
+together, so the results agree with PointToPointBatchParallel() to within
+floating point rounding of the transcendental functions on CPUs with AVX2, and
+are identical otherwise. The lanes do not interact, so the results do not
+depend on the number of threads.
+
+@param[in] n
+Number of links in the batch.
+
+@param[in] h_tx__meter
+Structural heights of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural heights of the RX, in meters.
+
+@param[in] pfls
+Packed terrain data, each profile in PFL format.
+
+@param[in] n_pfls
+Number of values in pfls.
+
+@param[in] pfl_offsets
+Index into pfls of the start (pfl[0]) of each link's profile. A link whose
+profile does not lie within pfls returns ERROR__TERRAIN_EXTENT.
+
+@param[in] f__mhz
+Frequencies, in MHz.
+
+@param[in] pol
+Polarizations.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivities.
+
+@param[in] sigma
+Conductivities.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission losses, in dB. Only set for links without an error.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] errors
+Error codes.
+
+@param[out] interValues
+Columns of intermediate values. May be NULL.
+
+@param[in] n_threads
+Number of threads, or 0 to use one per hardware thread.
+
+@param[in] workspace
+Scratch memory of the threads, from CreateWorkspace(), or NULL to use each
+thread's own. With a workspace the batch runs on at most its number of
+threads.
+
+@return error
+SUCCESS, SUCCESS_WITH_WARNINGS, or ERROR__BATCH_ELEMENT if any link returned
+an error.
+
+*/
+int PointToPointBatchSimd_Ws(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues,
+    int n_threads,
+    ILM_Workspace *workspace
+) {
+    int n_groups = n > 0 ? (n + LONGLEY_RICE_LANES - 1) / LONGLEY_RICE_LANES : 0;
+
+    n_threads = WorkspaceThreads(workspace, n_threads);
+
+    // The calling thread is worker 0.
+    WorkspaceBinding caller(workspace);
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    ArenaScope scope(arena);
+
+    // Estimated cost of each group of links.
+    double *cost = ArenaArray<double>(arena, n_groups);
+    std::fill(cost, cost + n_groups, 0.0);
+    for (int i = 0; i < n; i++)
+    {
+        cost[i / LONGLEY_RICE_LANES] += COST__POINT_TO_POINT;
+        if (ProfileInBounds(pfls, n_pfls, pfl_offsets[i]))
+            cost[i / LONGLEY_RICE_LANES] += pfls[pfl_offsets[i]];
+    }
+
+    ParallelFor(n_groups, cost, n_threads, [&](int g) {
+        WorkspaceBinding binding(workspace);
+        RadioContext radios[LONGLEY_RICE_LANES];
+        PreparedPath paths[LONGLEY_RICE_LANES];
+        const RadioContext *lane_radios[LONGLEY_RICE_LANES];
+        const PreparedPath *lane_paths[LONGLEY_RICE_LANES];
+        double lane_p[LONGLEY_RICE_LANES];
+        double lane_A__db[LONGLEY_RICE_LANES];
+        long lane_warnings[LONGLEY_RICE_LANES];
+        IntermediateValues lane_iv[LONGLEY_RICE_LANES];
+        int lane_i[LONGLEY_RICE_LANES];
+        int n_lanes = 0;
+
+        int i_end = std::min(n, (g + 1) * LONGLEY_RICE_LANES);
+        for (int i = g * LONGLEY_RICE_LANES; i < i_end; i++)
+        {
+            if (!ProfileInBounds(pfls, n_pfls, pfl_offsets[i]))
+            {
+                warnings[i] = NO_WARNINGS;
+                errors[i] = ERROR__TERRAIN_EXTENT;
+                continue;
+            }
+
+            RadioContext *radio = &radios[n_lanes];
+            *radio = *BatchRadioContext(f__mhz[i], pol[i], epsilon[i], sigma[i]);
+
+            // An invalid ground impedance is reported by the scalar mode.
+            if (!ValidGroundImpedance(radio))
+            {
+                IntermediateValues iv;
+                errors[i] = PointToPointContext_Ex(
+                    h_tx__meter[i],
+                    h_rx__meter[i],
+                    &pfls[pfl_offsets[i]],
+                    radio,
+                    p[i],
+                    &A__db[i],
+                    &warnings[i],
+                    &iv
+                );
+                continue;
+            }
+
+            warnings[i] = NO_WARNINGS;
+            errors[i] = ValidateInputs(
+                h_tx__meter[i],
+                h_rx__meter[i],
+                p[i],
+                radio->f__mhz,
+                radio->pol,
+                radio->epsilon,
+                radio->sigma,
+                &warnings[i]
+            );
+            if (errors[i] != SUCCESS)
+                continue;
+
+            PreparePath(
+                h_tx__meter[i],
+                h_rx__meter[i],
+                &pfls[pfl_offsets[i]],
+                &paths[n_lanes]
+            );
+
+            lane_radios[n_lanes] = radio;
+            lane_paths[n_lanes] = &paths[n_lanes];
+            lane_p[n_lanes] = p[i];
+            lane_warnings[n_lanes] = warnings[i];
+            lane_i[n_lanes] = i;
+            n_lanes++;
+        }
+
+        if (n_lanes == 0)
+            return;
+
+        PointToPointPreparedLanes(
+            n_lanes,
+            lane_paths,
+            lane_radios,
+            lane_p,
+            lane_A__db,
+            lane_warnings,
+            lane_iv
+        );
+
+        for (int l = 0; l < n_lanes; l++)
+        {
+            int i = lane_i[l];
+
+            A__db[i] = lane_A__db[l];
+            warnings[i] = lane_warnings[l];
+            errors[i] = warnings[i] != NO_WARNINGS ? SUCCESS_WITH_WARNINGS : SUCCESS;
+
+            if (interValues != nullptr)
+                ScatterIntermediateValues(&lane_iv[l], i, interValues);
+        }
+    });
+
+    bool any_error = false;
+    bool any_warnings = false;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (errors[i] != SUCCESS && errors[i] != SUCCESS_WITH_WARNINGS)
+            any_error = true;
+        else if (warnings[i] != NO_WARNINGS)
+            any_warnings = true;
+    }
+
+    if (any_error)
+        return ERROR__BATCH_ELEMENT;
+
+    if (any_warnings)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
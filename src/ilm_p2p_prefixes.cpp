@@ -0,0 +1,163 @@
+/**
+@file
+
+This file contains the PointToPointPrefixes() function.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Errors.h"
+#include "./include/ProfilePrefixes.h"
+#include "./include/Workspace.h"
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated with the RX at
+every point along a terrain profile.
+
+The RX at point k of the profile, 1 <= k <= pfl[0], sees the prefix of the
+profile that ends at k. The TX horizon is kept as a running maximum, the RX
+horizon search is pruned with block maxima of the terrain and the least
+squares fits come from prefix sums, so the cost grows close to linearly with
+the number of points. The terrain horizons are identical to PointToPoint() on
+the prefix of the profile. The prefix sum fits round differently than the
+direct fits, so the effective heights and the values that follow from them
+agree to about 1E-10 relative, and a warning or mode decided by a threshold
+can differ where a value is within that rounding of the threshold.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss with the RX at point k at index k - 1, in dB, for
+pfl[0] points. Only set for points without an error.
+
+@param[out] warnings
+Warning flags of each point.
+
+@param[out] errors
+Error code of each point. If the inputs common to every point are invalid,
+every point has the error of the input validation.
+
+@return error
+Error code of the input validation, or ERROR__BATCH_ELEMENT if any point
+returned an error.
+
+*/
+int PointToPointPrefixes(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double A__db[],
+    long warnings[],
+    int errors[]
+) {
+    int np = int(pfl[0]);
+
+    long common_warnings = NO_WARNINGS;
+
+    int rtn = ValidateInputs(
+        h_tx__meter,
+        h_rx__meter,
+        p,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &common_warnings
+    );
+    if (rtn != SUCCESS)
+    {
+        // The inputs are common to every point, so every point fails.
+        std::fill(warnings, warnings + np, common_warnings);
+        std::fill(errors, errors + np, rtn);
+        return rtn;
+    }
+
+    RadioContext radio;
+    InitializeRadioContext(
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &radio
+    );
+
+    double h__meter[2] = { h_tx__meter, h_rx__meter };
+
+    WorkspaceArena *arena = &CurrentWorkspace()->arena;
+    ArenaScope scope(arena);
+
+    // The profile is truncated in place at each RX, so work on a copy.
+    double *profile = ArenaArray<double>(arena, (size_t)np + 3);
+    std::copy(pfl, pfl + np + 3, profile);
+
+    int *k = ArenaArray<int>(arena, np);
+    for (int i = 0; i < np; i++)
+        k[i] = i + 1;
+
+    PointToPointAtPrefixes(
+        profile,
+        h__meter,
+        &radio,
+        p / 100.0,
+        common_warnings,
+        np,
+        k,
+        A__db,
+        warnings,
+        errors,
+        nullptr
+    );
+
+    bool any_error = false;
+    bool any_warnings = false;
+
+    for (int i = 0; i < np; i++)
+    {
+        if (errors[i] != SUCCESS && errors[i] != SUCCESS_WITH_WARNINGS)
+            any_error = true;
+        else if (warnings[i] != NO_WARNINGS)
+            any_warnings = true;
+    }
+
+    if (any_error)
+        return ERROR__BATCH_ELEMENT;
+
+    if (any_warnings)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
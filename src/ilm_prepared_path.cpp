@@ -0,0 +1,517 @@
+/**
+@file
+
+This file contains the PreparePath(), PreparePathView(),
+PreparePathCompact(), PointToPointPrepared(), PointToPointPrepared_Ex(),
+PointToPointPreparedPercentiles_Ex(), PointToPointPreparedContext_Ex() and
+EvaluatePreparedPath() functions.
+*/
+
+/* Standard includes. */
+#include <complex>
+
+/* Local includes. */
+#include "./include/ilm.h"
+#include "./include/Engine.h"
+#include "./include/Enums.h"
+#include "./include/Errors.h"
+#include "./include/RadioContext.h"
+
+/**
+@brief
+Prepare a Point-To-Point path for evaluation with many sets of radio
+parameters.
+
+Runs the terrain analysis of the path, which does not depend on the
+frequency, polarization, ground constants or location percentage. The inputs
+are validated when the path is evaluated.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] pfl
+Terrain data, in PFL format.
+
+@param[out] path
+Prepared path.
+
+*/
+void PreparePath(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    PreparedPath *path
+) {
+    path->h__meter[0] = h_tx__meter;
+    path->h__meter[1] = h_rx__meter;
+
+    path->d__km = (pfl[0] * pfl[1]) / 1000.0;
+
+    QuickPfl(
+        pfl,
+        path->h__meter,
+        path->theta_hzn,
+        path->d_hzn__meter,
+        path->h_e__meter,
+        &path->delta_h__meter,
+        &path->d__meter
+    );
+}
+
+/**
+@brief
+Prepare a Point-To-Point path over a terrain profile stored in place.
+
+The prepared path is identical to PreparePath() on the same profile in pfl
+format.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] view
+View of the terrain.
+
+@param[out] path
+Prepared path.
+
+*/
+void PreparePathView(
+    double h_tx__meter,
+    double h_rx__meter,
+    const TerrainView *view,
+    PreparedPath *path
+) {
+    path->h__meter[0] = h_tx__meter;
+    path->h__meter[1] = h_rx__meter;
+
+    path->d__km = (view->np * view->xi__meter) / 1000.0;
+
+    QuickPflView(
+        view,
+        path->h__meter,
+        path->theta_hzn,
+        path->d_hzn__meter,
+        path->h_e__meter,
+        &path->delta_h__meter,
+        &path->d__meter
+    );
+}
+
+/**
+@brief
+Prepare a Point-To-Point path over a terrain profile in a compact encoding.
+
+The prepared path is identical to PreparePath() on the widened profile in pfl
+format.
+
+@param[in] h_tx__meter
+Structural height of the TX, in meters.
+
+@param[in] h_rx__meter
+Structural height of the RX, in meters.
+
+@param[in] view
+View of the terrain.
+
+@param[out] path
+Prepared path.
+
+*/
+void PreparePathCompact(
+    double h_tx__meter,
+    double h_rx__meter,
+    const CompactTerrainView *view,
+    PreparedPath *path
+) {
+    path->h__meter[0] = h_tx__meter;
+    path->h__meter[1] = h_rx__meter;
+
+    path->d__km = (view->np * view->xi__meter) / 1000.0;
+
+    QuickPflCompact(
+        view,
+        path->h__meter,
+        path->theta_hzn,
+        path->d_hzn__meter,
+        path->h_e__meter,
+        &path->delta_h__meter,
+        &path->d__meter
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a
+prepared path.
+
+@param[in] path
+Prepared path, from PreparePath().
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@param[out] warnings
+Warning flags.
+
+@return error
+Error code.
+
+*/
+int PointToPointPrepared(
+    const PreparedPath *path,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double *A__db,
+    long *warnings
+) {
+    IntermediateValues interValues;
+
+    return PointToPointPreparedPercentiles_Ex(
+        path,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        1,
+        &p,
+        A__db,
+        warnings,
+        &interValues
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a
+prepared path.
+
+@param[in] path
+Prepared path, from PreparePath().
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] p
+Location percentage, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss, in dB.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int PointToPointPrepared_Ex(
+    const PreparedPath *path,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double *A__db,
+    long *warnings,
+    IntermediateValues *interValues
+) {
+    return PointToPointPreparedPercentiles_Ex(
+        path,
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        1,
+        &p,
+        A__db,
+        warnings,
+        interValues
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a
+prepared path and an array of location percentages.
+
+Only the radio parameter dependent steps are run: the ground impedance, the
+reference attenuation and the variability. The results are identical to
+calling PointToPointPercentiles_Ex() with the terrain and terminal heights the
+path was prepared from.
+
+@param[in] path
+Prepared path, from PreparePath().
+
+@param[in] f__mhz
+Frequency, in MHz.
+
+@param[in] pol
+Polarization.
+Either:
+    0: POLARIZATION__HORIZONTAL
+    1: POLARIZATION__VERTICAL
+
+@param[in] epsilon
+Relative permittivity.
+
+@param[in] sigma
+Conductivity.
+
+@param[in] n_p
+Number of location percentages.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss at each location percentage, in dB.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int PointToPointPreparedPercentiles_Ex(
+    const PreparedPath *path,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    int n_p,
+    double p[],
+    double *A__db,
+    long *warnings,
+    IntermediateValues *interValues
+) {
+    RadioContext radio;
+    InitializeRadioContext(
+        f__mhz,
+        pol,
+        epsilon,
+        sigma,
+        &radio
+    );
+
+    return PointToPointPreparedContext_Ex(
+        path,
+        &radio,
+        n_p,
+        p,
+        A__db,
+        warnings,
+        interValues
+    );
+}
+
+/**
+@brief
+The Irregular Lunar Model (ILM) Point-To-Point mode, evaluated for a
+prepared path, a radio context and an array of location percentages.
+
+Only the path dependent steps of the reference attenuation and the
+variability are run, with the frequency and ground dependent constants taken
+from the context. The results are identical to
+PointToPointPreparedPercentiles_Ex() with the radio parameters the context was
+initialized with.
+
+@param[in] path
+Prepared path, from PreparePath().
+
+@param[in] radio
+Radio context, from InitializeRadioContext().
+
+@param[in] n_p
+Number of location percentages.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss at each location percentage, in dB.
+
+@param[out] warnings
+Warning flags.
+
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int PointToPointPreparedContext_Ex(
+    const PreparedPath *path,
+    const RadioContext *radio,
+    int n_p,
+    double p[],
+    double *A__db,
+    long *warnings,
+    IntermediateValues *interValues
+) {
+    // Initialize to no warnings.
+    *warnings = NO_WARNINGS;
+
+    if (n_p < 1)
+        return ERROR__INVALID_PERCENTAGE;
+
+    // Initial input validation check.
+    // Some validation occurs later in calculations.
+    int rtn = ValidateInputs(
+        path->h__meter[0],
+        path->h__meter[1],
+        p[0],
+        radio->f__mhz,
+        radio->pol,
+        radio->epsilon,
+        radio->sigma,
+        warnings
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    for (int i = 1; i < n_p; i++)
+    {
+        if (p[i] <= 0.0 || p[i] >= 100.0)
+            return ERROR__INVALID_PERCENTAGE;
+    }
+
+    rtn = EvaluatePreparedPath(
+        path,
+        radio,
+        n_p,
+        p,
+        A__db,
+        warnings,
+        interValues
+    );
+    if (rtn != SUCCESS)
+        return rtn;
+
+    if (*warnings != NO_WARNINGS)
+        return SUCCESS_WITH_WARNINGS;
+
+    return SUCCESS;
+}
+
+/**
+@brief
+Evaluate a prepared path with the reference attenuation, the free space loss
+and the variability of the engine, for the precision of a radio context.
+
+The inputs are not validated. Only the path distance of the intermediate
+values is set if there is an error.
+
+@param[in] path
+Prepared path.
+
+@param[in] radio
+Radio context.
+
+@param[in] n_p
+Number of location percentages, at least 1.
+
+@param[in] p
+Location percentages, 0 < p < 100.
+
+@param[out] A__db
+Basic transmission loss at each location percentage, in dB.
+
+@param[in,out] warnings
+Warning flags.
+
+@param[out] interValues
+Struct of intermediate values.
+
+@return error
+Error code.
+
+*/
+int EvaluatePreparedPath(
+    const PreparedPath *path,
+    const RadioContext *radio,
+    int n_p,
+    const double p[],
+    double A__db[],
+    long *warnings,
+    IntermediateValues *interValues
+) {
+    EngineIntermediateValues<double> engine_values;
+
+    int rtn;
+    if (radio->precision == PRECISION__FAST)
+        rtn = FastModel::EvaluatePath(
+            EnginePathOf(path),
+            EngineRadioOf(radio),
+            n_p,
+            p,
+            A__db,
+            warnings,
+            &engine_values
+        );
+    else
+        rtn = ExactModel::EvaluatePath(
+            EnginePathOf(path),
+            EngineRadioOf(radio),
+            n_p,
+            p,
+            A__db,
+            warnings,
+            &engine_values
+        );
+    if (rtn != SUCCESS)
+    {
+        interValues->d__km = engine_values.d__km;
+        return rtn;
+    }
+
+    CopyIntermediateValues(engine_values, interValues);
+
+    return SUCCESS;
+}
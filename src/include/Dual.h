@@ -0,0 +1,431 @@
+#pragma once
+/**
+@file
+
+Forward mode dual numbers, to evaluate the engine of Engine.h along with the
+partial derivatives of its results.
+
+A Dual<N> holds a value and its partial derivatives with respect to N inputs.
+Each operation computes its value with the same operation on double as the
+engine does with T = double, and its derivatives with the chain rule, so the
+engine returns the same values for T = Dual<N> as for T = double, and the
+derivatives come with them from a single evaluation.
+
+Comparisons only look at the values, so the model takes the same branches as
+for double, and the derivatives are those of the branches taken. Where the
+model is continuous but not smooth, such as at the max() of two terms, the
+derivative is the one-sided derivative of the branch taken.
+
+    Dual<2> x = Dual<2>::Input(3.0, 0);
+    Dual<2> y = Dual<2>::Input(4.0, 1);
+    Dual<2> r = sqrt(x * x + y * y);    // r.value = 5, r.deriv = { 0.6, 0.8 }
+*/
+
+/* Standard includes. */
+#include <cmath>
+#include <complex>
+
+/* Local includes. */
+#include "Engine.h"
+
+/**
+@brief
+Dual number of a value and its partial derivatives with respect to N inputs.
+*/
+template <int N>
+struct Dual
+{
+    /**
+    Value.
+    */
+    double value;
+
+    /**
+    Partial derivatives of the value with respect to the inputs.
+    */
+    double deriv[N];
+
+    /**
+    Construct a constant, whose derivatives are zero.
+    */
+    Dual(double x = 0.0) : value(x)
+    {
+        for (int i = 0; i < N; i++)
+            deriv[i] = 0.0;
+    }
+
+    /**
+    Construct input i, whose derivative with respect to itself is one.
+    */
+    static Dual Input(double x, int i)
+    {
+        Dual result(x);
+        result.deriv[i] = 1.0;
+        return result;
+    }
+
+    /**
+    Truncate the value to an integer, as the model does to find the mode of
+    propagation.
+    */
+    explicit operator int() const
+    {
+        return int(value);
+    }
+};
+
+/**
+@brief
+Apply the chain rule for a function of one dual number.
+
+@param[in] x
+Argument.
+
+@param[in] value
+Value of the function at x.
+
+@param[in] slope
+Derivative of the function at x.
+
+@return
+Function of x.
+
+*/
+template <int N>
+inline Dual<N> DualChain(
+    const Dual<N> &x,
+    double value,
+    double slope
+) {
+    Dual<N> result(value);
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = slope * x.deriv[i];
+    return result;
+}
+
+template <int N>
+inline Dual<N> operator-(const Dual<N> &x)
+{
+    return DualChain(x, -x.value, -1.0);
+}
+
+template <int N>
+inline Dual<N> operator+(const Dual<N> &x, const Dual<N> &y)
+{
+    Dual<N> result(x.value + y.value);
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] + y.deriv[i];
+    return result;
+}
+
+template <int N>
+inline Dual<N> operator-(const Dual<N> &x, const Dual<N> &y)
+{
+    Dual<N> result(x.value - y.value);
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] - y.deriv[i];
+    return result;
+}
+
+template <int N>
+inline Dual<N> operator*(const Dual<N> &x, const Dual<N> &y)
+{
+    Dual<N> result(x.value * y.value);
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] * y.value + x.value * y.deriv[i];
+    return result;
+}
+
+template <int N>
+inline Dual<N> operator/(const Dual<N> &x, const Dual<N> &y)
+{
+    Dual<N> result(x.value / y.value);
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = (x.deriv[i] - result.value * y.deriv[i]) / y.value;
+    return result;
+}
+
+template <int N>
+inline bool operator<(const Dual<N> &x, const Dual<N> &y)
+{
+    return x.value < y.value;
+}
+
+template <int N>
+inline bool operator>(const Dual<N> &x, const Dual<N> &y)
+{
+    return x.value > y.value;
+}
+
+template <int N>
+inline bool operator<=(const Dual<N> &x, const Dual<N> &y)
+{
+    return x.value <= y.value;
+}
+
+template <int N>
+inline bool operator>=(const Dual<N> &x, const Dual<N> &y)
+{
+    return x.value >= y.value;
+}
+
+template <int N>
+inline bool operator==(const Dual<N> &x, const Dual<N> &y)
+{
+    return x.value == y.value;
+}
+
+template <int N>
+inline bool operator!=(const Dual<N> &x, const Dual<N> &y)
+{
+    return x.value != y.value;
+}
+
+template <int N>
+inline Dual<N> sqrt(const Dual<N> &x)
+{
+    double value = std::sqrt(x.value);
+    return DualChain(x, value, 0.5 / value);
+}
+
+template <int N>
+inline Dual<N> exp(const Dual<N> &x)
+{
+    double value = std::exp(x.value);
+    return DualChain(x, value, value);
+}
+
+template <int N>
+inline Dual<N> log(const Dual<N> &x)
+{
+    return DualChain(x, std::log(x.value), 1.0 / x.value);
+}
+
+template <int N>
+inline Dual<N> log10(const Dual<N> &x)
+{
+    // 1 / ln(10) = 0.4342944819032518
+    return DualChain(x, std::log10(x.value), 0.4342944819032518 / x.value);
+}
+
+template <int N>
+inline Dual<N> sin(const Dual<N> &x)
+{
+    return DualChain(x, std::sin(x.value), std::cos(x.value));
+}
+
+template <int N>
+inline Dual<N> cos(const Dual<N> &x)
+{
+    return DualChain(x, std::cos(x.value), -std::sin(x.value));
+}
+
+template <int N>
+inline Dual<N> abs(const Dual<N> &x)
+{
+    return DualChain(x, std::fabs(x.value), (x.value < 0.0) ? -1.0 : 1.0);
+}
+
+template <int N>
+inline Dual<N> pow(const Dual<N> &x, int n)
+{
+    return DualChain(x, std::pow(x.value, n), n * std::pow(x.value, n - 1));
+}
+
+template <int N>
+inline Dual<N> pow(const Dual<N> &x, const Dual<N> &y)
+{
+    Dual<N> result = DualChain(x, std::pow(x.value, y.value), y.value * std::pow(x.value, y.value - 1.0));
+
+    // The exponents of the model are almost always constants, whose
+    // derivatives are zero, so only take the logarithm when they are not.
+    for (int i = 0; i < N; i++)
+    {
+        if (y.deriv[i] != 0.0)
+            result.deriv[i] += result.value * std::log(x.value) * y.deriv[i];
+    }
+
+    return result;
+}
+
+/**
+@brief
+Return the magnitude of a dual number as the reference C code of the model
+takes it.
+
+Where the toolchain's abs() truncates the magnitude to an integer, it is
+piecewise constant and its derivative is zero.
+
+@param[in] x
+Value.
+
+@return
+abs(x).
+
+*/
+template <int N>
+inline Dual<N> ReferenceAbs(
+    const Dual<N> &x
+) {
+    double value = ReferenceAbs(x.value);
+
+    if (value != std::fabs(x.value))
+        return Dual<N>(value);
+
+    return abs(x);
+}
+
+/**
+@brief
+Complex number of dual numbers, for the ground impedance and the reflection
+coefficient of the model.
+
+The value is a std::complex<double> computed with the same operators as the
+engine uses for T = double, and each derivative is a std::complex<double> of
+the derivatives of the real and imaginary parts.
+*/
+template <int N>
+struct DualComplex
+{
+    /**
+    Value.
+    */
+    std::complex<double> value;
+
+    /**
+    Partial derivatives of the value with respect to the inputs.
+    */
+    std::complex<double> deriv[N];
+
+    /**
+    Construct zero.
+    */
+    DualComplex() : value()
+    {
+        for (int i = 0; i < N; i++)
+            deriv[i] = std::complex<double>();
+    }
+
+    /**
+    Construct from the real and imaginary parts.
+    */
+    DualComplex(const Dual<N> &re, const Dual<N> &im) : value(re.value, im.value)
+    {
+        for (int i = 0; i < N; i++)
+            deriv[i] = std::complex<double>(re.deriv[i], im.deriv[i]);
+    }
+
+    /**
+    Real part.
+    */
+    Dual<N> real() const
+    {
+        Dual<N> result(value.real());
+        for (int i = 0; i < N; i++)
+            result.deriv[i] = deriv[i].real();
+        return result;
+    }
+
+    /**
+    Imaginary part.
+    */
+    Dual<N> imag() const
+    {
+        Dual<N> result(value.imag());
+        for (int i = 0; i < N; i++)
+            result.deriv[i] = deriv[i].imag();
+        return result;
+    }
+};
+
+template <int N>
+inline DualComplex<N> operator+(const DualComplex<N> &x, const DualComplex<N> &y)
+{
+    DualComplex<N> result;
+    result.value = x.value + y.value;
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] + y.deriv[i];
+    return result;
+}
+
+template <int N>
+inline DualComplex<N> operator+(const Dual<N> &x, const DualComplex<N> &y)
+{
+    DualComplex<N> result;
+    result.value = x.value + y.value;
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] + y.deriv[i];
+    return result;
+}
+
+template <int N>
+inline DualComplex<N> operator-(const Dual<N> &x, const DualComplex<N> &y)
+{
+    DualComplex<N> result;
+    result.value = x.value - y.value;
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] - y.deriv[i];
+    return result;
+}
+
+template <int N>
+inline DualComplex<N> operator-(const DualComplex<N> &x, const Dual<N> &y)
+{
+    DualComplex<N> result;
+    result.value = x.value - y.value;
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] - y.deriv[i];
+    return result;
+}
+
+template <int N>
+inline DualComplex<N> operator*(const DualComplex<N> &x, const Dual<N> &y)
+{
+    DualComplex<N> result;
+    result.value = x.value * y.value;
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] * y.value + x.value * y.deriv[i];
+    return result;
+}
+
+template <int N>
+inline DualComplex<N> operator/(const DualComplex<N> &x, const DualComplex<N> &y)
+{
+    DualComplex<N> result;
+    result.value = x.value / y.value;
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = (x.deriv[i] - result.value * y.deriv[i]) / y.value;
+    return result;
+}
+
+template <int N>
+inline DualComplex<N> sqrt(const DualComplex<N> &x)
+{
+    DualComplex<N> result;
+    result.value = std::sqrt(x.value);
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = x.deriv[i] / (2.0 * result.value);
+    return result;
+}
+
+template <int N>
+inline Dual<N> abs(const DualComplex<N> &x)
+{
+    Dual<N> result(std::abs(x.value));
+    for (int i = 0; i < N; i++)
+        result.deriv[i] = (x.value.real() * x.deriv[i].real() + x.value.imag() * x.deriv[i].imag()) / result.value;
+    return result;
+}
+
+/**
+@brief
+Complex type of the engine for dual numbers.
+*/
+template <int N>
+struct EngineComplex<Dual<N> >
+{
+    /**
+    Complex type.
+    */
+    typedef DualComplex<N> type;
+};
@@ -0,0 +1,2254 @@
+#pragma once
+/**
+@file
+
+Header-only engine of the ILM, templated on the floating point type and
+specialized at compile time on the polarization, the siting criteria of the
+terminals and the precision of the special functions.
+
+The functions of ilm.h are thin wrappers over this engine with T = double, so
+both give identical results. A simulator that embeds the engine instead calls
+it directly: the small helpers such as FreeSpaceLoss() and FresnelIntegral()
+are inlined into the model, and the branches on the polarization and the
+siting criteria are resolved by the policies instead of at run time.
+
+    EngineRadio<double> radio;
+    IlmEngine<double, VerticalPolarization>::InitializeRadio(f__mhz, epsilon, sigma, &radio);
+    IlmEngine<double, VerticalPolarization>::Area<MobileSiting, FixedSiting>(...);
+
+Instantiated with the Dual<N> of Dual.h, the engine also returns the partial
+derivatives of its results, as in Area_Grad() and PointToPoint_Grad().
+
+Only the Longley-Rice method and the area mode are in the engine. The terrain
+analysis of the Point-To-Point mode stays in the library, and its results are
+passed to the engine as an EnginePath.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Enums.h"
+#include "Errors.h"
+#include "Internal.h"
+#include "Warnings.h"
+
+/**
+@brief
+Constants of the model.
+*/
+struct IlmConstants
+{
+    /**
+    Speed of light, in meters per second.
+    */
+    static constexpr double c__meter_per_sec = 299792458.0;
+
+    /**
+    Ratio of a circle's circumference to its diameter.
+    */
+    static constexpr double pi = 3.14159265358979323846;
+
+    /**
+    The ratio 1/3.
+    */
+    static constexpr double third = 1.0 / 3.0;
+
+    /**
+    Largest horizon angle for the small angle approximations.
+    */
+    static constexpr double theta_max = 200.0E-3;
+
+    /**
+    Scale distance of the terrain irregularity of a path, in meters.
+    */
+    static constexpr double d_scale__meter = 50.0E3;
+};
+
+/**
+@brief
+Return the magnitude of a value as the reference C code of the model takes it.
+
+The reference code calls the unqualified abs() of <cstdlib>. Which overload a
+floating point argument takes is up to the standard library, so the engine
+takes magnitudes the same way to agree with the library built by the same
+toolchain.
+
+@param[in] x
+Value.
+
+@return
+abs(x).
+
+*/
+template <typename T>
+inline T ReferenceAbs(
+    T x
+) {
+    return T(abs(x));
+}
+
+/**
+@brief
+Complex type of the engine for a floating point type.
+
+std::complex is only specified for the standard floating point types, so
+other types, such as the Dual<N> of Dual.h, specialize this with a complex type
+of their own.
+*/
+template <typename T>
+struct EngineComplex
+{
+    /**
+    Complex type.
+    */
+    typedef std::complex<T> type;
+};
+
+/**
+@brief
+Precision policy that evaluates the special functions with the standard
+library.
+*/
+struct ExactPrecision
+{
+    /**
+    Natural logarithm.
+    */
+    template <typename T>
+    static T Log(T x)
+    {
+        using std::log;
+        return log(x);
+    }
+
+    /**
+    Base 10 logarithm.
+    */
+    template <typename T>
+    static T Log10(T x)
+    {
+        using std::log10;
+        return log10(x);
+    }
+
+    /**
+    Natural exponential.
+    */
+    template <typename T>
+    static T Exp(T x)
+    {
+        using std::exp;
+        return exp(x);
+    }
+
+    /**
+    Cube root of a non-negative number.
+    */
+    template <typename T>
+    static T Cbrt(T x)
+    {
+        using std::pow;
+        return pow(x, T(IlmConstants::third));
+    }
+
+    /**
+    Fourth root of a non-negative number.
+    */
+    template <typename T>
+    static T Root4(T x)
+    {
+        using std::pow;
+        return pow(x, T(0.25));
+    }
+
+    /**
+    Cube of a number.
+    */
+    template <typename T>
+    static T Cube(T x)
+    {
+        using std::pow;
+        return pow(x, T(3.0));
+    }
+};
+
+/**
+@brief
+Polarization policy of horizontal polarization.
+*/
+struct HorizontalPolarization
+{
+    /**
+    Polarization indicator.
+    */
+    static constexpr int pol = POLARIZATION__HORIZONTAL;
+
+    /**
+    Ground impedance from the complex relative permittivity [RLS, A-3].
+    */
+    template <typename T>
+    static typename EngineComplex<T>::type GroundImpedance(typename EngineComplex<T>::type ep_r)
+    {
+        return sqrt(ep_r - T(1.0));
+    }
+};
+
+/**
+@brief
+Polarization policy of vertical polarization.
+*/
+struct VerticalPolarization
+{
+    /**
+    Polarization indicator.
+    */
+    static constexpr int pol = POLARIZATION__VERTICAL;
+
+    /**
+    Ground impedance from the complex relative permittivity [RLS, A-3].
+    */
+    template <typename T>
+    static typename EngineComplex<T>::type GroundImpedance(typename EngineComplex<T>::type ep_r)
+    {
+        return sqrt(ep_r - T(1.0)) / ep_r;
+    }
+};
+
+/**
+@brief
+Siting policy of a terminal sited without regard to the terrain.
+*/
+struct MobileSiting
+{
+    /**
+    Siting criteria indicator.
+    */
+    static constexpr int site_criteria = SITING_CRITERIA__MOBILE;
+
+    /**
+    Effective height of the terminal [RLS, A-4 & B-4].
+    */
+    template <typename T>
+    static T EffectiveHeight(T h__meter, T /* delta_h__meter */)
+    {
+        return h__meter;
+    }
+};
+
+/**
+@brief
+Siting policy of a terminal sited on a high point of the terrain.
+*/
+struct FixedSiting
+{
+    /**
+    Siting criteria indicator.
+    */
+    static constexpr int site_criteria = SITING_CRITERIA__FIXED;
+
+    /**
+    Effective height of the terminal [RLS, A-5 to A-7 & B-5 to B-7].
+    */
+    template <typename T>
+    static T EffectiveHeight(T h__meter, T delta_h__meter)
+    {
+        using std::exp;
+        using std::sin;
+
+        // [RLS, A-5 & B-5].
+        T B = T(10.0);
+        if (h__meter < T(5.0))
+        {
+            // [RLS, A-6 & B-6].
+            B = (B - T(1.0)) * sin(T(0.1) * T(IlmConstants::pi) * h__meter) + T(1.0);
+        }
+
+        // [RLS, A-7 & B-7].
+        return h__meter + B * exp(T(-2.0) * h__meter / delta_h__meter);
+    }
+};
+
+/**
+@brief
+Frequency and ground dependent constants of the model, as in a RadioContext.
+*/
+template <typename T>
+struct EngineRadio
+{
+    /**
+    Frequency, in MHz.
+    */
+    T f__mhz;
+
+    /**
+    Complex ground impedance.
+    */
+    typename EngineComplex<T>::type Z_g;
+
+    /**
+    Magnitude of the complex ground impedance.
+    */
+    T abs_Z_g;
+
+    /**
+    Wavenumber, in radians/meter.
+    */
+    T k;
+
+    /**
+    Scale distance of the smooth sphere diffraction, in meters.
+    */
+    T X_ae__meter;
+
+    /**
+    Cube root of the frequency in MHz.
+    */
+    T f_cbrt;
+
+    /**
+    Reciprocal of the cube root of the frequency in MHz.
+    */
+    T f_inv_cbrt;
+
+    /**
+    Frequency term of the free space loss, in dB.
+    */
+    T A_f__db;
+};
+
+/**
+@brief
+Terrain parameters of a path, as in a PreparedPath.
+*/
+template <typename T>
+struct EnginePath
+{
+    /**
+    Terminal structural heights, in meters.
+    */
+    T h__meter[2];
+
+    /**
+    Terminal horizon angles.
+    */
+    T theta_hzn[2];
+
+    /**
+    Terminal horizon distances, in meters.
+    */
+    T d_hzn__meter[2];
+
+    /**
+    Terminal effective heights, in meters.
+    */
+    T h_e__meter[2];
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    T delta_h__meter;
+
+    /**
+    Path distance, in meters.
+    */
+    T d__meter;
+
+    /**
+    Path distance, in km.
+    */
+    T d__km;
+};
+
+/**
+@brief
+Intermediate values of an evaluation, as in IntermediateValues.
+*/
+template <typename T>
+struct EngineIntermediateValues
+{
+    /**
+    Terminal horizon angles.
+    */
+    T theta_hzn[2];
+
+    /**
+    Terminal horizon distances, in meters.
+    */
+    T d_hzn__meter[2];
+
+    /**
+    Terminal effective heights, in meters.
+    */
+    T h_e__meter[2];
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    T delta_h__meter;
+
+    /**
+    Reference attenuation, in dB.
+    */
+    T A_ref__db;
+
+    /**
+    Free space basic transmission loss, in dB.
+    */
+    T A_fs__db;
+
+    /**
+    Path distance, in km.
+    */
+    T d__km;
+
+    /**
+    Mode of propagation value.
+    */
+    int mode;
+};
+
+/**
+@brief
+Path distance independent coefficients of the Longley-Rice reference
+attenuation, as in LongleyRiceCoefficients.
+*/
+template <typename T>
+struct EngineCoefficients
+{
+    /**
+    Maximum line-of-sight distance for a smooth earth, in meters.
+    */
+    T d_ls__meter;
+
+    /**
+    Maximum line-of-sight distance for the actual path, in meters.
+    */
+    T d_l__meter;
+
+    /**
+    Minimum path distance for the small angle approximation, in meters.
+    */
+    T d_min__meter;
+
+    /**
+    Diffraction slope, in dB/meter.
+    */
+    T m_d;
+
+    /**
+    Diffraction intercept, in dB.
+    */
+    T A_ed__db;
+
+    /**
+    Line-of-sight linear coefficient, in dB/meter.
+    */
+    T kHat_1;
+
+    /**
+    Line-of-sight logarithmic coefficient, in dB.
+    */
+    T kHat_2;
+
+    /**
+    Line-of-sight intercept, in dB.
+    */
+    T A_o__db;
+};
+
+/**
+@brief
+The Longley-Rice method and its special functions, for a floating point type
+and a precision policy.
+
+Nothing here depends on the polarization or the siting criteria, which only
+enter through the ground impedance of the radio constants and the terrain
+parameters of the path.
+*/
+template <typename T, typename Precision = ExactPrecision>
+struct LongleyRiceModel
+{
+    /**
+    @brief
+    Initialize the radio constants from a frequency and a ground impedance.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in] Z_g
+    Complex ground impedance.
+
+    @param[out] radio
+    Radio constants.
+
+    */
+    static void InitializeRadio(
+        T f__mhz,
+        typename EngineComplex<T>::type Z_g,
+        EngineRadio<T> *radio
+    ) {
+        using std::log10;
+        using std::pow;
+
+        radio->f__mhz = f__mhz;
+        radio->Z_g = Z_g;
+        radio->abs_Z_g = abs(Z_g);
+
+        // [RLS, A-1 & B-1].
+        radio->k = T(2.0) * T(IlmConstants::pi) * (f__mhz * T(1.0E6)) / T(IlmConstants::c__meter_per_sec);
+
+        // [RLS, A-20 & B-18].
+        radio->X_ae__meter = pow(radio->k / pow(T(a_m__meter), 2), -T(IlmConstants::third));
+
+        radio->f_cbrt = pow(f__mhz, T(IlmConstants::third));
+        radio->f_inv_cbrt = pow(f__mhz, -T(IlmConstants::third));
+        radio->A_f__db = T(20.0) * log10(f__mhz);
+    }
+
+    /**
+    @brief
+    Return the free space basic transmission loss, in dB.
+
+    @param[in] d__meter
+    Path distance, in meters.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @return A_fs__db
+    Free space basic transmission loss, in dB.
+
+    */
+    static T FreeSpaceLoss(
+        T d__meter,
+        T f__mhz
+    ) {
+        using std::log10;
+        return T(32.45) + T(20.0) * log10(f__mhz) + T(20.0) * log10(d__meter / T(1000.0));
+    }
+
+    /**
+    @brief
+    Return the free space basic transmission loss, in dB, with the frequency
+    term of the radio constants.
+
+    @param[in] d__meter
+    Path distance, in meters.
+
+    @param[in] radio
+    Radio constants.
+
+    @return A_fs__db
+    Free space basic transmission loss, in dB.
+
+    */
+    static T FreeSpaceLoss(
+        T d__meter,
+        const EngineRadio<T> &radio
+    ) {
+        using std::log10;
+        return T(32.45) + radio.A_f__db + T(20.0) * log10(d__meter / T(1000.0));
+    }
+
+    /**
+    @brief
+    Return the terrain irregularity of a path, delta_h_d, in meters [RLS, A-14].
+
+    @param[in] d__meter
+    Path distance, in meters.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter.
+
+    @return
+    delta_h_d, in meters.
+
+    */
+    static T TerrainRoughness(
+        T d__meter,
+        T delta_h__meter
+    ) {
+        using std::exp;
+        return delta_h__meter * (T(1.0) - T(0.8) * exp(-d__meter / T(IlmConstants::d_scale__meter)));
+    }
+
+    /**
+    @brief
+    Return the RMS deviation of terrain and terrain clutter within the first
+    Fresnel zone, sigma_h, in meters [ERL 79-ITS 67, Eqn 3.6a].
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter.
+
+    @return
+    sigma_h, in meters.
+
+    */
+    static T SigmaHFunction(
+        T delta_h__meter
+    ) {
+        using std::exp;
+        using std::pow;
+        return T(0.78) * delta_h__meter * exp(T(-0.5) * pow(delta_h__meter, T(0.25)));
+    }
+
+    /**
+    @brief
+    Approximation to ideal knife edge diffraction loss.
+
+    @param[in] v2
+    v^2 parameter.
+
+    @return A(v, 0)
+    Loss, in dB.
+
+    */
+    static T FresnelIntegral(
+        T v2
+    ) {
+        using std::sqrt;
+
+        // Note: v2  is v^2, so 5.76 is actually comparing v to 2.4.
+        if (v2 < T(5.76))
+            // [TN101v2, Eqn III.24b] and [ERL 79-ITS 67, Eqn 3.27a & 3.27b].
+            return T(6.02) + T(9.11) * sqrt(v2) - T(1.27) * v2;
+        else
+            // [TN101v2, Eqn III.24c] and [ERL 79-ITS 67, Eqn 3.27a & 3.27b].
+            return T(12.953) + T(10.0) * Precision::Log10(v2);
+    }
+
+    /**
+    @brief
+    Height Function, F(x, K) for smooth earth diffraction.
+
+    @param[in] x__km
+    Normalized distance, in meters.
+
+    @param[in] K
+    K value.
+
+    @return
+    F(x, K), in dB.
+
+    */
+    static T HeightFunction(
+        T x__km,
+        T K
+    ) {
+        using std::pow;
+
+        T w;
+        T result;
+
+        if (x__km < T(200.0))
+        {
+            w = -Precision::Log(K);
+
+            if (K < T(1.0E-5) || x__km * Precision::Cube(w) > T(5495.0))
+            {
+                result = T(-117.0);
+
+                if (x__km > T(1.0))
+                    result = T(17.372) * Precision::Log(x__km) + result;
+            }
+            else
+                result = T(2.5E-5) * pow(x__km, 2) / K - T(8.686) * w - T(15.0);
+        }
+        else
+        {
+            result = T(0.05751) * x__km - T(4.343) * Precision::Log(x__km);
+
+            if (x__km < T(2000.0))
+            {
+                w = T(0.0134) * x__km * Precision::Exp(T(-0.005) * x__km);
+                result = (T(1.0) - w) * result + w * (T(17.372) * Precision::Log(x__km) - T(117.0));
+            }
+        }
+
+        return result;
+    }
+
+    /**
+    @brief
+    Compute the B_0 factor of the normalized distance of smooth sphere
+    diffraction [Vogler 1964, Fig 4], [RLS, A-76].
+
+    @param[in] K
+    K value.
+
+    @return
+    B_0 value.
+
+    */
+    static T SmoothSphereB0(
+        T K
+    ) {
+        return T(1.607) - ReferenceAbs(K);
+    }
+
+    /**
+    @brief
+    Compute the knife-edge diffraction loss.
+
+    @param[in] d__meter
+    Distance of interest, in meters.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in] theta_los
+    Angular distance of line-of-sight region.
+
+    @param[in] d_hzn__meter
+    Horizon distances, in meters.
+
+    @return A_k__db
+    Knife-edge diffraction loss, in dB.
+
+    */
+    static T KnifeEdgeDiffraction(
+        T d__meter,
+        T f__mhz,
+        T theta_los,
+        const T d_hzn__meter[2]
+    ) {
+        using std::pow;
+
+        // Maximum line-of-sight distance for actual path.
+        T d_ML__meter = d_hzn__meter[0] + d_hzn__meter[1];
+
+        // Angular distance of diffraction region [Algorithm, Eqn 4.12].
+        T theta_nlos = d__meter / T(a_m__meter) - theta_los;
+
+        // Diffraction distance, in meters.
+        T d_nlos__meter = d__meter - d_ML__meter;
+
+        // [TN101, Eqn I.7].
+        // 1 / (4 pi) = 0.0795775
+        T v_1 = T(0.0795775) * (f__mhz / T(47.7)) * pow(theta_nlos, 2) * d_hzn__meter[0] * d_nlos__meter / (d_nlos__meter + d_hzn__meter[0]);
+        T v_2 = T(0.0795775) * (f__mhz / T(47.7)) * pow(theta_nlos, 2) * d_hzn__meter[1] * d_nlos__meter / (d_nlos__meter + d_hzn__meter[1]);
+
+        // [RLS, A-26& B-24].
+        return FresnelIntegral(v_1) + FresnelIntegral(v_2);
+    }
+
+    /**
+    @brief
+    Compute the smooth sphere diffraction loss using the Vogler 3-radii
+    method.
+
+    @param[in] radius__meter
+    Sphere's radius, in meters.
+
+    @param[in] d__meter
+    Path distance, in meters.
+
+    @param[in] radio
+    Radio constants.
+
+    @param[in] theta_los
+    Angular distance of line-of-sight region.
+
+    @param[in] d_hzn__meter
+    Horizon distances, in meters.
+
+    @param[in] h_e__meter
+    Effective terminal heights, in meters.
+
+    @return A_r__db
+    Smooth-sphere diffraction loss, in dB.
+
+    */
+    static T SmoothSphereDiffraction(
+        T radius__meter,
+        T d__meter,
+        const EngineRadio<T> &radio,
+        T theta_los,
+        const T d_hzn__meter[2],
+        const T h_e__meter[2]
+    ) {
+        using std::pow;
+
+        T a__meter[3];
+        T d__km[3];
+        T F_x__db[2];
+        T K[3];
+        T B_0[3];
+        T x__km[3];
+        T C_0[3];
+
+        // [Algorithm, Eqn 4.12].
+        T theta_nlos = d__meter / radius__meter - theta_los;
+
+        // Maximum line-of-sight distance for actual path.
+        T d_ML__meter = d_hzn__meter[0] + d_hzn__meter[1];
+
+        // [RLS, A-30b, rearranged]
+        // Which is radius__meter when theta_los = d_ML__meter / radius__meter.
+        a__meter[0] = (d__meter - d_ML__meter) / (d__meter / radius__meter - theta_los);
+
+        // Radius of the effective earth for each terminal, [Volger 1964, Eqn 3]
+        // re-arranged.
+        a__meter[1] = T(0.5) * pow(d_hzn__meter[0], 2) / h_e__meter[0];
+        a__meter[2] = T(0.5) * pow(d_hzn__meter[1], 2) / h_e__meter[1];
+
+        // Angular distance of the "diffraction path".
+        d__km[0] = (a__meter[0] * theta_nlos) / T(1000.0);
+        d__km[1] = d_hzn__meter[0] / T(1000.0);
+        d__km[2] = d_hzn__meter[1] / T(1000.0);
+
+        for (int i = 0; i < 3; i++)
+        {
+            // C_0 = (4 / 3k) ^ (1 / 3) [Vogler 1964, Eqn 2].
+            C_0[i] = Precision::Cbrt((T(4.0) / T(3.0)) * radius__meter / a__meter[i]);
+
+            // [Vogler 1964, Eqn 6a / 7a].
+            K[i] = T(0.017778) * C_0[i] * radio.f_inv_cbrt / radio.abs_Z_g;
+
+            B_0[i] = SmoothSphereB0(K[i]);
+        }
+
+        // Compute x__km for each radius [RLS].
+        x__km[1] = B_0[1] * pow(C_0[1], 2) * radio.f_cbrt * d__km[1];
+        x__km[2] = B_0[2] * pow(C_0[2], 2) * radio.f_cbrt * d__km[2];
+        x__km[0] = B_0[0] * pow(C_0[0], 2) * radio.f_cbrt * d__km[0] + x__km[1] + x__km[2];
+
+        // Compute height gain functions.
+        F_x__db[0] = HeightFunction(x__km[1], K[1]);
+        F_x__db[1] = HeightFunction(x__km[2], K[2]);
+
+        // Compute distance function.
+        // [TN101, Eqn 8.4] & [Volger 1964, Eqn 13].
+        T G_x__db = T(0.05751) * x__km[0] - T(10.0) * Precision::Log10(x__km[0]);
+
+        // [Algorithm, Eqn 4.20] & [Volger 1964].
+        return G_x__db - F_x__db[0] - F_x__db[1] - T(20.0);
+    }
+
+    /**
+    @brief
+    Compute the diffraction loss at a specified distance.
+
+    @param[in] radius__meter
+    Radius in meters of the celestial body under consideration.
+
+    @param[in] d__meter
+    Path distance, in meters.
+
+    @param[in] d_hzn__meter
+    Horizon distances, in meters.
+
+    @param[in] h_e__meter
+    Effective terminal heights, in meters.
+
+    @param[in] radio
+    Radio constants.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter, in meters.
+
+    @param[in] h__meter
+    Terminal heights, in meters.
+
+    @param[in] theta_los
+    Angular distance of line-of-sight region.
+
+    @return A_d__db
+    Diffraction loss, in dB.
+
+    */
+    static T DiffractionLoss(
+        T radius__meter,
+        T d__meter,
+        const T d_hzn__meter[2],
+        const T h_e__meter[2],
+        const EngineRadio<T> &radio,
+        T delta_h__meter,
+        const T h__meter[2],
+        T theta_los
+    ) {
+        using std::sqrt;
+
+        T A_k__db = KnifeEdgeDiffraction(
+            d__meter,
+            radio.f__mhz,
+            theta_los,
+            d_hzn__meter
+        );
+
+        T A_r__db = SmoothSphereDiffraction(
+            radius__meter,
+            d__meter,
+            radio,
+            theta_los,
+            d_hzn__meter,
+            h_e__meter
+        );
+
+        T delta_h_d__meter = TerrainRoughness(
+            d__meter,
+            delta_h__meter
+        );
+
+        // [RLS, A-25 & B-23].
+        T term1 = sqrt((h_e__meter[0] * h_e__meter[1]) / (h__meter[0] * h__meter[1]));
+        T d_l__meter = d_hzn__meter[0] + d_hzn__meter[1];
+        T q = (term1 + (-theta_los * radius__meter + d_l__meter) / d__meter) * std::min(delta_h_d__meter * radio.f__mhz / T(47.7), T(1000.0));
+
+        // [RLS, A-24 & B-22].
+        T w = T(1.0) / (T(1.0) + T(0.1) * sqrt(q));
+
+        // [RLS, A-23 & B-21].
+        return w * A_r__db + (T(1.0) - w) * A_k__db;
+    }
+
+    /**
+    @brief
+    Compute the loss in the line-of-sight region.
+
+    @param[in] s__meter
+    Path distance, in meters.
+
+    @param[in] h_e__meter
+    Terminal effective heights, in meters.
+
+    @param[in] radio
+    Radio constants.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter.
+
+    @param[in] m_d
+    Diffraction slope.
+
+    @param[in] A_ed
+    Diffraction intercept.
+
+    @param[in] d_ls__meter
+    Maximum line-of-sight distance for a smooth earth, in meters.
+
+    @return A_los__db
+    Loss, in dB.
+
+    */
+    static T LineOfSightLoss(
+        T s__meter,
+        const T h_e__meter[2],
+        const EngineRadio<T> &radio,
+        T delta_h__meter,
+        T m_d,
+        T A_ed,
+        T d_ls__meter
+    ) {
+        using std::cos;
+        using std::pow;
+        using std::sin;
+        using std::sqrt;
+
+        // [RLS, A-67 & B-65].
+        T sigma_h_s__meter = (delta_h__meter / T(1.282)) * Precision::Exp(-Precision::Root4(delta_h__meter) / T(2.0));
+
+        // [RLS, A-1].
+        T k = radio.k;
+
+        // [RLS, A-65 & B-63].
+        T sin_psi = (h_e__meter[0] + h_e__meter[1]) / sqrt(pow(s__meter, 2) + pow(h_e__meter[0] + h_e__meter[1], 2));
+
+        // [RLS, A-66 & B-64].
+        typename EngineComplex<T>::type R_e = (sin_psi - radio.Z_g) / (sin_psi + radio.Z_g) * Precision::Exp(-k * sigma_h_s__meter * sin_psi);
+
+        // [RLS, A-69 & B-67].
+        T q = pow(R_e.real(), 2) + pow(R_e.imag(), 2);
+        if (q < T(0.25) || q < sin_psi)
+            R_e = R_e * sqrt(sin_psi / q);
+
+        // [RLS, A-68 & B-66].
+        T delta_phi = T(2.0) * k * h_e__meter[0] * h_e__meter[1] / s__meter;
+
+        // [RLS, A-70 & B-68].
+        if (delta_phi > T(IlmConstants::pi) / T(2.0))
+            delta_phi = T(IlmConstants::pi) - pow(T(IlmConstants::pi) / T(2.0), 2) / delta_phi;
+
+        // [RLS, A-71 & B-69].
+        typename EngineComplex<T>::type rr = typename EngineComplex<T>::type(cos(delta_phi), -sin(delta_phi)) + R_e;
+        T A_t__db = T(-10.0) * Precision::Log10(pow(rr.real(), 2) + pow(rr.imag(), 2));
+
+        // [RLS, A-64 & B-62].
+        T A_d__db = A_ed + m_d * s__meter;
+
+        // [RLS, A-63 & B-61].
+        T D_1 = T(47.7);
+        T D_2 = T(10.0E3);
+        T w = T(1.0) / (T(1.0) + D_1 * k * delta_h__meter / std::max(D_2, d_ls__meter));
+
+        // [RLS, A-62 & B-60].
+        return (T(1.0) - w) * A_d__db + w * A_t__db;
+    }
+
+    /**
+    @brief
+    Return if the ground impedance of the radio constants can be used by the
+    Longley-Rice method.
+
+    @param[in] radio
+    Radio constants.
+
+    @return
+    False if InitializeLongleyRice() returns ERROR__GROUND_IMPEDANCE.
+
+    */
+    static bool ValidGroundImpedance(
+        const EngineRadio<T> &radio
+    ) {
+        return !(radio.Z_g.real() <= ReferenceAbs(radio.Z_g.imag()));
+    }
+
+    /**
+    @brief
+    Check the validity of the small angle approximation for the terminal
+    horizon angles.
+
+    @param[in] theta_hzn
+    Terminal horizon angles.
+
+    @param[in,out] warnings
+    Warning flags.
+
+    */
+    static void SmallAngleWarnings(
+        const T theta_hzn[2],
+        long *warnings
+    ) {
+        if (ReferenceAbs(theta_hzn[0]) > T(IlmConstants::theta_max))
+            *warnings |= WARN__TX_HORIZON_ANGLE;
+        if (ReferenceAbs(theta_hzn[1]) > T(IlmConstants::theta_max))
+            *warnings |= WARN__RX_HORIZON_ANGLE;
+    }
+
+    /**
+    @brief
+    Compute the path distance below which the terminal effective heights are
+    too different for the Longley-Rice method.
+
+    @param[in] h_e__meter
+    Effective terminal heights, in meters.
+
+    @return
+    Minimum path distance, in meters.
+
+    */
+    static T MinimumPathDistance(
+        const T h_e__meter[2]
+    ) {
+        return ReferenceAbs(h_e__meter[0] - h_e__meter[1]) / T(IlmConstants::theta_max);
+    }
+
+    /**
+    @brief
+    Compute the distance-independent coefficients of the Longley-Rice
+    reference attenuation.
+
+    @param[in] theta_hzn
+    Terminal horizon angles.
+
+    @param[in] radio
+    Radio constants.
+
+    @param[in] d_hzn__meter
+    Terminal horizon distances, in meters.
+
+    @param[in] h_e__meter
+    Effective terminal heights, in meters.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter.
+
+    @param[in] h__meter
+    Terminal structural heights, in meters.
+
+    @param[out] coeffs
+    Longley-Rice coefficients.
+
+    @param[out] warnings
+    Warning flags.
+
+    @return error
+    Error code.
+
+    */
+    static int InitializeLongleyRice(
+        const T theta_hzn[2],
+        const EngineRadio<T> &radio,
+        const T d_hzn__meter[2],
+        const T h_e__meter[2],
+        T delta_h__meter,
+        const T h__meter[2],
+        EngineCoefficients<T> *coeffs,
+        long *warnings
+    ) {
+        using std::log;
+        using std::sqrt;
+
+        // [RLS, A-8 & B-8].
+        T d_hzn_s__meter[2];
+        for (int i = 0; i < 2; i++)
+            d_hzn_s__meter[i] = sqrt(T(2.0) * h_e__meter[i] * T(a_m__meter));
+
+        // [RLS, A-11].
+        T d_ls__meter = d_hzn_s__meter[0] + d_hzn_s__meter[1];
+
+        // [RLS, A-12].
+        T d_l__meter = d_hzn__meter[0] + d_hzn__meter[1];
+
+        SmallAngleWarnings(
+            theta_hzn,
+            warnings
+        );
+
+        if (d_hzn__meter[0] < T(0.1) * d_hzn_s__meter[0])
+            *warnings |= WARN__TX_HORIZON_DISTANCE_1;
+        if (d_hzn__meter[1] < T(0.1) * d_hzn_s__meter[1])
+            *warnings |= WARN__RX_HORIZON_DISTANCE_1;
+
+        if (d_hzn__meter[0] > T(3.0) * d_hzn_s__meter[0])
+            *warnings |= WARN__TX_HORIZON_DISTANCE_2;
+        if (d_hzn__meter[1] > T(3.0) * d_hzn_s__meter[1])
+            *warnings |= WARN__RX_HORIZON_DISTANCE_2;
+
+        // Check ground impedance.
+        if (!ValidGroundImpedance(radio))
+            return ERROR__GROUND_IMPEDANCE;
+
+        // [RLS, A-1 & B-1].
+        T k = radio.k;
+
+        // [RLS, A-20 & B-18].
+        T X_ae__meter = radio.X_ae__meter;
+
+        // [RLS, A-16 & B-14].
+        T d_3__meter = std::max(d_ls__meter, d_l__meter + T(1.3787) * X_ae__meter);
+        // [RLS, A-17 & B-15].
+        T d_4__meter = d_3__meter + T(2.7574) * X_ae__meter;
+
+        // [RLS, A-18 & B-16].
+        T A_3__db = DiffractionLoss(
+            T(a_m__meter),
+            d_3__meter,
+            d_hzn__meter,
+            h_e__meter,
+            radio,
+            delta_h__meter,
+            h__meter,
+            d_ls__meter
+        );
+        // [RLS, A-19 & B-17].
+        T A_4__db = DiffractionLoss(
+            T(a_m__meter),
+            d_4__meter,
+            d_hzn__meter,
+            h_e__meter,
+            radio,
+            delta_h__meter,
+            h__meter,
+            d_ls__meter
+        );
+
+        // [RLS, A-21 & B-19].
+        T m_d = (A_4__db - A_3__db) / (d_4__meter - d_3__meter);
+        // [RLS, A-22 & B-20].
+        T A_ed__db = A_3__db - m_d * d_3__meter;
+
+        /* Line-of-sight coefficients. */
+
+        // [RLS, A-35 & B-33].
+        T d_2__meter = d_ls__meter;
+
+        // [RLS, A-36 & B-34].
+        T A_2__db = A_ed__db + m_d * d_ls__meter;
+
+        T d_0__meter;
+        T d_1__meter;
+
+        if (A_ed__db >= T(0.0))  // [RLS, A.1.5, CASE 1].
+        {
+            // [RLS, A-37 & B-35].
+            d_0__meter = std::min(T(0.5) * d_l__meter, T(1.908) * k * h_e__meter[0] * h_e__meter[1]);
+            // [RLS, A-38 & B-36].
+            d_1__meter = T(3.0) / T(4.0) * d_0__meter + d_l__meter / T(4.0);
+        }
+        else
+        {
+            // [RLS, A-47].
+            d_0__meter = T(1.908) * k * h_e__meter[0] * h_e__meter[1];
+            // [RLS, A-48].
+            d_1__meter = std::max(-A_ed__db / m_d, d_l__meter / T(4.0));
+        }
+
+        T A_1__db = LineOfSightLoss(
+            d_1__meter,
+            h_e__meter,
+            radio,
+            delta_h__meter,
+            m_d,
+            A_ed__db,
+            d_ls__meter
+        );
+
+        bool flag = false;
+
+        T kHat_1 = T(0.0);
+        T kHat_2 = T(0.0);
+
+        if (d_0__meter < d_1__meter)
+        {
+            T A_0__db = LineOfSightLoss(
+                d_0__meter,
+                h_e__meter,
+                radio,
+                delta_h__meter,
+                m_d,
+                A_ed__db,
+                d_ls__meter
+            );
+
+            T term1 = log(d_ls__meter / d_0__meter);
+
+            // [ERL 79-ITS 67, Eqn 3.20].
+            kHat_2 = std::max(T(0.0), ((d_ls__meter - d_0__meter) * (A_1__db - A_0__db) - (d_1__meter - d_0__meter) * (A_2__db - A_0__db)) / ((d_ls__meter - d_0__meter) * log(d_1__meter / d_0__meter) - (d_1__meter - d_0__meter) * term1));
+
+            flag = A_ed__db > T(0.0) || kHat_2 > T(0.0);
+
+            if (flag)
+            {
+                // [RLS, A-42 & A-52 & B-40 & B-50].
+                kHat_1 = (A_2__db - A_0__db - kHat_2 * term1) / (d_2__meter - d_0__meter);
+
+                if (kHat_1 < T(0.0))
+                {
+                    kHat_1 = T(0.0);
+
+                    // [RLS, A-54 & B-42].
+                    kHat_2 = Dim(A_2__db, A_0__db) / term1;
+
+                    if (kHat_2 == T(0.0))
+                        kHat_1 = m_d;
+                }
+            }
+        }
+
+        if (!flag)
+        {
+            kHat_1 = Dim(A_2__db, A_1__db) / (d_ls__meter - d_1__meter);
+            kHat_2 = T(0.0);
+
+            if (kHat_1 == T(0.0))
+                kHat_1 = m_d;
+        }
+
+        T A_o__db = A_2__db - kHat_1 * d_ls__meter - kHat_2 * log(d_ls__meter);
+
+        coeffs->d_ls__meter = d_ls__meter;
+        coeffs->d_l__meter = d_l__meter;
+        coeffs->d_min__meter = MinimumPathDistance(h_e__meter);
+        coeffs->m_d = m_d;
+        coeffs->A_ed__db = A_ed__db;
+        coeffs->kHat_1 = kHat_1;
+        coeffs->kHat_2 = kHat_2;
+        coeffs->A_o__db = A_o__db;
+
+        return SUCCESS;
+    }
+
+    /**
+    @brief
+    Evaluate the Longley-Rice reference attenuation at a path distance.
+
+    @param[in] coeffs
+    Longley-Rice coefficients, from InitializeLongleyRice().
+
+    @param[in] d__meter
+    Path distance, in meters.
+
+    @param[out] A_ref__db
+    Reference attenuation, in dB.
+
+    @param[out] warnings
+    Warning flags.
+
+    @param[out] propmode
+    Mode of propagation value.
+
+    */
+    static void EvaluateLongleyRice(
+        const EngineCoefficients<T> &coeffs,
+        T d__meter,
+        T *A_ref__db,
+        long *warnings,
+        int *propmode
+    ) {
+        using std::log;
+
+        if (d__meter < coeffs.d_min__meter)
+            *warnings |= WARN__PATH_DISTANCE_TOO_SMALL_1;
+        if (d__meter < T(1.0E3))
+            *warnings |= WARN__PATH_DISTANCE_TOO_SMALL_2;
+        if (d__meter > T(1000.0E3))
+            *warnings |= WARN__PATH_DISTANCE_TOO_BIG_1;
+        if (d__meter > T(2000.0E3))
+            *warnings |= WARN__PATH_DISTANCE_TOO_BIG_2;
+
+        if (d__meter < coeffs.d_ls__meter)
+        {
+            // [ERL 79-ITS 67, Eqn 3.19].
+            *A_ref__db = coeffs.A_o__db + coeffs.kHat_1 * d__meter + coeffs.kHat_2 * log(d__meter);
+        }
+        else  // This is a trans-horizon path.
+        {
+            *A_ref__db = coeffs.m_d * d__meter + coeffs.A_ed__db;
+        }
+
+        // Set mode of propagation.
+        T delta__meter = d__meter - coeffs.d_l__meter;
+        if (int(delta__meter) < 0)
+            *propmode = MODE__LINE_OF_SIGHT;
+        else
+            *propmode = (int(delta__meter) == 0) ? MODE__DIFFRACTION_SINGLE_HORIZON : MODE__DIFFRACTION_DOUBLE_HORIZON;
+
+        // Don't allow a negative loss.
+        *A_ref__db = std::max(*A_ref__db, T(0.0));
+    }
+
+    /**
+    @brief
+    Compute the reference attenuation, using the Longley-Rice method.
+
+    @param[in] theta_hzn
+    Terminal horizon angles.
+
+    @param[in] radio
+    Radio constants.
+
+    @param[in] d_hzn__meter
+    Terminal horizon distances, in meters.
+
+    @param[in] h_e__meter
+    Effective terminal heights, in meters.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter.
+
+    @param[in] h__meter
+    Terminal structural heights, in meters.
+
+    @param[in] d__meter
+    Path distance, in meters.
+
+    @param[out] A_ref__db
+    Reference attenuation, in dB.
+
+    @param[out] warnings
+    Warning flags.
+
+    @param[out] propmode
+    Mode of propagation value.
+
+    @return error
+    Error code.
+
+    */
+    static int LongleyRice(
+        const T theta_hzn[2],
+        const EngineRadio<T> &radio,
+        const T d_hzn__meter[2],
+        const T h_e__meter[2],
+        T delta_h__meter,
+        const T h__meter[2],
+        T d__meter,
+        T *A_ref__db,
+        long *warnings,
+        int *propmode
+    ) {
+        EngineCoefficients<T> coeffs;
+
+        int rtn = InitializeLongleyRice(
+            theta_hzn,
+            radio,
+            d_hzn__meter,
+            h_e__meter,
+            delta_h__meter,
+            h__meter,
+            &coeffs,
+            warnings
+        );
+        if (rtn != SUCCESS)
+            return rtn;
+
+        EvaluateLongleyRice(
+            coeffs,
+            d__meter,
+            A_ref__db,
+            warnings,
+            propmode
+        );
+
+        return SUCCESS;
+    }
+
+    /**
+    @brief
+    Return the inverse complementary cumulative distribution function, with
+    the approximation of Formula 26.2.23 in Abramowitz & Stegun, which has an
+    error of abs(epsilon(p)) < 4.5E-4.
+
+    @param[in] q
+    Quantile, 0.0 < q < 1.0.
+
+    @return Q_q
+    Q(q)^-1.
+
+    */
+    static T InverseComplementaryCumulativeDistributionFunction(
+        T q
+    ) {
+        using std::sqrt;
+
+        T C_0 = T(2.515516);
+        T C_1 = T(0.802853);
+        T C_2 = T(0.010328);
+        T D_1 = T(1.432788);
+        T D_2 = T(0.189269);
+        T D_3 = T(0.001308);
+
+        T x = q;
+        if (q > T(0.5))
+            x = T(1.0) - x;
+
+        T T_x = sqrt(T(-2.0) * Precision::Log(x));
+
+        T zeta_x = ((C_2 * T_x + C_1) * T_x + C_0) / (((D_3 * T_x + D_2) * T_x + D_1) * T_x + T(1.0));
+
+        T Q_q = T_x - zeta_x;
+
+        if (q > T(0.5))
+            Q_q = -Q_q;
+
+        return Q_q;
+    }
+
+    /**
+    @brief
+    Compute the variability.
+
+    @param[in] p
+    Location percentage, 0 < location < 1.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter.
+
+    @param[in] radio
+    Radio constants.
+
+    @param[in] d__meter
+    Path distance, in meters.
+
+    @param[in] A_ref__db
+    Reference attenuation, in dB.
+
+    @return A_ref__db
+    Reference attenuation, with variability, in dB.
+
+    */
+    static T Variability(
+        T p,
+        T delta_h__meter,
+        const EngineRadio<T> &radio,
+        T d__meter,
+        T A_ref__db
+    ) {
+        // [RLS, A-1 & B-1].
+        T k = radio.k;
+
+        // [RLS, A-72 & B-70].
+        T delta_h_d__meter = delta_h__meter * (T(1.0) - T(0.8) * Precision::Exp(-d__meter / T(IlmConstants::d_scale__meter)));
+
+        // [RLS, A-73 & B-71].
+        T sigma = T(10.0) * k * delta_h_d__meter / (k * delta_h_d__meter + T(13.0));
+
+        // [RLS, A-74 & B-72].
+        T z = InverseComplementaryCumulativeDistributionFunction(p);
+
+        // [RLS, A-75 & B-73].
+        A_ref__db = A_ref__db + sigma * z;
+
+        // [Algorithm, Eqn 52].
+        if (A_ref__db < T(0.0))
+            A_ref__db = A_ref__db * (T(29.0) - A_ref__db) / (T(29.0) - T(10.0) * A_ref__db);
+
+        return A_ref__db;
+    }
+
+    /**
+    @brief
+    Evaluate a path with the Longley-Rice method, for an array of location
+    percentages.
+
+    The inputs are not validated.
+
+    @param[in] path
+    Terrain parameters of the path.
+
+    @param[in] radio
+    Radio constants.
+
+    @param[in] n_p
+    Number of location percentages, at least 1.
+
+    @param[in] p
+    Location percentages, 0 < p < 100.
+
+    @param[out] A__db
+    Basic transmission loss at each location percentage, in dB.
+
+    @param[in,out] warnings
+    Warning flags.
+
+    @param[out] interValues
+    Intermediate values. Only the path distance is set if there is an error.
+
+    @return error
+    Error code.
+
+    */
+    static int EvaluatePath(
+        const EnginePath<T> &path,
+        const EngineRadio<T> &radio,
+        int n_p,
+        const T p[],
+        T A__db[],
+        long *warnings,
+        EngineIntermediateValues<T> *interValues
+    ) {
+        interValues->d__km = path.d__km;
+
+        // Reference attenuation, in dB.
+        T A_ref__db = T(0.0);
+        int propmode = MODE__NOT_SET;
+        int rtn = LongleyRice(
+            path.theta_hzn,
+            radio,
+            path.d_hzn__meter,
+            path.h_e__meter,
+            path.delta_h__meter,
+            path.h__meter,
+            path.d__meter,
+            &A_ref__db,
+            warnings,
+            &propmode
+        );
+        if (rtn != SUCCESS)
+            return rtn;
+
+        T A_fs__db = FreeSpaceLoss(
+            path.d__meter,
+            radio
+        );
+
+        for (int i = 0; i < n_p; i++)
+        {
+            // Switch from percentages to ratios.
+            A__db[i] = A_fs__db
+                + Variability(
+                    p[i] / T(100.0),
+                    path.delta_h__meter,
+                    radio,
+                    path.d__meter,
+                    A_ref__db
+                );
+        }
+
+        // Save intermediate values.
+        interValues->A_ref__db = A_ref__db;
+        interValues->A_fs__db = A_fs__db;
+        interValues->delta_h__meter = path.delta_h__meter;
+        interValues->d_hzn__meter[0] = path.d_hzn__meter[0];
+        interValues->d_hzn__meter[1] = path.d_hzn__meter[1];
+        interValues->h_e__meter[0] = path.h_e__meter[0];
+        interValues->h_e__meter[1] = path.h_e__meter[1];
+        interValues->theta_hzn[0] = path.theta_hzn[0];
+        interValues->theta_hzn[1] = path.theta_hzn[1];
+        interValues->mode = propmode;
+
+        return SUCCESS;
+    }
+
+private:
+    /**
+    @brief
+    Return x - y if positive, else 0.
+    */
+    static T Dim(
+        T x,
+        T y
+    ) {
+        return (x > y) ? (x - y) : T(0);
+    }
+};
+
+/**
+@brief
+Terrain estimates of the area mode, for a floating point type. The siting
+policies of the terminals are template parameters of the functions.
+*/
+template <typename T>
+struct AreaModel
+{
+    /**
+    @brief
+    Estimate the effective height, horizon distance and horizon angle of a
+    terminal in area mode.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter, in meters.
+
+    @param[in] h__meter
+    Structural height of the terminal, in meters.
+
+    @param[out] h_e__meter
+    Effective height of the terminal, in meters.
+
+    @param[out] d_l__meter
+    Horizon distance of the terminal, in meters.
+
+    @param[out] theta_hzn
+    Horizon angle of the terminal.
+
+    */
+    template <typename Siting>
+    static void InitializeTerminal(
+        T delta_h__meter,
+        T h__meter,
+        T *h_e__meter,
+        T *d_l__meter,
+        T *theta_hzn
+    ) {
+        using std::exp;
+        using std::sqrt;
+
+        *h_e__meter = Siting::EffectiveHeight(h__meter, delta_h__meter);
+
+        // [RLS, A-8 & B-8].
+        T d_ls__meter = sqrt(T(2.0) * *h_e__meter * T(a_m__meter));
+
+        // [RLS, A-9 & B-9].
+        *d_l__meter = d_ls__meter * exp(T(-0.07) * sqrt(delta_h__meter / std::max(*h_e__meter, T(5.0))));
+
+        // [RLS, A-10 & B-10].
+        *theta_hzn = -(T(2.0) * *h_e__meter + T(0.65) * delta_h__meter * (d_ls__meter / *d_l__meter - T(1.0))) / d_ls__meter;
+    }
+
+    /**
+    @brief
+    Prepare a Point-to-Area path, from the siting criteria of the terminals
+    and the terrain irregularity parameter.
+
+    @param[in] h_tx__meter
+    Structural height of the TX, in meters.
+
+    @param[in] h_rx__meter
+    Structural height of the RX, in meters.
+
+    @param[in] d__km
+    Path distance, in km.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter.
+
+    @param[out] path
+    Terrain parameters of the path.
+
+    @return error
+    Error code.
+
+    */
+    template <typename TxSiting, typename RxSiting>
+    static int PrepareArea(
+        T h_tx__meter,
+        T h_rx__meter,
+        T d__km,
+        T delta_h__meter,
+        EnginePath<T> *path
+    ) {
+        // Additional area mode parameter validation checks.
+        if (d__km <= T(0))
+            return ERROR__PATH_DISTANCE;
+        if (delta_h__meter < T(0))
+            return ERROR__DELTA_H;
+
+        path->h__meter[0] = h_tx__meter;
+        path->h__meter[1] = h_rx__meter;
+        path->delta_h__meter = delta_h__meter;
+        path->d__meter = d__km * T(1000.0);
+        path->d__km = d__km;
+
+        InitializeTerminal<TxSiting>(
+            delta_h__meter,
+            h_tx__meter,
+            &path->h_e__meter[0],
+            &path->d_hzn__meter[0],
+            &path->theta_hzn[0]
+        );
+        InitializeTerminal<RxSiting>(
+            delta_h__meter,
+            h_rx__meter,
+            &path->h_e__meter[1],
+            &path->d_hzn__meter[1],
+            &path->theta_hzn[1]
+        );
+
+        return SUCCESS;
+    }
+};
+
+/**
+@brief
+The ILM for a floating point type, a polarization policy and a precision
+policy. The siting policies of the terminals are parameters of the area mode
+functions.
+*/
+template <typename T, typename Polarization, typename Precision = ExactPrecision>
+struct IlmEngine
+{
+    /**
+    @brief
+    The Longley-Rice method of the engine.
+    */
+    typedef LongleyRiceModel<T, Precision> Model;
+
+    /**
+    @brief
+    Compute the complex ground impedance.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in] epsilon
+    Relative permittivity.
+
+    @param[in] sigma
+    Conductivity.
+
+    @return Z_g
+    Complex ground impedance.
+
+    */
+    static typename EngineComplex<T>::type GroundImpedance(
+        T f__mhz,
+        T epsilon,
+        T sigma
+    ) {
+        // Complex relative permittivity.
+        typename EngineComplex<T>::type ep_r = typename EngineComplex<T>::type(epsilon, T(18000.0) * sigma / f__mhz);
+
+        return Polarization::template GroundImpedance<T>(ep_r);
+    }
+
+    /**
+    @brief
+    Initialize the radio constants of a set of paths.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in] epsilon
+    Relative permittivity.
+
+    @param[in] sigma
+    Conductivity.
+
+    @param[out] radio
+    Radio constants.
+
+    */
+    static void InitializeRadio(
+        T f__mhz,
+        T epsilon,
+        T sigma,
+        EngineRadio<T> *radio
+    ) {
+        Model::InitializeRadio(
+            f__mhz,
+            GroundImpedance(f__mhz, epsilon, sigma),
+            radio
+        );
+    }
+
+    /**
+    @brief
+    Validate the terminal heights and the frequency.
+
+    @param[in] h_tx__meter
+    Structural height of the TX, in meters.
+
+    @param[in] h_rx__meter
+    Structural height of the RX, in meters.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in,out] warnings
+    Warning flags.
+
+    @return error
+    Error code.
+
+    */
+    static int ValidateTerminals(
+        T h_tx__meter,
+        T h_rx__meter,
+        T f__mhz,
+        long *warnings
+    ) {
+        if (h_tx__meter < T(1.0) || h_tx__meter > T(1000.0))
+            *warnings |= WARN__TX_TERMINAL_HEIGHT;
+
+        if (h_tx__meter < T(0.5) || h_tx__meter > T(3000.0))
+            return ERROR__TX_TERMINAL_HEIGHT;
+
+        if (h_rx__meter < T(1.0) || h_rx__meter > T(1000.0))
+            *warnings |= WARN__RX_TERMINAL_HEIGHT;
+
+        if (h_rx__meter < T(0.5) || h_rx__meter > T(3000.0))
+            return ERROR__RX_TERMINAL_HEIGHT;
+
+        if (f__mhz < T(40.0) || f__mhz > T(10000.0))
+            *warnings |= WARN__FREQUENCY;
+
+        if (f__mhz < T(20.0) || f__mhz > T(20000.0))
+            return ERROR__FREQUENCY;
+
+        return SUCCESS;
+    }
+
+    /**
+    @brief
+    Validate the ground constants and the location percentage.
+
+    @param[in] epsilon
+    Relative permittivity.
+
+    @param[in] sigma
+    Conductivity.
+
+    @param[in] p
+    Location percentage, 0 < p < 100.
+
+    @return error
+    Error code.
+
+    */
+    static int ValidateGround(
+        T epsilon,
+        T sigma,
+        T p
+    ) {
+        if (epsilon < T(1.0))
+            return ERROR__EPSILON;
+
+        if (sigma <= T(0.0))
+            return ERROR__SIGMA;
+
+        if (p <= T(0.0) || p >= T(100.0))
+            return ERROR__INVALID_PERCENTAGE;
+
+        return SUCCESS;
+    }
+
+    /**
+    @brief
+    Validate the inputs common to the Point-To-Point and area modes. The
+    polarization is valid by construction.
+
+    @param[in] h_tx__meter
+    Structural height of the TX, in meters.
+
+    @param[in] h_rx__meter
+    Structural height of the RX, in meters.
+
+    @param[in] p
+    Location percentage, 0 < p < 100.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in] epsilon
+    Relative permittivity.
+
+    @param[in] sigma
+    Conductivity.
+
+    @param[in,out] warnings
+    Warning flags.
+
+    @return error
+    Error code.
+
+    */
+    static int ValidateInputs(
+        T h_tx__meter,
+        T h_rx__meter,
+        T p,
+        T f__mhz,
+        T epsilon,
+        T sigma,
+        long *warnings
+    ) {
+        int rtn = ValidateTerminals(h_tx__meter, h_rx__meter, f__mhz, warnings);
+        if (rtn != SUCCESS)
+            return rtn;
+
+        return ValidateGround(epsilon, sigma, p);
+    }
+
+    /**
+    @brief
+    Validate the inputs of an evaluation for an array of location
+    percentages.
+
+    @param[in] h__meter
+    Terminal structural heights, in meters.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in] epsilon
+    Relative permittivity.
+
+    @param[in] sigma
+    Conductivity.
+
+    @param[in] n_p
+    Number of location percentages.
+
+    @param[in] p
+    Location percentages, 0 < p < 100.
+
+    @param[in,out] warnings
+    Warning flags.
+
+    @return error
+    Error code.
+
+    */
+    static int ValidatePercentiles(
+        const T h__meter[2],
+        T f__mhz,
+        T epsilon,
+        T sigma,
+        int n_p,
+        const T p[],
+        long *warnings
+    ) {
+        if (n_p < 1)
+            return ERROR__INVALID_PERCENTAGE;
+
+        int rtn = ValidateInputs(h__meter[0], h__meter[1], p[0], f__mhz, epsilon, sigma, warnings);
+        if (rtn != SUCCESS)
+            return rtn;
+
+        for (int i = 1; i < n_p; i++)
+        {
+            if (p[i] <= T(0.0) || p[i] >= T(100.0))
+                return ERROR__INVALID_PERCENTAGE;
+        }
+
+        return SUCCESS;
+    }
+
+    /**
+    @brief
+    The ILM Point-To-Point mode for the terrain parameters of a path, from the
+    terrain analysis of the library, for an array of location percentages.
+
+    @param[in] path
+    Terrain parameters of the path.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in] epsilon
+    Relative permittivity.
+
+    @param[in] sigma
+    Conductivity.
+
+    @param[in] n_p
+    Number of location percentages.
+
+    @param[in] p
+    Location percentages, 0 < p < 100.
+
+    @param[out] A__db
+    Basic transmission loss at each location percentage, in dB.
+
+    @param[out] warnings
+    Warning flags.
+
+    @param[out] interValues
+    Intermediate values.
+
+    @return error
+    Error code.
+
+    */
+    static int PointToPoint(
+        const EnginePath<T> &path,
+        T f__mhz,
+        T epsilon,
+        T sigma,
+        int n_p,
+        const T p[],
+        T A__db[],
+        long *warnings,
+        EngineIntermediateValues<T> *interValues
+    ) {
+        *warnings = NO_WARNINGS;
+
+        int rtn = ValidatePercentiles(path.h__meter, f__mhz, epsilon, sigma, n_p, p, warnings);
+        if (rtn != SUCCESS)
+            return rtn;
+
+        EngineRadio<T> radio;
+        InitializeRadio(f__mhz, epsilon, sigma, &radio);
+
+        rtn = Model::EvaluatePath(path, radio, n_p, p, A__db, warnings, interValues);
+        if (rtn != SUCCESS)
+            return rtn;
+
+        return *warnings != NO_WARNINGS ? SUCCESS_WITH_WARNINGS : SUCCESS;
+    }
+
+    /**
+    @brief
+    The ILM Point-to-Area mode, for an array of location percentages.
+
+    @param[in] h_tx__meter
+    Structural height of the TX, in meters.
+
+    @param[in] h_rx__meter
+    Structural height of the RX, in meters.
+
+    @param[in] d__km
+    Path distance, in km.
+
+    @param[in] delta_h__meter
+    Terrain irregularity parameter.
+
+    @param[in] f__mhz
+    Frequency, in MHz.
+
+    @param[in] epsilon
+    Relative permittivity.
+
+    @param[in] sigma
+    Conductivity.
+
+    @param[in] n_p
+    Number of location percentages.
+
+    @param[in] p
+    Location percentages, 0 < p < 100.
+
+    @param[out] A__db
+    Basic transmission loss at each location percentage, in dB.
+
+    @param[out] warnings
+    Warning flags.
+
+    @param[out] interValues
+    Intermediate values.
+
+    @return error
+    Error code.
+
+    */
+    template <typename TxSiting, typename RxSiting>
+    static int Area(
+        T h_tx__meter,
+        T h_rx__meter,
+        T d__km,
+        T delta_h__meter,
+        T f__mhz,
+        T epsilon,
+        T sigma,
+        int n_p,
+        const T p[],
+        T A__db[],
+        long *warnings,
+        EngineIntermediateValues<T> *interValues
+    ) {
+        *warnings = NO_WARNINGS;
+
+        T h__meter[2] = { h_tx__meter, h_rx__meter };
+        int rtn = ValidatePercentiles(h__meter, f__mhz, epsilon, sigma, n_p, p, warnings);
+        if (rtn != SUCCESS)
+            return rtn;
+
+        EnginePath<T> path;
+        rtn = AreaModel<T>::template PrepareArea<TxSiting, RxSiting>(
+            h_tx__meter,
+            h_rx__meter,
+            d__km,
+            delta_h__meter,
+            &path
+        );
+        if (rtn != SUCCESS)
+            return rtn;
+
+        EngineRadio<T> radio;
+        InitializeRadio(f__mhz, epsilon, sigma, &radio);
+
+        rtn = Model::EvaluatePath(path, radio, n_p, p, A__db, warnings, interValues);
+        if (rtn != SUCCESS)
+            return rtn;
+
+        return *warnings != NO_WARNINGS ? SUCCESS_WITH_WARNINGS : SUCCESS;
+    }
+};
+
+/**
+@brief
+Copy the constants of a radio context of ilm.h to the engine.
+
+@param[in] radio
+Radio context.
+
+@return
+Radio constants.
+
+*/
+inline EngineRadio<double> EngineRadioOf(
+    const RadioContext *radio
+) {
+    EngineRadio<double> engine_radio;
+    engine_radio.f__mhz = radio->f__mhz;
+    engine_radio.Z_g = radio->Z_g;
+    engine_radio.abs_Z_g = radio->abs_Z_g;
+    engine_radio.k = radio->k;
+    engine_radio.X_ae__meter = radio->X_ae__meter;
+    engine_radio.f_cbrt = radio->f_cbrt;
+    engine_radio.f_inv_cbrt = radio->f_inv_cbrt;
+    engine_radio.A_f__db = radio->A_f__db;
+    return engine_radio;
+}
+
+/**
+@brief
+Copy a prepared path of ilm.h to the engine.
+
+@param[in] path
+Prepared path.
+
+@return
+Terrain parameters of the path.
+
+*/
+inline EnginePath<double> EnginePathOf(
+    const PreparedPath *path
+) {
+    EnginePath<double> engine_path;
+    for (int i = 0; i < 2; i++)
+    {
+        engine_path.h__meter[i] = path->h__meter[i];
+        engine_path.theta_hzn[i] = path->theta_hzn[i];
+        engine_path.d_hzn__meter[i] = path->d_hzn__meter[i];
+        engine_path.h_e__meter[i] = path->h_e__meter[i];
+    }
+    engine_path.delta_h__meter = path->delta_h__meter;
+    engine_path.d__meter = path->d__meter;
+    engine_path.d__km = path->d__km;
+    return engine_path;
+}
+
+/**
+@brief
+Copy the intermediate values of the engine to ilm.h.
+
+@param[in] engine_values
+Intermediate values of the engine.
+
+@param[out] interValues
+Intermediate values.
+
+*/
+inline void CopyIntermediateValues(
+    const EngineIntermediateValues<double> &engine_values,
+    IntermediateValues *interValues
+) {
+    for (int i = 0; i < 2; i++)
+    {
+        interValues->theta_hzn[i] = engine_values.theta_hzn[i];
+        interValues->d_hzn__meter[i] = engine_values.d_hzn__meter[i];
+        interValues->h_e__meter[i] = engine_values.h_e__meter[i];
+    }
+    interValues->delta_h__meter = engine_values.delta_h__meter;
+    interValues->A_ref__db = engine_values.A_ref__db;
+    interValues->A_fs__db = engine_values.A_fs__db;
+    interValues->d__km = engine_values.d__km;
+    interValues->mode = engine_values.mode;
+}
+
+/**
+@brief
+Copy Longley-Rice coefficients of Internal.h to the engine.
+
+@param[in] coeffs
+Longley-Rice coefficients.
+
+@return
+Longley-Rice coefficients of the engine.
+
+*/
+inline EngineCoefficients<double> EngineCoefficientsOf(
+    const LongleyRiceCoefficients *coeffs
+) {
+    EngineCoefficients<double> engine_coeffs;
+    engine_coeffs.d_ls__meter = coeffs->d_ls__meter;
+    engine_coeffs.d_l__meter = coeffs->d_l__meter;
+    engine_coeffs.d_min__meter = coeffs->d_min__meter;
+    engine_coeffs.m_d = coeffs->m_d;
+    engine_coeffs.A_ed__db = coeffs->A_ed__db;
+    engine_coeffs.kHat_1 = coeffs->kHat_1;
+    engine_coeffs.kHat_2 = coeffs->kHat_2;
+    engine_coeffs.A_o__db = coeffs->A_o__db;
+    return engine_coeffs;
+}
+
+/**
+@brief
+Copy Longley-Rice coefficients of the engine to Internal.h.
+
+@param[in] engine_coeffs
+Longley-Rice coefficients of the engine.
+
+@param[out] coeffs
+Longley-Rice coefficients.
+
+*/
+inline void CopyCoefficients(
+    const EngineCoefficients<double> &engine_coeffs,
+    LongleyRiceCoefficients *coeffs
+) {
+    coeffs->d_ls__meter = engine_coeffs.d_ls__meter;
+    coeffs->d_l__meter = engine_coeffs.d_l__meter;
+    coeffs->d_min__meter = engine_coeffs.d_min__meter;
+    coeffs->m_d = engine_coeffs.m_d;
+    coeffs->A_ed__db = engine_coeffs.A_ed__db;
+    coeffs->kHat_1 = engine_coeffs.kHat_1;
+    coeffs->kHat_2 = engine_coeffs.kHat_2;
+    coeffs->A_o__db = engine_coeffs.A_o__db;
+}
@@ -25,6 +25,131 @@ Fixed siting criteria.
 */
 #define SITING_CRITERIA__FIXED 1
 
+/**
+Terrain elevations are 16 bit signed integers, with a scale and offset.
+*/
+#define TERRAIN_ENCODING__INT16 0
+
+/**
+Terrain elevations are 32 bit floats, with a scale and offset.
+*/
+#define TERRAIN_ENCODING__FLOAT32 1
+
+/**
+Precision of the special functions: the exact functions of the model.
+*/
+#define PRECISION__EXACT 0
+
+/**
+Precision of the special functions: table driven approximations of the
+logarithms, exponentials and cube roots, with a bounded error.
+*/
+#define PRECISION__FAST 1
+
+// Columns of result files
+
+/**
+Result file column of basic transmission losses, in dB.
+*/
+#define RESULT_COLUMN__A_DB 0
+
+/**
+Result file column of warning flags.
+*/
+#define RESULT_COLUMN__WARNINGS 1
+
+/**
+Result file column of error codes.
+*/
+#define RESULT_COLUMN__ERROR 2
+
+/**
+Result file column of TX horizon angles.
+*/
+#define RESULT_COLUMN__THETA_HZN_TX 3
+
+/**
+Result file column of RX horizon angles.
+*/
+#define RESULT_COLUMN__THETA_HZN_RX 4
+
+/**
+Result file column of TX horizon distances, in meters.
+*/
+#define RESULT_COLUMN__D_HZN_TX 5
+
+/**
+Result file column of RX horizon distances, in meters.
+*/
+#define RESULT_COLUMN__D_HZN_RX 6
+
+/**
+Result file column of TX effective heights, in meters.
+*/
+#define RESULT_COLUMN__H_E_TX 7
+
+/**
+Result file column of RX effective heights, in meters.
+*/
+#define RESULT_COLUMN__H_E_RX 8
+
+/**
+Result file column of terrain irregularity parameters, in meters.
+*/
+#define RESULT_COLUMN__DELTA_H 9
+
+/**
+Result file column of reference attenuations, in dB.
+*/
+#define RESULT_COLUMN__A_REF_DB 10
+
+/**
+Result file column of free space basic transmission losses, in dB.
+*/
+#define RESULT_COLUMN__A_FS_DB 11
+
+/**
+Result file column of path distances, in km.
+*/
+#define RESULT_COLUMN__D_KM 12
+
+/**
+Result file column of modes of propagation.
+*/
+#define RESULT_COLUMN__MODE 13
+
+/**
+Number of result file columns.
+*/
+#define RESULT_COLUMN_COUNT 14
+
+/**
+Selects the output columns of a result file: losses, warnings and errors.
+*/
+#define RESULT_COLUMNS__OUTPUTS 0x7
+
+/**
+Selects all the columns of a result file.
+*/
+#define RESULT_COLUMNS__ALL 0x3FFF
+
+// Types of result file columns
+
+/**
+Column of 64 bit IEEE floats.
+*/
+#define RESULT_TYPE__FLOAT64 0
+
+/**
+Column of 32 bit signed integers.
+*/
+#define RESULT_TYPE__INT32 1
+
+/**
+Column of 64 bit signed integers.
+*/
+#define RESULT_TYPE__INT64 2
+
 // List of valid modes of propagation
 
 /**
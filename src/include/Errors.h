@@ -84,3 +84,35 @@ Invalid value for TX siting criteria.
 Invalid value for RX siting criteria.
 */
 #define ERROR__RX_SITING_CRITERIA 1012
+
+/**
+One or more elements of a batch returned an error. See the per-element error
+codes.
+*/
+#define ERROR__BATCH_ELEMENT 1013
+
+/**
+The terrain data does not cover the path.
+*/
+#define ERROR__TERRAIN_EXTENT 1014
+
+/**
+The DEM file could not be opened, or its label is not supported.
+*/
+#define ERROR__DEM_FILE 1015
+
+/**
+Invalid value for the terrain encoding.
+*/
+#define ERROR__TERRAIN_ENCODING 1016
+
+/**
+The result file could not be created, opened or written, or is not valid.
+*/
+#define ERROR__RESULT_FILE 1017
+
+/**
+The basic transmission loss is not finite at a distance of the range, so its
+crossings of the threshold are not known.
+*/
+#define ERROR__LOSS_NOT_FINITE 1018
@@ -0,0 +1,70 @@
+#pragma once
+/**
+@file
+
+Parallel executor for batch evaluation in the ILM.
+
+The items of a batch are grouped into contiguous chunks of roughly equal
+estimated cost, the chunks are dealt to per-thread work-stealing deques, and
+the threads of a process-wide pool evaluate them. Each item writes only its
+own outputs, so results do not depend on the schedule. Once the pool has
+grown to the number of threads asked for, starting a batch does not allocate.
+*/
+
+/* Standard includes. */
+#include <functional>
+
+/**
+@brief
+Estimated cost of a Point-To-Point evaluation, apart from its terrain
+profile, in units of the cost of one terrain point.
+*/
+#define COST__POINT_TO_POINT 1000.0
+
+/**
+@brief
+Estimated cost of an Area evaluation, in units of the cost of one terrain
+point.
+*/
+#define COST__AREA 250.0
+
+void ParallelFor(
+    int n,
+    const double cost[],
+    int n_threads,
+    const std::function<void(int)> &body
+);
+
+int ParallelWorker();
+
+/**
+@brief
+Evaluate every item of a batch on a pool of threads, with any function
+object as the body.
+
+The body is passed to ParallelFor() by reference, so it is not copied into
+memory of its own however much it captures.
+
+@param[in] n
+Number of items.
+
+@param[in] cost
+Estimated cost of each item, or NULL if all items cost the same.
+
+@param[in] n_threads
+Number of threads, including the calling thread, or 0 to use one per
+hardware thread.
+
+@param[in] body
+Function object to evaluate item i.
+
+*/
+template <typename Body>
+void ParallelFor(
+    int n,
+    const double cost[],
+    int n_threads,
+    const Body &body
+) {
+    ParallelFor(n, cost, n_threads, std::function<void(int)>(std::cref(body)));
+}
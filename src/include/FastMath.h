@@ -0,0 +1,261 @@
+#pragma once
+/**
+@file
+
+Table driven approximations of the elementary functions for the
+PRECISION__FAST mode of the special functions, with their error bounds.
+
+FastLog2() writes x = 2^e * m, with 1 <= m < 2, and takes c as the midpoint of
+the one of 128 equal intervals of [1, 2) that holds m. Then
+log2(x) = e - log2(1 / c) + log2(1 + r), with r = m / c - 1 and
+|r| <= 1 / 257. The series of log2(1 + r), truncated after r^3, is off by at
+most r^4 / (4 ln(2) (1 - |r|)) < 8.4E-11.
+
+FastExp2() writes y = n + j / 64 + r, with |r| <= 1 / 128. Then
+2^y = 2^n * 2^(j / 64) * e^(r ln(2)), and the series of e^t, truncated after
+t^3, is off by a relative error of at most t^4 e^|t| / 24 < 3.7E-11.
+
+Arguments outside the ranges where these bounds hold (zero, negative,
+subnormal, infinite, NaN, and exponents outside -1000 < y < 1000) are passed
+to the standard library, so the special cases are identical to it.
+*/
+
+/* Standard includes. */
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+@brief
+Bound of the absolute error of FastLog2(), before rounding of the result.
+*/
+#define FAST_LOG2_ERROR 8.4E-11
+
+/**
+@brief
+Bound of the relative error of FastExp2(), before rounding of the result.
+*/
+#define FAST_EXP2_ERROR 3.7E-11
+
+extern const double FAST_LOG2_INVERSE[128];
+
+extern const double FAST_LOG2_LOG[128];
+
+extern const double FAST_EXP2_TABLE[64];
+
+/**
+@brief
+Approximate the base 2 logarithm.
+
+@param[in] x
+Argument.
+
+@return
+log2(x), to within FAST_LOG2_ERROR.
+
+*/
+inline double FastLog2(
+    double x
+) {
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+
+    // Zero, negative, subnormal, infinite and NaN arguments.
+    if (bits - 0x0010000000000000ULL >= 0x7FE0000000000000ULL)
+        return log2(x);
+
+    int e = int(bits >> 52) - 1023;
+    int i = int(bits >> 45) & 127;
+
+    bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+
+    double r = m * FAST_LOG2_INVERSE[i] - 1.0;
+
+    // log2(1 + r) = (r - r^2 / 2 + r^3 / 3) / ln(2).
+    double log2_1p = r * (1.4426950408889634 + r * (-0.7213475204444817 + r * 0.4808983469629878));
+
+    return (e + FAST_LOG2_LOG[i]) + log2_1p;
+}
+
+/**
+@brief
+Approximate the base 2 exponential.
+
+@param[in] y
+Exponent.
+
+@return
+2^y, to within a relative FAST_EXP2_ERROR.
+
+*/
+inline double FastExp2(
+    double y
+) {
+    // Overflow, subnormal results, and NaN arguments.
+    if (!(y > -1000.0 && y < 1000.0))
+        return exp2(y);
+
+    // Round y * 64 to the nearest integer k, in the low bits of k_shifted.
+    double k_shifted = y * 64.0 + 6755399441055744.0;
+    uint64_t k_bits;
+    memcpy(&k_bits, &k_shifted, sizeof(k_bits));
+    int k = int(int32_t(uint32_t(k_bits)));
+
+    double r = y - (k_shifted - 6755399441055744.0) / 64.0;
+
+    int j = k & 63;
+    int n = (k - j) / 64;
+
+    // e^t = 1 + t + t^2 / 2 + t^3 / 6, with t = r ln(2).
+    double exp2_r = 1.0 + r * (0.6931471805599453 + r * (0.24022650695910072 + r * 0.05550410866482158));
+
+    double result = FAST_EXP2_TABLE[j] * exp2_r;
+
+    // Scale by 2^n.
+    uint64_t bits;
+    memcpy(&bits, &result, sizeof(bits));
+    bits += uint64_t(int64_t(n)) << 52;
+    memcpy(&result, &bits, sizeof(result));
+
+    return result;
+}
+
+/**
+@brief
+Approximate the natural logarithm.
+
+@param[in] x
+Argument.
+
+@return
+log(x), to within ln(2) * FAST_LOG2_ERROR.
+
+*/
+inline double FastLog(
+    double x
+) {
+    return FastLog2(x) * 0.6931471805599453;
+}
+
+/**
+@brief
+Approximate the base 10 logarithm.
+
+@param[in] x
+Argument.
+
+@return
+log10(x), to within log10(2) * FAST_LOG2_ERROR.
+
+*/
+inline double FastLog10(
+    double x
+) {
+    return FastLog2(x) * 0.3010299956639812;
+}
+
+/**
+@brief
+Approximate the natural exponential.
+
+@param[in] y
+Exponent.
+
+@return
+e^y, to within a relative FAST_EXP2_ERROR, plus the rounding of y / ln(2).
+
+*/
+inline double FastExp(
+    double y
+) {
+    return FastExp2(y * 1.4426950408889634);
+}
+
+/**
+@brief
+Approximate the cube root of a non-negative number, as pow(x, 1.0 / 3.0).
+
+@param[in] x
+Argument.
+
+@return
+x^(1/3), to within a relative ln(2) * FAST_LOG2_ERROR / 3 + FAST_EXP2_ERROR.
+
+*/
+inline double FastCbrt(
+    double x
+) {
+    return FastExp2(FastLog2(x) * (1.0 / 3.0));
+}
+
+/**
+@brief
+Precision policy of the engine in Engine.h that evaluates the special
+functions with the approximations above, for PRECISION__FAST. Only defined
+for double.
+*/
+struct FastPrecision
+{
+    /**
+    Natural logarithm.
+    */
+    static double Log(double x)
+    {
+        return FastLog(x);
+    }
+
+    /**
+    Base 10 logarithm.
+    */
+    static double Log10(double x)
+    {
+        return FastLog10(x);
+    }
+
+    /**
+    Natural exponential.
+    */
+    static double Exp(double x)
+    {
+        return FastExp(x);
+    }
+
+    /**
+    Cube root of a non-negative number.
+    */
+    static double Cbrt(double x)
+    {
+        return FastCbrt(x);
+    }
+
+    /**
+    Fourth root of a non-negative number.
+    */
+    static double Root4(double x)
+    {
+        return FastExp2(0.25 * FastLog2(x));
+    }
+
+    /**
+    Cube of a number.
+    */
+    static double Cube(double x)
+    {
+        return x * x * x;
+    }
+};
+
+double FresnelIntegralFast(
+    double v2
+);
+
+double HeightFunctionFast(
+    double x__km,
+    double K
+);
+
+double InverseComplementaryCumulativeDistributionFunctionFast(
+    double q
+);
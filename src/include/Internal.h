@@ -0,0 +1,152 @@
+#pragma once
+/**
+@file
+
+Helper functions shared by the source files of the ILM library.
+
+These are not exported from the library and their signatures may change
+between versions. The public interface is declared in ilm.h.
+*/
+
+/* Standard includes. */
+#include <complex>
+
+/* Local includes. */
+#include "ilm.h"
+
+template <int N>
+struct Dual;
+
+template <typename T>
+struct EnginePath;
+
+/**
+@brief
+Structure to hold the path distance independent coefficients of the
+Longley-Rice reference attenuation.
+*/
+struct LongleyRiceCoefficients
+{
+    /**
+    Maximum line-of-sight distance for a smooth earth, in meters.
+    */
+    double d_ls__meter;
+
+    /**
+    Maximum line-of-sight distance for the actual path, in meters.
+    */
+    double d_l__meter;
+
+    /**
+    Minimum path distance for the small angle approximation, in meters.
+    */
+    double d_min__meter;
+
+    /**
+    Diffraction slope, in dB/meter.
+    */
+    double m_d;
+
+    /**
+    Diffraction intercept, in dB.
+    */
+    double A_ed__db;
+
+    /**
+    Line-of-sight linear coefficient, in dB/meter.
+    */
+    double kHat_1;
+
+    /**
+    Line-of-sight logarithmic coefficient, in dB.
+    */
+    double kHat_2;
+
+    /**
+    Line-of-sight intercept, in dB.
+    */
+    double A_o__db;
+};
+
+/* Prototypes. */
+
+void DualLinearLeastSquaresFit(
+    double pfl[],
+    double d_start[2],
+    double d_end[2],
+    double fit_y1[2],
+    double fit_y2[2]
+);
+
+void DualLinearLeastSquaresFitView(
+    const TerrainView* view,
+    double d_start[2],
+    double d_end[2],
+    double fit_y1[2],
+    double fit_y2[2]
+);
+
+void DualLinearLeastSquaresFitCompact(
+    const CompactTerrainView* view,
+    double d_start[2],
+    double d_end[2],
+    double fit_y1[2],
+    double fit_y2[2]
+);
+
+void EvaluateLongleyRice(
+    const LongleyRiceCoefficients* coeffs,
+    double d__meter,
+    double* A_ref__db,
+    long* warnings,
+    int* propmode
+);
+
+int InitializeLongleyRice(
+    double theta_hzn[2],
+    double f__mhz,
+    std::complex<double> Z_g,
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double delta_h__meter,
+    double h__meter[2],
+    LongleyRiceCoefficients* coeffs,
+    long* warnings
+);
+
+void PreparePathGrad(
+    const Dual<4> h__meter[2],
+    double pfl[],
+    EnginePath<Dual<4>>* path
+);
+
+void QuickPflPreparedFromHorizons(
+    const PreparedProfile* prepared,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+);
+
+void ScatterIntermediateValues(
+    const IntermediateValues* iv,
+    int i,
+    IntermediateValuesBatch* interValues
+);
+
+int SolveAreaRange(
+    const LongleyRiceCoefficients* coeffs,
+    double delta_h__meter,
+    double f__mhz,
+    double p,
+    double A__db,
+    double d_min__km,
+    double d_max__km,
+    int n_max,
+    double d__km[],
+    int direction[],
+    int* n_crossings,
+    double* d_range__km
+);
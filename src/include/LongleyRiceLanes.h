@@ -0,0 +1,270 @@
+#pragma once
+/**
+@file
+
+Evaluation of the Longley-Rice method for several paths at once, one path per
+lane of a SIMD register, after their terrain analysis.
+*/
+
+/* Local includes. */
+#include "ilm.h"
+
+/**
+@brief
+Number of paths evaluated together by the lane kernels.
+*/
+#define LONGLEY_RICE_LANES 4
+
+/**
+@brief
+Structure to hold the paths of one evaluation of the lane kernels, with each
+input and output stored lane by lane.
+*/
+struct LongleyRiceLanes
+{
+    /**
+    Radio context of each path. The ground impedance must be valid.
+    */
+    const RadioContext *radio[LONGLEY_RICE_LANES];
+
+    /**
+    Terminal horizon angles.
+    */
+    double theta_hzn[2][LONGLEY_RICE_LANES];
+
+    /**
+    Terminal horizon distances, in meters.
+    */
+    double d_hzn__meter[2][LONGLEY_RICE_LANES];
+
+    /**
+    Terminal effective heights, in meters.
+    */
+    double h_e__meter[2][LONGLEY_RICE_LANES];
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    double delta_h__meter[LONGLEY_RICE_LANES];
+
+    /**
+    Terminal structural heights, in meters.
+    */
+    double h__meter[2][LONGLEY_RICE_LANES];
+
+    /**
+    Path distance, in meters.
+    */
+    double d__meter[LONGLEY_RICE_LANES];
+
+    /**
+    Location ratio, 0 < p < 1.
+    */
+    double p[LONGLEY_RICE_LANES];
+
+    /**
+    Reference attenuation, in dB.
+    */
+    double A_ref__db[LONGLEY_RICE_LANES];
+
+    /**
+    Free space basic transmission loss, in dB.
+    */
+    double A_fs__db[LONGLEY_RICE_LANES];
+
+    /**
+    Basic transmission loss, in dB.
+    */
+    double A__db[LONGLEY_RICE_LANES];
+
+    /**
+    Warning flags. The flags already set are kept.
+    */
+    long warnings[LONGLEY_RICE_LANES];
+
+    /**
+    Mode of propagation value.
+    */
+    int propmode[LONGLEY_RICE_LANES];
+};
+
+/**
+@brief
+Structure to hold the arguments and results of the terms of the lane kernels,
+one set per lane, so that each term can be checked against its scalar
+function.
+*/
+struct LongleyRiceTermLanes
+{
+    /**
+    Radio context of each lane. The ground impedance must be valid.
+    */
+    const RadioContext *radio[LONGLEY_RICE_LANES];
+
+    /**
+    Argument of the exponential.
+    */
+    double x[LONGLEY_RICE_LANES];
+
+    /**
+    Argument of the logarithms and the cube root, >= 0.
+    */
+    double y[LONGLEY_RICE_LANES];
+
+    /**
+    Angle of the sine and cosine, in radians.
+    */
+    double phi[LONGLEY_RICE_LANES];
+
+    /**
+    Square of the Fresnel-Kirchhoff diffraction parameter.
+    */
+    double v2[LONGLEY_RICE_LANES];
+
+    /**
+    Normalized distance of the height gain function, in km.
+    */
+    double x__km[LONGLEY_RICE_LANES];
+
+    /**
+    K value of the height gain function.
+    */
+    double K[LONGLEY_RICE_LANES];
+
+    /**
+    Quantile of the inverse CCDF, 0 < q < 1.
+    */
+    double q[LONGLEY_RICE_LANES];
+
+    /**
+    Path distance of the diffraction terms, in meters.
+    */
+    double d__meter[LONGLEY_RICE_LANES];
+
+    /**
+    Angular distance of line-of-sight region.
+    */
+    double theta_los[LONGLEY_RICE_LANES];
+
+    /**
+    Terminal horizon distances, in meters.
+    */
+    double d_hzn__meter[2][LONGLEY_RICE_LANES];
+
+    /**
+    Terminal effective heights, in meters.
+    */
+    double h_e__meter[2][LONGLEY_RICE_LANES];
+
+    /**
+    Distance of the line-of-sight term, in meters.
+    */
+    double s__meter[LONGLEY_RICE_LANES];
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    double delta_h__meter[LONGLEY_RICE_LANES];
+
+    /**
+    Diffraction slope.
+    */
+    double m_d[LONGLEY_RICE_LANES];
+
+    /**
+    Diffraction intercept, in dB.
+    */
+    double A_ed__db[LONGLEY_RICE_LANES];
+
+    /**
+    Maximum line-of-sight distance for a smooth path, in meters.
+    */
+    double d_ls__meter[LONGLEY_RICE_LANES];
+
+    /**
+    e^x.
+    */
+    double exp_x[LONGLEY_RICE_LANES];
+
+    /**
+    Natural logarithm of y.
+    */
+    double log_y[LONGLEY_RICE_LANES];
+
+    /**
+    Base 10 logarithm of y.
+    */
+    double log10_y[LONGLEY_RICE_LANES];
+
+    /**
+    Cube root of y.
+    */
+    double cbrt_y[LONGLEY_RICE_LANES];
+
+    /**
+    Sine of phi.
+    */
+    double sin_phi[LONGLEY_RICE_LANES];
+
+    /**
+    Cosine of phi.
+    */
+    double cos_phi[LONGLEY_RICE_LANES];
+
+    /**
+    Fresnel integral of v2, in dB.
+    */
+    double F_v__db[LONGLEY_RICE_LANES];
+
+    /**
+    Height gain of x__km and K, in dB.
+    */
+    double F_x__db[LONGLEY_RICE_LANES];
+
+    /**
+    Inverse CCDF of q.
+    */
+    double Q_q[LONGLEY_RICE_LANES];
+
+    /**
+    Knife-edge diffraction loss, in dB.
+    */
+    double A_k__db[LONGLEY_RICE_LANES];
+
+    /**
+    Smooth sphere diffraction loss over the lunar radius, in dB.
+    */
+    double A_r__db[LONGLEY_RICE_LANES];
+
+    /**
+    Line-of-sight loss, in dB.
+    */
+    double A_los__db[LONGLEY_RICE_LANES];
+};
+
+void SmallAngleWarnings(
+    const double theta_hzn[2],
+    long *warnings
+);
+
+double MinimumPathDistance(
+    const double h_e__meter[2]
+);
+
+double SmoothSphereB0(
+    double K
+);
+
+void LongleyRiceLanesScalar(
+    LongleyRiceLanes *lanes
+);
+
+void PointToPointPreparedLanes(
+    int n,
+    const PreparedPath *paths[],
+    const RadioContext *radios[],
+    const double p[],
+    double A__db[],
+    long warnings[],
+    IntermediateValues interValues[]
+);
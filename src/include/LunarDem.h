@@ -0,0 +1,236 @@
+#pragma once
+/**
+@file
+
+Memory-mapped lunar digital elevation models (DEMs) for the ILM.
+
+A DEM file is a raw grid of elevation samples preceded by a PDS3 style text
+label of KEYWORD = VALUE lines, ended by an END line. The file is mapped into
+memory and samples are read in place, so opening a DEM does not read the
+grid and extracting a profile only touches the pages it crosses.
+*/
+
+/* Standard includes. */
+#include <algorithm>
+#include <cstddef>
+
+/* Local includes. */
+#include "ilm.h"
+
+/**
+@brief
+Elevation samples are 16 bit signed integers.
+*/
+#define DEM_SAMPLE__INT16 0
+
+/**
+@brief
+Elevation samples are 32 bit IEEE floats.
+*/
+#define DEM_SAMPLE__FLOAT32 1
+
+/**
+@brief
+Equirectangular (simple cylindrical) map projection.
+*/
+#define DEM_PROJECTION__EQUIRECTANGULAR 0
+
+/**
+@brief
+Polar stereographic map projection.
+*/
+#define DEM_PROJECTION__POLAR_STEREOGRAPHIC 1
+
+/**
+@brief
+Structure to hold a memory-mapped lunar DEM.
+*/
+struct LunarDem
+{
+    /**
+    Start of the file mapping.
+    */
+    void *map;
+
+    /**
+    Size of the file mapping, in bytes.
+    */
+    size_t map_size;
+
+    /**
+    Operating system handles of the file and its mapping, where needed.
+    */
+    void *handles[2];
+
+    /**
+    First elevation sample.
+    */
+    const unsigned char *data;
+
+    /**
+    Number of lines (rows) of samples.
+    */
+    int lines;
+
+    /**
+    Number of samples in each line.
+    */
+    int samples;
+
+    /**
+    Sample type, DEM_SAMPLE__INT16 or DEM_SAMPLE__FLOAT32.
+    */
+    int sample_type;
+
+    /**
+    Whether the samples are stored in the opposite byte order of the host.
+    */
+    bool swap_bytes;
+
+    /**
+    Elevation of a sample is scale * value + offset, in meters.
+    */
+    double scale;
+
+    /**
+    Elevation of a sample is scale * value + offset, in meters.
+    */
+    double offset__meter;
+
+    /**
+    Map projection, DEM_PROJECTION__EQUIRECTANGULAR or
+    DEM_PROJECTION__POLAR_STEREOGRAPHIC.
+    */
+    int projection;
+
+    /**
+    Center latitude of the projection, in degrees.
+    */
+    double center_lat__deg;
+
+    /**
+    Center longitude of the projection, in degrees.
+    */
+    double center_lon__deg;
+
+    /**
+    Line of the projection origin, in zero based pixels.
+    */
+    double line_offset;
+
+    /**
+    Sample of the projection origin, in zero based pixels.
+    */
+    double sample_offset;
+
+    /**
+    Equirectangular resolution, in pixels per degree of latitude.
+    */
+    double resolution__px_per_deg;
+
+    /**
+    Polar stereographic scale, in meters per pixel.
+    */
+    double map_scale__meter;
+
+    /**
+    Equirectangular resolution, in pixels per degree of longitude.
+    */
+    double resolution_lon__px_per_deg;
+
+    /**
+    Cosine of the center longitude.
+    */
+    double cos_center_lon;
+
+    /**
+    Sine of the center longitude.
+    */
+    double sin_center_lon;
+
+    /**
+    Whether an equirectangular grid wraps around in longitude.
+    */
+    bool wraps;
+};
+
+bool LunarDemPixel(
+    const LunarDem *dem,
+    const double v[3],
+    double *line,
+    double *sample
+);
+
+double ReadLunarDem(
+    const LunarDem *dem,
+    int line,
+    int sample
+);
+
+double SampleLunarDem(
+    const LunarDem *dem,
+    double line,
+    double sample
+);
+
+/**
+@brief
+Interpolate the elevation of a lunar DEM at a pixel from its four neighboring
+samples.
+
+Pixels within half a pixel of the edge of the grid take the value of the
+edge, and grids that wrap in longitude interpolate across the seam.
+
+@param[in] dem
+DEM.
+
+@param[in] line
+Zero based line, from LunarDemPixel().
+
+@param[in] sample
+Zero based sample, from LunarDemPixel().
+
+@param[in] read
+Function returning the elevation of the sample at a line and sample, in
+meters.
+
+@return
+Elevation, in meters.
+
+*/
+template <typename Read>
+inline double InterpolateLunarDem(
+    const LunarDem *dem,
+    double line,
+    double sample,
+    Read &read
+) {
+    line = std::max(0.0, std::min(line, dem->lines - 1.0));
+    int j = std::min((int)line, dem->lines - 2);
+    double f_j = line - j;
+
+    int i_0, i_1;
+    double f_i;
+
+    if (dem->wraps)
+    {
+        i_0 = std::min((int)sample, dem->samples - 1);
+        i_1 = (i_0 + 1) % dem->samples;
+        f_i = sample - i_0;
+    }
+    else
+    {
+        sample = std::max(0.0, std::min(sample, dem->samples - 1.0));
+        i_0 = std::min((int)sample, dem->samples - 2);
+        i_1 = i_0 + 1;
+        f_i = sample - i_0;
+    }
+
+    double z_00 = read(j, i_0);
+    double z_01 = read(j, i_1);
+    double z_10 = read(j + 1, i_0);
+    double z_11 = read(j + 1, i_1);
+
+    return (1.0 - f_j) * ((1.0 - f_i) * z_00 + f_i * z_01)
+        + f_j * ((1.0 - f_i) * z_10 + f_i * z_11);
+}
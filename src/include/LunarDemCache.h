@@ -0,0 +1,161 @@
+#pragma once
+/**
+@file
+
+Concurrent cache of decoded tiles of a lunar DEM.
+
+The grid of a DEM is split into square tiles of DEM_TILE_SIZE samples, which
+are decoded to elevations in meters the first time they are used and kept
+under a memory budget with least recently used eviction. The tiles are spread
+over DEM_CACHE_SHARDS independently locked shards, and a profile keeps the
+tiles it is crossing in hand, so the cache is only visited when a profile
+moves onto another tile.
+*/
+
+/* Standard includes. */
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/* Local includes. */
+#include "LunarDem.h"
+
+/**
+@brief
+Log2 of the size of a tile, in samples.
+*/
+#define DEM_TILE_SHIFT 7
+
+/**
+@brief
+Size of a tile, in samples, on each side.
+*/
+#define DEM_TILE_SIZE (1 << DEM_TILE_SHIFT)
+
+/**
+@brief
+Number of shards of the cache.
+*/
+#define DEM_CACHE_SHARDS 16
+
+/**
+@brief
+Structure to hold a decoded tile of a lunar DEM.
+*/
+struct DemTile
+{
+    /**
+    First line of the tile.
+    */
+    int line_0;
+
+    /**
+    First sample of the tile.
+    */
+    int sample_0;
+
+    /**
+    Number of samples in each line of the tile.
+    */
+    int samples;
+
+    /**
+    Elevations of the tile, line by line, in meters.
+    */
+    std::vector<double> z__meter;
+};
+
+/**
+@brief
+Structure to hold one shard of a lunar DEM tile cache.
+*/
+struct DemCacheShard
+{
+    /**
+    Lock of the shard.
+    */
+    std::mutex mutex;
+
+    /**
+    Tiles of the shard with their keys, most recently used first.
+    */
+    std::list<std::pair<uint64_t, std::shared_ptr<const DemTile>>> lru;
+
+    /**
+    Position of each tile in the LRU list, by key.
+    */
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, std::shared_ptr<const DemTile>>>::iterator> index;
+
+    /**
+    Memory held by the tiles of the shard, in bytes.
+    */
+    long long bytes;
+
+    /**
+    Number of lookups served from the shard.
+    */
+    long long hits;
+
+    /**
+    Number of lookups that decoded a tile.
+    */
+    long long misses;
+
+    /**
+    Number of tiles evicted from the shard.
+    */
+    long long evictions;
+};
+
+/**
+@brief
+Structure to hold a lunar DEM tile cache.
+*/
+struct LunarDemCache
+{
+    /**
+    DEM the tiles are decoded from.
+    */
+    const LunarDem *dem;
+
+    /**
+    Memory budget of each shard, in bytes.
+    */
+    long long shard_budget__bytes;
+
+    /**
+    Number of tile lines of the grid.
+    */
+    int tile_lines;
+
+    /**
+    Number of tile samples of the grid.
+    */
+    int tile_samples;
+
+    /**
+    Shards of the cache.
+    */
+    DemCacheShard shards[DEM_CACHE_SHARDS];
+
+    /**
+    Number of tiles prefetched.
+    */
+    std::atomic<long long> prefetches;
+};
+
+std::shared_ptr<const DemTile> FindDemTile(
+    LunarDemCache *cache,
+    int tile_line,
+    int tile_sample
+);
+
+void PrefetchDemTile(
+    LunarDemCache *cache,
+    int tile_line,
+    int tile_sample
+);
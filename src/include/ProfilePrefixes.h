@@ -0,0 +1,110 @@
+#pragma once
+/**
+@file
+
+Incremental evaluation of the ILM Point-To-Point mode at receiver positions
+along one terrain profile.
+
+A receiver at sample k of a profile sees the prefix of the profile that ends
+at k. The terrain is sampled once for the whole profile, the TX horizon is kept
+as a running maximum as k grows, the RX horizon search is pruned with block
+maxima of the terrain, and the least squares fits come from the prefix sums of
+a prepared profile.
+*/
+
+/* Standard includes. */
+#include <complex>
+
+/* Local includes. */
+#include "ilm.h"
+
+/**
+@brief
+Number of terrain samples in each block of the RX horizon search.
+*/
+#define PREFIX_HORIZON_BLOCK 64
+
+/**
+@brief
+State of the horizon search over the prefixes of a terrain profile.
+*/
+struct PrefixHorizons
+{
+    /**
+    Terrain data of the whole profile, in pfl format.
+    */
+    const double *pfl;
+
+    /**
+    Terminal structural heights, in meters.
+    */
+    double h__meter[2];
+
+    /**
+    Maximum terrain elevation of each block of samples, in meters.
+    */
+    double *z_block_max__meter;
+
+    /**
+    Maximum terrain elevation of all blocks up to and including each block,
+    in meters.
+    */
+    double *z_prefix_max__meter;
+
+    /**
+    Next sample to add to the TX horizon search.
+    */
+    int i_next;
+
+    /**
+    Distance of sample i_next - 1 from the TX, in meters.
+    */
+    double d_tx__meter;
+
+    /**
+    Maximum TX horizon angle of the samples searched so far.
+    */
+    double theta_tx_max;
+
+    /**
+    Distance of the TX horizon maximum, in meters, or zero if none was found.
+    */
+    double d_tx_max__meter;
+
+    /**
+    Distance of each sample from the receiver at sample k_rx, in meters.
+    */
+    double *d_rx__meter;
+
+    /**
+    Sample index of the receiver of d_rx__meter, or 0 if not yet computed.
+    */
+    int k_rx;
+};
+
+void InitializePrefixHorizons(
+    const double pfl[],
+    double h__meter[2],
+    PrefixHorizons *search
+);
+
+void FindPrefixHorizons(
+    PrefixHorizons *search,
+    int k,
+    double theta_hzn[2],
+    double d_hzn__meter[2]
+);
+
+void PointToPointAtPrefixes(
+    double pfl[],
+    double h__meter[2],
+    const RadioContext *radio,
+    double p,
+    long common_warnings,
+    int n,
+    const int k[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch *interValues
+);
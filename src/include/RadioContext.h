@@ -0,0 +1,132 @@
+#pragma once
+/**
+@file
+
+Evaluation of the Longley-Rice method with the frequency and ground dependent
+constants taken from a RadioContext rather than recomputed on each call.
+
+The functions with radio parameters in ilm.h build a context and call these,
+so both give identical results. These in turn are wrappers over the engine of
+Engine.h, instantiated for double with the precision of the context.
+*/
+
+/* Standard includes. */
+#include <complex>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Engine.h"
+#include "FastMath.h"
+
+/**
+@brief
+Engine of the Longley-Rice method for PRECISION__EXACT.
+*/
+typedef LongleyRiceModel<double, ExactPrecision> ExactModel;
+
+/**
+@brief
+Engine of the Longley-Rice method for PRECISION__FAST.
+*/
+typedef LongleyRiceModel<double, FastPrecision> FastModel;
+
+void InitializeRadioContext(
+    double f__mhz,
+    std::complex<double> Z_g,
+    RadioContext *radio
+);
+
+const RadioContext *BatchRadioContext(
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma
+);
+
+double DiffractionLoss(
+    double radius__meter,
+    double d__meter,
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    const RadioContext *radio,
+    double delta_h__meter,
+    double h__meter[2],
+    double theta_los
+);
+
+int EvaluatePreparedPath(
+    const PreparedPath *path,
+    const RadioContext *radio,
+    int n_p,
+    const double p[],
+    double A__db[],
+    long *warnings,
+    IntermediateValues *interValues
+);
+
+double FreeSpaceLoss(
+    double d__meter,
+    const RadioContext *radio
+);
+
+int InitializeLongleyRice(
+    double theta_hzn[2],
+    const RadioContext *radio,
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double delta_h__meter,
+    double h__meter[2],
+    LongleyRiceCoefficients *coeffs,
+    long *warnings
+);
+
+double KnifeEdgeDiffraction(
+    double d__meter,
+    const RadioContext *radio,
+    double theta_los,
+    double d_hzn__meter[2]
+);
+
+double LineOfSightLoss(
+    double s__meter,
+    double h_e__meter[2],
+    const RadioContext *radio,
+    double delta_h__meter,
+    double m_d,
+    double A_ed,
+    double d_ls__meter
+);
+
+int LongleyRice(
+    double theta_hzn[2],
+    const RadioContext *radio,
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double delta_h__meter,
+    double h__meter[2],
+    double d__meter,
+    double *A_ref__db,
+    long *warnings,
+    int *propmode
+);
+
+double SmoothSphereDiffraction(
+    double radius__meter,
+    double d__meter,
+    const RadioContext *radio,
+    double theta_los,
+    double d_hzn__meter[2],
+    double h_e__meter[2]
+);
+
+bool ValidGroundImpedance(
+    const RadioContext *radio
+);
+
+double Variability(
+    double p,
+    double delta_h__meter,
+    const RadioContext *radio,
+    double d__meter,
+    double A_ref__db
+);
@@ -0,0 +1,72 @@
+#pragma once
+/**
+@file
+
+Columnar, memory-mapped result files for the ILM.
+
+A result file holds one column per output and per intermediate value of a
+batch of paths, each stored contiguously so a reader can map just the columns
+it needs. The layout is fixed when the file is created, so worker threads
+write their rows straight into the mapping with no coordination.
+
+All values are little-endian. The file is:
+
+    header   "ILMRSLT1", uint32 version (1), uint32 reserved
+    columns  each n_rows values, starting on a 64 byte boundary
+    footer   per column: uint32 column, uint32 type, uint64 offset,
+             uint64 bytes
+    trailer  uint64 n_rows, uint32 n_columns, uint32 version,
+             uint64 footer offset, "ILMRSLT1"
+
+Column numbers are the RESULT_COLUMN__* values and types the RESULT_TYPE__*
+values. The warnings column has the width of the writer's long.
+*/
+
+/* Standard includes. */
+#include <cstddef>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Enums.h"
+
+/**
+@brief
+Structure to hold a memory-mapped result file.
+*/
+struct ResultFile
+{
+    /**
+    Start of the file mapping.
+    */
+    void *map;
+
+    /**
+    Size of the file mapping, in bytes.
+    */
+    size_t map_size;
+
+    /**
+    Operating system handles of the file and its mapping, where needed.
+    */
+    void *handles[2];
+
+    /**
+    Whether the file was created for writing.
+    */
+    bool writable;
+
+    /**
+    Number of rows.
+    */
+    long long n_rows;
+
+    /**
+    Offset of each column in the file, in bytes, or 0 if it is not stored.
+    */
+    size_t column_offset[RESULT_COLUMN_COUNT];
+
+    /**
+    Type of each column, a RESULT_TYPE__* value.
+    */
+    int column_type[RESULT_COLUMN_COUNT];
+};
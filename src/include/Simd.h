@@ -0,0 +1,111 @@
+#pragma once
+/**
+@file
+
+CPU feature detection and SIMD kernels for the ILM.
+
+The kernels are compiled for their instruction set with per-function target
+attributes and are only called after a runtime check of the CPU, so the rest
+of the library does not need to be built for a specific instruction set.
+*/
+
+/**
+ILM_X86_SIMD indicates that the x86 SIMD kernels are available to the build.
+ILM_TARGET_AVX2 and ILM_TARGET_AVX512 mark functions that use AVX2 and
+AVX-512F instructions.
+*/
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define ILM_X86_SIMD
+#define ILM_TARGET_AVX2
+#define ILM_TARGET_AVX512
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ILM_X86_SIMD
+#define ILM_TARGET_AVX2 __attribute__((target("avx2")))
+#define ILM_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+/* Standard includes. */
+#include <cstdint>
+
+/* CPU feature detection. */
+
+bool CpuSupportsAvx2();
+
+bool CpuSupportsAvx512();
+
+/* SIMD kernels. */
+
+#ifdef ILM_X86_SIMD
+
+void FindHorizonsAvx2(
+    const double z__meter[],
+    const double d_tx__meter[],
+    const double c_tx[],
+    const double d_rx__meter[],
+    const double c_rx[],
+    int i_start,
+    int i_end,
+    double z_tx__meter,
+    double z_rx__meter,
+    double theta_max[2],
+    int i_max[2]
+);
+
+void FindHorizonsAvx512(
+    const double z__meter[],
+    const double d_tx__meter[],
+    const double c_tx[],
+    const double d_rx__meter[],
+    const double c_rx[],
+    int i_start,
+    int i_end,
+    double z_tx__meter,
+    double z_rx__meter,
+    double theta_max[2],
+    int i_max[2]
+);
+
+void WidenTerrainAvx2(
+    const int16_t z[],
+    int n,
+    double scale,
+    double offset__meter,
+    double z__meter[]
+);
+
+void WidenTerrainAvx2(
+    const float z[],
+    int n,
+    double scale,
+    double offset__meter,
+    double z__meter[]
+);
+
+struct LunarDem;
+
+bool SampleGreatCircleAvx2(
+    const LunarDem *dem,
+    const double u[3],
+    const double w[3],
+    const double c[],
+    const double s[],
+    int n,
+    double z__meter[]
+);
+
+struct LongleyRiceLanes;
+
+void LongleyRiceAvx2(
+    LongleyRiceLanes *lanes
+);
+
+struct LongleyRiceTermLanes;
+
+void LongleyRiceTermsAvx2(
+    LongleyRiceTermLanes *terms
+);
+
+#endif  // ILM_X86_SIMD
@@ -0,0 +1,298 @@
+#pragma once
+/**
+@file
+
+Access to the points of a terrain profile, either in pfl format or through a
+TerrainView or CompactTerrainView, so the terrain analysis can be written once
+for all of them.
+
+All give the same values and the same path distance for the same profile, so
+the results do not depend on how the profile is stored.
+*/
+
+/* Standard includes. */
+#include <cstddef>
+#include <cstdint>
+
+/* Local includes. */
+#include "ilm.h"
+#include "Enums.h"
+#include "Simd.h"
+
+/**
+@brief
+Terrain profile in pfl format.
+*/
+struct PflTerrain
+{
+    /**
+    Terrain data, in pfl format.
+    */
+    double *pfl;
+
+    /**
+    Number of intervals of the profile.
+    */
+    int Intervals() const
+    {
+        return (int)pfl[0];
+    }
+
+    /**
+    Profile resolution, in meters.
+    */
+    double Resolution() const
+    {
+        return pfl[1];
+    }
+
+    /**
+    Path distance, in meters.
+    */
+    double Distance() const
+    {
+        return pfl[0] * pfl[1];
+    }
+
+    /**
+    Elevation of point i, in meters.
+    */
+    double operator[](int i) const
+    {
+        return pfl[i + 2];
+    }
+
+    /**
+    Elevations of the points as a contiguous array.
+    */
+    const double *Contiguous() const
+    {
+        return &pfl[2];
+    }
+
+    /**
+    Copy the elevations of n points from point i_0 into an array.
+    */
+    void Widen(int i_0, int n, double z__meter[]) const
+    {
+        for (int k = 0; k < n; k++)
+            z__meter[k] = pfl[i_0 + k + 2];
+    }
+};
+
+/**
+@brief
+Terrain profile described by a TerrainView.
+
+The fields of the view are copied in, so reading the terrain does not reload
+them after every store.
+*/
+struct StridedTerrain
+{
+    /**
+    View of the terrain.
+    */
+    const TerrainView *view;
+
+    /**
+    Elevation of the first point, in meters.
+    */
+    const double *z__meter;
+
+    /**
+    Number of elements between successive points.
+    */
+    ptrdiff_t stride;
+
+    StridedTerrain(const TerrainView *view)
+        : view(view), z__meter(view->z__meter), stride(view->stride)
+    {
+    }
+
+    /**
+    Number of intervals of the profile.
+    */
+    int Intervals() const
+    {
+        return view->np;
+    }
+
+    /**
+    Profile resolution, in meters.
+    */
+    double Resolution() const
+    {
+        return view->xi__meter;
+    }
+
+    /**
+    Path distance, in meters.
+    */
+    double Distance() const
+    {
+        return view->np * view->xi__meter;
+    }
+
+    /**
+    Elevation of point i, in meters.
+    */
+    double operator[](int i) const
+    {
+        return z__meter[i * stride];
+    }
+
+    /**
+    Elevations of the points as a contiguous array, or NULL if the stride is
+    not 1.
+    */
+    const double *Contiguous() const
+    {
+        return stride == 1 ? z__meter : nullptr;
+    }
+
+    /**
+    Copy the elevations of n points from point i_0 into an array.
+    */
+    void Widen(int i_0, int n, double z__meter[]) const
+    {
+        for (int k = 0; k < n; k++)
+            z__meter[k] = (*this)[i_0 + k];
+    }
+};
+
+/**
+@brief
+Terrain profile described by a CompactTerrainView, with elements of type T.
+
+Elements are widened to double precision as they are read. The fields of the
+view are copied in, so reading the terrain does not reload them after every
+store, and views with a stride of 1 are read with unit_stride set, so that
+loops over the terrain can be vectorized.
+*/
+template <typename T, bool unit_stride>
+struct CompactTerrain
+{
+    /**
+    View of the terrain.
+    */
+    const CompactTerrainView *view;
+
+    /**
+    First element of the profile.
+    */
+    const T *z;
+
+    /**
+    Number of elements between successive points.
+    */
+    ptrdiff_t stride;
+
+    /**
+    Elevation of an element is scale * element + offset__meter.
+    */
+    double scale;
+
+    /**
+    Elevation of an element is scale * element + offset__meter.
+    */
+    double offset__meter;
+
+    CompactTerrain(const CompactTerrainView *view)
+        : view(view), z(static_cast<const T *>(view->z)), stride(view->stride),
+        scale(view->scale), offset__meter(view->offset__meter)
+    {
+    }
+
+    /**
+    Number of intervals of the profile.
+    */
+    int Intervals() const
+    {
+        return view->np;
+    }
+
+    /**
+    Profile resolution, in meters.
+    */
+    double Resolution() const
+    {
+        return view->xi__meter;
+    }
+
+    /**
+    Path distance, in meters.
+    */
+    double Distance() const
+    {
+        return view->np * view->xi__meter;
+    }
+
+    /**
+    Elevation of point i, in meters.
+    */
+    double operator[](int i) const
+    {
+        return scale * z[unit_stride ? i : i * stride] + offset__meter;
+    }
+
+    /**
+    Elevations of the points as a contiguous array of doubles, which a compact
+    encoding never has.
+    */
+    const double *Contiguous() const
+    {
+        return nullptr;
+    }
+
+    /**
+    Widen the elevations of n points from point i_0 into an array, with the
+    AVX2 kernels for views with a stride of 1.
+    */
+    void Widen(int i_0, int n, double z__meter[]) const
+    {
+#ifdef ILM_X86_SIMD
+        if (unit_stride && CpuSupportsAvx2())
+        {
+            WidenTerrainAvx2(&z[i_0], n, scale, offset__meter, z__meter);
+            return;
+        }
+#endif
+
+        for (int k = 0; k < n; k++)
+            z__meter[k] = (*this)[i_0 + k];
+    }
+};
+
+/**
+@brief
+Call a function with the terrain accessor for the encoding of a compact view.
+
+@param[in] view
+View of the terrain. Encodings other than TERRAIN_ENCODING__INT16 are read as
+TERRAIN_ENCODING__FLOAT32.
+
+@param[in] function
+Function to call with the accessor.
+
+@return
+Result of the function.
+*/
+template <typename Function>
+auto WithCompactTerrain(
+    const CompactTerrainView *view,
+    Function function
+) -> decltype(function(CompactTerrain<float, true>(view)))
+{
+    if (view->encoding == TERRAIN_ENCODING__INT16)
+    {
+        if (view->stride == 1)
+            return function(CompactTerrain<int16_t, true>(view));
+
+        return function(CompactTerrain<int16_t, false>(view));
+    }
+
+    if (view->stride == 1)
+        return function(CompactTerrain<float, true>(view));
+
+    return function(CompactTerrain<float, false>(view));
+}
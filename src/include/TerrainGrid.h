@@ -0,0 +1,16 @@
+#pragma once
+/**
+@file
+
+Access to gridded terrain models, shared by the coverage mode and the viewshed.
+*/
+
+/* Local includes. */
+#include "ilm.h"
+
+bool SampleTerrainGrid(
+    const TerrainGrid *grid,
+    double x__meter,
+    double y__meter,
+    double *z__meter
+);
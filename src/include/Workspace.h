@@ -0,0 +1,287 @@
+#pragma once
+/**
+@file
+
+Per-thread scratch memory of the ILM, so that evaluations do not allocate.
+
+Each thread evaluates with a ThreadWorkspace: a bump arena for the buffers of
+one call, released in scopes, and the cached distance tables of the horizon
+search. A thread uses its own default workspace unless a batch binds one of
+the per-thread workspaces of an ILM_Workspace. Workspaces only allocate when
+a call needs more memory than any call before it, so once warmed up, or sized
+by CreateWorkspace(), they never allocate again.
+*/
+
+/* Standard includes. */
+#include <cstddef>
+#include <memory>
+
+/* Local includes. */
+#include "ilm.h"
+
+/**
+@brief
+Alignment of every arena allocation, in bytes.
+*/
+#define ARENA_ALIGNMENT 64
+
+/**
+@brief
+Memory allocated by an arena that did not fit in its block, kept until the
+scope that allocated it ends.
+*/
+struct ArenaOverflow
+{
+    /**
+    Overflow allocated before this one.
+    */
+    ArenaOverflow *previous;
+
+    /**
+    Size of the allocation, in bytes.
+    */
+    size_t bytes;
+
+    /**
+    Memory of the allocation.
+    */
+    std::unique_ptr<char[]> memory;
+};
+
+/**
+@brief
+Bump allocator of per-call scratch buffers.
+
+Allocations are released together at the end of the ArenaScope they were made
+in. An allocation that does not fit in the block is made separately, and once
+the outermost scope ends the block grows to the most memory used at once, so
+the next call with the same needs does not allocate.
+*/
+struct WorkspaceArena
+{
+    /**
+    Block of the arena.
+    */
+    std::unique_ptr<char[]> block;
+
+    /**
+    First aligned byte of the block.
+    */
+    char *memory = nullptr;
+
+    /**
+    Usable size of the block, in bytes.
+    */
+    size_t capacity = 0;
+
+    /**
+    Bytes of the block in use.
+    */
+    size_t used = 0;
+
+    /**
+    Bytes in use, including the overflow allocations.
+    */
+    size_t in_use = 0;
+
+    /**
+    Most bytes in use at once since the block last grew.
+    */
+    size_t peak = 0;
+
+    /**
+    Last overflow allocation, or NULL.
+    */
+    ArenaOverflow *overflow = nullptr;
+
+    /**
+    Number of open scopes.
+    */
+    int depth = 0;
+};
+
+/**
+@brief
+Scope of arena allocations, released when it ends.
+*/
+struct ArenaScope
+{
+    ArenaScope(WorkspaceArena *arena);
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+    /**
+    Arena of the scope.
+    */
+    WorkspaceArena *arena;
+
+    /**
+    Bytes of the block in use when the scope began.
+    */
+    size_t used;
+
+    /**
+    Bytes in use when the scope began.
+    */
+    size_t in_use;
+
+    /**
+    Last overflow allocation when the scope began.
+    */
+    ArenaOverflow *overflow;
+};
+
+/**
+@brief
+Distance tables of the horizon search.
+
+The distances from each terminal are accumulated sample by sample in exactly
+the order of the scalar search, so the tables only depend on the number of
+points and the resolution of the profile and can be shared by every profile
+with the same np and xi.
+*/
+struct HorizonTables
+{
+    /**
+    Number of points in the profile, or 0 if the tables are not filled in.
+    */
+    int np = 0;
+
+    /**
+    Profile resolution, in meters.
+    */
+    double xi = 0.0;
+
+    /**
+    Number of samples the tables have room for.
+    */
+    int capacity = 0;
+
+    /**
+    Memory of the four tables.
+    */
+    std::unique_ptr<double[]> memory;
+
+    /**
+    Distance of each sample from the TX, in meters.
+    */
+    double *d_tx__meter = nullptr;
+
+    /**
+    Curvature term d_tx__meter / (2 a_m__meter) of each sample.
+    */
+    double *c_tx = nullptr;
+
+    /**
+    Distance of each sample from the RX, in meters.
+    */
+    double *d_rx__meter = nullptr;
+
+    /**
+    Curvature term d_rx__meter / (2 a_m__meter) of each sample.
+    */
+    double *c_rx = nullptr;
+};
+
+/**
+@brief
+Scratch memory of one thread.
+*/
+struct ThreadWorkspace
+{
+    /**
+    Arena of the per-call buffers.
+    */
+    WorkspaceArena arena;
+
+    /**
+    Distance tables of the last profile shape searched for horizons.
+    */
+    HorizonTables horizons;
+};
+
+/**
+@brief
+Per-thread scratch memory for the batch and coverage functions, created with
+CreateWorkspace() and destroyed with DestroyWorkspace().
+*/
+struct ILM_Workspace
+{
+    /**
+    Number of threads the workspace has scratch memory for.
+    */
+    int n_threads;
+
+    /**
+    Scratch memory of each worker of a batch.
+    */
+    std::unique_ptr<ThreadWorkspace[]> threads;
+};
+
+/**
+@brief
+Bind a per-thread workspace of an ILM_Workspace to the calling thread for the
+rest of a scope.
+
+The thread takes the workspace of its worker index in the running batch. A
+NULL ILM_Workspace leaves the binding unchanged.
+*/
+struct WorkspaceBinding
+{
+    WorkspaceBinding(ILM_Workspace *workspace);
+    ~WorkspaceBinding();
+
+    WorkspaceBinding(const WorkspaceBinding &) = delete;
+    WorkspaceBinding &operator=(const WorkspaceBinding &) = delete;
+
+    /**
+    Workspace bound before the scope began.
+    */
+    ThreadWorkspace *previous;
+};
+
+ThreadWorkspace *CurrentWorkspace();
+
+void *ArenaAllocate(
+    WorkspaceArena *arena,
+    size_t bytes
+);
+
+void ReserveArena(
+    WorkspaceArena *arena,
+    size_t bytes
+);
+
+void ReserveHorizonTables(
+    HorizonTables *tables,
+    int np
+);
+
+int WorkspaceThreads(
+    const ILM_Workspace *workspace,
+    int n_threads
+);
+
+/**
+@brief
+Allocate an uninitialized array from an arena.
+
+@param[in,out] arena
+Arena.
+
+@param[in] n
+Number of elements.
+
+@return
+Array, valid until the end of the current scope of the arena.
+
+*/
+template <typename T>
+T *ArenaArray(
+    WorkspaceArena *arena,
+    size_t n
+) {
+    return static_cast<T *>(ArenaAllocate(arena, n * sizeof(T)));
+}
@@ -32,7 +32,7 @@ ILM.dll compilation date and time.
 @brief
 The radius of Earth's moon in meters.
 */
-#define a_m__meter 1737400.0
+constexpr double a_m__meter = 1737400.0;
 
 /**
 @brief
@@ -81,6 +81,424 @@ struct IntermediateValues
     int mode;
 };
 
+/**
+@brief
+Structure of arrays to hold intermediate values for a batch of links.
+
+Each member points to a caller-allocated column with one entry per link. Any
+member may be NULL, in which case that column is not written.
+*/
+struct IntermediateValuesBatch
+{
+    /**
+    Terminal horizon angles.
+    */
+    double *theta_hzn[2];
+
+    /**
+    Terminal horizon distances, in meters.
+    */
+    double *d_hzn__meter[2];
+
+    /**
+    Terminal effective heights, in meters.
+    */
+    double *h_e__meter[2];
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    double *delta_h__meter;
+
+    /**
+    Reference attenuation, in dB.
+    */
+    double *A_ref__db;
+
+    /**
+    Free space basic transmission loss, in dB.
+    */
+    double *A_fs__db;
+
+    /**
+    Path distance, in km.
+    */
+    double *d__km;
+
+    /**
+    Mode of propagation value.
+    */
+    int *mode;
+};
+
+/**
+@brief
+Structure to hold the partial derivatives of the basic transmission loss with
+respect to the terminal heights, the frequency and the path distance, from
+PointToPoint_Grad() and Area_Grad().
+*/
+struct LossGradient
+{
+    /**
+    Derivative with respect to the structural height of the TX, in dB/meter.
+    */
+    double dA_dh_tx__db_per_meter;
+
+    /**
+    Derivative with respect to the structural height of the RX, in dB/meter.
+    */
+    double dA_dh_rx__db_per_meter;
+
+    /**
+    Derivative with respect to the frequency, in dB/MHz.
+    */
+    double dA_df__db_per_mhz;
+
+    /**
+    Derivative with respect to the path distance, in dB/km.
+    */
+    double dA_dd__db_per_km;
+};
+
+/**
+@brief
+Structure to hold the radio parameters of a set of paths and the constants
+derived from them, from InitializeRadioContext().
+
+The constants depend only on the frequency and the ground, so paths that share
+them can be evaluated without recomputing them.
+*/
+struct RadioContext
+{
+    /**
+    Frequency, in MHz.
+    */
+    double f__mhz;
+
+    /**
+    Polarization.
+    */
+    int pol;
+
+    /**
+    Relative permittivity.
+    */
+    double epsilon;
+
+    /**
+    Conductivity.
+    */
+    double sigma;
+
+    /**
+    Complex ground impedance.
+    */
+    std::complex<double> Z_g;
+
+    /**
+    Magnitude of the complex ground impedance.
+    */
+    double abs_Z_g;
+
+    /**
+    Wavenumber, in radians/meter.
+    */
+    double k;
+
+    /**
+    Scale distance of the smooth sphere diffraction, in meters.
+    */
+    double X_ae__meter;
+
+    /**
+    Cube root of the frequency in MHz.
+    */
+    double f_cbrt;
+
+    /**
+    Reciprocal of the cube root of the frequency in MHz.
+    */
+    double f_inv_cbrt;
+
+    /**
+    Frequency term of the free space loss, in dB.
+    */
+    double A_f__db;
+
+    /**
+    Precision of the special functions, PRECISION__EXACT or PRECISION__FAST.
+    */
+    int precision;
+};
+
+/**
+@brief
+Structure to hold a terrain profile prepared for constant time least squares
+fits over any window.
+
+The prefix sum arrays are allocated by the caller, each with pfl[0] + 2
+entries, and filled in by PrepareProfile().
+*/
+struct PreparedProfile
+{
+    /**
+    Terrain data, in PFL format.
+    */
+    double *pfl;
+
+    /**
+    Reference elevation removed from the terrain before summing, in meters.
+    */
+    double z_ref__meter;
+
+    /**
+    Prefix sums of the terrain, sum_z[i] = sum over j < i of z_j - z_ref.
+    */
+    double *sum_z;
+
+    /**
+    Prefix sums of the index weighted terrain, sum_iz[i] = sum over j < i of
+    j * (z_j - z_ref).
+    */
+    double *sum_iz;
+};
+
+/**
+@brief
+Structure to describe a terrain profile stored in place in another array,
+such as a row or column of a DEM, without the pfl header.
+
+Point i of the profile, for 0 <= i <= np, is z__meter[i * stride].
+*/
+struct TerrainView
+{
+    /**
+    Elevation of the first point of the profile, in meters.
+    */
+    const double *z__meter;
+
+    /**
+    Number of intervals of the profile, so the profile has np + 1 points.
+    */
+    int np;
+
+    /**
+    Profile resolution, in meters.
+    */
+    double xi__meter;
+
+    /**
+    Number of array elements between successive points. Negative strides walk
+    the array backwards.
+    */
+    int stride;
+};
+
+/**
+@brief
+Structure to describe a terrain profile stored in place in a compact
+encoding, such as 16 bit integers at decimeter scale.
+
+Point i of the profile, for 0 <= i <= np, has an elevation of
+scale * z[i * stride] + offset__meter, in meters, where z is an array of the
+encoding's element type. Elevations are widened to double precision as they
+are read, and the terrain analysis itself is done in double precision.
+*/
+struct CompactTerrainView
+{
+    /**
+    First element of the profile.
+    */
+    const void *z;
+
+    /**
+    Encoding of the elements.
+    Either:
+        0: TERRAIN_ENCODING__INT16
+        1: TERRAIN_ENCODING__FLOAT32
+    */
+    int encoding;
+
+    /**
+    Elevation of an element is scale * element + offset__meter.
+    */
+    double scale;
+
+    /**
+    Elevation of an element is scale * element + offset__meter.
+    */
+    double offset__meter;
+
+    /**
+    Number of intervals of the profile, so the profile has np + 1 points.
+    */
+    int np;
+
+    /**
+    Profile resolution, in meters.
+    */
+    double xi__meter;
+
+    /**
+    Number of elements between successive points. Negative strides walk the
+    array backwards.
+    */
+    int stride;
+};
+
+/**
+@brief
+Structure to hold the terrain analysis of a Point-To-Point path, which does
+not depend on the frequency, polarization, ground constants or location
+percentage.
+
+Filled in by PreparePath().
+*/
+struct PreparedPath
+{
+    /**
+    Terminal structural heights, in meters.
+    */
+    double h__meter[2];
+
+    /**
+    Terminal horizon angles.
+    */
+    double theta_hzn[2];
+
+    /**
+    Terminal horizon distances, in meters.
+    */
+    double d_hzn__meter[2];
+
+    /**
+    Terminal effective heights, in meters.
+    */
+    double h_e__meter[2];
+
+    /**
+    Terrain irregularity parameter, in meters.
+    */
+    double delta_h__meter;
+
+    /**
+    Path distance, in meters.
+    */
+    double d__meter;
+
+    /**
+    Path distance, in km.
+    */
+    double d__km;
+};
+
+/**
+@brief
+Structure to describe a gridded terrain model in projected coordinates.
+
+The elevations are stored row by row, so the sample at column col and row row
+is z__meter[row * n_x + col] and lies at x_0__meter + col * dx__meter,
+y_0__meter + row * dy__meter. The spacings may be negative, such as for rows
+that run from north to south.
+*/
+struct TerrainGrid
+{
+    /**
+    Number of columns.
+    */
+    int n_x;
+
+    /**
+    Number of rows.
+    */
+    int n_y;
+
+    /**
+    Projected x coordinate of the first column, in meters.
+    */
+    double x_0__meter;
+
+    /**
+    Projected y coordinate of the first row, in meters.
+    */
+    double y_0__meter;
+
+    /**
+    Column spacing, in meters.
+    */
+    double dx__meter;
+
+    /**
+    Row spacing, in meters.
+    */
+    double dy__meter;
+
+    /**
+    Terrain elevations, in meters.
+    */
+    const double *z__meter;
+};
+
+/**
+@brief
+Memory-mapped lunar DEM, opened with OpenLunarDem() and closed with
+CloseLunarDem().
+*/
+struct LunarDem;
+
+/**
+@brief
+Concurrent cache of decoded tiles of a lunar DEM, created with
+CreateLunarDemCache() and destroyed with DestroyLunarDemCache().
+*/
+struct LunarDemCache;
+
+/**
+@brief
+Structure to hold the counters of a lunar DEM tile cache.
+*/
+struct TileCacheStatistics
+{
+    /**
+    Number of tile lookups served from the cache.
+    */
+    long long hits;
+
+    /**
+    Number of tile lookups that decoded the tile from the DEM.
+    */
+    long long misses;
+
+    /**
+    Number of tiles evicted to stay within the memory budget.
+    */
+    long long evictions;
+
+    /**
+    Number of tiles prefetched ahead of a profile.
+    */
+    long long prefetches;
+
+    /**
+    Memory held by the cached tiles, in bytes.
+    */
+    long long bytes;
+};
+
+/**
+@brief
+Per-thread scratch memory for the batch and coverage functions, created with
+CreateWorkspace() and destroyed with DestroyWorkspace().
+*/
+struct ILM_Workspace;
+
+/**
+@brief
+Memory-mapped columnar result file, created with CreateResultFile() or opened
+with OpenResultFile() and closed with CloseResultFile().
+*/
+struct ResultFile;
+
 /* DLL export/import. */
 /**
 _WIN32 indicates compilation on a Windows OS.
@@ -90,36 +508,294 @@ Visual Studio > Projects > ILM_DLL Properties > C/C++ > Preprocessor
 */
 #ifdef _WIN32
 
-/**
-ILM_DLL_EXPORT indicates if the library functions should be exported or
-imported.
-Only define ILM_DLL_EXPORT to export the library functions for creating
-ILM.dll. Do not define ILM_DLL_EXPORT in projects that import ILM.dll and the
-library functions will be imported.
+/**
+ILM_DLL_EXPORT indicates if the library functions should be exported or
+imported.
+Only define ILM_DLL_EXPORT to export the library functions for creating
+ILM.dll. Do not define ILM_DLL_EXPORT in projects that import ILM.dll and the
+library functions will be imported.
+
+Define ILM_DLL_EXPORT in:
+Visual Studio > Project > MKE Properties > C/C++ > Preprocessor
+> Preprocessor Definitions.
+*/
+#ifdef ILM_DLL_EXPORT
+#define ILM_API extern "C" __declspec(dllexport)
+#else
+#define ILM_API extern "C" __declspec(dllimport)
+#endif  // ILM_DLL_EXPORT
+#else
+// Compiling with a non-Windows OS.
+#define ILM_API
+#endif  // _WIN32
+
+/* Prototypes. */
+
+ILM_API char const *version();
+
+ILM_API char const *compile_time();
+
+/* Primary ILM library functions. */
+
+ILM_API int PointToPoint(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double* A__db,
+    long* warnings
+);
+
+ILM_API int PointToPoint_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double* A__db,
+    long* warnings,
+    IntermediateValues* interValues
+);
+
+ILM_API int PointToPointView_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    const TerrainView* view,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double* A__db,
+    long* warnings,
+    IntermediateValues* interValues
+);
+
+ILM_API int PointToPointCompact_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    const CompactTerrainView* view,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double* A__db,
+    long* warnings,
+    IntermediateValues* interValues
+);
+
+ILM_API int PointToPointPercentiles_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    int n_p,
+    double p[],
+    double* A__db,
+    long* warnings,
+    IntermediateValues* interValues
+);
+
+ILM_API int PointToPoint_Grad(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double* A__db,
+    LossGradient* grad,
+    long* warnings
+);
+
+ILM_API void PreparePath(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    PreparedPath* path
+);
+
+ILM_API void PreparePathView(
+    double h_tx__meter,
+    double h_rx__meter,
+    const TerrainView* view,
+    PreparedPath* path
+);
+
+ILM_API void PreparePathCompact(
+    double h_tx__meter,
+    double h_rx__meter,
+    const CompactTerrainView* view,
+    PreparedPath* path
+);
+
+ILM_API int PointToPointPrepared(
+    const PreparedPath* path,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double* A__db,
+    long* warnings
+);
+
+ILM_API int PointToPointPrepared_Ex(
+    const PreparedPath* path,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double* A__db,
+    long* warnings,
+    IntermediateValues* interValues
+);
+
+ILM_API int PointToPointPreparedPercentiles_Ex(
+    const PreparedPath* path,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    int n_p,
+    double p[],
+    double* A__db,
+    long* warnings,
+    IntermediateValues* interValues
+);
+
+ILM_API int PointToPointContext_Ex(
+    double h_tx__meter,
+    double h_rx__meter,
+    double pfl[],
+    const RadioContext* radio,
+    double p,
+    double* A__db,
+    long* warnings,
+    IntermediateValues* interValues
+);
 
-Define ILM_DLL_EXPORT in:
-Visual Studio > Project > MKE Properties > C/C++ > Preprocessor
-> Preprocessor Definitions.
-*/
-#ifdef ILM_DLL_EXPORT
-#define ILM_API extern "C" __declspec(dllexport)
-#else
-#define ILM_API extern "C" __declspec(dllimport)
-#endif  // ILM_DLL_EXPORT
-#else
-// Compiling with a non-Windows OS.
-#define ILM_API
-#endif  // _WIN32
+ILM_API int PointToPointPreparedContext_Ex(
+    const PreparedPath* path,
+    const RadioContext* radio,
+    int n_p,
+    double p[],
+    double* A__db,
+    long* warnings,
+    IntermediateValues* interValues
+);
 
-/* Prototypes. */
+ILM_API int PointToPointBatch(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues
+);
 
-ILM_API char const *version();
+ILM_API int PointToPointBatchParallel(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues,
+    int n_threads
+);
 
-ILM_API char const *compile_time();
+ILM_API int PointToPointBatchParallel_Ws(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues,
+    int n_threads,
+    ILM_Workspace* workspace
+);
 
-/* Primary ILM library functions. */
+ILM_API int PointToPointBatchSimd(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues,
+    int n_threads
+);
 
-ILM_API int PointToPoint(
+ILM_API int PointToPointBatchSimd_Ws(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    double pfls[],
+    long long n_pfls,
+    long long pfl_offsets[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues,
+    int n_threads,
+    ILM_Workspace* workspace
+);
+
+ILM_API int PointToPointPrefixes(
     double h_tx__meter,
     double h_rx__meter,
     double pfl[],
@@ -128,14 +804,34 @@ ILM_API int PointToPoint(
     double epsilon,
     double sigma,
     double p,
+    double A__db[],
+    long warnings[],
+    int errors[]
+);
+
+ILM_API int Area(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    double d__km,
+    double delta_h__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
     double* A__db,
     long* warnings
 );
 
-ILM_API int PointToPoint_Ex(
+ILM_API int Area_Ex(
     double h_tx__meter,
     double h_rx__meter,
-    double pfl[],
+    int tx_site_criteria,
+    int rx_site_criteria,
+    double d__km,
+    double delta_h__meter,
     double f__mhz,
     int pol,
     double epsilon,
@@ -146,7 +842,7 @@ ILM_API int PointToPoint_Ex(
     IntermediateValues* interValues
 );
 
-ILM_API int Area(
+ILM_API int Area_Grad(
     double h_tx__meter,
     double h_rx__meter,
     int tx_site_criteria,
@@ -159,10 +855,11 @@ ILM_API int Area(
     double sigma,
     double p,
     double* A__db,
+    LossGradient* grad,
     long* warnings
 );
 
-ILM_API int Area_Ex(
+ILM_API int AreaPercentiles_Ex(
     double h_tx__meter,
     double h_rx__meter,
     int tx_site_criteria,
@@ -173,12 +870,363 @@ ILM_API int Area_Ex(
     int pol,
     double epsilon,
     double sigma,
-    double p,
+    int n_p,
+    double p[],
     double* A__db,
     long* warnings,
     IntermediateValues* interValues
 );
 
+ILM_API int PrepareArea(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    double d__km,
+    double delta_h__meter,
+    PreparedPath* path
+);
+
+ILM_API int AreaBatchParallel(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    int tx_site_criteria[],
+    int rx_site_criteria[],
+    double d__km[],
+    double delta_h__meter[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues,
+    int n_threads
+);
+
+ILM_API int AreaBatchParallel_Ws(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    int tx_site_criteria[],
+    int rx_site_criteria[],
+    double d__km[],
+    double delta_h__meter[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues,
+    int n_threads,
+    ILM_Workspace* workspace
+);
+
+ILM_API int AreaBatchSimd(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    int tx_site_criteria[],
+    int rx_site_criteria[],
+    double d__km[],
+    double delta_h__meter[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues,
+    int n_threads
+);
+
+ILM_API int AreaBatchSimd_Ws(
+    int n,
+    double h_tx__meter[],
+    double h_rx__meter[],
+    int tx_site_criteria[],
+    int rx_site_criteria[],
+    double d__km[],
+    double delta_h__meter[],
+    double f__mhz[],
+    int pol[],
+    double epsilon[],
+    double sigma[],
+    double p[],
+    double A__db[],
+    long warnings[],
+    int errors[],
+    IntermediateValuesBatch* interValues,
+    int n_threads,
+    ILM_Workspace* workspace
+);
+
+ILM_API int AreaCurve(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    int n,
+    double d__km[],
+    double delta_h__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double A__db[],
+    long warnings[],
+    int mode[]
+);
+
+ILM_API int AreaRange(
+    double h_tx__meter,
+    double h_rx__meter,
+    int tx_site_criteria,
+    int rx_site_criteria,
+    double d_min__km,
+    double d_max__km,
+    double delta_h__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    double A__db,
+    int n_max,
+    double d__km[],
+    int direction[],
+    int* n_crossings,
+    double* d_range__km,
+    long* warnings
+);
+
+ILM_API int Coverage(
+    const TerrainGrid* grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    int n_radials,
+    int n_ranges,
+    double d_step__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    int n_threads,
+    double A__db[],
+    long warnings[],
+    int errors[]
+);
+
+ILM_API int Coverage_Ws(
+    const TerrainGrid* grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    int n_radials,
+    int n_ranges,
+    double d_step__meter,
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    double p,
+    int n_threads,
+    ILM_Workspace* workspace,
+    double A__db[],
+    long warnings[],
+    int errors[]
+);
+
+ILM_API int CoverageContext(
+    const TerrainGrid* grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    int n_radials,
+    int n_ranges,
+    double d_step__meter,
+    const RadioContext* radio,
+    double p,
+    int n_threads,
+    double A__db[],
+    long warnings[],
+    int errors[]
+);
+
+ILM_API int CoverageContext_Ws(
+    const TerrainGrid* grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    int n_radials,
+    int n_ranges,
+    double d_step__meter,
+    const RadioContext* radio,
+    double p,
+    int n_threads,
+    ILM_Workspace* workspace,
+    double A__db[],
+    long warnings[],
+    int errors[]
+);
+
+ILM_API int CreateWorkspace(
+    int n_threads,
+    int max_np,
+    ILM_Workspace** workspace
+);
+
+ILM_API void DestroyWorkspace(
+    ILM_Workspace* workspace
+);
+
+ILM_API void ShutdownExecutor();
+
+ILM_API int Viewshed(
+    const TerrainGrid* grid,
+    double x_tx__meter,
+    double y_tx__meter,
+    double h_tx__meter,
+    double h_rx__meter,
+    unsigned char mask[]
+);
+
+/* Lunar DEM functions. */
+
+ILM_API int OpenLunarDem(
+    const char* path,
+    LunarDem** dem
+);
+
+ILM_API void CloseLunarDem(
+    LunarDem* dem
+);
+
+ILM_API double LunarDemSpacing(
+    const LunarDem* dem
+);
+
+ILM_API double GreatCircleDistance(
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg
+);
+
+ILM_API int ExtractGreatCircleProfile(
+    const LunarDem* dem,
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg,
+    int np,
+    double pfl[]
+);
+
+ILM_API long long PlanGreatCircleProfiles(
+    int n,
+    const double lat_tx__deg[],
+    const double lon_tx__deg[],
+    const double lat_rx__deg[],
+    const double lon_rx__deg[],
+    const double xi__meter[],
+    long long pfl_offsets[]
+);
+
+ILM_API int ExtractGreatCircleProfiles(
+    const LunarDem* dem,
+    int n,
+    const double lat_tx__deg[],
+    const double lon_tx__deg[],
+    const double lat_rx__deg[],
+    const double lon_rx__deg[],
+    const double xi__meter[],
+    const long long pfl_offsets[],
+    double pfls[],
+    int errors[],
+    int n_threads
+);
+
+ILM_API int CreateLunarDemCache(
+    const LunarDem* dem,
+    long long budget__bytes,
+    LunarDemCache** cache
+);
+
+ILM_API void DestroyLunarDemCache(
+    LunarDemCache* cache
+);
+
+ILM_API void LunarDemCacheStatistics(
+    LunarDemCache* cache,
+    TileCacheStatistics* stats
+);
+
+ILM_API void ResetLunarDemCacheStatistics(
+    LunarDemCache* cache
+);
+
+ILM_API int ExtractGreatCircleProfileCached(
+    LunarDemCache* cache,
+    double lat_tx__deg,
+    double lon_tx__deg,
+    double lat_rx__deg,
+    double lon_rx__deg,
+    int np,
+    double pfl[]
+);
+
+/* Result file functions. */
+
+ILM_API int CreateResultFile(
+    const char* path,
+    long long n_rows,
+    long columns,
+    ResultFile** file
+);
+
+ILM_API int OpenResultFile(
+    const char* path,
+    ResultFile** file
+);
+
+ILM_API int CloseResultFile(
+    ResultFile* file
+);
+
+ILM_API long long ResultFileRows(
+    const ResultFile* file
+);
+
+ILM_API const void* ResultFileColumn(
+    const ResultFile* file,
+    int column,
+    int* type
+);
+
+ILM_API int ResultFileColumns(
+    ResultFile* file,
+    double** A__db,
+    long** warnings,
+    int** errors,
+    IntermediateValuesBatch* interValues
+);
+
 /* ILM Helper Functions. */
 
 ILM_API double ComputeDeltaH(
@@ -187,6 +1235,18 @@ ILM_API double ComputeDeltaH(
     double d_end__meter
 );
 
+ILM_API double ComputeDeltaHView(
+    const TerrainView* view,
+    double d_start__meter,
+    double d_end__meter
+);
+
+ILM_API double ComputeDeltaHCompact(
+    const CompactTerrainView* view,
+    double d_start__meter,
+    double d_end__meter
+);
+
 ILM_API double DiffractionLoss(
     double radius__meter,
     double d__meter,
@@ -206,6 +1266,20 @@ ILM_API void FindHorizons(
     double d_hzn__meter[2]
 );
 
+ILM_API void FindHorizonsView(
+    const TerrainView* view,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2]
+);
+
+ILM_API void FindHorizonsCompact(
+    const CompactTerrainView* view,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2]
+);
+
 ILM_API double FreeSpaceLoss(
     double d__meter,
     double f__mhz
@@ -237,6 +1311,14 @@ ILM_API void InitializePointToPoint(
     std::complex<double> *Z_g
 );
 
+ILM_API void InitializeRadioContext(
+    double f__mhz,
+    int pol,
+    double epsilon,
+    double sigma,
+    RadioContext *radio
+);
+
 ILM_API double InverseComplementaryCumulativeDistributionFunction(
     double q
 );
@@ -256,6 +1338,30 @@ ILM_API void LinearLeastSquaresFit(
     double *fit_y2
 );
 
+ILM_API void LinearLeastSquaresFitPrepared(
+    const PreparedProfile* prepared,
+    double d_start,
+    double d_end,
+    double *fit_y1,
+    double *fit_y2
+);
+
+ILM_API void LinearLeastSquaresFitView(
+    const TerrainView* view,
+    double d_start,
+    double d_end,
+    double *fit_y1,
+    double *fit_y2
+);
+
+ILM_API void LinearLeastSquaresFitCompact(
+    const CompactTerrainView* view,
+    double d_start,
+    double d_end,
+    double *fit_y1,
+    double *fit_y2
+);
+
 ILM_API double LineOfSightLoss(
     double d__meter,
     double h_e__meter[2],
@@ -281,6 +1387,13 @@ ILM_API int LongleyRice(
     int* propmode
 );
 
+ILM_API void PrepareProfile(
+    double pfl[],
+    double sum_z[],
+    double sum_iz[],
+    PreparedProfile* prepared
+);
+
 ILM_API void QuickPfl(
     double pfl[],
     double h__meter[2],
@@ -291,6 +1404,36 @@ ILM_API void QuickPfl(
     double *d__meter
 );
 
+ILM_API void QuickPflPrepared(
+    const PreparedProfile* prepared,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+);
+
+ILM_API void QuickPflView(
+    const TerrainView* view,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+);
+
+ILM_API void QuickPflCompact(
+    const CompactTerrainView* view,
+    double h__meter[2],
+    double theta_hzn[2],
+    double d_hzn__meter[2],
+    double h_e__meter[2],
+    double *delta_h__meter,
+    double *d__meter
+);
+
 ILM_API double SigmaHFunction(
     double delta_h__meter
 );